@@ -19,6 +19,19 @@ public class MetaCameraProvider : MonoBehaviour
     [SerializeField] private bool autoStart = true;
     [SerializeField] private bool flipImageVertically = true;
     [SerializeField] private bool useCameraRotation = false;
+    [SerializeField] private bool lumaOnlyTracking = false;
+    [SerializeField] private bool rectifyFrames = false;
+    [SerializeField, Range(0, 4)] private int ingestWorkers = 0;
+    [SerializeField] private bool cropHalfSizeModes = false;
+    [SerializeField] private bool dropBlurredFrames = false;
+    [SerializeField] private bool throttleWhenStatic = false;
+    [SerializeField] private bool useCaptureTimestamp = true;
+
+    [Header("Exposure")]
+    // PassthroughCameraAccess doesn't report exposure, so these apply to every frame unless
+    // the app calls ReportExposure() with capture results; 0 = unknown / global shutter
+    [SerializeField] private float exposureTimeMs = 0f;
+    [SerializeField] private float readoutTimeMs = 0f;
 
     [Header("Debug")]
     [SerializeField] private bool enableDebugLogs = false;
@@ -26,11 +39,14 @@ public class MetaCameraProvider : MonoBehaviour
     [SerializeField] private bool showPoseDebug = false;
     [SerializeField] private float statsInterval = 1.0f;
 
-    private byte[] imageDataRGB;
     private bool isRunning = false;
     private int frameCount = 0;
     private int width, height;
     private float[] cachedIntrinsics;
+    private long reportedExposureNs = -1;
+    private long reportedReadoutNs;
+    private long sentExposureNs = -1;
+    private long sentReadoutNs = -1;
 
     // Frame stats
     private float lastStatsTime;
@@ -86,7 +102,6 @@ public class MetaCameraProvider : MonoBehaviour
         Vector2Int resolution = cameraAccess.CurrentResolution;
         width = resolution.x;
         height = resolution.y;
-        imageDataRGB = new byte[width * height * 3];
 
         var sensorRes = cameraAccess.Intrinsics.SensorResolution;
         Log($"Camera initialized: Current={width}x{height}, Sensor={sensorRes.x}x{sensorRes.y}");
@@ -98,6 +113,17 @@ public class MetaCameraProvider : MonoBehaviour
 
         // Setup intrinsics
         SetupCameraIntrinsics();
+        QuestVuforiaBridge.SetLumaOnlyTracking(lumaOnlyTracking);
+        QuestVuforiaBridge.SetFrameRectification(rectifyFrames);
+        QuestVuforiaBridge.SetIngestWorkers(ingestWorkers);
+        QuestVuforiaBridge.SetCropHalfSizeModes(cropHalfSizeModes);
+        QuestVuforiaBridge.SetFrameQualityGateEnabled(dropBlurredFrames);
+        QuestVuforiaBridge.SetMotionThrottleEnabled(throttleWhenStatic);
+
+        // Capture times come as a DateTime (wall clock); the native side maps them to the
+        // monotonic clock Vuforia and the pose history use
+        QuestVuforiaBridge.SetTimestampDomain(useCaptureTimestamp ? QuestVuforiaBridge.ClockDomain.Realtime
+                                                                  : QuestVuforiaBridge.ClockDomain.Monotonic);
 
         isRunning = true;
         lastStatsTime = Time.time;
@@ -159,6 +185,10 @@ public class MetaCameraProvider : MonoBehaviour
             {
                 float fps = framesProcessed / (Time.time - lastStatsTime);
                 Log($"Processing: {fps:F1} FPS | Total: {frameCount}");
+                if (QuestVuforiaBridge.GetClockState(out var clock))
+                {
+                    Log($"Capture -> driver latency: {clock.LatencyMs:F1} ms");
+                }
                 lastStatsTime = Time.time;
                 framesProcessed = 0;
             }
@@ -167,6 +197,30 @@ public class MetaCameraProvider : MonoBehaviour
         }
     }
 
+    /// <summary>
+    /// Exposure and rolling-shutter readout time of the next frame, e.g. from the camera's
+    /// capture result (SENSOR_EXPOSURE_TIME, SENSOR_ROLLING_SHUTTER_SKEW).
+    /// </summary>
+    public void ReportExposure(long exposureNs, long readoutNs)
+    {
+        reportedExposureNs = exposureNs;
+        reportedReadoutNs = readoutNs;
+    }
+
+    // Only crosses into native code when the exposure changes
+    private void UpdateExposure()
+    {
+        long exposureNs = reportedExposureNs >= 0 ? reportedExposureNs : (long)(exposureTimeMs * 1e6f);
+        long readoutNs = reportedExposureNs >= 0 ? reportedReadoutNs : (long)(readoutTimeMs * 1e6f);
+        if (exposureNs == sentExposureNs && readoutNs == sentReadoutNs) return;
+
+        if (QuestVuforiaBridge.SetCameraExposure(exposureNs, readoutNs))
+        {
+            sentExposureNs = exposureNs;
+            sentReadoutNs = readoutNs;
+        }
+    }
+
     private void ProcessCurrentFrame()
     {
         // Get camera frame pixels
@@ -177,25 +231,9 @@ public class MetaCameraProvider : MonoBehaviour
             return;
         }
 
-        // Convert Color32 to RGB888
-        for (int i = 0; i < pixels.Length; i++)
-        {
-            int rgbIndex = i * 3;
-            Color32 pixel = pixels[i];
-            imageDataRGB[rgbIndex] = pixel.r;
-            imageDataRGB[rgbIndex + 1] = pixel.g;
-            imageDataRGB[rgbIndex + 2] = pixel.b;
-        }
-
-        // Flip Y-axis if needed
-        if (flipImageVertically)
-        {
-            FlipImageVertically(imageDataRGB, width, height);
-        }
-
-        // Get synchronized timestamp and pose
-        DateTime currentTime = DateTime.Now;
-        long timestampNs = currentTime.Ticks * 100;
+        // Capture timestamp and the camera pose at that time
+        long timestampNs = useCaptureTimestamp ? QuestVuforiaBridge.ToRealtimeNs(cameraAccess.Timestamp)
+                                               : QuestVuforiaBridge.GetMonotonicTimeNs();
         Pose cameraPose = cameraAccess.GetCameraPose();
 
         // Choose rotation based on setting
@@ -209,27 +247,14 @@ public class MetaCameraProvider : MonoBehaviour
                      $"useCameraRotation={useCameraRotation}");
         }
 
-        // Feed to Vuforia (pose first, then frame with same timestamp)
-        QuestVuforiaBridge.FeedDevicePose(cameraPose.position, rotation, timestampNs);
-        QuestVuforiaBridge.FeedCameraFrame(imageDataRGB, width, height, null, timestampNs);
-
-        frameCount++;
-    }
-
-    private void FlipImageVertically(byte[] imageData, int width, int height)
-    {
-        int stride = width * 3;
-        byte[] rowBuffer = new byte[stride];
+        UpdateExposure();
 
-        for (int row = 0; row < height / 2; row++)
-        {
-            int topRow = row * stride;
-            int bottomRow = (height - 1 - row) * stride;
+        // Submit frame + pose in one call. The native side repacks and flips the Color32 pixels
+        // straight out of the NativeArray, and delivers this pose with this frame.
+        QuestVuforiaBridge.SubmitFrame(pixels, width, height, QuestVuforiaBridge.PixelFormat.RGBA8888, 0,
+                                       flipImageVertically, cameraPose.position, rotation, timestampNs);
 
-            Array.Copy(imageData, topRow, rowBuffer, 0, stride);
-            Array.Copy(imageData, bottomRow, imageData, topRow, stride);
-            Array.Copy(rowBuffer, 0, imageData, bottomRow, stride);
-        }
+        frameCount++;
     }
 
     public void StopCamera()
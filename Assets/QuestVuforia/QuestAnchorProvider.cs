@@ -0,0 +1,217 @@
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using UnityEngine;
+
+/// <summary>
+/// Backs Vuforia anchors with Meta spatial anchors (OVRSpatialAnchor).
+/// Carries out Vuforia's create/remove requests and reports anchor poses back every frame;
+/// optionally anchors are saved and reloaded in the next session so Vuforia can relocalize
+/// against them instead of detecting its targets from scratch.
+/// </summary>
+[DefaultExecutionOrder(-40)]
+public class QuestAnchorProvider : MonoBehaviour
+{
+    [Header("Settings")]
+    [SerializeField] private bool persistAnchors = true;
+
+    [Header("Debug")]
+    [SerializeField] private bool enableDebugLogs = false;
+
+    // Vuforia UUID -> spatial anchor UUID of the saved anchors, "uuid=guid;..."
+    private const string PersistedAnchorsKey = "Quforia.PersistedAnchors";
+    private const int MaxAnchors = 64;
+
+    private struct ReportedPose
+    {
+        public Vector3 Position;
+        public Quaternion Rotation;
+        public bool Localized;
+    }
+
+    private readonly Dictionary<string, OVRSpatialAnchor> anchors = new Dictionary<string, OVRSpatialAnchor>();
+    private readonly Dictionary<string, ReportedPose> reported = new Dictionary<string, ReportedPose>();
+    private readonly Dictionary<string, Guid> persisted = new Dictionary<string, Guid>();
+    private readonly List<string> lost = new List<string>();
+    private readonly QuestVuforiaBridge.AnchorRequest[] requests = new QuestVuforiaBridge.AnchorRequest[MaxAnchors];
+    private readonly QuestVuforiaBridge.AnchorUpdate[] updates = new QuestVuforiaBridge.AnchorUpdate[MaxAnchors];
+
+    private void Start()
+    {
+        if (persistAnchors)
+        {
+            StartCoroutine(LoadPersistedAnchors());
+        }
+    }
+
+    private void Update()
+    {
+        if (!QuestVuforiaBridge.IsDriverInitialized()) return;
+
+        int count = QuestVuforiaBridge.GetAnchorRequests(requests);
+        for (int i = 0; i < count; i++)
+        {
+            string uuid = requests[i].UuidString;
+            if (requests[i].Type == QuestVuforiaBridge.AnchorRequestType.Create)
+            {
+                CreateAnchor(uuid, requests[i].Position, requests[i].Rotation);
+            }
+            else
+            {
+                EraseAnchor(uuid);
+            }
+        }
+
+        ReportPoses();
+    }
+
+    private void CreateAnchor(string uuid, Vector3 position, Quaternion rotation)
+    {
+        var anchorObject = new GameObject($"Quforia Anchor {uuid}");
+        anchorObject.transform.SetPositionAndRotation(position, rotation);
+        var anchor = anchorObject.AddComponent<OVRSpatialAnchor>();
+        anchors[uuid] = anchor;
+        Log($"Creating anchor {uuid}");
+
+        if (persistAnchors)
+        {
+            StartCoroutine(SaveAnchor(uuid, anchor));
+        }
+    }
+
+    private void EraseAnchor(string uuid)
+    {
+        if (!anchors.TryGetValue(uuid, out var anchor)) return;
+
+        anchors.Remove(uuid);
+        reported.Remove(uuid);
+        if (persisted.Remove(uuid))
+        {
+            anchor.EraseAnchorAsync();
+            SavePersistedList();
+        }
+        Destroy(anchor.gameObject);
+        Log($"Erased anchor {uuid}");
+    }
+
+    // Send the anchors whose pose or localization changed since the last report
+    private void ReportPoses()
+    {
+        int count = 0;
+        lost.Clear();
+
+        foreach (var entry in anchors)
+        {
+            var anchor = entry.Value;
+            if (anchor == null)
+            {
+                lost.Add(entry.Key);
+                continue;
+            }
+            if (!anchor.Created || count == updates.Length) continue;
+
+            var current = new ReportedPose
+            {
+                Position = anchor.transform.position,
+                Rotation = anchor.transform.rotation,
+                Localized = anchor.Localized
+            };
+            if (reported.TryGetValue(entry.Key, out var last) && last.Localized == current.Localized &&
+                last.Position == current.Position && last.Rotation == current.Rotation)
+            {
+                continue;
+            }
+
+            reported[entry.Key] = current;
+            updates[count++] = new QuestVuforiaBridge.AnchorUpdate(entry.Key, current.Position, current.Rotation,
+                                                                   current.Localized);
+        }
+
+        if (count > 0)
+        {
+            QuestVuforiaBridge.UpdateAnchors(updates, count);
+        }
+
+        // Destroyed from elsewhere (e.g. a scene change)
+        foreach (var uuid in lost)
+        {
+            anchors.Remove(uuid);
+            reported.Remove(uuid);
+            QuestVuforiaBridge.RemoveAnchor(uuid);
+        }
+    }
+
+    private IEnumerator SaveAnchor(string uuid, OVRSpatialAnchor anchor)
+    {
+        yield return new WaitUntil(() => anchor == null || anchor.Created);
+        if (anchor == null) yield break;
+
+        var save = anchor.SaveAnchorAsync();
+        yield return new WaitUntil(() => save.IsCompleted);
+        if (anchor == null || !anchors.ContainsKey(uuid)) yield break;
+
+        persisted[uuid] = anchor.Uuid;
+        SavePersistedList();
+        Log($"Saved anchor {uuid}");
+    }
+
+    private IEnumerator LoadPersistedAnchors()
+    {
+        foreach (var pair in PlayerPrefs.GetString(PersistedAnchorsKey, "").Split(';'))
+        {
+            int separator = pair.IndexOf('=');
+            if (separator > 0 && Guid.TryParse(pair.Substring(separator + 1), out var guid))
+            {
+                persisted[pair.Substring(0, separator)] = guid;
+            }
+        }
+        if (persisted.Count == 0) yield break;
+
+        var unbound = new List<OVRSpatialAnchor.UnboundAnchor>();
+        var load = OVRSpatialAnchor.LoadUnboundAnchorsAsync(persisted.Values, unbound);
+        yield return new WaitUntil(() => load.IsCompleted);
+
+        foreach (var unboundAnchor in unbound)
+        {
+            string uuid = null;
+            foreach (var entry in persisted)
+            {
+                if (entry.Value == unboundAnchor.Uuid) uuid = entry.Key;
+            }
+            if (uuid == null || anchors.ContainsKey(uuid)) continue;
+
+            // Bound anchors follow their tracked pose; they reach Vuforia with the next report
+            var anchor = new GameObject($"Quforia Anchor {uuid}").AddComponent<OVRSpatialAnchor>();
+            unboundAnchor.BindTo(anchor);
+            anchors[uuid] = anchor;
+            Log($"Loaded anchor {uuid}");
+        }
+    }
+
+    private void SavePersistedList()
+    {
+        var pairs = new List<string>();
+        foreach (var entry in persisted)
+        {
+            pairs.Add($"{entry.Key}={entry.Value}");
+        }
+        PlayerPrefs.SetString(PersistedAnchorsKey, string.Join(";", pairs));
+        PlayerPrefs.Save();
+    }
+
+    private void OnDestroy()
+    {
+        if (QuestVuforiaBridge.IsDriverInitialized())
+        {
+            QuestVuforiaBridge.ClearAnchors();
+        }
+    }
+
+    private void Log(string message)
+    {
+        if (enableDebugLogs)
+        {
+            Debug.Log($"[Quforia] {message}");
+        }
+    }
+}
@@ -1,5 +1,7 @@
 using System;
 using System.Runtime.InteropServices;
+using Unity.Collections;
+using Unity.Collections.LowLevel.Unsafe;
 using UnityEngine;
 
 /// <summary>
@@ -9,15 +11,543 @@ public static class QuestVuforiaBridge
 {
     private const string LibraryName = "quforia";
 
+    /// <summary>
+    /// How the native delivery thread hands frames to Vuforia when it falls behind.
+    /// </summary>
+    public enum FrameDeliveryPolicy
+    {
+        LatestOnly = 0,
+        EveryFrame = 1
+    }
+
+    /// <summary>
+    /// Camera frame layouts (mirrors VuforiaDriver::PixelFormat).
+    /// </summary>
+    public enum PixelFormat
+    {
+        Unknown = 0,
+        YUYV = 1,
+        NV12 = 2,
+        NV21 = 3,
+        RGB888 = 4,
+        RGBA8888 = 5,
+        YUV420P = 6,
+        YV12 = 7
+    }
+
+    /// <summary>
+    /// Blittable device pose (mirrors the native PoseData struct, 40 bytes).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PoseSample
+    {
+        public long Timestamp;
+        public float PositionX, PositionY, PositionZ;
+        public float RotationX, RotationY, RotationZ, RotationW;
+
+        public PoseSample(Vector3 position, Quaternion rotation, long timestamp)
+        {
+            Timestamp = timestamp;
+            PositionX = position.x; PositionY = position.y; PositionZ = position.z;
+            RotationX = rotation.x; RotationY = rotation.y; RotationZ = rotation.z; RotationW = rotation.w;
+        }
+    }
+
+    /// <summary>
+    /// Latency histogram with log2 microsecond buckets (mirrors native QuforiaHistogram).
+    /// Bucket i counts samples below 2^i microseconds; the last bucket is open-ended.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct LatencyHistogram
+    {
+        public const int BucketCount = 24;
+
+        public ulong Count;
+        public ulong SumNs;
+        public ulong MaxNs;
+        public fixed ulong Buckets[BucketCount];
+
+        public double MeanMs => Count > 0 ? SumNs / (double)Count / 1e6 : 0.0;
+    }
+
+    /// <summary>
+    /// Frame governor state (mirrors native QuforiaGovernorState, 40 bytes).
+    /// Level 0 delivers every frame; each level up sheds more frames, and the top level
+    /// recommends restarting Vuforia with a half resolution camera mode.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GovernorState
+    {
+        public int Enabled;
+        public int Level;
+        public int FrameDivisor;
+        public int RecommendHalfResolution;
+        public float InputFps;
+        public float CallbackMs;
+        public float Pressure;
+        public uint Reserved;
+        public ulong FramesShed;
+
+        public float DeliveredFps => FrameDivisor > 0 ? InputFps / FrameDivisor : InputFps;
+    }
+
+    /// <summary>
+    /// Motion-blur quality gate state (mirrors native QuforiaQualityState, 40 bytes).
+    /// Scores are Laplacian variances of the luma plane; frames taken during fast head turns
+    /// that score below MinSharpness x ReferenceScore are not delivered.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct QualityState
+    {
+        public int Enabled;
+        public int ConsecutiveRejects;
+        public float MinSharpness;
+        public float MinAngularSpeed;
+        public float LastScore;
+        public float ReferenceScore;
+        public float AngularSpeed;
+        public float ScoreMs;
+        public ulong FramesScored;
+    }
+
+    /// <summary>
+    /// Motion throttle state (mirrors native QuforiaMotionThrottleState, 40 bytes).
+    /// While the headset is static, frames are delivered at StaticFps; motion restores full rate.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MotionThrottleState
+    {
+        public int Enabled;
+        public int Throttled;
+        public int HoldFullRate;
+        public int RecommendLowResolution;
+        public float LinearSpeed;
+        public float AngularSpeed;
+        public float StaticSeconds;
+        public float StaticFps;
+        public ulong FramesThrottled;
+    }
+
+    /// <summary>
+    /// What Vuforia asks of the spatial anchor provider.
+    /// </summary>
+    public enum AnchorRequestType
+    {
+        Create = 0,  // Place a spatial anchor at the pose and report it back
+        Remove = 1   // Vuforia removed the anchor; erase the spatial anchor
+    }
+
+    /// <summary>
+    /// Anchor request from Vuforia (mirrors native QuforiaAnchorRequest, 72 bytes).
+    /// The pose is in Unity world space, like device poses.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct AnchorRequest
+    {
+        public const int UuidSize = 40;
+
+        public fixed byte Uuid[UuidSize];
+        public AnchorRequestType Type;
+        public float PositionX, PositionY, PositionZ;
+        public float RotationX, RotationY, RotationZ, RotationW;
+
+        public string UuidString
+        {
+            get
+            {
+                fixed (byte* uuid = Uuid)
+                {
+                    return Marshal.PtrToStringAnsi((IntPtr)uuid);
+                }
+            }
+        }
+
+        public Vector3 Position => new Vector3(PositionX, PositionY, PositionZ);
+        public Quaternion Rotation => new Quaternion(RotationX, RotationY, RotationZ, RotationW);
+    }
+
+    /// <summary>
+    /// Spatial anchor pose reported to Vuforia (mirrors native QuforiaAnchorUpdate, 72 bytes).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct AnchorUpdate
+    {
+        public fixed byte Uuid[AnchorRequest.UuidSize];
+        public float PositionX, PositionY, PositionZ;
+        public float RotationX, RotationY, RotationZ, RotationW;
+        public int Localized;
+
+        public AnchorUpdate(string uuid, Vector3 position, Quaternion rotation, bool localized)
+        {
+            int length = Math.Min(uuid.Length, AnchorRequest.UuidSize - 1);
+            for (int i = 0; i < length; i++)
+            {
+                Uuid[i] = (byte)uuid[i];
+            }
+            Uuid[length] = 0;
+
+            PositionX = position.x; PositionY = position.y; PositionZ = position.z;
+            RotationX = rotation.x; RotationY = rotation.y; RotationZ = rotation.z; RotationW = rotation.w;
+            Localized = localized ? 1 : 0;
+        }
+    }
+
+    /// <summary>
+    /// Clock that timestamps passed to the feed/submit functions are in. The native side
+    /// converts them to CLOCK_MONOTONIC, which Vuforia and the pose history use.
+    /// </summary>
+    public enum ClockDomain
+    {
+        /// <summary>CLOCK_MONOTONIC ns, e.g. from GetMonotonicTimeNs (the default).</summary>
+        Monotonic = 0,
+        /// <summary>CLOCK_BOOTTIME ns (Android sensor and camera2 timestamps).</summary>
+        BootTime = 1,
+        /// <summary>Unix epoch ns (a UTC DateTime, see ToRealtimeNs).</summary>
+        Realtime = 2,
+        /// <summary>Any other clock (e.g. OpenXR XrTime); offset and drift are estimated
+        /// natively, or pinned with AddClockSyncPoint.</summary>
+        External = 3
+    }
+
+    /// <summary>
+    /// Timestamp mapping state (mirrors native QuforiaClockState, 24 bytes).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ClockState
+    {
+        public ClockDomain Domain;
+        public int Samples;
+        public long OffsetNs;
+        public float DriftPpm;
+        public float LatencyMs;
+    }
+
+    /// <summary>
+    /// Native driver threads that can be named, prioritized and pinned.
+    /// </summary>
+    public enum ThreadRole
+    {
+        FrameDelivery = 0,
+        SessionWriter = 1,
+        SessionReplay = 2,
+        IngestWorker = 3
+    }
+
+    /// <summary>
+    /// Scheduling class for a native thread. Fifo needs permission the app usually lacks;
+    /// when refused, the thread keeps the default class and its nice value is applied instead.
+    /// </summary>
+    public enum SchedPolicy
+    {
+        Default = 0,
+        Fifo = 1
+    }
+
+    /// <summary>
+    /// Requested settings for one native thread (mirrors native QuforiaThreadConfig, 48 bytes).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+    public struct ThreadConfig
+    {
+        public ThreadRole Role;
+        public SchedPolicy Policy;
+        public int Priority;
+        public int Nice;
+        public int SetNice;
+        public int Reserved;
+        public ulong CpuMask;
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 16)]
+        public string Name;
+    }
+
+    /// <summary>
+    /// Settings a native thread actually runs with (mirrors native QuforiaThreadReport, 48 bytes).
+    /// Errors has a bit set for each setting that was refused (1 name, 2 policy, 4 nice, 8 affinity).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+    public struct ThreadReport
+    {
+        public ThreadRole Role;
+        public int Tid;
+        public SchedPolicy Policy;
+        public int Priority;
+        public int Nice;
+        public int Errors;
+        public ulong CpuMask;
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 16)]
+        public string Name;
+
+        public bool IsRunning => Tid != 0;
+
+        public override string ToString()
+        {
+            return $"{Name} (tid {Tid}): {Policy} priority {Priority}, nice {Nice}, " +
+                   $"cpus 0x{CpuMask:x}" + (Errors != 0 ? $", refused 0x{Errors:x}" : "");
+        }
+    }
+
+    /// <summary>
+    /// Frame and pose memory requested for the driver (mirrors native QuforiaMemoryConfig, 32 bytes).
+    /// Zero fields keep the defaults: 3 queued frames, no resolution limit, 3 s of poses at
+    /// up to 500 Hz, no budget.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MemoryConfig
+    {
+        public uint FrameQueueDepth;
+        public uint MaxFrameWidth;
+        public uint MaxFrameHeight;
+        public uint PoseHistoryMs;
+        public uint MaxPoseRateHz;
+        public uint Reserved;
+        public ulong BudgetBytes;
+    }
+
+    /// <summary>
+    /// Frame pool and pose history the driver allocated (mirrors native QuforiaMemoryReport, 72 bytes).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MemoryReport
+    {
+        public uint FrameQueueDepth;
+        public uint FramePoolSlots;
+        public uint MaxFrameWidth;
+        public uint MaxFrameHeight;
+        public uint PoseHistoryMs;
+        public uint PoseCapacity;
+        public ulong SlabBytes;
+        public ulong FramePoolBytes;
+        public ulong PoseHistoryBytes;
+        public ulong TotalBytes;
+        public ulong BudgetBytes;
+        public int BudgetMet;
+        public int ModesAdvertised;
+
+        public override string ToString()
+        {
+            return $"{TotalBytes / (1024.0 * 1024.0):F1} MB ({FramePoolSlots} x {SlabBytes} B frames, " +
+                   $"queue {FrameQueueDepth}, {PoseHistoryMs} ms pose history), {ModesAdvertised} modes " +
+                   $"up to {MaxFrameWidth}x{MaxFrameHeight}" +
+                   (BudgetBytes != 0 && BudgetMet == 0 ? ", over budget" : "");
+        }
+    }
+
+    /// <summary>
+    /// Hot-path counters and histograms (mirrors native QuforiaStats, 1616 bytes).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct DriverStats
+    {
+        public uint Size;
+        public uint Reserved;
+
+        public ulong FramesFed;
+        public ulong FramesRejected;
+        public ulong FramesDelivered;
+        public ulong FramesDropped;
+        public ulong FramesDuplicated;
+        public ulong FramesSkipped;
+        public ulong PosesFed;
+        public ulong PosesDelivered;
+        public ulong PosesMissing;
+
+        public LatencyHistogram FeedToDeliverLatency;
+        public LatencyHistogram PoseMatchError;
+        public LatencyHistogram FrameCallbackTime;
+        public LatencyHistogram MutexWaitTime;
+        public LatencyHistogram RectifyTime;
+
+        public ulong FramesBlurred;
+
+        public ulong CameraStarts;
+        public ulong WarmStarts;
+        public LatencyHistogram StartCallTime;
+        public LatencyHistogram StartToFirstFrame;
+    }
+
+    /// <summary>
+    /// Camera mode Vuforia started the native camera with.
+    /// </summary>
+    public struct CameraMode
+    {
+        public int Width;
+        public int Height;
+        public int Fps;
+        public PixelFormat Format;
+    }
+
     [DllImport(LibraryName)]
     private static extern bool nativeSetCameraIntrinsics(float[] intrinsics, int length);
 
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetPoseExtrapolationTolerance(long toleranceNs);
+
     [DllImport(LibraryName)]
     private static extern bool nativeFeedDevicePose(float[] position, float[] rotation, long timestamp);
 
+    [DllImport(LibraryName)]
+    private static extern bool nativeFeedDevicePosePtr(ref PoseSample pose);
+
+    [DllImport(LibraryName)]
+    private static extern unsafe int nativeFeedDevicePoses(PoseSample* batch, int count);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeGetPoseAt(long timestamp, out PoseSample pose);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeFeedCameraFramePtr(IntPtr imageData, int imageSize, int width, int height, int format, int stride, IntPtr intrinsics, int intrinsicsLength, long timestamp);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSubmitFrame(IntPtr imageData, int imageSize, int width, int height, int format, int stride, bool flipVertically, ref PoseSample pose, IntPtr intrinsics, int intrinsicsLength, long timestamp);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetIngestWorkers(int count);
+
+    [DllImport(LibraryName)]
+    private static extern unsafe long nativeFeedCameraFrameAsync(IntPtr imageData, int imageSize, int width, int height, int format, int stride, bool flipVertically, PoseSample* pose, IntPtr intrinsics, int intrinsicsLength, long timestamp);
+
+    [DllImport(LibraryName)]
+    private static extern long nativeGetCompletedIngestTicket();
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSubmitHardwareBuffer(IntPtr hardwareBuffer, bool flipVertically, ref PoseSample pose, long timestamp);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSubmitJavaHardwareBuffer(IntPtr hardwareBuffer, bool flipVertically, ref PoseSample pose, long timestamp);
+
     [DllImport(LibraryName)]
     private static extern bool nativeFeedCameraFrame(byte[] imageData, int width, int height, float[] intrinsics, int intrinsicsLength, long timestamp);
 
+    [DllImport(LibraryName)]
+    private static extern bool nativeFeedCameraFrameWithFormat(IntPtr imageData, int width, int height, int format, int stride, float[] intrinsics, int intrinsicsLength, long timestamp);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeFeedCameraFrameRGBA(IntPtr rgbaData, int imageSize, int width, int height, bool flipVertically, float[] intrinsics, int intrinsicsLength, long timestamp);
+
+    [DllImport(LibraryName)]
+    private static extern IntPtr nativeBeginCameraFrame(int width, int height);
+
+    [DllImport(LibraryName)]
+    private static extern IntPtr nativeBeginCameraFrameWithFormat(int width, int height, int format);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeCommitCameraFrame(float[] intrinsics, int intrinsicsLength, long timestamp);
+
+    [DllImport(LibraryName)]
+    private static extern void nativeCancelCameraFrame();
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetFrameDeliveryPolicy(int policy);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetLumaOnlyTracking(bool enabled);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetCameraExposure(long exposureNs, long readoutNs);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetFrameRectification(bool enabled);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetCropCenter(float x, float y);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetCropHalfSizeModes(bool enabled);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeGetCropWindow(int width, int height, int[] window);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeGetActiveCameraMode(int[] mode);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeStartRecording(string path, bool compress);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeStopRecording();
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeStartReplay(string path, float speed, bool loop);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeStopReplay();
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeIsReplaying();
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetFrameGovernorEnabled(bool enabled);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeGetFrameGovernorState(out GovernorState state);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetFrameQualityGateEnabled(bool enabled);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetFrameQualityThresholds(float minSharpness, float minAngularSpeed);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeGetFrameQualityState(out QualityState state);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetMotionThrottleEnabled(bool enabled);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeConfigureMotionThrottle(float staticFps, float linearSpeed, float angularSpeed,
+                                                             bool recommendLowResolution);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetMotionThrottleHold(bool hold);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeGetMotionThrottleState(out MotionThrottleState state);
+
+    [DllImport(LibraryName)]
+    private static extern unsafe int nativeGetAnchorRequests(AnchorRequest* requests, int maxRequests);
+
+    [DllImport(LibraryName)]
+    private static extern unsafe int nativeUpdateAnchors(AnchorUpdate* updates, int count);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeRemoveAnchor(string uuid);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeClearAnchors();
+
+    [DllImport(LibraryName)]
+    private static extern long nativeGetMonotonicTimeNs();
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetTimestampDomain(int domain);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeAddClockSyncPoint(long externalNs, long monotonicNs);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeGetClockState(out ClockState state);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetThreadConfig(ref ThreadConfig config);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeGetThreadReport(int role, out ThreadReport report);
+
+    [DllImport(LibraryName)]
+    private static extern ulong nativeGetCpuClusterMask(int cluster);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeSetMemoryConfig(ref MemoryConfig config);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeGetMemoryReport(out MemoryReport report);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeGetStats(ref DriverStats stats);
+
+    [DllImport(LibraryName)]
+    private static extern bool nativeResetStats();
+
     [DllImport(LibraryName)]
     private static extern bool nativeIsDriverInitialized();
 
@@ -35,29 +565,649 @@ public static class QuestVuforiaBridge
         return nativeSetCameraIntrinsics(intrinsics, intrinsics.Length);
     }
 
+    /// <summary>
+    /// Set how far (ns) past the newest pose the driver may extrapolate when matching a frame.
+    /// </summary>
+    public static bool SetPoseExtrapolationTolerance(long toleranceNs)
+    {
+        return nativeSetPoseExtrapolationTolerance(toleranceNs);
+    }
+
     /// <summary>
     /// Feed device pose to driver. Call BEFORE FeedCameraFrame.
     /// </summary>
     public static bool FeedDevicePose(Vector3 position, Quaternion rotation, long timestamp)
     {
-        float[] pos = new float[] { position.x, position.y, position.z };
-        float[] rot = new float[] { rotation.x, rotation.y, rotation.z, rotation.w };
-        return nativeFeedDevicePose(pos, rot, timestamp);
+        // Struct on the stack, passed by ref: no per-call float[] allocations
+        PoseSample pose = new PoseSample(position, rotation, timestamp);
+        return nativeFeedDevicePosePtr(ref pose);
     }
 
     /// <summary>
-    /// Feed camera frame to driver. Call AFTER FeedDevicePose.
+    /// Feed device pose to driver. Call BEFORE FeedCameraFrame.
     /// </summary>
-    public static bool FeedCameraFrame(byte[] imageData, int width, int height, float[] intrinsics, long timestamp)
+    public static bool FeedDevicePose(ref PoseSample pose)
     {
-        if (imageData == null || imageData.Length != width * height * 3)
+        return nativeFeedDevicePosePtr(ref pose);
+    }
+
+    /// <summary>
+    /// Feed a batch of device poses in timestamp order (e.g. head poses at display rate,
+    /// independent of camera frames). Returns how many were kept, or -1 on error.
+    /// Call from the thread that feeds frames.
+    /// </summary>
+    public static unsafe int FeedDevicePoses(NativeArray<PoseSample> poses, int count)
+    {
+        if (count < 0 || count > poses.Length)
         {
-            Debug.LogError("[Quforia] Invalid image data");
-            return false;
+            Debug.LogError("[Quforia] Invalid pose count");
+            return -1;
         }
 
-        int intrinsicsLength = intrinsics?.Length ?? 0;
-        return nativeFeedCameraFrame(imageData, width, height, intrinsics, intrinsicsLength, timestamp);
+        return nativeFeedDevicePoses((PoseSample*)NativeArrayUnsafeUtility.GetUnsafeReadOnlyPtr(poses), count);
+    }
+
+    /// <summary>
+    /// Feed the first count poses of a managed array (pinned for the call only).
+    /// </summary>
+    public static unsafe int FeedDevicePoses(PoseSample[] poses, int count)
+    {
+        if (poses == null || count < 0 || count > poses.Length)
+        {
+            Debug.LogError("[Quforia] Invalid pose batch");
+            return -1;
+        }
+
+        fixed (PoseSample* batch = poses)
+        {
+            return nativeFeedDevicePoses(batch, count);
+        }
+    }
+
+    /// <summary>
+    /// Head pose at timestamp (in the SetTimestampDomain clock), interpolated from the fed poses
+    /// or extrapolated a little past the newest one. Lock-free: call it right before rendering
+    /// (e.g. from Application.onBeforeRender) to re-project anchored content late.
+    /// </summary>
+    public static bool GetPoseAt(long timestamp, out PoseSample pose)
+    {
+        return nativeGetPoseAt(timestamp, out pose);
+    }
+
+    /// <summary>
+    /// Head pose at timestamp as a Unity position and rotation (see GetPoseAt).
+    /// </summary>
+    public static bool GetPoseAt(long timestamp, out Vector3 position, out Quaternion rotation)
+    {
+        bool found = nativeGetPoseAt(timestamp, out PoseSample pose);
+        position = new Vector3(pose.PositionX, pose.PositionY, pose.PositionZ);
+        rotation = new Quaternion(pose.RotationX, pose.RotationY, pose.RotationZ, pose.RotationW);
+        return found;
+    }
+
+    /// <summary>
+    /// Feed camera frame to driver. Call AFTER FeedDevicePose.
+    /// </summary>
+    public static bool FeedCameraFrame(byte[] imageData, int width, int height, float[] intrinsics, long timestamp)
+    {
+        if (imageData == null || imageData.Length != width * height * 3)
+        {
+            Debug.LogError("[Quforia] Invalid image data");
+            return false;
+        }
+
+        int intrinsicsLength = intrinsics?.Length ?? 0;
+        return nativeFeedCameraFrame(imageData, width, height, intrinsics, intrinsicsLength, timestamp);
+    }
+
+    /// <summary>
+    /// Feed a native camera frame in any supported layout (stride 0 = tightly packed).
+    /// The driver converts it to the active camera mode's format if needed.
+    /// </summary>
+    public static bool FeedCameraFrame(IntPtr imageData, int width, int height, PixelFormat format, int stride, float[] intrinsics, long timestamp)
+    {
+        if (imageData == IntPtr.Zero)
+        {
+            Debug.LogError("[Quforia] Invalid image data");
+            return false;
+        }
+
+        int intrinsicsLength = intrinsics?.Length ?? 0;
+        return nativeFeedCameraFrameWithFormat(imageData, width, height, (int)format, stride, intrinsics, intrinsicsLength, timestamp);
+    }
+
+    /// <summary>
+    /// Feed a camera frame from unmanaged memory (stride 0 = tightly packed). imageSize is the
+    /// buffer length in bytes and is validated natively. Zero GC allocations.
+    /// </summary>
+    public static bool FeedCameraFrame(IntPtr imageData, int imageSize, int width, int height, PixelFormat format, int stride, long timestamp)
+    {
+        return nativeFeedCameraFramePtr(imageData, imageSize, width, height, (int)format, stride, IntPtr.Zero, 0, timestamp);
+    }
+
+    /// <summary>
+    /// Feed a camera frame straight from a NativeArray (e.g. a YUV buffer from the camera API).
+    /// </summary>
+    public static unsafe bool FeedCameraFrame<T>(NativeArray<T> imageData, int width, int height, PixelFormat format, int stride, long timestamp) where T : struct
+    {
+        if (!imageData.IsCreated)
+        {
+            Debug.LogError("[Quforia] Invalid image data");
+            return false;
+        }
+
+        IntPtr data = (IntPtr)NativeArrayUnsafeUtility.GetUnsafeReadOnlyPtr(imageData);
+        int size = imageData.Length * UnsafeUtility.SizeOf<T>();
+        return nativeFeedCameraFramePtr(data, size, width, height, (int)format, stride, IntPtr.Zero, 0, timestamp);
+    }
+
+    /// <summary>
+    /// Feed a Color32 frame straight from its NativeArray memory. The driver repacks it to the
+    /// active camera mode's format (and flips it if requested) with NEON kernels. imageSize is
+    /// the buffer length in bytes and is validated natively.
+    /// </summary>
+    public static bool FeedCameraFrameRGBA(IntPtr rgbaData, int imageSize, int width, int height, bool flipVertically, float[] intrinsics, long timestamp)
+    {
+        if (rgbaData == IntPtr.Zero)
+        {
+            Debug.LogError("[Quforia] Invalid image data");
+            return false;
+        }
+
+        int intrinsicsLength = intrinsics?.Length ?? 0;
+        return nativeFeedCameraFrameRGBA(rgbaData, imageSize, width, height, flipVertically, intrinsics, intrinsicsLength, timestamp);
+    }
+
+    /// <summary>
+    /// Feed a Color32 NativeArray (e.g. PassthroughCameraAccess.GetColors()) without copying it.
+    /// </summary>
+    public static unsafe bool FeedCameraFrameRGBA(NativeArray<Color32> pixels, int width, int height, bool flipVertically, long timestamp)
+    {
+        if (!pixels.IsCreated)
+        {
+            Debug.LogError("[Quforia] Invalid image data");
+            return false;
+        }
+
+        IntPtr data = (IntPtr)NativeArrayUnsafeUtility.GetUnsafeReadOnlyPtr(pixels);
+        int size = pixels.Length * UnsafeUtility.SizeOf<Color32>();
+        return nativeFeedCameraFrameRGBA(data, size, width, height, flipVertically, null, 0, timestamp);
+    }
+
+    /// <summary>
+    /// Submit a frame and its device pose in one call (no separate FeedDevicePose needed).
+    /// The pose is handed to Vuforia with exactly this frame rather than matched by timestamp.
+    /// </summary>
+    public static unsafe bool SubmitFrame<T>(NativeArray<T> imageData, int width, int height, PixelFormat format, int stride, bool flipVertically, Vector3 position, Quaternion rotation, long timestamp) where T : struct
+    {
+        if (!imageData.IsCreated)
+        {
+            Debug.LogError("[Quforia] Invalid image data");
+            return false;
+        }
+
+        PoseSample pose = new PoseSample(position, rotation, timestamp);
+        IntPtr data = (IntPtr)NativeArrayUnsafeUtility.GetUnsafeReadOnlyPtr(imageData);
+        int size = imageData.Length * UnsafeUtility.SizeOf<T>();
+        return nativeSubmitFrame(data, size, width, height, (int)format, stride, flipVertically, ref pose, IntPtr.Zero, 0, timestamp);
+    }
+
+    /// <summary>
+    /// Convert frames on native worker threads (0-4, 0 = on the calling thread). The feed and
+    /// submit calls still return once their frame is published, but convert in parallel.
+    /// </summary>
+    public static bool SetIngestWorkers(int count)
+    {
+        return nativeSetIngestWorkers(count);
+    }
+
+    /// <summary>
+    /// Queue a frame (and its pose) for the ingest workers without waiting for it. Returns a
+    /// ticket, or 0 if the frame was dropped. The NativeArray must stay alive and unmodified
+    /// until GetCompletedIngestTicket() is at least the returned ticket.
+    /// </summary>
+    public static unsafe long SubmitFrameAsync<T>(NativeArray<T> imageData, int width, int height, PixelFormat format, int stride, bool flipVertically, Vector3 position, Quaternion rotation, long timestamp) where T : struct
+    {
+        if (!imageData.IsCreated)
+        {
+            Debug.LogError("[Quforia] Invalid image data");
+            return 0;
+        }
+
+        PoseSample pose = new PoseSample(position, rotation, timestamp);
+        IntPtr data = (IntPtr)NativeArrayUnsafeUtility.GetUnsafeReadOnlyPtr(imageData);
+        int size = imageData.Length * UnsafeUtility.SizeOf<T>();
+        return nativeFeedCameraFrameAsync(data, size, width, height, (int)format, stride, flipVertically, &pose, IntPtr.Zero, 0, timestamp);
+    }
+
+    /// <summary>
+    /// Newest ticket whose frame has been published or dropped (buffers up to it may be reused).
+    /// </summary>
+    public static long GetCompletedIngestTicket()
+    {
+        return nativeGetCompletedIngestTicket();
+    }
+
+    /// <summary>
+    /// Submit a CPU-readable AHardwareBuffer* (RGBA, RGB or YUV_420_888) with its pose. The plugin
+    /// converts straight from the buffer mapping, so pixels never pass through managed memory.
+    /// </summary>
+    public static bool SubmitHardwareBuffer(IntPtr hardwareBuffer, bool flipVertically, Vector3 position, Quaternion rotation, long timestamp)
+    {
+        PoseSample pose = new PoseSample(position, rotation, timestamp);
+        return nativeSubmitHardwareBuffer(hardwareBuffer, flipVertically, ref pose, timestamp);
+    }
+
+    /// <summary>
+    /// Submit an android.hardware.HardwareBuffer (e.g. from an ImageReader Image) with its pose.
+    /// Call from a thread attached to the JVM (the Unity main thread is).
+    /// </summary>
+    public static bool SubmitHardwareBuffer(AndroidJavaObject hardwareBuffer, bool flipVertically, Vector3 position, Quaternion rotation, long timestamp)
+    {
+        if (hardwareBuffer == null)
+        {
+            Debug.LogError("[Quforia] Invalid hardware buffer");
+            return false;
+        }
+
+        PoseSample pose = new PoseSample(position, rotation, timestamp);
+        return nativeSubmitJavaHardwareBuffer(hardwareBuffer.GetRawObject(), flipVertically, ref pose, timestamp);
+    }
+
+    /// <summary>
+    /// Borrow a native RGB888 frame buffer (width * height * 3 bytes) to write into directly.
+    /// Returns IntPtr.Zero if no buffer is available. Follow with CommitCameraFrame or CancelCameraFrame.
+    /// </summary>
+    public static IntPtr BeginCameraFrame(int width, int height)
+    {
+        return nativeBeginCameraFrame(width, height);
+    }
+
+    /// <summary>
+    /// Borrow a tightly packed native frame buffer in the given format.
+    /// Returns IntPtr.Zero if no buffer is available. Follow with CommitCameraFrame or CancelCameraFrame.
+    /// </summary>
+    public static IntPtr BeginCameraFrame(int width, int height, PixelFormat format)
+    {
+        return nativeBeginCameraFrameWithFormat(width, height, (int)format);
+    }
+
+    /// <summary>
+    /// Publish the buffer obtained from BeginCameraFrame. Call AFTER FeedDevicePose.
+    /// </summary>
+    public static bool CommitCameraFrame(float[] intrinsics, long timestamp)
+    {
+        int intrinsicsLength = intrinsics?.Length ?? 0;
+        return nativeCommitCameraFrame(intrinsics, intrinsicsLength, timestamp);
+    }
+
+    /// <summary>
+    /// Return the buffer obtained from BeginCameraFrame without publishing it.
+    /// </summary>
+    public static void CancelCameraFrame()
+    {
+        nativeCancelCameraFrame();
+    }
+
+    /// <summary>
+    /// Select latest-only (lowest latency) or every-frame (in order) delivery.
+    /// </summary>
+    public static bool SetFrameDeliveryPolicy(FrameDeliveryPolicy policy)
+    {
+        return nativeSetFrameDeliveryPolicy((int)policy);
+    }
+
+    /// <summary>
+    /// Publish YUV camera modes as grayscale (constant chroma). Vuforia tracks on luma,
+    /// so this only skips chroma work.
+    /// </summary>
+    public static bool SetLumaOnlyTracking(bool enabled)
+    {
+        return nativeSetLumaOnlyTracking(enabled);
+    }
+
+    /// <summary>
+    /// Exposure duration and rolling-shutter readout time (nanoseconds, 0 = unknown / global
+    /// shutter) of the frames fed from now on, until the next call. Vuforia gets that exposure,
+    /// and each frame gets the head pose at the middle of its exposure instead of at its
+    /// (end of exposure) timestamp.
+    /// </summary>
+    public static bool SetCameraExposure(long exposureNs, long readoutNs)
+    {
+        return nativeSetCameraExposure(exposureNs, readoutNs);
+    }
+
+    /// <summary>
+    /// Undistort frames natively using the distortion coefficients of the camera intrinsics,
+    /// so Vuforia receives pinhole images. Frames without distortion pass through unchanged.
+    /// </summary>
+    public static bool SetFrameRectification(bool enabled)
+    {
+        return nativeSetFrameRectification(enabled);
+    }
+
+    /// <summary>
+    /// Centre of the window crop modes cut from each frame, in normalized upright image
+    /// coordinates ((0.5, 0.5) = image centre). Move it to follow the tracked target.
+    /// </summary>
+    public static bool SetCropCenter(Vector2 center)
+    {
+        return nativeSetCropCenter(center.x, center.y);
+    }
+
+    /// <summary>
+    /// Cut camera modes of exactly half the input size from the frame instead of downscaling it.
+    /// </summary>
+    public static bool SetCropHalfSizeModes(bool enabled)
+    {
+        return nativeSetCropHalfSizeModes(enabled);
+    }
+
+    /// <summary>
+    /// Pixel window of a width x height camera image that the active crop mode delivers, e.g. to
+    /// map target positions in Vuforia's image back to the full frame. False if not cropped.
+    /// </summary>
+    public static bool GetCropWindow(int width, int height, out RectInt window)
+    {
+        int[] values = new int[4];
+        bool cropped = nativeGetCropWindow(width, height, values);
+        window = new RectInt(values[0], values[1], values[2], values[3]);
+        return cropped;
+    }
+
+    /// <summary>
+    /// Query the mode Vuforia started the camera with. Returns false while the camera is stopped.
+    /// </summary>
+    public static bool GetActiveCameraMode(out CameraMode mode)
+    {
+        int[] values = new int[4];
+        bool active = nativeGetActiveCameraMode(values);
+
+        mode = new CameraMode
+        {
+            Width = values[0],
+            Height = values[1],
+            Fps = values[2],
+            Format = (PixelFormat)values[3]
+        };
+        return active;
+    }
+
+    /// <summary>
+    /// Record every frame, pose and intrinsics update fed to the driver into a session file
+    /// (e.g. under Application.persistentDataPath). Frames are LZ4-compressed when requested
+    /// and the plugin was built with LZ4.
+    /// </summary>
+    public static bool StartRecording(string path, bool compress = false)
+    {
+        return nativeStartRecording(path, compress);
+    }
+
+    /// <summary>
+    /// Flush and close the current session recording.
+    /// </summary>
+    public static bool StopRecording()
+    {
+        return nativeStopRecording();
+    }
+
+    /// <summary>
+    /// Feed a recorded session to Vuforia instead of the live camera.
+    /// speed: 1 = original timing, 0 = as fast as possible.
+    /// Stop feeding live frames while a replay runs.
+    /// </summary>
+    public static bool StartReplay(string path, float speed = 1.0f, bool loop = false)
+    {
+        return nativeStartReplay(path, speed, loop);
+    }
+
+    /// <summary>
+    /// Stop the session replay.
+    /// </summary>
+    public static bool StopReplay()
+    {
+        return nativeStopReplay();
+    }
+
+    /// <summary>
+    /// True while a session replay is feeding the driver.
+    /// </summary>
+    public static bool IsReplaying()
+    {
+        return nativeIsReplaying();
+    }
+
+    /// <summary>
+    /// Enable or disable adaptive frame shedding when Vuforia falls behind (enabled by default).
+    /// </summary>
+    public static bool SetFrameGovernorEnabled(bool enabled)
+    {
+        return nativeSetFrameGovernorEnabled(enabled);
+    }
+
+    /// <summary>
+    /// Query the frame governor's current level and load.
+    /// </summary>
+    public static bool GetFrameGovernorState(out GovernorState state)
+    {
+        return nativeGetFrameGovernorState(out state);
+    }
+
+    /// <summary>
+    /// Enable or disable dropping motion-blurred frames during fast head turns (disabled by default).
+    /// Dropped frames are counted in DriverStats.FramesBlurred.
+    /// </summary>
+    public static bool SetFrameQualityGateEnabled(bool enabled)
+    {
+        return nativeSetFrameQualityGateEnabled(enabled);
+    }
+
+    /// <summary>
+    /// Quality gate thresholds: the share (0-1) of the at-rest sharpness a moving frame must reach,
+    /// and the head rotation speed (rad/s) below which frames are delivered unscored.
+    /// Pass 0 to keep a value.
+    /// </summary>
+    public static bool SetFrameQualityThresholds(float minSharpness, float minAngularSpeed)
+    {
+        return nativeSetFrameQualityThresholds(minSharpness, minAngularSpeed);
+    }
+
+    /// <summary>
+    /// Query the quality gate's scores and the head speed it last saw.
+    /// </summary>
+    public static bool GetFrameQualityState(out QualityState state)
+    {
+        return nativeGetFrameQualityState(out state);
+    }
+
+    /// <summary>
+    /// Enable or disable delivering fewer frames while the headset is static (disabled by default).
+    /// </summary>
+    public static bool SetMotionThrottleEnabled(bool enabled)
+    {
+        return nativeSetMotionThrottleEnabled(enabled);
+    }
+
+    /// <summary>
+    /// Motion throttle settings: frame rate while static, and the speeds (m/s, rad/s) below which
+    /// the headset counts as static. Pass 0 to keep a value. With recommendLowResolution the state
+    /// suggests restarting with a smaller camera mode while throttled.
+    /// </summary>
+    public static bool ConfigureMotionThrottle(float staticFps, float linearSpeed = 0f, float angularSpeed = 0f,
+                                               bool recommendLowResolution = false)
+    {
+        return nativeConfigureMotionThrottle(staticFps, linearSpeed, angularSpeed, recommendLowResolution);
+    }
+
+    /// <summary>
+    /// Force full-rate delivery regardless of motion. Hold it while Vuforia is still detecting a
+    /// target, and release it once the target is tracked.
+    /// </summary>
+    public static bool SetMotionThrottleHold(bool hold)
+    {
+        return nativeSetMotionThrottleHold(hold);
+    }
+
+    /// <summary>
+    /// Query whether delivery is throttled and the head motion it is based on.
+    /// </summary>
+    public static bool GetMotionThrottleState(out MotionThrottleState state)
+    {
+        return nativeGetMotionThrottleState(out state);
+    }
+
+    /// <summary>
+    /// Take Vuforia's pending anchor requests, oldest first. Returns how many were written
+    /// to requests, or -1 on error.
+    /// </summary>
+    public static unsafe int GetAnchorRequests(AnchorRequest[] requests)
+    {
+        if (requests == null)
+        {
+            Debug.LogError("[Quforia] Invalid anchor request buffer");
+            return -1;
+        }
+
+        fixed (AnchorRequest* buffer = requests)
+        {
+            return nativeGetAnchorRequests(buffer, requests.Length);
+        }
+    }
+
+    /// <summary>
+    /// Report the first count spatial anchor poses. Anchors Vuforia doesn't know yet (e.g. loaded
+    /// from storage) are added; Localized = 0 pauses an anchor. Returns how many were accepted.
+    /// </summary>
+    public static unsafe int UpdateAnchors(AnchorUpdate[] updates, int count)
+    {
+        if (updates == null || count < 0 || count > updates.Length)
+        {
+            Debug.LogError("[Quforia] Invalid anchor updates");
+            return -1;
+        }
+
+        fixed (AnchorUpdate* batch = updates)
+        {
+            return nativeUpdateAnchors(batch, count);
+        }
+    }
+
+    /// <summary>
+    /// Tell Vuforia a spatial anchor no longer exists.
+    /// </summary>
+    public static bool RemoveAnchor(string uuid)
+    {
+        return nativeRemoveAnchor(uuid);
+    }
+
+    /// <summary>
+    /// Remove every anchor from Vuforia and drop pending requests (e.g. when the space changes).
+    /// </summary>
+    public static bool ClearAnchors()
+    {
+        return nativeClearAnchors();
+    }
+
+    /// <summary>
+    /// Current CLOCK_MONOTONIC time in nanoseconds, the clock frames and poses are matched on.
+    /// Use this instead of DateTime when no capture timestamp is available.
+    /// </summary>
+    public static long GetMonotonicTimeNs()
+    {
+        return nativeGetMonotonicTimeNs();
+    }
+
+    /// <summary>
+    /// Convert a DateTime to the Realtime clock domain (Unix epoch nanoseconds).
+    /// </summary>
+    public static long ToRealtimeNs(DateTime time)
+    {
+        return (time.ToUniversalTime() - DateTime.UnixEpoch).Ticks * 100;
+    }
+
+    /// <summary>
+    /// Declare the clock of all timestamps passed to the feed and submit functions.
+    /// </summary>
+    public static bool SetTimestampDomain(ClockDomain domain)
+    {
+        return nativeSetTimestampDomain((int)domain);
+    }
+
+    /// <summary>
+    /// Pin the External clock domain with a known correspondence between the two clocks.
+    /// </summary>
+    public static bool AddClockSyncPoint(long externalNs, long monotonicNs)
+    {
+        return nativeAddClockSyncPoint(externalNs, monotonicNs);
+    }
+
+    /// <summary>
+    /// Query the timestamp mapping: offset, estimated drift and capture to arrival latency.
+    /// </summary>
+    public static bool GetClockState(out ClockState state)
+    {
+        return nativeGetClockState(out state);
+    }
+
+    /// <summary>
+    /// Configure a native thread role. Can be called before Vuforia initializes the driver;
+    /// a thread that is already running switches immediately.
+    /// </summary>
+    public static bool SetThreadConfig(ThreadConfig config)
+    {
+        return nativeSetThreadConfig(ref config);
+    }
+
+    /// <summary>
+    /// Query what a native thread runs with (Tid is 0 while it isn't running).
+    /// </summary>
+    public static bool GetThreadReport(ThreadRole role, out ThreadReport report)
+    {
+        return nativeGetThreadReport((int)role, out report);
+    }
+
+    /// <summary>
+    /// Size the driver's frame queue, frame pool and pose history. Must be called before
+    /// Vuforia initializes the driver; the buffers are allocated once at init.
+    /// </summary>
+    public static bool SetMemoryConfig(MemoryConfig config)
+    {
+        return nativeSetMemoryConfig(ref config);
+    }
+
+    /// <summary>
+    /// What the driver allocated, and whether the budget could be met.
+    /// </summary>
+    public static bool GetMemoryReport(out MemoryReport report)
+    {
+        return nativeGetMemoryReport(out report);
+    }
+
+    /// <summary>
+    /// CPU mask of a core cluster, clusters ordered by max frequency (0 = slowest).
+    /// Returns 0 if the cluster doesn't exist or the topology can't be read.
+    /// </summary>
+    public static ulong GetCpuClusterMask(int cluster)
+    {
+        return nativeGetCpuClusterMask(cluster);
+    }
+
+    /// <summary>
+    /// Read the native hot-path counters and latency histograms. stats.Size comes back as
+    /// the bytes the native library filled in; fields past it (newer than the library) stay 0.
+    /// </summary>
+    public static bool GetStats(out DriverStats stats)
+    {
+        stats = new DriverStats { Size = (uint)Marshal.SizeOf<DriverStats>() };
+        return nativeGetStats(ref stats);
+    }
+
+    /// <summary>
+    /// Zero the native counters and histograms.
+    /// </summary>
+    public static bool ResetStats()
+    {
+        return nativeResetStats();
     }
 
     /// <summary>
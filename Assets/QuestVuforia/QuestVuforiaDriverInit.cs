@@ -12,6 +12,22 @@ public class QuestVuforiaDriverInit : MonoBehaviour
     [SerializeField] private string driverLibraryName = "quforia";
     [SerializeField] private bool enableDebugLogs = false;
 
+    [Header("Frame Delivery Thread")]
+    [SerializeField] private bool realtimeDeliveryThread = false;
+    [SerializeField, Range(1, 99)] private int realtimePriority = 2;
+    [SerializeField] private bool setDeliveryThreadNice = true;
+    [SerializeField, Range(-20, 19)] private int deliveryThreadNice = -4;
+    [SerializeField] private bool pinToFastCores = false;
+
+    [Header("Memory")]
+    // Frames queued for delivery; 0 keeps the default of 3
+    [SerializeField, Range(0, 8)] private int frameQueueDepth = 0;
+    // Camera modes larger than this aren't offered to Vuforia; 0 for no limit
+    [SerializeField] private int maxFrameWidth = 0;
+    [SerializeField] private int maxFrameHeight = 0;
+    // Limit for the frame pool and pose history; 0 for no limit
+    [SerializeField] private int memoryBudgetMB = 0;
+
     private void Start()
     {
         InitializeVuforiaWithDriver();
@@ -23,6 +39,9 @@ public class QuestVuforiaDriverInit : MonoBehaviour
         {
             Log($"Initializing Vuforia with driver: {driverLibraryName}");
 
+            ConfigureDeliveryThread();
+            ConfigureMemory();
+
             VuforiaApplication.Instance.OnVuforiaInitialized += OnVuforiaInitialized;
             VuforiaApplication.Instance.OnVuforiaDeinitialized += OnVuforiaDeinitialized;
             VuforiaApplication.Instance.Initialize(driverLibraryName, IntPtr.Zero);
@@ -38,6 +57,21 @@ public class QuestVuforiaDriverInit : MonoBehaviour
         if (error == VuforiaInitError.NONE)
         {
             Log("Vuforia initialized successfully");
+
+            if (QuestVuforiaBridge.GetThreadReport(QuestVuforiaBridge.ThreadRole.FrameDelivery,
+                                                   out var report) && report.IsRunning)
+            {
+                Log($"Frame delivery thread: {report}");
+            }
+
+            if (QuestVuforiaBridge.GetMemoryReport(out var memory))
+            {
+                Log($"Frame and pose memory: {memory}");
+                if (memory.BudgetMet == 0)
+                {
+                    Debug.LogWarning($"[Quforia] Memory budget of {memoryBudgetMB} MB not met: {memory}");
+                }
+            }
         }
         else
         {
@@ -45,6 +79,64 @@ public class QuestVuforiaDriverInit : MonoBehaviour
         }
     }
 
+    /// <summary>
+    /// Thread settings are process-wide on the native side, so they are set before Vuforia
+    /// creates the driver and apply when the camera starts its delivery thread.
+    /// </summary>
+    private void ConfigureDeliveryThread()
+    {
+        ulong cpuMask = 0;
+        if (pinToFastCores)
+        {
+            // Highest-frequency cluster
+            for (int cluster = 0; ; cluster++)
+            {
+                ulong mask = QuestVuforiaBridge.GetCpuClusterMask(cluster);
+                if (mask == 0)
+                {
+                    break;
+                }
+                cpuMask = mask;
+            }
+        }
+
+        var config = new QuestVuforiaBridge.ThreadConfig
+        {
+            Role = QuestVuforiaBridge.ThreadRole.FrameDelivery,
+            Policy = realtimeDeliveryThread ? QuestVuforiaBridge.SchedPolicy.Fifo
+                                            : QuestVuforiaBridge.SchedPolicy.Default,
+            Priority = realtimePriority,
+            Nice = deliveryThreadNice,
+            SetNice = setDeliveryThreadNice ? 1 : 0,
+            CpuMask = cpuMask,
+            Name = ""
+        };
+
+        if (!QuestVuforiaBridge.SetThreadConfig(config))
+        {
+            Debug.LogWarning("[Quforia] Failed to configure the frame delivery thread");
+        }
+    }
+
+    /// <summary>
+    /// Like the thread settings, the memory config is read when Vuforia creates the driver.
+    /// </summary>
+    private void ConfigureMemory()
+    {
+        var config = new QuestVuforiaBridge.MemoryConfig
+        {
+            FrameQueueDepth = (uint)Mathf.Max(frameQueueDepth, 0),
+            MaxFrameWidth = (uint)Mathf.Max(maxFrameWidth, 0),
+            MaxFrameHeight = (uint)Mathf.Max(maxFrameHeight, 0),
+            BudgetBytes = (ulong)Mathf.Max(memoryBudgetMB, 0) * 1024 * 1024
+        };
+
+        if (!QuestVuforiaBridge.SetMemoryConfig(config))
+        {
+            Debug.LogWarning("[Quforia] Failed to configure driver memory");
+        }
+    }
+
     private void OnVuforiaDeinitialized()
     {
         Log("Vuforia deinitialized");
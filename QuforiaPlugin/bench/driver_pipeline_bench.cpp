@@ -0,0 +1,1154 @@
+/**
+ * End-to-end benchmark of the driver pipeline with mock Vuforia callbacks.
+ *
+ * Drives a real QuestVuforiaDriver / QuestExternalCamera / QuestExternalTracker the way
+ * Vuforia and Unity do on device: the camera and tracker are opened and started with mock
+ * CameraCallback / PoseCallback implementations, a producer thread feeds synthetic frames at
+ * the requested rate and a pose thread feeds device poses. Reports throughput, feed->deliver
+ * latency percentiles, heap allocations per frame and the driver's pose match error.
+ *
+ * Usage: quforia_driver_bench [--frames N] [--fps N] [--pose-rate N] [--pose-batch N]
+ *                             [--width N] [--height N] [--input FORMAT] [--mode FORMAT]
+ *                             [--every-frame] [--submit] [--flip] [--downscale]
+ *                             [--record FILE [--compress]] [--replay FILE [--speed X]]
+ *                             [--callback-ms X] [--no-governor]
+ *                             [--nice N] [--cpus MASK] [--clock DOMAIN]
+ *                             [--distortion K1] [--async N] [--crop] [--blur-gate]
+ *                             [--throttle-static] [--anchors] [--pose-query] [--restarts N]
+ *                             [--budget-mb X] [--exposure-ms X [--readout-ms Y]]
+ *
+ *   --fps 0        feed as fast as the delivery thread takes frames
+ *   --pose-batch   feed poses N at a time through feedDevicePoses (headset-rate batching)
+ *   --input/--mode rgb, rgba, nv12, nv21 or yuv420p (the camera must advertise a mode
+ *                  in that format at the input size)
+ *   --downscale    use the mode at half the input size (driver box-filters RGB input)
+ *   --record       write the session to FILE (LZ4 frames with --compress)
+ *   --replay       feed a recorded session instead of synthetic data; --width/--height/--mode
+ *                  must describe the recorded camera mode. --speed 0 replays unthrottled.
+ *   --callback-ms  make the mock Vuforia spend X ms per frame (exercises the frame governor)
+ *   --nice/--cpus  nice value / hex CPU mask for the delivery thread, passed through the
+ *                  vuforiaDriver_init userData (QuforiaInitConfig)
+ *   --clock        stamp synthetic frames and poses in monotonic, boottime, realtime or
+ *                  external (a simulated drifting clock) time; the driver maps them back
+ *   --submit       feed each frame together with its pose (submitFrame) instead of a
+ *                  separate pose stream
+ *   --distortion   calibrate with radial coefficient K1 and let the driver rectify frames
+ *   --async        convert on N ingest workers and feed through feedCameraFrameAsync (the
+ *                  "feed call" row is how long the producer is blocked per frame)
+ *   --crop         use the mode at 3/4 of the input size: the driver cuts a centre window
+ *                  and shifts the principal point (checked on every delivered frame)
+ *   --blur-gate    alternate standing still with fast head turns that feed a blurred image,
+ *                  with the quality gate on (fails unless it drops some of those frames)
+ *   --throttle-static  hold the head still with the motion throttle on (fails unless it
+ *                  lowers the delivered rate once the headset counts as static); feeds past
+ *                  --frames until it does, for up to four static delays' worth of frames
+ *   --anchors      play the Unity anchor provider while frames are fed: Vuforia creates and
+ *                  removes an anchor, a "persisted" one is added, paused and dropped, and a
+ *                  new one is dropped before Unity places it (fails unless every AnchorCallback
+ *                  status arrives, poses survive the round trip and no request is left over)
+ *   --pose-query   sample the head pose at render rate, slightly ahead of now, the way Unity's
+ *                  render thread calls nativeGetPoseAt (fails if queries miss or drift)
+ *   --restarts     stop, close, reopen and restart the camera N times while feeding, like
+ *                  Vuforia on app focus changes (fails unless every restart is warm)
+ *   --budget-mb    cap the frame pool and pose history at X MB through the init config's
+ *                  QuforiaMemoryConfig (fails unless the driver stays within it)
+ *   --exposure-ms  report X ms exposure and Y ms rolling-shutter readout for every frame
+ *                  (frame timestamps mark the end of exposure, as in Vuforia); fails unless
+ *                  Vuforia sees that exposure and poses sampled at mid-exposure, which must
+ *                  track the head more closely than poses at the frame timestamp would
+ */
+
+#include "vuforia_driver.h"
+#include "external_camera.h"
+#include "external_tracker.h"
+#include "pixel_convert.h"
+#include "init_config.h"
+#include "pose_transform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Allocation counting (global operator new)
+// -----------------------------------------------------------------------------
+
+static std::atomic<uint64_t> g_allocationCount(0);
+
+void* operator new(size_t size) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+using VuforiaDriver::PixelFormat;
+
+struct LatencyStats {
+    std::vector<int64_t> samples;
+
+    void add(int64_t ns) { samples.push_back(ns); }
+
+    int64_t percentile(double p) {
+        if (samples.empty()) {
+            return 0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+};
+
+void printRow(const char* name, LatencyStats& stats) {
+    printf("  %-24s p50=%8.3f ms  p90=%8.3f ms  p99=%8.3f ms  max=%8.3f ms  (n=%zu)\n",
+           name,
+           stats.percentile(0.50) / 1e6,
+           stats.percentile(0.90) / 1e6,
+           stats.percentile(0.99) / 1e6,
+           stats.percentile(1.0) / 1e6,
+           stats.samples.size());
+}
+
+// Upper bound of the histogram bucket holding the p-th sample (buckets are log2 microseconds)
+double histogramPercentileUs(const QuforiaHistogram& histogram, double p) {
+    if (histogram.count == 0) {
+        return 0.0;
+    }
+    const uint64_t target = static_cast<uint64_t>(std::ceil(p * histogram.count));
+    uint64_t seen = 0;
+    for (int i = 0; i < QUFORIA_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram.buckets[i];
+        if (seen >= target) {
+            return static_cast<double>(1ull << i);
+        }
+    }
+    return static_cast<double>(1ull << (QUFORIA_HISTOGRAM_BUCKETS - 1));
+}
+
+void printHistogram(const char* name, const QuforiaHistogram& histogram) {
+    const double meanUs = histogram.count ? histogram.sumNs / 1e3 / histogram.count : 0.0;
+    printf("  %-24s mean=%9.1f us  p50<%8.0f us  p99<%8.0f us  max=%9.1f us  (n=%llu)\n",
+           name, meanUs,
+           histogramPercentileUs(histogram, 0.50),
+           histogramPercentileUs(histogram, 0.99),
+           histogram.maxNs / 1e3,
+           (unsigned long long)histogram.count);
+}
+
+bool parseFormat(const char* name, PixelFormat* format) {
+    static const struct { const char* name; PixelFormat format; } kFormats[] = {
+        { "rgb", PixelFormat::RGB888 },
+        { "rgba", PixelFormat::RGBA8888 },
+        { "nv12", PixelFormat::NV12 },
+        { "nv21", PixelFormat::NV21 },
+        { "yuv420p", PixelFormat::YUV420P },
+    };
+    for (const auto& entry : kFormats) {
+        if (strcmp(name, entry.name) == 0) {
+            *format = entry.format;
+            return true;
+        }
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+// Mock Vuforia callbacks
+// -----------------------------------------------------------------------------
+
+// Frame timestamps are CLOCK_MONOTONIC at feed time, so latency is "now - timestamp"
+class MockCameraCallback : public VuforiaDriver::CameraCallback {
+public:
+    MockCameraCallback(size_t expectedFrames, int64_t workNs) : workNs_(workNs) {
+        latency_.samples.reserve(expectedFrames);
+    }
+
+    void onNewCameraFrame(VuforiaDriver::CameraFrame* frame) override {
+        const int64_t now = monotonicNowNs();
+        latency_.add(now - frame->timestamp);
+
+        // Simulated tracking work
+        while (workNs_ > 0 && monotonicNowNs() - now < workNs_) {
+        }
+
+        // Touch the pixels like a tracker would, so the benchmark can't skip the last copy
+        checksum_ += frame->buffer[0] + frame->buffer[frame->bufferSize - 1];
+        principalPointX_ = frame->intrinsics.principalPointX;
+        principalPointY_ = frame->intrinsics.principalPointY;
+        exposureTime_ = frame->exposureTime;
+        if (static_cast<int64_t>(frame->timestamp) < sessionStartNs_) {
+            staleFrames_++;
+        }
+        delivered_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Principal point of the newest delivered frame (read after delivery stopped)
+    float principalPointX() const { return principalPointX_; }
+    float principalPointY() const { return principalPointY_; }
+    uint64_t exposureTime() const { return exposureTime_; }
+
+    // --restarts: frames fed before the camera restarted at `startNs` are stale
+    void beginSession(int64_t startNs) { sessionStartNs_ = startNs; }
+    int staleFrames() const { return staleFrames_; }
+
+    uint64_t delivered() const { return delivered_.load(std::memory_order_acquire); }
+    LatencyStats& latency() { return latency_; }
+
+private:
+    LatencyStats latency_;
+    int64_t workNs_;
+    std::atomic<uint64_t> delivered_{0};
+    uint64_t checksum_ = 0;
+    float principalPointX_ = 0.0f;
+    float principalPointY_ = 0.0f;
+    uint64_t exposureTime_ = 0;
+    int64_t sessionStartNs_ = 0;  // Set while the camera is stopped
+    int staleFrames_ = 0;
+};
+
+class MockPoseCallback : public VuforiaDriver::PoseCallback {
+public:
+    void onNewPose(VuforiaDriver::Pose* pose) override {
+        if (pose->validity == VuforiaDriver::PoseValidity::VALID) {
+            valid_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t valid() const { return valid_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> valid_{0};
+};
+
+// Counts AnchorCallback batches by status; runs on the delivery thread
+class MockAnchorCallback : public VuforiaDriver::AnchorCallback {
+public:
+    void onAnchorUpdate(VuforiaDriver::Anchor* anchors, int numAnchors,
+                        VuforiaDriver::AnchorStatus status) override {
+        const int index = static_cast<int>(status);
+        counts_[index].fetch_add(numAnchors, std::memory_order_relaxed);
+        if (status == VuforiaDriver::AnchorStatus::UPDATED && numAnchors > 0) {
+            memcpy(updatedTranslation_, anchors[0].pose.translationData, sizeof(updatedTranslation_));
+        }
+    }
+
+    int count(VuforiaDriver::AnchorStatus status) const {
+        return counts_[static_cast<int>(status)].load(std::memory_order_relaxed);
+    }
+
+    // Translation of the last UPDATED anchor (read after delivery stopped)
+    const float* updatedTranslation() const { return updatedTranslation_; }
+
+private:
+    std::atomic<int> counts_[4] = {};
+    float updatedTranslation_[3] = {};
+};
+
+// --blur-gate head motion: half a second still, then half a second turning at FAST_TURN_RATE
+static const int64_t FAST_TURN_PHASE_NS = 500000000LL;
+static const double FAST_TURN_RATE = 3.0;  // rad/s
+
+bool fastTurnAt(int64_t timestamp) {
+    return (timestamp / FAST_TURN_PHASE_NS) % 2 == 1;
+}
+
+enum class HeadMotion {
+    ORBIT,       // Smooth slow orbit and yaw
+    FAST_TURNS,  // --blur-gate still/turn cycle
+    STILL,       // --throttle-static
+};
+
+PoseData syntheticPose(int64_t timestamp, HeadMotion motion = HeadMotion::ORBIT) {
+    const double t = motion == HeadMotion::STILL ? 0.0 : timestamp / 1e9;
+    double yaw = 0.5 * std::sin(t);
+    if (motion == HeadMotion::FAST_TURNS) {
+        yaw = fastTurnAt(timestamp) ? FAST_TURN_RATE * (timestamp % FAST_TURN_PHASE_NS) / 1e9 : 0.0;
+    }
+
+    PoseData pose;
+    pose.timestamp = timestamp;
+    pose.position[0] = static_cast<float>(0.2 * std::cos(t));
+    pose.position[1] = 1.6f;
+    pose.position[2] = static_cast<float>(0.2 * std::sin(t));
+    pose.rotation[0] = 0.0f;
+    pose.rotation[1] = static_cast<float>(std::sin(yaw / 2));
+    pose.rotation[2] = 0.0f;
+    pose.rotation[3] = static_cast<float>(std::cos(yaw / 2));
+    return pose;
+}
+
+// Compares every delivered pose with where the synthetic head was at mid-exposure (the
+// frame timestamp minus `midExposureOffsetNs`) and, for reference, at the frame timestamp.
+// The first pose is skipped: with --submit nothing before it brackets mid-exposure, so the
+// submitted pose goes out as is.
+class ExposurePoseCallback : public MockPoseCallback {
+public:
+    ExposurePoseCallback(HeadMotion motion, int64_t midExposureOffsetNs)
+        : motion_(motion), offsetNs_(midExposureOffsetNs) {}
+
+    void onNewPose(VuforiaDriver::Pose* pose) override {
+        MockPoseCallback::onNewPose(pose);
+        if (pose->validity != VuforiaDriver::PoseValidity::VALID || first_) {
+            first_ = false;
+            return;
+        }
+
+        PoseData delivered;
+        transformPoseCVToOpenXR(pose->translationData, pose->rotationData, &delivered);
+        midExposureError_ = std::max(midExposureError_, distance(delivered, pose->timestamp - offsetNs_));
+        timestampError_ = std::max(timestampError_, distance(delivered, pose->timestamp));
+    }
+
+    // Largest position errors (read after delivery stopped)
+    float midExposureError() const { return midExposureError_; }
+    float timestampError() const { return timestampError_; }
+
+private:
+    float distance(const PoseData& pose, int64_t timestamp) const {
+        const PoseData truth = syntheticPose(timestamp, motion_);
+        const float dx = pose.position[0] - truth.position[0];
+        const float dy = pose.position[1] - truth.position[1];
+        const float dz = pose.position[2] - truth.position[2];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    HeadMotion motion_;
+    int64_t offsetNs_;
+    float midExposureError_ = 0.0f;
+    float timestampError_ = 0.0f;
+    bool first_ = true;
+};
+
+// Simulated EXTERNAL clock: its own epoch, running 40 ppm fast
+static const int64_t EXTERNAL_CLOCK_EPOCH_NS = 700000000000LL;
+static const double EXTERNAL_CLOCK_RATE = 1.0 + 40e-6;
+
+int64_t clockNowNs(QuforiaClockDomain domain) {
+    timespec ts;
+    switch (domain) {
+        case QUFORIA_CLOCK_BOOTTIME:
+            clock_gettime(CLOCK_BOOTTIME, &ts);
+            break;
+        case QUFORIA_CLOCK_REALTIME:
+            clock_gettime(CLOCK_REALTIME, &ts);
+            break;
+        case QUFORIA_CLOCK_EXTERNAL:
+            return EXTERNAL_CLOCK_EPOCH_NS +
+                   static_cast<int64_t>(monotonicNowNs() * EXTERNAL_CLOCK_RATE);
+        default:
+            return monotonicNowNs();
+    }
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+void sleepUntil(int64_t deadlineNs) {
+    const int64_t remaining = deadlineNs - monotonicNowNs();
+    if (remaining > 0) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(remaining));
+    }
+}
+
+struct Options {
+    int frames = 600;
+    int fps = 30;
+    int poseRate = 90;
+    int poseBatch = 1;
+    int width = 1280;
+    int height = 960;
+    PixelFormat inputFormat = PixelFormat::RGBA8888;
+    PixelFormat modeFormat = PixelFormat::RGB888;
+    bool everyFrame = false;
+    bool submit = false;
+    bool flip = false;
+    bool downscale = false;
+    const char* recordPath = nullptr;
+    bool compress = false;
+    const char* replayPath = nullptr;
+    float replaySpeed = 1.0f;
+    float callbackMs = 0.0f;
+    bool governor = true;
+    bool setNice = false;
+    int nice = 0;
+    uint64_t cpuMask = 0;
+    QuforiaClockDomain clock = QUFORIA_CLOCK_MONOTONIC;
+    float distortion = 0.0f;
+    int ingestWorkers = 0;
+    bool crop = false;
+    bool blurGate = false;
+    bool throttleStatic = false;
+    bool anchors = false;
+    bool poseQuery = false;
+    int restarts = 0;
+    float budgetMb = 0.0f;
+    float exposureMs = 0.0f;
+    float readoutMs = 0.0f;
+
+    // Middle of the centre row's exposure to the (end of exposure) frame timestamp
+    int64_t midExposureOffsetNs() const {
+        return static_cast<int64_t>((exposureMs + readoutMs) * 1e6f) / 2;
+    }
+
+    HeadMotion headMotion() const {
+        return throttleStatic ? HeadMotion::STILL : (blurGate ? HeadMotion::FAST_TURNS : HeadMotion::ORBIT);
+    }
+};
+
+// --anchors: what Vuforia creates, and how far Unity then moves it
+static const float ANCHOR_TRANSLATION[3] = {0.1f, -0.2f, 0.5f};
+static const float ANCHOR_NUDGE = 0.1f;  // m, along OpenXR y
+static const char* PERSISTED_ANCHOR_UUID = "6f9619ff-8b86-d011-b42d-00c04fc964ff";
+static const int64_t ANCHOR_DELIVERY_TIMEOUT_NS = 10000000000LL;  // Generous for sanitizer builds
+
+struct AnchorProviderResult {
+    bool ok = false;
+    int requests = 0;
+    int remaining = -1;
+};
+
+// Plays Vuforia (tracker createAnchor/removeAnchor) and the Unity anchor provider (requests
+// and pose updates) against the running pipeline. Each step waits for the frames being fed
+// to carry its batch out, so changes never coalesce however slowly frames are delivered.
+void runAnchorProvider(QuestVuforiaDriver& driver, QuestExternalTracker* tracker,
+                       const MockAnchorCallback& callback, AnchorProviderResult* result) {
+    using VuforiaDriver::AnchorStatus;
+    AnchorStore& store = driver.anchors();
+    const auto delivered = [&](AnchorStatus status, int count) {
+        const int64_t deadline = monotonicNowNs() + ANCHOR_DELIVERY_TIMEOUT_NS;
+        while (callback.count(status) < count) {
+            if (monotonicNowNs() > deadline) {
+                fprintf(stderr, "Anchor provider: timed out waiting for status %d\n", static_cast<int>(status));
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    };
+
+    // 30 degrees about the vertical axis
+    const float c = std::cos(0.5236f), s = std::sin(0.5236f);
+    VuforiaDriver::AnchorPose pose = {
+        {ANCHOR_TRANSLATION[0], ANCHOR_TRANSLATION[1], ANCHOR_TRANSLATION[2]},
+        {c, 0, s, 0, 1, 0, -s, 0, c}
+    };
+    const char* uuid = tracker->createAnchor(&pose);
+
+    QuforiaAnchorRequest request;
+    if (!uuid || store.takeRequests(&request, 1) != 1 || request.type != QUFORIA_ANCHOR_CREATE) {
+        return;
+    }
+    result->requests++;
+
+    // The spatial anchor reports back where it was asked to be: no change for Vuforia
+    QuforiaAnchorUpdate update;
+    memcpy(update.uuid, request.uuid, sizeof(update.uuid));
+    memcpy(update.position, request.position, sizeof(update.position));
+    memcpy(update.rotation, request.rotation, sizeof(update.rotation));
+    update.localized = 1;
+    store.update(&update, 1);
+
+    // Drift correction moves it
+    update.position[1] += ANCHOR_NUDGE;
+    store.update(&update, 1);
+    if (!delivered(AnchorStatus::UPDATED, 1)) {
+        return;
+    }
+
+    // An anchor loaded from an earlier session shows up, then loses tracking
+    QuforiaAnchorUpdate persisted = update;
+    snprintf(persisted.uuid, sizeof(persisted.uuid), "%s", PERSISTED_ANCHOR_UUID);
+    store.update(&persisted, 1);
+    if (!delivered(AnchorStatus::ADDED, 1)) {
+        return;
+    }
+    persisted.localized = 0;
+    store.update(&persisted, 1);
+    if (!delivered(AnchorStatus::PAUSED, 1)) {
+        return;
+    }
+
+    // Vuforia removes its anchor (a request, no callback); the persisted one is erased in Unity
+    if (!tracker->removeAnchor(uuid) || store.takeRequests(&request, 1) != 1 ||
+        request.type != QUFORIA_ANCHOR_REMOVE) {
+        return;
+    }
+    result->requests++;
+    store.drop(PERSISTED_ANCHOR_UUID);
+    if (!delivered(AnchorStatus::REMOVED, 1)) {
+        return;
+    }
+
+    // Unity drops an anchor Vuforia just created before taking its request: nothing is left
+    // asking Unity to place it
+    const char* dropped = tracker->createAnchor(&pose);
+    if (!dropped || !store.drop(dropped) || store.takeRequests(&request, 1) != 0 ||
+        !delivered(AnchorStatus::REMOVED, 2)) {
+        return;
+    }
+
+    result->remaining = store.size();
+    result->ok = result->remaining == 0;
+}
+
+// --pose-query: a 90 Hz render loop predicting a little past now, then the worst acceptable error
+static const int RENDER_RATE = 90;
+static const int64_t RENDER_PREDICTION_NS = 5000000LL;
+static const float MAX_POSE_QUERY_ERROR = 0.005f;  // m
+static const double MIN_POSE_QUERY_HITS = 0.95;
+
+// --exposure-ms: largest mid-exposure pose error, as a share of the error at the frame timestamp
+static const float MAX_MID_EXPOSURE_ERROR_SHARE = 0.5f;
+
+struct PoseQueryResult {
+    LatencyStats calls;
+    int queries = 0;
+    int hits = 0;
+    float maxError = 0.0f;
+};
+
+// What the render thread does before submission: map "now + prediction" like nativeGetPoseAt
+// and sample the history, compared against where the synthetic head really is at that time
+void runPoseQueries(QuestVuforiaDriver& driver, const Options& options, const std::atomic<bool>& running,
+                    PoseQueryResult* result) {
+    const int64_t period = 1000000000LL / RENDER_RATE;
+    result->calls.samples.reserve(1024);
+
+    // The pose stream needs a moment to fill the history
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    int64_t next = monotonicNowNs();
+    while (running.load(std::memory_order_relaxed)) {
+        const int64_t callStart = monotonicNowNs();
+        const int64_t timestamp = driver.clock().queryToMonotonic(clockNowNs(options.clock) + RENDER_PREDICTION_NS);
+        PoseData pose;
+        const bool found = driver.samplePose(timestamp, &pose);
+        result->calls.add(monotonicNowNs() - callStart);
+
+        result->queries++;
+        if (found) {
+            result->hits++;
+            const PoseData truth = syntheticPose(timestamp, options.headMotion());
+            const float dx = pose.position[0] - truth.position[0];
+            const float dy = pose.position[1] - truth.position[1];
+            const float dz = pose.position[2] - truth.position[2];
+            result->maxError = std::max(result->maxError, std::sqrt(dx * dx + dy * dy + dz * dz));
+        }
+
+        next += period;
+        sleepUntil(next);
+    }
+}
+
+bool findMode(QuestExternalCamera& camera, const Options& options, VuforiaDriver::CameraMode* mode) {
+    for (uint32_t i = 0; i < camera.getNumSupportedCameraModes(); i++) {
+        VuforiaDriver::CameraMode candidate;
+        if (!camera.getSupportedCameraMode(i, &candidate) || candidate.format != options.modeFormat) {
+            continue;
+        }
+        // Crop modes are 3/4 of the input, downscaled ones half of it
+        const uint32_t num = options.crop ? 4 : (options.downscale ? 2 : 1);
+        const uint32_t den = options.crop ? 3 : 1;
+        if (candidate.width * num == static_cast<uint32_t>(options.width) * den &&
+            candidate.height * num == static_cast<uint32_t>(options.height) * den) {
+            *mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Feed synthetic frames (and a pose stream unless poses travel with the frames), past
+// options.frames for as long as `moreFrames(fed)` says a check still needs them. Fills in where
+// the steady-state measurement window starts; returns how many frames were fed.
+int runSynthetic(QuestVuforiaDriver& driver, const Options& options,
+                 const VuforiaDriver::CameraMode& mode, QuestExternalCamera* camera,
+                 MockCameraCallback& cameraCallback, int warmupFrames, uint64_t* allocationsAtWarmup, uint64_t* deliveredAtWarmup,
+                 int64_t* startNs, LatencyStats* feedCalls, const std::function<bool(int)>& moreFrames) {
+    const std::string rate = options.fps > 0 ? std::to_string(options.fps) + " fps" : "unthrottled";
+    const std::string poses = options.submit ? "pose with frame"
+                                             : std::to_string(options.poseRate) + " Hz poses" +
+                                               (options.poseBatch > 1
+                                                    ? " in batches of " + std::to_string(options.poseBatch)
+                                                    : "");
+    const std::string ingest = options.ingestWorkers > 0
+                                   ? ", async on " + std::to_string(options.ingestWorkers) + " workers"
+                                   : "";
+    printf("Driver pipeline benchmark: %d frames %dx%d %s -> %ux%u %s, %s, %s%s%s%s\n\n",
+           options.frames, options.width, options.height, pixelFormatName(options.inputFormat),
+           mode.width, mode.height, pixelFormatName(mode.format),
+           rate.c_str(), poses.c_str(),
+           options.everyFrame ? ", every frame" : ", latest only",
+           options.flip ? ", flipped" : "", ingest.c_str());
+
+    // Synthetic gradient so conversions work on varied data
+    const size_t frameSize = frameBufferSize(options.inputFormat, options.width, options.height);
+    std::vector<uint8_t> image(frameSize);
+    for (size_t i = 0; i < frameSize; i++) {
+        image[i] = static_cast<uint8_t>((i * 7) ^ (i >> 9));
+    }
+
+    // What the camera sees during a fast turn: the same image smeared along each row
+    std::vector<uint8_t> blurred;
+    if (options.blurGate) {
+        const size_t step = options.inputFormat == PixelFormat::RGB888 ? 3
+                            : options.inputFormat == PixelFormat::RGBA8888 ? 4 : 1;
+        const size_t taps = 8;
+        blurred.resize(frameSize);
+        for (size_t i = 0; i < frameSize; i++) {
+            unsigned sum = 0;
+            for (size_t k = 0; k < taps; k++) {
+                sum += image[i >= k * step ? i - k * step : i];
+            }
+            blurred[i] = static_cast<uint8_t>(sum / taps);
+        }
+    }
+
+    // Poses lead the frames a little, like the OpenXR head pose does on device
+    std::atomic<bool> posesRunning(!options.submit);
+    std::thread poseThread;
+    if (!options.submit) {
+        poseThread = std::thread([&]() {
+            const int64_t period = 1000000000LL / std::max(options.poseRate, 1);
+            std::vector<PoseData> batch;
+            batch.reserve(static_cast<size_t>(options.poseBatch));
+            int64_t next = monotonicNowNs();
+            while (posesRunning.load(std::memory_order_relaxed)) {
+                // Stamped in the producer's clock, mapped like the P/Invoke entry points do
+                const PoseData pose = syntheticPose(driver.clock().toMonotonic(clockNowNs(options.clock)),
+                                                    options.headMotion());
+                if (options.poseBatch > 1) {
+                    batch.push_back(pose);
+                    if (batch.size() == static_cast<size_t>(options.poseBatch)) {
+                        driver.feedDevicePoses(batch.data(), batch.size());
+                        batch.clear();
+                    }
+                } else {
+                    driver.feedDevicePose(pose.position, pose.rotation, pose.timestamp);
+                }
+                next += period;
+                sleepUntil(next);
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    const int64_t framePeriod = options.fps > 0 ? 1000000000LL / options.fps : 0;
+    const int restartInterval = std::max((options.frames - warmupFrames) / (options.restarts + 1), 1);
+    int restartsDone = 0;
+
+    int64_t next = monotonicNowNs();
+    int i = 0;
+    for (; i < options.frames || moreFrames(i); i++) {
+        // Vuforia pausing and resuming the camera on an app focus change
+        if (restartsDone < options.restarts && i > warmupFrames && (i - warmupFrames) % restartInterval == 0) {
+            camera->stop();
+            camera->close();
+            camera->open();
+            cameraCallback.beginSession(monotonicNowNs());
+            camera->start(mode, &cameraCallback);
+            restartsDone++;
+        }
+
+        if (i == warmupFrames) {
+            *allocationsAtWarmup = g_allocationCount.load(std::memory_order_relaxed);
+            *deliveredAtWarmup = cameraCallback.delivered();
+            *startNs = monotonicNowNs();
+        }
+
+        const uint64_t deliveredBefore = cameraCallback.delivered();
+        const int64_t timestamp = driver.clock().toMonotonic(clockNowNs(options.clock));
+        const uint8_t* pixels = options.blurGate && fastTurnAt(timestamp) ? blurred.data() : image.data();
+        const int64_t feedStart = monotonicNowNs();
+        if (options.ingestWorkers > 0) {
+            // The synthetic images never change, so they can be reused before the ticket completes
+            const PoseData pose = syntheticPose(timestamp, options.headMotion());
+            driver.feedCameraFrameAsync(pixels, options.width, options.height,
+                                        options.inputFormat, 0, options.submit ? &pose : nullptr,
+                                        nullptr, timestamp, options.flip);
+        } else if (options.submit) {
+            driver.submitFrame(pixels, options.width, options.height, options.inputFormat, 0,
+                               syntheticPose(timestamp, options.headMotion()), nullptr, timestamp, options.flip);
+        } else {
+            driver.feedCameraFrame(pixels, options.width, options.height, options.inputFormat,
+                                   0, nullptr, timestamp, options.flip);
+        }
+        if (i >= warmupFrames) {
+            feedCalls->add(monotonicNowNs() - feedStart);
+        }
+
+        if (framePeriod > 0) {
+            next += framePeriod;
+            sleepUntil(next);
+        } else {
+            // Unthrottled: wait for the delivery thread so frames aren't all overwritten
+            const int64_t deadline = monotonicNowNs() + 100000000LL;
+            while (cameraCallback.delivered() == deliveredBefore && monotonicNowNs() < deadline) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Queued frames still read `image`: let the ingest workers publish them first
+    driver.setIngestWorkers(0);
+
+    posesRunning = false;
+    if (poseThread.joinable()) {
+        poseThread.join();
+    }
+    return i;
+}
+
+int usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--frames N] [--fps N] [--pose-rate N] [--pose-batch N]\n"
+            "          [--width N] [--height N]\n"
+            "          [--input rgb|rgba|nv12|nv21|yuv420p] [--mode rgb|rgba|nv12|nv21|yuv420p]\n"
+            "          [--every-frame] [--submit] [--flip] [--downscale]\n"
+            "          [--record FILE [--compress]] [--replay FILE [--speed X]]\n"
+            "          [--callback-ms X] [--no-governor] [--nice N] [--cpus MASK]\n"
+            "          [--clock monotonic|boottime|realtime|external] [--distortion K1]\n"
+            "          [--async N] [--crop] [--blur-gate] [--throttle-static] [--anchors]\n"
+            "          [--pose-query] [--restarts N] [--budget-mb X]\n"
+            "          [--exposure-ms X [--readout-ms Y]]\n",
+            program);
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--frames") == 0 && hasValue) {
+            options.frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fps") == 0 && hasValue) {
+            options.fps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--pose-rate") == 0 && hasValue) {
+            options.poseRate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--pose-batch") == 0 && hasValue) {
+            options.poseBatch = std::max(atoi(argv[++i]), 1);
+        } else if (strcmp(argv[i], "--width") == 0 && hasValue) {
+            options.width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--height") == 0 && hasValue) {
+            options.height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--input") == 0 && hasValue) {
+            if (!parseFormat(argv[++i], &options.inputFormat)) {
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--mode") == 0 && hasValue) {
+            if (!parseFormat(argv[++i], &options.modeFormat)) {
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--every-frame") == 0) {
+            options.everyFrame = true;
+        } else if (strcmp(argv[i], "--submit") == 0) {
+            options.submit = true;
+        } else if (strcmp(argv[i], "--flip") == 0) {
+            options.flip = true;
+        } else if (strcmp(argv[i], "--downscale") == 0) {
+            options.downscale = true;
+        } else if (strcmp(argv[i], "--record") == 0 && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--compress") == 0) {
+            options.compress = true;
+        } else if (strcmp(argv[i], "--replay") == 0 && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--speed") == 0 && hasValue) {
+            options.replaySpeed = static_cast<float>(atof(argv[++i]));
+        } else if (strcmp(argv[i], "--callback-ms") == 0 && hasValue) {
+            options.callbackMs = static_cast<float>(atof(argv[++i]));
+        } else if (strcmp(argv[i], "--no-governor") == 0) {
+            options.governor = false;
+        } else if (strcmp(argv[i], "--nice") == 0 && hasValue) {
+            options.setNice = true;
+            options.nice = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cpus") == 0 && hasValue) {
+            options.cpuMask = strtoull(argv[++i], nullptr, 16);
+        } else if (strcmp(argv[i], "--clock") == 0 && hasValue) {
+            const char* clock = argv[++i];
+            if (strcmp(clock, "monotonic") == 0) {
+                options.clock = QUFORIA_CLOCK_MONOTONIC;
+            } else if (strcmp(clock, "boottime") == 0) {
+                options.clock = QUFORIA_CLOCK_BOOTTIME;
+            } else if (strcmp(clock, "realtime") == 0) {
+                options.clock = QUFORIA_CLOCK_REALTIME;
+            } else if (strcmp(clock, "external") == 0) {
+                options.clock = QUFORIA_CLOCK_EXTERNAL;
+            } else {
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--distortion") == 0 && hasValue) {
+            options.distortion = static_cast<float>(atof(argv[++i]));
+        } else if (strcmp(argv[i], "--crop") == 0) {
+            options.crop = true;
+        } else if (strcmp(argv[i], "--blur-gate") == 0) {
+            options.blurGate = true;
+        } else if (strcmp(argv[i], "--throttle-static") == 0) {
+            options.throttleStatic = true;
+        } else if (strcmp(argv[i], "--anchors") == 0) {
+            options.anchors = true;
+        } else if (strcmp(argv[i], "--pose-query") == 0) {
+            options.poseQuery = true;
+        } else if (strcmp(argv[i], "--restarts") == 0 && hasValue) {
+            options.restarts = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--budget-mb") == 0 && hasValue) {
+            options.budgetMb = static_cast<float>(atof(argv[++i]));
+        } else if (strcmp(argv[i], "--exposure-ms") == 0 && hasValue) {
+            options.exposureMs = static_cast<float>(atof(argv[++i]));
+        } else if (strcmp(argv[i], "--readout-ms") == 0 && hasValue) {
+            options.readoutMs = static_cast<float>(atof(argv[++i]));
+        } else if (strcmp(argv[i], "--async") == 0 && hasValue) {
+            options.ingestWorkers = atoi(argv[++i]);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    if (options.frames <= 0 || options.width <= 0 || options.height <= 0 || options.restarts < 0 ||
+        options.budgetMb < 0.0f || options.exposureMs < 0.0f || options.readoutMs < 0.0f ||
+        options.ingestWorkers < 0 || options.ingestWorkers > FrameIngestPool::MAX_WORKERS) {
+        return usage(argv[0]);
+    }
+
+    QuforiaThreadConfig deliveryThread;
+    memset(&deliveryThread, 0, sizeof(deliveryThread));
+    deliveryThread.role = static_cast<int32_t>(QuforiaThreadRole::FRAME_DELIVERY);
+    deliveryThread.setNice = options.setNice ? 1 : 0;
+    deliveryThread.nice = options.nice;
+    deliveryThread.cpuMask = options.cpuMask;
+
+    QuforiaInitConfig initConfig;
+    initConfig.size = sizeof(initConfig);
+    initConfig.threadConfigCount = 1;
+    initConfig.threadConfigs = &deliveryThread;
+
+    QuforiaMemoryConfig memory;
+    memset(&memory, 0, sizeof(memory));
+    memory.budgetBytes = static_cast<uint64_t>(options.budgetMb * 1024.0f * 1024.0f);
+    initConfig.memoryConfig = options.budgetMb > 0.0f ? &memory : nullptr;
+
+    QuestVuforiaDriver driver(nullptr, &initConfig);
+    driver.setFrameDeliveryPolicy(options.everyFrame ? FrameDeliveryPolicy::EVERY_FRAME
+                                                     : FrameDeliveryPolicy::LATEST_ONLY);
+
+    const float intrinsics[14] = {
+        static_cast<float>(options.width), static_cast<float>(options.height),
+        options.width * 0.8f, options.width * 0.8f,
+        options.width * 0.5f, options.height * 0.5f,
+        options.distortion, 0, 0, 0, 0, 0, 0, 0
+    };
+    driver.setCameraIntrinsics(intrinsics);
+    driver.setFrameRectification(options.distortion != 0.0f);
+    driver.setIngestWorkers(options.ingestWorkers);
+    // What the passthrough camera's capture results would report, the same for every frame
+    driver.setCameraExposure(static_cast<int64_t>(options.exposureMs * 1e6f),
+                             static_cast<int64_t>(options.readoutMs * 1e6f));
+
+    auto* camera = static_cast<QuestExternalCamera*>(driver.createExternalCamera());
+    auto* tracker = static_cast<QuestExternalTracker*>(driver.createExternalPositionalDeviceTracker());
+
+    VuforiaDriver::CameraMode mode;
+    if (!findMode(*camera, options, &mode)) {
+        fprintf(stderr, "No %s camera mode for %dx%d input\n",
+                pixelFormatName(options.modeFormat), options.width, options.height);
+        return 1;
+    }
+
+    MockCameraCallback cameraCallback(static_cast<size_t>(options.frames),
+                                      static_cast<int64_t>(options.callbackMs * 1e6));
+    driver.governor().setEnabled(options.governor);
+    driver.qualityGate().setEnabled(options.blurGate);
+    driver.motionThrottle().setEnabled(options.throttleStatic);
+    driver.clock().setDomain(options.clock);
+    ExposurePoseCallback poseCallback(options.headMotion(), options.midExposureOffsetNs());
+    MockAnchorCallback anchorCallback;
+
+    if (!tracker->open() || !tracker->start(&poseCallback, options.anchors ? &anchorCallback : nullptr) ||
+        !camera->open() || !camera->start(mode, &cameraCallback)) {
+        fprintf(stderr, "Failed to start camera/tracker\n");
+        return 1;
+    }
+
+    if (options.recordPath && !driver.startRecording(options.recordPath, options.compress)) {
+        fprintf(stderr, "Cannot record to %s\n", options.recordPath);
+        return 1;
+    }
+
+    AnchorProviderResult anchorResult;
+    PoseQueryResult poseQueries;
+    int fedFrames = options.frames;
+    int warmupFrames = std::min(options.frames / 10, 30);
+    uint64_t allocationsAtWarmup = 0;
+    int64_t startNs = 0;
+    uint64_t deliveredAtWarmup = 0;
+    LatencyStats feedCalls;
+
+    if (options.replayPath) {
+        char speed[16] = "max";
+        if (options.replaySpeed > 0) {
+            snprintf(speed, sizeof(speed), "%gx", options.replaySpeed);
+        }
+        printf("Driver pipeline benchmark: replaying %s into %ux%u %s at %s speed%s\n\n",
+               options.replayPath, mode.width, mode.height, pixelFormatName(mode.format), speed,
+               options.everyFrame ? ", every frame" : ", latest only");
+
+        allocationsAtWarmup = g_allocationCount.load(std::memory_order_relaxed);
+        startNs = monotonicNowNs();
+        if (!driver.startReplay(options.replayPath, options.replaySpeed, false)) {
+            fprintf(stderr, "Cannot replay %s\n", options.replayPath);
+            return 1;
+        }
+        while (driver.isReplaying()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        // No warmup window: the allocation count includes mapping and indexing the file
+        warmupFrames = 0;
+    } else {
+        // Checks that need frames past --frames: the anchor provider until its last batch is
+        // delivered, and a still head until frames are throttled, which takes STATIC_DELAY_NS
+        // of frame timestamps however slowly they are fed (up to four delays' worth of frames)
+        const int64_t throttleFps = std::max(options.fps, 30);
+        const int throttleFrameLimit =
+            options.frames + static_cast<int>(4 * MotionThrottle::STATIC_DELAY_NS * throttleFps / 1000000000LL);
+        std::atomic<bool> anchorsRunning(options.anchors);
+        std::thread anchorProvider;
+        if (options.anchors) {
+            anchorProvider = std::thread([&]() {
+                runAnchorProvider(driver, tracker, anchorCallback, &anchorResult);
+                anchorsRunning = false;
+            });
+        }
+        std::atomic<bool> rendering(true);
+        std::thread renderThread;
+        if (options.poseQuery) {
+            renderThread = std::thread(runPoseQueries, std::ref(driver), std::cref(options),
+                                       std::cref(rendering), &poseQueries);
+        }
+        fedFrames = runSynthetic(driver, options, mode, camera, cameraCallback, warmupFrames,
+                                 &allocationsAtWarmup, &deliveredAtWarmup, &startNs, &feedCalls,
+                                 [&](int fed) {
+                                     QuforiaMotionThrottleState throttle;
+                                     driver.motionThrottle().state(&throttle);
+                                     return anchorsRunning.load() ||
+                                            (options.throttleStatic && fed < throttleFrameLimit &&
+                                             throttle.framesThrottled == 0);
+                                 });
+        rendering = false;
+        if (renderThread.joinable()) {
+            renderThread.join();
+        }
+        if (anchorProvider.joinable()) {
+            anchorProvider.join();
+        }
+    }
+
+    // Let the delivery thread drain the ring
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const int64_t elapsedNs = monotonicNowNs() - startNs;
+    const uint64_t allocations = g_allocationCount.load(std::memory_order_relaxed) - allocationsAtWarmup;
+    const uint64_t delivered = cameraCallback.delivered();
+
+    QuforiaThreadReport deliveryReport;
+    getThreadReport(QuforiaThreadRole::FRAME_DELIVERY, &deliveryReport);
+
+    driver.stopReplay();
+    driver.stopRecording();
+    camera->stop();
+    tracker->stop();
+
+    QuforiaStats stats;
+    driver.stats().snapshot(&stats);
+    if (options.replayPath) {
+        fedFrames = static_cast<int>(stats.framesFed);
+    }
+
+    const int measuredFrames = fedFrames - warmupFrames;
+    printf("Throughput\n");
+    printf("  fed %d frames, delivered %llu (%.1f fps), valid poses %llu\n",
+           fedFrames, (unsigned long long)delivered,
+           (delivered - deliveredAtWarmup) / (elapsedNs / 1e9),
+           (unsigned long long)poseCallback.valid());
+    printf("  driver: fed=%llu rejected=%llu dropped=%llu skipped=%llu duplicated=%llu blurred=%llu "
+           "poses fed=%llu delivered=%llu missing=%llu\n",
+           (unsigned long long)stats.framesFed, (unsigned long long)stats.framesRejected,
+           (unsigned long long)stats.framesDropped, (unsigned long long)stats.framesSkipped,
+           (unsigned long long)stats.framesDuplicated, (unsigned long long)stats.framesBlurred,
+           (unsigned long long)stats.posesFed,
+           (unsigned long long)stats.posesDelivered, (unsigned long long)stats.posesMissing);
+
+    printf("\nLatency\n");
+    printRow("feed -> onNewCameraFrame", cameraCallback.latency());
+    if (!feedCalls.samples.empty()) {
+        printRow("feed call", feedCalls);
+    }
+    printHistogram("pose match error", stats.poseMatchError);
+    printHistogram("onNewCameraFrame", stats.frameCallbackTime);
+    printHistogram("mutex wait", stats.mutexWaitTime);
+    if (stats.rectifyTime.count > 0) {
+        printHistogram("rectify", stats.rectifyTime);
+    }
+
+    QuforiaGovernorState governor;
+    driver.governor().state(&governor);
+    printf("\nGovernor%s\n", governor.enabled ? "" : " (disabled)");
+    printf("  level %d (1/%d%s), input %.1f fps, callback %.2f ms, pressure %.2f, shed %llu\n",
+           governor.level, governor.frameDivisor,
+           governor.recommendHalfResolution ? ", half resolution recommended" : "",
+           governor.inputFps, governor.callbackMs, governor.pressure,
+           (unsigned long long)governor.framesShed);
+
+    if (options.blurGate) {
+        QuforiaQualityState quality;
+        driver.qualityGate().state(&quality);
+        printf("\nQuality gate\n");
+        printf("  scored %llu, dropped %llu as blurred, last score %.0f (reference %.0f), "
+               "%.2f rad/s, %.3f ms per score\n",
+               (unsigned long long)quality.framesScored, (unsigned long long)stats.framesBlurred,
+               quality.lastScore, quality.referenceScore, quality.angularSpeed, quality.scoreMs);
+    }
+
+    QuforiaClockState clock;
+    driver.clock().state(&clock);
+    printf("\nClock mapping (domain %d)\n", clock.domain);
+    printf("  offset %.3f ms, drift %.1f ppm over %d fit points, capture -> arrival %.3f ms\n",
+           clock.offsetNs / 1e6, clock.driftPpm, clock.samples, clock.latencyMs);
+
+    printf("\nDelivery thread\n");
+    printf("  %s (tid %d): %s, priority %d, nice %d, cpus 0x%llx%s\n",
+           deliveryReport.name, deliveryReport.tid,
+           deliveryReport.policy == QUFORIA_SCHED_FIFO ? "SCHED_FIFO" : "SCHED_OTHER",
+           deliveryReport.priority, deliveryReport.nice,
+           (unsigned long long)deliveryReport.cpuMask,
+           deliveryReport.errors ? " (some settings refused)" : "");
+
+    printf("\nAllocations\n");
+    printf("  %llu heap allocations over %d steady-state frames (%.2f per frame)\n",
+           (unsigned long long)allocations, measuredFrames,
+           measuredFrames > 0 ? static_cast<double>(allocations) / measuredFrames : 0.0);
+
+    camera->close();
+    tracker->close();
+    driver.destroyExternalCamera(camera);
+    driver.destroyExternalPositionalDeviceTracker(tracker);
+
+    // The centre window keeps the calibrated principal point at the centre of the frame
+    bool intrinsicsOk = true;
+    if (options.crop) {
+        intrinsicsOk = std::fabs(cameraCallback.principalPointX() - mode.width * 0.5f) < 1e-3f &&
+                       std::fabs(cameraCallback.principalPointY() - mode.height * 0.5f) < 1e-3f;
+        printf("\nCrop\n  principal point (%.2f, %.2f) in the %ux%u window%s\n",
+               cameraCallback.principalPointX(), cameraCallback.principalPointY(),
+               mode.width, mode.height, intrinsicsOk ? "" : " (expected the centre)");
+    }
+
+    // Fast turns feed only blurred frames, so the gate must have dropped some
+    const bool qualityOk = !options.blurGate || stats.framesBlurred > 0;
+
+    // A still head must end up throttled
+    QuforiaMotionThrottleState throttle;
+    driver.motionThrottle().state(&throttle);
+    const bool throttleOk = !options.throttleStatic || throttle.framesThrottled > 0;
+    if (options.throttleStatic) {
+        printf("\nMotion throttle\n");
+        printf("  %s after %.2f s static, %.1f fps cap, %llu frames throttled\n",
+               throttle.throttled ? "throttled" : "full rate", throttle.staticSeconds,
+               throttle.staticFps, (unsigned long long)throttle.framesThrottled);
+    }
+
+    // Every status arrives once; the echoed CREATE pose changes nothing, the nudged one is an UPDATE
+    bool anchorsOk = true;
+    if (options.anchors) {
+        using VuforiaDriver::AnchorStatus;
+        const float* moved = anchorCallback.updatedTranslation();
+        const float shift = std::sqrt((moved[0] - ANCHOR_TRANSLATION[0]) * (moved[0] - ANCHOR_TRANSLATION[0]) +
+                                      (moved[1] - ANCHOR_TRANSLATION[1]) * (moved[1] - ANCHOR_TRANSLATION[1]) +
+                                      (moved[2] - ANCHOR_TRANSLATION[2]) * (moved[2] - ANCHOR_TRANSLATION[2]));
+        anchorsOk = anchorResult.ok && anchorCallback.count(AnchorStatus::ADDED) == 1 &&
+                    anchorCallback.count(AnchorStatus::UPDATED) == 1 &&
+                    anchorCallback.count(AnchorStatus::PAUSED) == 1 &&
+                    anchorCallback.count(AnchorStatus::REMOVED) == 2 &&
+                    std::fabs(shift - ANCHOR_NUDGE) < 1e-4f;
+        printf("\nAnchors\n");
+        printf("  requests %d, added %d, updated %d (moved %.4f m), paused %d, removed %d, %d left%s\n",
+               anchorResult.requests, anchorCallback.count(AnchorStatus::ADDED),
+               anchorCallback.count(AnchorStatus::UPDATED), shift,
+               anchorCallback.count(AnchorStatus::PAUSED), anchorCallback.count(AnchorStatus::REMOVED),
+               anchorResult.remaining, anchorsOk ? "" : " (unexpected)");
+    }
+
+    // Render-time queries must find a pose nearly every time, close to the true head position
+    bool poseQueryOk = true;
+    if (options.poseQuery) {
+        poseQueryOk = poseQueries.queries > 0 &&
+                      poseQueries.hits >= MIN_POSE_QUERY_HITS * poseQueries.queries &&
+                      poseQueries.maxError <= MAX_POSE_QUERY_ERROR;
+        printf("\nPose queries (%.0f ms ahead)\n", RENDER_PREDICTION_NS / 1e6);
+        printRow("samplePose", poseQueries.calls);
+        printf("  %d of %d found, max position error %.3f mm%s\n", poseQueries.hits, poseQueries.queries,
+               poseQueries.maxError * 1e3f, poseQueryOk ? "" : " (unexpected)");
+    }
+
+    // Delivered poses belong to mid-exposure, so they must beat poses at the frame timestamp
+    bool exposureOk = true;
+    if (options.exposureMs > 0.0f) {
+        const uint64_t exposureNs = static_cast<uint64_t>(options.exposureMs * 1e6f);
+        exposureOk = cameraCallback.exposureTime() == exposureNs &&
+                     poseCallback.midExposureError() <= MAX_MID_EXPOSURE_ERROR_SHARE * poseCallback.timestampError();
+        printf("\nExposure (%.1f ms, %.1f ms readout: poses %.1f ms before the frame timestamp)\n",
+               options.exposureMs, options.readoutMs, options.midExposureOffsetNs() / 1e6);
+        printf("  Vuforia sees %.1f ms exposure; max pose error %.3f mm (%.3f mm at the frame timestamp)%s\n",
+               cameraCallback.exposureTime() / 1e6, poseCallback.midExposureError() * 1e3f,
+               poseCallback.timestampError() * 1e3f, exposureOk ? "" : " (unexpected)");
+    }
+
+    // Only the first start() may create the delivery thread, and a restarted camera must not
+    // deliver the frames left in the ring from before it stopped
+    const bool restartsOk = stats.warmStarts == static_cast<uint64_t>(options.restarts) &&
+                            cameraCallback.staleFrames() == 0;
+    if (options.restarts > 0) {
+        printf("\nRestarts\n");
+        printf("  %llu camera starts, %llu warm, %d stale frames delivered%s\n",
+               (unsigned long long)stats.cameraStarts, (unsigned long long)stats.warmStarts,
+               cameraCallback.staleFrames(), restartsOk ? "" : " (expected warm restarts, no stale frames)");
+        printHistogram("start()", stats.startCallTime);
+        printHistogram("start -> first frame", stats.startToFirstFrame);
+    }
+
+    // Frame pool plus pose history, all allocated (and pre-faulted) at driver init
+    QuforiaMemoryReport memoryReport;
+    driver.memoryReport(&memoryReport);
+    const bool budgetOk = memoryReport.budgetMet &&
+                          (memory.budgetBytes == 0 || memoryReport.totalBytes <= memory.budgetBytes);
+    printf("\nMemory\n");
+    printf("  %.1f MB: %u x %llu B frame slabs (queue %u), %u poses in %llu B%s\n",
+           memoryReport.totalBytes / (1024.0 * 1024.0), memoryReport.framePoolSlots,
+           (unsigned long long)memoryReport.slabBytes, memoryReport.frameQueueDepth, memoryReport.poseCapacity,
+           (unsigned long long)memoryReport.poseHistoryBytes, budgetOk ? "" : " (over budget)");
+    printf("  %d camera modes up to %ux%u\n", memoryReport.modesAdvertised, memoryReport.maxFrameWidth,
+           memoryReport.maxFrameHeight);
+
+    // Non-zero exit for smoke tests when the pipeline delivered nothing
+    return delivered > 0 && intrinsicsOk && qualityOk && throttleOk && anchorsOk && poseQueryOk &&
+           restartsOk && budgetOk && exposureOk ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+/**
+ * Pose transform microbenchmark: the tracker's previous one-pose-at-a-time OpenXR -> CV
+ * conversion (quaternion remap into a temporary array, then quaternion -> matrix) versus
+ * the batched transformPosesOpenXRToCV kernels, on SoA and PoseData input.
+ *
+ * Verifies that all paths agree and reports nanoseconds per pose.
+ *
+ * Usage: quforia_pose_transform_bench [--poses N] [--rounds N]
+ */
+
+#include "pose_transform.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+inline int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Previous QuestExternalTracker::transformOpenXRToCV + quaternionToMatrix
+void transformOnePose(const float* positionIn, const float* rotationIn,
+                      float* positionOut, float* rotationOut) {
+    positionOut[0] = positionIn[0];
+    positionOut[1] = -positionIn[1];
+    positionOut[2] = -positionIn[2];
+
+    float quat[4];
+    quat[0] = rotationIn[3];
+    quat[1] = -rotationIn[2];
+    quat[2] = -rotationIn[1];
+    quat[3] = rotationIn[0];
+
+    const float x = quat[0], y = quat[1], z = quat[2], w = quat[3];
+    rotationOut[0] = 1.0f - 2.0f * (y * y + z * z);
+    rotationOut[1] = 2.0f * (x * y - z * w);
+    rotationOut[2] = 2.0f * (x * z + y * w);
+    rotationOut[3] = 2.0f * (x * y + z * w);
+    rotationOut[4] = 1.0f - 2.0f * (x * x + z * z);
+    rotationOut[5] = 2.0f * (y * z - x * w);
+    rotationOut[6] = 2.0f * (x * z - y * w);
+    rotationOut[7] = 2.0f * (y * z + x * w);
+    rotationOut[8] = 1.0f - 2.0f * (x * x + y * y);
+}
+
+// Best-of-rounds time per pose
+template <typename Fn>
+double measure(int rounds, size_t poses, Fn&& fn) {
+    int64_t best = INT64_MAX;
+    for (int round = 0; round < rounds; round++) {
+        const int64_t start = nowNs();
+        fn();
+        best = std::min(best, nowNs() - start);
+    }
+    return static_cast<double>(best) / poses;
+}
+
+int usage(const char* program) {
+    fprintf(stderr, "Usage: %s [--poses N] [--rounds N]\n", program);
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t poseCount = 4096;
+    int rounds = 50;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--poses") == 0 && hasValue) {
+            poseCount = static_cast<size_t>(std::max(atoi(argv[++i]), 1));
+        } else if (strcmp(argv[i], "--rounds") == 0 && hasValue) {
+            rounds = std::max(atoi(argv[++i]), 1);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    // Random unit quaternions and positions, in both layouts
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<PoseData> records(poseCount);
+    std::vector<float> px(poseCount), py(poseCount), pz(poseCount);
+    std::vector<float> qx(poseCount), qy(poseCount), qz(poseCount), qw(poseCount);
+    for (size_t i = 0; i < poseCount; i++) {
+        float q[4];
+        float norm = 0.0f;
+        for (float& c : q) {
+            c = uniform(rng);
+            norm += c * c;
+        }
+        norm = std::sqrt(norm);
+        PoseData& pose = records[i];
+        for (int k = 0; k < 4; k++) {
+            pose.rotation[k] = q[k] / norm;
+        }
+        for (int k = 0; k < 3; k++) {
+            pose.position[k] = uniform(rng) * 2.0f;
+        }
+        px[i] = pose.position[0];
+        py[i] = pose.position[1];
+        pz[i] = pose.position[2];
+        qx[i] = pose.rotation[0];
+        qy[i] = pose.rotation[1];
+        qz[i] = pose.rotation[2];
+        qw[i] = pose.rotation[3];
+    }
+    const PoseStreamSoA stream = { px.data(), py.data(), pz.data(),
+                                   qx.data(), qy.data(), qz.data(), qw.data() };
+
+    std::vector<float> scalarOut(poseCount * 12);
+    std::vector<PoseMatrix34> soaOut(poseCount);
+    std::vector<PoseMatrix34> recordOut(poseCount);
+
+    const double scalarNs = measure(rounds, poseCount, [&]() {
+        for (size_t i = 0; i < poseCount; i++) {
+            float* out = &scalarOut[i * 12];
+            transformOnePose(records[i].position, records[i].rotation, out, out + 3);
+        }
+    });
+    const double soaNs = measure(rounds, poseCount, [&]() {
+        transformPosesOpenXRToCV(stream, poseCount, soaOut.data());
+    });
+    const double recordNs = measure(rounds, poseCount, [&]() {
+        transformPosesOpenXRToCV(records.data(), poseCount, recordOut.data());
+    });
+
+    double maxError = 0.0;
+    for (size_t i = 0; i < poseCount; i++) {
+        float translation[3];
+        float rotation[9];
+        splitPoseMatrix(soaOut[i], translation, rotation);
+        const float* expected = &scalarOut[i * 12];
+        for (int k = 0; k < 3; k++) {
+            maxError = std::max(maxError, static_cast<double>(std::fabs(translation[k] - expected[k])));
+        }
+        for (int k = 0; k < 9; k++) {
+            maxError = std::max(maxError, static_cast<double>(std::fabs(rotation[k] - expected[3 + k])));
+        }
+        if (memcmp(&soaOut[i], &recordOut[i], sizeof(PoseMatrix34)) != 0) {
+            maxError = std::max(maxError, 1.0);
+        }
+    }
+
+    printf("Pose transform benchmark: %zu poses, best of %d rounds\n\n", poseCount, rounds);
+    printf("  per pose (previous tracker path) %8.2f ns/pose\n", scalarNs);
+    printf("  batched SoA                      %8.2f ns/pose  (%.1fx)\n", soaNs, scalarNs / soaNs);
+    printf("  batched PoseData                 %8.2f ns/pose  (%.1fx)\n", recordNs, scalarNs / recordNs);
+    printf("\n  max deviation from the per-pose path: %g\n", maxError);
+
+    // Non-zero exit for smoke tests when the paths disagree
+    return maxError < 1e-5 ? 0 : 1;
+}
@@ -0,0 +1,288 @@
+/**
+ * Contention microbenchmark: mutex + std::queue<shared_ptr> (previous driver design)
+ * versus the lock-free FrameRing / PoseRing.
+ *
+ * One producer publishes frames and poses while reader threads poll the latest frame
+ * and look up poses, like the delivery threads do. Reports per-call latency percentiles
+ * for both sides.
+ *
+ * Usage: quforia_ring_bench [--iterations N] [--readers N]
+ */
+
+#include "frame_pool.h"
+#include "frame_ring.h"
+#include "pose_ring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t FRAME_QUEUE_SIZE = 3;
+const size_t POSE_QUEUE_SIZE = 90;
+const size_t SLAB_SIZE = 64 * 1024;  // Contention only, the pixel copy is not measured
+
+inline int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct LatencyStats {
+    std::vector<int64_t> samples;
+
+    void add(int64_t ns) { samples.push_back(ns); }
+
+    void merge(const LatencyStats& other) {
+        samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+    }
+
+    int64_t percentile(double p) {
+        if (samples.empty()) {
+            return 0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+};
+
+void printRow(const char* name, LatencyStats& stats) {
+    printf("  %-28s p50=%7lld ns  p99=%7lld ns  p99.9=%8lld ns  max=%9lld ns  (n=%zu)\n",
+           name,
+           (long long)stats.percentile(0.50),
+           (long long)stats.percentile(0.99),
+           (long long)stats.percentile(0.999),
+           (long long)stats.percentile(1.0),
+           stats.samples.size());
+}
+
+struct Results {
+    LatencyStats framePublish;
+    LatencyStats posePublish;
+    LatencyStats frameAcquire;
+    LatencyStats poseLookup;
+};
+
+// -----------------------------------------------------------------------------
+// Baseline: the previous mutex + std::queue<std::shared_ptr<...>> design
+// -----------------------------------------------------------------------------
+
+struct LegacyFrame {
+    int64_t timestamp;
+    std::unique_ptr<uint8_t[]> imageData;
+};
+
+class LegacyBuffers {
+public:
+    void feedFrame(int64_t timestamp) {
+        auto frame = std::make_shared<LegacyFrame>();
+        frame->timestamp = timestamp;
+
+        std::lock_guard<std::mutex> lock(frameMutex_);
+        frameQueue_.push(frame);
+        while (frameQueue_.size() > FRAME_QUEUE_SIZE) {
+            frameQueue_.pop();
+        }
+    }
+
+    void feedPose(const PoseData& pose) {
+        auto poseData = std::make_shared<PoseData>(pose);
+
+        std::lock_guard<std::mutex> lock(poseMutex_);
+        poseQueue_.push(poseData);
+        while (poseQueue_.size() > POSE_QUEUE_SIZE) {
+            poseQueue_.pop();
+        }
+    }
+
+    std::shared_ptr<LegacyFrame> acquireLatestFrame() {
+        std::lock_guard<std::mutex> lock(frameMutex_);
+        return frameQueue_.empty() ? nullptr : frameQueue_.back();
+    }
+
+    bool acquirePose(int64_t timestamp, PoseData* out) {
+        std::lock_guard<std::mutex> lock(poseMutex_);
+        std::queue<std::shared_ptr<PoseData>> tempQueue = poseQueue_;
+
+        int64_t best = INT64_MAX;
+        while (!tempQueue.empty()) {
+            auto pose = tempQueue.front();
+            tempQueue.pop();
+            int64_t diff = std::llabs(pose->timestamp - timestamp);
+            if (diff < best) {
+                best = diff;
+                *out = *pose;
+            }
+        }
+        return best != INT64_MAX;
+    }
+
+private:
+    std::mutex frameMutex_;
+    std::queue<std::shared_ptr<LegacyFrame>> frameQueue_;
+    std::mutex poseMutex_;
+    std::queue<std::shared_ptr<PoseData>> poseQueue_;
+};
+
+// -----------------------------------------------------------------------------
+// Lock-free: FramePool + FrameRing and PoseRing, as used by QuestVuforiaDriver
+// -----------------------------------------------------------------------------
+
+class LockFreeBuffers {
+public:
+    LockFreeBuffers() : frameRing_(framePool_) {
+        framePool_.allocate(FRAME_QUEUE_SIZE + 3, SLAB_SIZE);
+        frameRing_.allocate(FRAME_QUEUE_SIZE);
+        poseRing_.allocate(POSE_QUEUE_SIZE);
+    }
+
+    void feedFrame(int64_t timestamp) {
+        FrameHandle frame = framePool_.acquire();
+        if (!frame && frameRing_.evictOldest()) {
+            frame = framePool_.acquire();
+        }
+        if (!frame) {
+            return;
+        }
+        frame->timestamp = timestamp;
+        frameRing_.publish(std::move(frame));
+    }
+
+    void feedPose(const PoseData& pose) { poseRing_.push(pose); }
+
+    FrameHandle acquireLatestFrame() { return frameRing_.acquireLatest(); }
+
+    bool acquirePose(int64_t timestamp, PoseData* out) {
+        const uint64_t head = poseRing_.head();
+        int64_t best = INT64_MAX;
+        for (uint64_t i = poseRing_.oldest(head); i < head; i++) {
+            PoseData pose;
+            if (!poseRing_.read(i, &pose)) {
+                continue;
+            }
+            int64_t diff = std::llabs(pose.timestamp - timestamp);
+            if (diff < best) {
+                best = diff;
+                *out = pose;
+            }
+        }
+        return best != INT64_MAX;
+    }
+
+private:
+    FramePool framePool_;
+    FrameRing frameRing_;
+    PoseRing poseRing_;
+};
+
+template <typename Buffers>
+Results run(Buffers& buffers, int iterations, int readerCount) {
+    Results results;
+    std::atomic<bool> running(true);
+    std::vector<Results> readerResults(readerCount);
+    std::vector<std::thread> readers;
+
+    for (int r = 0; r < readerCount; r++) {
+        readers.emplace_back([&, r]() {
+            Results& local = readerResults[r];
+            while (running.load(std::memory_order_relaxed)) {
+                int64_t start = nowNs();
+                auto frame = buffers.acquireLatestFrame();
+                int64_t mid = nowNs();
+                local.frameAcquire.add(mid - start);
+
+                if (frame) {
+                    PoseData pose;
+                    buffers.acquirePose(frame->timestamp, &pose);
+                    local.poseLookup.add(nowNs() - mid);
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < iterations; i++) {
+        int64_t timestamp = nowNs();
+
+        PoseData pose;
+        pose.timestamp = timestamp;
+        pose.position[0] = static_cast<float>(i);
+
+        int64_t start = nowNs();
+        buffers.feedPose(pose);
+        int64_t mid = nowNs();
+        buffers.feedFrame(timestamp);
+        int64_t end = nowNs();
+
+        results.posePublish.add(mid - start);
+        results.framePublish.add(end - mid);
+
+        // Give readers a little room, roughly like a camera cadence compressed in time
+        while (nowNs() - end < 2000) {
+        }
+    }
+
+    running = false;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    for (auto& local : readerResults) {
+        results.frameAcquire.merge(local.frameAcquire);
+        results.poseLookup.merge(local.poseLookup);
+    }
+    return results;
+}
+
+void report(const char* title, Results& results) {
+    printf("%s\n", title);
+    printRow("producer: feed frame", results.framePublish);
+    printRow("producer: feed pose", results.posePublish);
+    printRow("reader: acquire latest frame", results.frameAcquire);
+    printRow("reader: pose lookup", results.poseLookup);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = 200000;
+    int readers = 2;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--readers") == 0 && i + 1 < argc) {
+            readers = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations N] [--readers N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("Ring contention benchmark: %d iterations, 1 producer, %d readers\n\n",
+           iterations, readers);
+
+    {
+        LegacyBuffers buffers;
+        Results results = run(buffers, iterations, readers);
+        report("mutex + std::queue<shared_ptr>:", results);
+    }
+
+    printf("\n");
+
+    {
+        LockFreeBuffers buffers;
+        Results results = run(buffers, iterations, readers);
+        report("lock-free FrameRing / PoseRing:", results);
+    }
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+#ifndef QUFORIA_BENCH_STUB_ANDROID_LOG_H
+#define QUFORIA_BENCH_STUB_ANDROID_LOG_H
+
+// Minimal host stand-in for <android/log.h> so driver sources build off-device.
+// Only warnings and errors are printed; debug/info output would distort timings.
+
+#include <cstdarg>
+#include <cstdio>
+
+enum android_LogPriority {
+    ANDROID_LOG_UNKNOWN = 0,
+    ANDROID_LOG_DEFAULT,
+    ANDROID_LOG_VERBOSE,
+    ANDROID_LOG_DEBUG,
+    ANDROID_LOG_INFO,
+    ANDROID_LOG_WARN,
+    ANDROID_LOG_ERROR,
+    ANDROID_LOG_FATAL,
+    ANDROID_LOG_SILENT,
+};
+
+inline int __android_log_print(int prio, const char* tag, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+inline int __android_log_print(int prio, const char* tag, const char* fmt, ...) {
+    if (prio < ANDROID_LOG_WARN) {
+        return 0;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "[%s] ", tag);
+    int written = vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    return written;
+}
+
+#endif // QUFORIA_BENCH_STUB_ANDROID_LOG_H
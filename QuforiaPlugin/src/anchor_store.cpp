@@ -0,0 +1,423 @@
+#include "anchor_store.h"
+#include "pose_transform.h"
+#include "quforia_log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using VuforiaDriver::AnchorStatus;
+
+// Pose changes below this are treated as the same pose (spatial anchors only move on relocalization)
+static const float POSE_EPSILON = 1e-5f;
+
+static uint32_t hashUuid(const char* uuid) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char* c = uuid; *c; c++) {
+        hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+    }
+    return hash;
+}
+
+static bool validUuid(const char* uuid) {
+    if (!uuid) {
+        return false;
+    }
+    const size_t length = strnlen(uuid, QUFORIA_ANCHOR_UUID_SIZE);
+    return length > 0 && length < QUFORIA_ANCHOR_UUID_SIZE;
+}
+
+static bool samePose(const VuforiaDriver::AnchorPose& a, const VuforiaDriver::AnchorPose& b) {
+    for (int i = 0; i < 3; i++) {
+        if (std::fabs(a.translationData[i] - b.translationData[i]) > POSE_EPSILON) {
+            return false;
+        }
+    }
+    for (int i = 0; i < 9; i++) {
+        if (std::fabs(a.rotationData[i] - b.rotationData[i]) > POSE_EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
+
+AnchorStore::AnchorStore()
+    : freeCount_(MAX_ANCHORS)
+    , deletedSlots_(0)
+    , requestCount_(0)
+    , removedCount_(0)
+    , pendingUpdates_(false)
+    , random_(std::random_device{}())
+{
+    for (int i = 0; i < MAX_ANCHORS; i++) {
+        entries_[i].used = false;
+        // Hand out low entries first
+        freeEntries_[i] = static_cast<int16_t>(MAX_ANCHORS - 1 - i);
+    }
+    std::fill(index_, index_ + INDEX_SIZE, static_cast<int16_t>(SLOT_EMPTY));
+}
+
+// =============================================================================
+// Hash index
+// =============================================================================
+
+int AnchorStore::findSlot(const char* uuid) const {
+    const int mask = INDEX_SIZE - 1;
+    int slot = static_cast<int>(hashUuid(uuid)) & mask;
+    for (int probe = 0; probe < INDEX_SIZE; probe++, slot = (slot + 1) & mask) {
+        const int16_t entry = index_[slot];
+        if (entry == SLOT_EMPTY) {
+            return -1;
+        }
+        if (entry != SLOT_DELETED && strcmp(entries_[entry].uuid, uuid) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+AnchorStore::Entry* AnchorStore::insert(const char* uuid) {
+    if (freeCount_ == 0) {
+        LOGE("Anchor table full (%d anchors)", MAX_ANCHORS);
+        return nullptr;
+    }
+    if (deletedSlots_ > MAX_ANCHORS / 2) {
+        rehash();
+    }
+
+    const int mask = INDEX_SIZE - 1;
+    int slot = static_cast<int>(hashUuid(uuid)) & mask;
+    while (index_[slot] >= 0) {
+        slot = (slot + 1) & mask;
+    }
+    if (index_[slot] == SLOT_DELETED) {
+        deletedSlots_--;
+    }
+
+    const int16_t e = freeEntries_[--freeCount_];
+    index_[slot] = e;
+
+    Entry& entry = entries_[e];
+    snprintf(entry.uuid, sizeof(entry.uuid), "%s", uuid);
+    entry.pending = NOTHING_PENDING;
+    entry.localized = false;
+    entry.announced = false;
+    entry.used = true;
+    return &entry;
+}
+
+void AnchorStore::erase(int slot) {
+    const int16_t e = index_[slot];
+    entries_[e].used = false;
+    freeEntries_[freeCount_++] = e;
+    index_[slot] = SLOT_DELETED;
+    deletedSlots_++;
+}
+
+void AnchorStore::rehash() {
+    std::fill(index_, index_ + INDEX_SIZE, static_cast<int16_t>(SLOT_EMPTY));
+    const int mask = INDEX_SIZE - 1;
+    for (int e = 0; e < MAX_ANCHORS; e++) {
+        if (!entries_[e].used) {
+            continue;
+        }
+        int slot = static_cast<int>(hashUuid(entries_[e].uuid)) & mask;
+        while (index_[slot] != SLOT_EMPTY) {
+            slot = (slot + 1) & mask;
+        }
+        index_[slot] = static_cast<int16_t>(e);
+    }
+    deletedSlots_ = 0;
+}
+
+int AnchorStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return MAX_ANCHORS - freeCount_;
+}
+
+void AnchorStore::generateUuid(char* out) {
+    // Random (version 4) UUID
+    do {
+        const uint64_t high = random_();
+        const uint64_t low = random_();
+        snprintf(out, QUFORIA_ANCHOR_UUID_SIZE, "%08x-%04x-4%03x-%04x-%012llx",
+                 static_cast<uint32_t>(high >> 32), static_cast<uint32_t>(high >> 16) & 0xffff,
+                 static_cast<uint32_t>(high) & 0x0fff, static_cast<uint32_t>((low >> 48) & 0x3fff) | 0x8000,
+                 static_cast<unsigned long long>(low & 0xffffffffffffULL));
+    } while (findSlot(out) >= 0);
+}
+
+// =============================================================================
+// Vuforia side
+// =============================================================================
+
+const char* AnchorStore::create(const VuforiaDriver::AnchorPose& pose) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (requestCount_ == MAX_REQUESTS) {
+        LOGE("Anchor request queue full, is the Unity anchor provider running?");
+        return nullptr;
+    }
+
+    char uuid[QUFORIA_ANCHOR_UUID_SIZE];
+    generateUuid(uuid);
+    Entry* entry = insert(uuid);
+    if (!entry) {
+        return nullptr;
+    }
+    entry->pose = pose;
+    entry->localized = true;
+    entry->announced = true;  // Vuforia made it
+
+    // Unity places a spatial anchor there and keeps reporting its pose
+    QuforiaAnchorRequest& request = requests_[requestCount_++];
+    memcpy(request.uuid, entry->uuid, sizeof(request.uuid));
+    request.type = QUFORIA_ANCHOR_CREATE;
+    PoseData openxr;
+    transformPoseCVToOpenXR(pose.translationData, pose.rotationData, &openxr);
+    memcpy(request.position, openxr.position, sizeof(request.position));
+    memcpy(request.rotation, openxr.rotation, sizeof(request.rotation));
+
+    LOGI("Anchor %s created (%d anchors)", entry->uuid, MAX_ANCHORS - freeCount_);
+    return entry->uuid;
+}
+
+bool AnchorStore::remove(const char* uuid) {
+    if (!validUuid(uuid)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int slot = findSlot(uuid);
+    if (slot < 0) {
+        LOGW("removeAnchor: unknown anchor %s", uuid);
+        return false;
+    }
+
+    // A spatial anchor Unity hasn't placed yet doesn't need erasing
+    if (!cancelRequest(uuid)) {
+        if (requestCount_ < MAX_REQUESTS) {
+            QuforiaAnchorRequest& request = requests_[requestCount_++];
+            memset(&request, 0, sizeof(request));
+            memcpy(request.uuid, entries_[index_[slot]].uuid, sizeof(request.uuid));
+            request.type = QUFORIA_ANCHOR_REMOVE;
+        } else {
+            LOGW("Anchor request queue full, spatial anchor %s is not erased", uuid);
+        }
+    }
+
+    erase(slot);
+    LOGI("Anchor %s removed (%d anchors)", uuid, MAX_ANCHORS - freeCount_);
+    return true;
+}
+
+// =============================================================================
+// Unity side
+// =============================================================================
+
+int AnchorStore::takeRequests(QuforiaAnchorRequest* out, int maxRequests) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int count = std::min(std::max(maxRequests, 0), requestCount_);
+    std::copy(requests_, requests_ + count, out);
+    std::copy(requests_ + count, requests_ + requestCount_, requests_);
+    requestCount_ -= count;
+    return count;
+}
+
+int AnchorStore::update(const QuforiaAnchorUpdate* updates, int count) {
+    // Convert the whole batch to Vuforia's convention in one pass, outside the lock
+    PoseData poses[MAX_ANCHORS];
+    PoseMatrix34 matrices[MAX_ANCHORS];
+    int accepted = 0;
+
+    for (int start = 0; start < count; start += MAX_ANCHORS) {
+        const int n = std::min(count - start, static_cast<int>(MAX_ANCHORS));
+        for (int i = 0; i < n; i++) {
+            memcpy(poses[i].position, updates[start + i].position, sizeof(poses[i].position));
+            memcpy(poses[i].rotation, updates[start + i].rotation, sizeof(poses[i].rotation));
+        }
+        transformPosesOpenXRToCV(poses, n, matrices);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = 0; i < n; i++) {
+            const QuforiaAnchorUpdate& update = updates[start + i];
+            if (!validUuid(update.uuid)) {
+                continue;
+            }
+
+            const int slot = findSlot(update.uuid);
+            if (slot < 0 && removalRequested(update.uuid)) {
+                continue;  // Vuforia removed it; Unity hasn't erased the spatial anchor yet
+            }
+            Entry* entry = slot >= 0 ? &entries_[index_[slot]] : insert(update.uuid);
+            if (!entry) {
+                continue;
+            }
+            accepted++;
+
+            if (!update.localized) {
+                if (entry->localized) {
+                    entry->localized = false;
+                    setPending(*entry, AnchorStatus::PAUSED);
+                }
+                continue;
+            }
+
+            VuforiaDriver::AnchorPose pose;
+            splitPoseMatrix(matrices[i], pose.translationData, pose.rotationData);
+            if (entry->announced && entry->localized && samePose(pose, entry->pose)) {
+                continue;
+            }
+            entry->pose = pose;
+            entry->localized = true;
+            setPending(*entry, entry->announced ? AnchorStatus::UPDATED : AnchorStatus::ADDED);
+        }
+    }
+    return accepted;
+}
+
+bool AnchorStore::removalRequested(const char* uuid) const {
+    for (int i = 0; i < requestCount_; i++) {
+        if (requests_[i].type == QUFORIA_ANCHOR_REMOVE && strcmp(requests_[i].uuid, uuid) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AnchorStore::cancelRequest(const char* uuid) {
+    for (int i = 0; i < requestCount_; i++) {
+        if (strcmp(requests_[i].uuid, uuid) == 0) {
+            std::copy(requests_ + i + 1, requests_ + requestCount_, requests_ + i);
+            requestCount_--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AnchorStore::drop(const char* uuid) {
+    if (!validUuid(uuid)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int slot = findSlot(uuid);
+    if (slot < 0) {
+        return false;
+    }
+    Entry& entry = entries_[index_[slot]];
+    if (vuforiaKnows(entry)) {
+        queueRemoved(entry.uuid);
+    }
+    // Unity hasn't placed the spatial anchor Vuforia asked for, and now never will
+    cancelRequest(uuid);
+    erase(slot);
+    return true;
+}
+
+void AnchorStore::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int slot = 0; slot < INDEX_SIZE; slot++) {
+        if (index_[slot] < 0) {
+            continue;
+        }
+        if (vuforiaKnows(entries_[index_[slot]])) {
+            queueRemoved(entries_[index_[slot]].uuid);
+        }
+        erase(slot);
+    }
+    rehash();
+    requestCount_ = 0;
+    LOGI("Anchors cleared");
+}
+
+// =============================================================================
+// Delivery
+// =============================================================================
+
+void AnchorStore::setPending(Entry& entry, AnchorStatus status) {
+    const int8_t pending = entry.pending;
+    if (status == AnchorStatus::ADDED) {
+        entry.announced = true;
+    }
+
+    if (pending == static_cast<int8_t>(AnchorStatus::ADDED)) {
+        if (status == AnchorStatus::PAUSED) {
+            // Lost again before Vuforia heard of it: announce it once it is back
+            entry.pending = NOTHING_PENDING;
+            entry.announced = false;
+        }
+        return;  // Still ADDED, with the newest pose
+    }
+
+    entry.pending = static_cast<int8_t>(status);
+    pendingUpdates_.store(true, std::memory_order_release);
+}
+
+bool AnchorStore::vuforiaKnows(const Entry& entry) {
+    // setPending(ADDED) marks the entry announced before a frame delivers the ADDED
+    return entry.announced && entry.pending != static_cast<int8_t>(AnchorStatus::ADDED);
+}
+
+void AnchorStore::queueRemoved(const char* uuid) {
+    if (removedCount_ == MAX_ANCHORS) {
+        // Nobody delivers (no tracker running); the oldest notification is the least useful
+        LOGW("Too many undelivered anchor removals, dropping one");
+        memmove(removed_[0], removed_[1], sizeof(removed_[0]) * (MAX_ANCHORS - 1));
+        removedCount_--;
+    }
+    memcpy(removed_[removedCount_++], uuid, QUFORIA_ANCHOR_UUID_SIZE);
+    pendingUpdates_.store(true, std::memory_order_release);
+}
+
+void AnchorStore::announceAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Entry& entry : entries_) {
+        if (entry.used && entry.localized) {
+            entry.pending = static_cast<int8_t>(AnchorStatus::ADDED);
+            entry.announced = true;
+            pendingUpdates_.store(true, std::memory_order_release);
+        }
+    }
+}
+
+int AnchorStore::takeUpdates(AnchorStatus status, VuforiaDriver::Anchor* out, int maxAnchors) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int limit = std::min(maxAnchors, static_cast<int>(MAX_ANCHORS));
+    int count = 0;
+
+    if (status == AnchorStatus::REMOVED) {
+        count = std::min(limit, removedCount_);
+        for (int i = 0; i < count; i++) {
+            memcpy(deliveredUuids_[i], removed_[i], QUFORIA_ANCHOR_UUID_SIZE);
+            out[i].uuid = deliveredUuids_[i];
+            memset(&out[i].pose, 0, sizeof(out[i].pose));
+        }
+        memmove(removed_[0], removed_[count], sizeof(removed_[0]) * (removedCount_ - count));
+        removedCount_ -= count;
+    } else {
+        for (Entry& entry : entries_) {
+            if (count == limit) {
+                break;
+            }
+            if (!entry.used || entry.pending != static_cast<int8_t>(status)) {
+                continue;
+            }
+            memcpy(deliveredUuids_[count], entry.uuid, QUFORIA_ANCHOR_UUID_SIZE);
+            out[count].uuid = deliveredUuids_[count];
+            out[count].pose = entry.pose;
+            entry.pending = NOTHING_PENDING;
+            count++;
+        }
+    }
+
+    // Anything left for another call?
+    bool pending = removedCount_ > 0;
+    for (const Entry& entry : entries_) {
+        pending = pending || (entry.used && entry.pending != NOTHING_PENDING);
+    }
+    pendingUpdates_.store(pending, std::memory_order_release);
+    return count;
+}
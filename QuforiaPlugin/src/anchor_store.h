@@ -0,0 +1,140 @@
+#ifndef QUEST_ANCHOR_STORE_H
+#define QUEST_ANCHOR_STORE_H
+
+#include <VuforiaEngine/Driver/Driver.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+// UUID strings are the canonical 36 characters, stored NUL-terminated in 40 bytes
+static const size_t QUFORIA_ANCHOR_UUID_SIZE = 40;
+
+enum QuforiaAnchorRequestType : int32_t {
+    QUFORIA_ANCHOR_CREATE = 0,  // Place a spatial anchor at the pose and report it back
+    QUFORIA_ANCHOR_REMOVE = 1,  // Vuforia removed the anchor; erase the spatial anchor
+};
+
+// Work for Unity's spatial anchor provider (mirrored by QuestVuforiaBridge.AnchorRequest)
+struct QuforiaAnchorRequest {
+    char uuid[QUFORIA_ANCHOR_UUID_SIZE];
+    int32_t type;          // QuforiaAnchorRequestType
+    float position[3];     // OpenXR convention, CREATE only
+    float rotation[4];     // Quaternion (x, y, z, w)
+};
+
+// Spatial anchor pose reported by Unity (mirrored by QuestVuforiaBridge.AnchorUpdate)
+struct QuforiaAnchorUpdate {
+    char uuid[QUFORIA_ANCHOR_UUID_SIZE];
+    float position[3];     // OpenXR convention
+    float rotation[4];
+    int32_t localized;     // 0: the headset lost this anchor (Vuforia sees it PAUSED)
+};
+
+/**
+ * Anchors shared between Vuforia and Unity's spatial anchors (OVRSpatialAnchor).
+ *
+ * Vuforia creates and removes anchors through the tracker; those become requests Unity
+ * collects with takeRequests() and carries out on spatial anchors. Unity reports anchor
+ * poses with update(), including anchors Vuforia doesn't know yet (persisted from an
+ * earlier session), which is what lets Vuforia relocalize against them instead of
+ * detecting targets from scratch. The tracker delivers the resulting ADDED / UPDATED /
+ * PAUSED / REMOVED batches through AnchorCallback from the delivery thread, ahead of the
+ * next frame's pose, so every Vuforia callback stays on that thread.
+ *
+ * Lookups by UUID go through an open-addressing hash index over a fixed entry array, so
+ * they are O(1) and entries never move: the UUID pointer createAnchor() returns stays
+ * valid until the anchor is removed. All operations take a mutex, except the delivery
+ * thread's per-frame hasUpdates() check.
+ */
+class AnchorStore {
+public:
+    static const int MAX_ANCHORS = 64;
+    static const int MAX_REQUESTS = MAX_ANCHORS;
+
+    AnchorStore();
+
+    AnchorStore(const AnchorStore&) = delete;
+    AnchorStore& operator=(const AnchorStore&) = delete;
+
+    // Vuforia: new anchor at `pose` (CV convention); returns its UUID, null if full
+    const char* create(const VuforiaDriver::AnchorPose& pose);
+    // Vuforia: forget the anchor and ask Unity to erase its spatial anchor
+    bool remove(const char* uuid);
+
+    // Unity: move up to `maxRequests` pending requests into `out`, oldest first
+    int takeRequests(QuforiaAnchorRequest* out, int maxRequests);
+    // Unity: anchor poses; unknown UUIDs are added. Returns how many were accepted.
+    int update(const QuforiaAnchorUpdate* updates, int count);
+    // Unity: the spatial anchor is gone; Vuforia gets REMOVED
+    bool drop(const char* uuid);
+    // Unity: forget everything (e.g. a new space); Vuforia gets REMOVED for all anchors
+    void clear();
+
+    // Tracker start: report every known anchor to the new AnchorCallback as ADDED
+    void announceAll();
+
+    // Delivery thread: cheap check before taking the lock
+    bool hasUpdates() const { return pendingUpdates_.load(std::memory_order_acquire); }
+
+    // Delivery thread: anchors with `status` waiting to be delivered, at most `maxAnchors`.
+    // The UUID pointers in `out` stay valid until the next takeUpdates() call.
+    int takeUpdates(VuforiaDriver::AnchorStatus status, VuforiaDriver::Anchor* out, int maxAnchors);
+
+    int size() const;
+
+private:
+    static const int INDEX_SIZE = MAX_ANCHORS * 2;  // Power of two, load factor <= 1/2
+    static const int16_t SLOT_EMPTY = -1;
+    static const int16_t SLOT_DELETED = -2;
+    static const int8_t NOTHING_PENDING = -1;
+
+    struct Entry {
+        char uuid[QUFORIA_ANCHOR_UUID_SIZE];
+        VuforiaDriver::AnchorPose pose;
+        int8_t pending;   // AnchorStatus to deliver, or NOTHING_PENDING
+        bool localized;
+        bool announced;   // Vuforia knows the anchor (created it, or got ADDED)
+        bool used;
+    };
+
+    // Index slot holding `uuid`, or -1 (mutex_ held)
+    int findSlot(const char* uuid) const;
+    // Add `uuid` to a free entry; null if the table is full (mutex_ held)
+    Entry* insert(const char* uuid);
+    // Free the entry at index slot `slot` (mutex_ held)
+    void erase(int slot);
+    // Rebuild the index once deleted markers make probe chains long (mutex_ held)
+    void rehash();
+    // A REMOVE request for `uuid` is waiting for Unity (mutex_ held)
+    bool removalRequested(const char* uuid) const;
+    // Drop the request for `uuid` Unity hasn't taken yet; false if there is none (mutex_ held)
+    bool cancelRequest(const char* uuid);
+    void setPending(Entry& entry, VuforiaDriver::AnchorStatus status);
+    // Vuforia got (or, for its own anchors, made) the anchor, so removing it needs a REMOVED
+    static bool vuforiaKnows(const Entry& entry);
+    void queueRemoved(const char* uuid);
+    void generateUuid(char* out);
+
+    mutable std::mutex mutex_;
+    Entry entries_[MAX_ANCHORS];
+    int16_t index_[INDEX_SIZE];
+    int16_t freeEntries_[MAX_ANCHORS];
+    int freeCount_;
+    int deletedSlots_;
+
+    QuforiaAnchorRequest requests_[MAX_REQUESTS];
+    int requestCount_;
+
+    // REMOVED notifications; their entries are already gone
+    char removed_[MAX_ANCHORS][QUFORIA_ANCHOR_UUID_SIZE];
+    int removedCount_;
+
+    std::atomic<bool> pendingUpdates_;
+    std::mt19937_64 random_;
+
+    // Delivery thread only: UUIDs handed to the last onAnchorUpdate
+    char deliveredUuids_[MAX_ANCHORS][QUFORIA_ANCHOR_UUID_SIZE];
+};
+
+#endif // QUEST_ANCHOR_STORE_H
@@ -0,0 +1,221 @@
+#include "clock_domain.h"
+#include "driver_stats.h"
+#include "quforia_log.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+// Clamp for the fitted EXTERNAL drift; real oscillators are within tens of ppm
+static const double MAX_DRIFT = 1e-3;
+
+// Exponential smoothing weight of a new latency sample
+static const float LATENCY_SMOOTHING = 1.0f / 16.0f;
+
+static int64_t clockNowNs(clockid_t clock) {
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// CLOCK_MONOTONIC minus `clock`, sampled between two monotonic reads
+static int64_t kernelClockOffset(clockid_t clock) {
+    const int64_t before = monotonicNowNs();
+    const int64_t other = clockNowNs(clock);
+    const int64_t after = monotonicNowNs();
+    return before + (after - before) / 2 - other;
+}
+
+ClockDomainMapper::ClockDomainMapper()
+    : domain_(QUFORIA_CLOCK_MONOTONIC)
+    , queryOffset_(0)
+    , lastOffset_(0)
+    , latencyNs_(0.0f)
+    , pointCount_(0)
+    , nextPoint_(0)
+    , haveSyncPoints_(false)
+    , windowStart_(0)
+    , windowMinOffset_(0)
+    , windowMinExternal_(0)
+    , windowOpen_(false)
+    , fitBase_(0)
+    , fitOffset_(0)
+    , fitDrift_(0.0)
+    , haveFit_(false)
+{
+}
+
+void ClockDomainMapper::setDomain(QuforiaClockDomain domain) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    domain_.store(domain, std::memory_order_relaxed);
+    resetEstimate();
+    queryOffset_.store(0, std::memory_order_relaxed);
+    lastOffset_.store(0, std::memory_order_relaxed);
+    latencyNs_.store(0.0f, std::memory_order_relaxed);
+    LOGI("Input timestamps are in clock domain %d", static_cast<int>(domain));
+}
+
+int64_t ClockDomainMapper::toMonotonic(int64_t timestamp) {
+    const QuforiaClockDomain domain = domain_.load(std::memory_order_relaxed);
+
+    int64_t offset = 0;
+    switch (domain) {
+        case QUFORIA_CLOCK_BOOTTIME:
+            offset = kernelClockOffset(CLOCK_BOOTTIME);
+            break;
+        case QUFORIA_CLOCK_REALTIME:
+            offset = kernelClockOffset(CLOCK_REALTIME);
+            break;
+        default:
+            break;
+    }
+
+    const int64_t arrival = monotonicNowNs();
+    if (domain == QUFORIA_CLOCK_EXTERNAL) {
+        offset = estimateExternalOffset(timestamp, arrival);
+    }
+
+    // Nothing is captured after it reaches the driver
+    const int64_t mapped = std::min(timestamp + offset, arrival);
+
+    lastOffset_.store(mapped - timestamp, std::memory_order_relaxed);
+    const float latency = latencyNs_.load(std::memory_order_relaxed);
+    latencyNs_.store(latency + (static_cast<float>(arrival - mapped) - latency) * LATENCY_SMOOTHING,
+                     std::memory_order_relaxed);
+    return mapped;
+}
+
+ClockDomainMapper::BatchMapping ClockDomainMapper::mapBatch(int64_t newest) {
+    const int64_t mapped = toMonotonic(newest);
+    return BatchMapping{ mapped - newest, mapped };
+}
+
+int64_t ClockDomainMapper::estimateExternalOffset(int64_t timestamp, int64_t arrival) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!haveSyncPoints_) {
+        observe(timestamp, arrival);
+    }
+    int64_t offset = haveFit_ ? externalOffset(timestamp) : arrival - timestamp;
+
+    // A capture far in the future or past means the input clock jumped (e.g. the runtime
+    // restarted); no camera pipeline is that early or late
+    const int64_t ahead = timestamp + offset - arrival;
+    if (ahead > MAX_AHEAD_NS || -ahead > MAX_BEHIND_NS) {
+        LOGW_EVERY_MS(1000, "External clock jumped by %.1f ms, re-estimating offset", ahead / 1e6);
+        resetEstimate();
+        observe(timestamp, arrival);
+        offset = externalOffset(timestamp);
+    }
+    queryOffset_.store(offset, std::memory_order_relaxed);
+    return offset;
+}
+
+int64_t ClockDomainMapper::queryToMonotonic(int64_t timestamp) const {
+    switch (domain_.load(std::memory_order_relaxed)) {
+        case QUFORIA_CLOCK_BOOTTIME:
+            return timestamp + kernelClockOffset(CLOCK_BOOTTIME);
+        case QUFORIA_CLOCK_REALTIME:
+            return timestamp + kernelClockOffset(CLOCK_REALTIME);
+        case QUFORIA_CLOCK_EXTERNAL:
+            return timestamp + queryOffset_.load(std::memory_order_relaxed);
+        default:
+            return timestamp;
+    }
+}
+
+void ClockDomainMapper::addSyncPoint(int64_t externalNs, int64_t monotonicNs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!haveSyncPoints_) {
+        // Exact correspondences replace the envelope estimate
+        resetEstimate();
+        haveSyncPoints_ = true;
+    }
+    addFitPoint(externalNs, monotonicNs - externalNs);
+    refit();
+}
+
+void ClockDomainMapper::state(QuforiaClockState* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out->domain = domain_.load(std::memory_order_relaxed);
+    out->samples = pointCount_;
+    out->offsetNs = lastOffset_.load(std::memory_order_relaxed);
+    out->driftPpm = static_cast<float>(fitDrift_ * 1e6);
+    out->latencyMs = latencyNs_.load(std::memory_order_relaxed) / 1e6f;
+}
+
+void ClockDomainMapper::resetEstimate() {
+    pointCount_ = 0;
+    nextPoint_ = 0;
+    haveSyncPoints_ = false;
+    windowOpen_ = false;
+    fitBase_ = 0;
+    fitOffset_ = 0;
+    fitDrift_ = 0.0;
+    haveFit_ = false;
+}
+
+void ClockDomainMapper::observe(int64_t capture, int64_t arrival) {
+    const int64_t offset = arrival - capture;
+
+    if (!windowOpen_ || capture - windowStart_ >= WINDOW_NS || capture < windowStart_) {
+        if (windowOpen_) {
+            addFitPoint(windowMinExternal_, windowMinOffset_);
+            refit();
+        }
+        windowOpen_ = true;
+        windowStart_ = capture;
+        windowMinOffset_ = offset;
+        windowMinExternal_ = capture;
+    } else if (offset < windowMinOffset_) {
+        windowMinOffset_ = offset;
+        windowMinExternal_ = capture;
+    }
+
+    // Until the first window closes, map with the least delayed sample so far
+    if (pointCount_ == 0 && (!haveFit_ || offset < fitOffset_)) {
+        fitBase_ = capture;
+        fitOffset_ = offset;
+        fitDrift_ = 0.0;
+        haveFit_ = true;
+    }
+}
+
+void ClockDomainMapper::addFitPoint(int64_t external, int64_t offset) {
+    points_[nextPoint_] = FitPoint{ external, offset };
+    nextPoint_ = (nextPoint_ + 1) % MAX_FIT_POINTS;
+    if (pointCount_ < MAX_FIT_POINTS) {
+        pointCount_++;
+    }
+}
+
+void ClockDomainMapper::refit() {
+    // Least squares line through the points, relative to the newest one for precision
+    const FitPoint& newest = points_[(nextPoint_ + MAX_FIT_POINTS - 1) % MAX_FIT_POINTS];
+
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    for (int i = 0; i < pointCount_; i++) {
+        const double x = static_cast<double>(points_[i].external - newest.external);
+        const double y = static_cast<double>(points_[i].offset - newest.offset);
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+    }
+
+    const double n = static_cast<double>(pointCount_);
+    const double denominator = n * sumXX - sumX * sumX;
+    double drift = 0.0;
+    if (pointCount_ > 1 && denominator > 0.0) {
+        drift = std::max(-MAX_DRIFT, std::min((n * sumXY - sumX * sumY) / denominator, MAX_DRIFT));
+    }
+    const double intercept = (sumY - drift * sumX) / n;
+
+    fitBase_ = newest.external;
+    fitOffset_ = newest.offset + static_cast<int64_t>(std::llround(intercept));
+    fitDrift_ = drift;
+    haveFit_ = true;
+}
+
+int64_t ClockDomainMapper::externalOffset(int64_t external) const {
+    return fitOffset_ + static_cast<int64_t>(std::llround(fitDrift_ * (external - fitBase_)));
+}
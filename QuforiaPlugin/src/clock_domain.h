@@ -0,0 +1,118 @@
+#ifndef QUEST_CLOCK_DOMAIN_H
+#define QUEST_CLOCK_DOMAIN_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// Clock that timestamps passed in from Unity are expressed in
+enum QuforiaClockDomain : int32_t {
+    QUFORIA_CLOCK_MONOTONIC = 0,  // CLOCK_MONOTONIC ns (what Vuforia and the driver use)
+    QUFORIA_CLOCK_BOOTTIME = 1,   // CLOCK_BOOTTIME ns (Android sensor / camera2 timestamps)
+    QUFORIA_CLOCK_REALTIME = 2,   // Unix epoch ns (wall clock, e.g. a C# DateTime)
+    QUFORIA_CLOCK_EXTERNAL = 3,   // Any other clock (OpenXR XrTime, a sensor counter), estimated
+    QUFORIA_CLOCK_DOMAIN_COUNT
+};
+
+// Mapper state as exported to Unity (mirrored by QuestVuforiaBridge.ClockState)
+struct QuforiaClockState {
+    int32_t domain;       // QuforiaClockDomain of the input timestamps
+    int32_t samples;      // Points in the EXTERNAL offset/drift fit (sync points or window minima)
+    int64_t offsetNs;     // Monotonic minus input time at the last mapped timestamp
+    float driftPpm;       // Estimated EXTERNAL clock rate error vs CLOCK_MONOTONIC
+    float latencyMs;      // Smoothed capture -> driver arrival delay of mapped timestamps
+};
+
+/**
+ * Converts capture timestamps from the producer's clock to CLOCK_MONOTONIC, so camera frames
+ * and poses reach Vuforia and the pose history in one clock domain.
+ *
+ * BOOTTIME and REALTIME are kernel clocks: their offset to CLOCK_MONOTONIC is sampled on
+ * every conversion, which also follows suspend and wall clock steps. EXTERNAL clocks can't be
+ * read here, so the offset and drift are estimated online. Callers that know a correspondence
+ * (e.g. from xrConvertTimeToTimespecTimeKHR) add sync points; otherwise every conversion is an
+ * observation, and the lower envelope of arrival minus capture time (the least delayed
+ * timestamps per window) is fit with a line. The envelope sits one minimal pipeline latency
+ * late, which is consistent across frames and poses.
+ *
+ * Called from whichever threads feed the driver. MONOTONIC, BOOTTIME and REALTIME
+ * conversions are lock-free; EXTERNAL ones are serialized by a mutex guarding the estimate.
+ */
+class ClockDomainMapper {
+public:
+    ClockDomainMapper();
+
+    // Switching domains discards the EXTERNAL estimate
+    void setDomain(QuforiaClockDomain domain);
+    QuforiaClockDomain domain() const { return domain_.load(std::memory_order_relaxed); }
+
+    // `timestamp` in the input domain -> CLOCK_MONOTONIC ns
+    int64_t toMonotonic(int64_t timestamp);
+
+    // One offset for a batch of timestamps that reached the driver together (e.g. the poses
+    // queued since the last feed)
+    struct BatchMapping {
+        int64_t offset;
+        int64_t limit;  // The newest timestamp's mapped time, never past arrival
+        int64_t map(int64_t timestamp) const { return std::min(timestamp + offset, limit); }
+    };
+
+    // Maps `newest` like toMonotonic(), as the batch's only observation: the older timestamps
+    // waited in the caller's queue, not the capture pipeline
+    BatchMapping mapBatch(int64_t newest);
+
+    // Lock-free mapping for queries such as render-time pose lookups: the time may lie in the
+    // future and isn't taken as an observation. EXTERNAL uses the offset of the last mapped
+    // timestamp.
+    int64_t queryToMonotonic(int64_t timestamp) const;
+
+    // EXTERNAL: `externalNs` and `monotonicNs` denote the same instant
+    void addSyncPoint(int64_t externalNs, int64_t monotonicNs);
+
+    void state(QuforiaClockState* out);
+
+private:
+    static const int MAX_FIT_POINTS = 16;
+    static const int64_t WINDOW_NS = 1000000000LL;      // Envelope window (of input time)
+    static const int64_t MAX_AHEAD_NS = 50000000LL;     // Mapped past arrival -> reset
+    static const int64_t MAX_BEHIND_NS = 1000000000LL;  // Mapped before arrival -> reset
+
+    struct FitPoint {
+        int64_t external;
+        int64_t offset;  // monotonic - external
+    };
+
+    void resetEstimate();
+    void addFitPoint(int64_t external, int64_t offset);
+    void refit();
+    int64_t externalOffset(int64_t external) const;
+    void observe(int64_t capture, int64_t arrival);
+    int64_t estimateExternalOffset(int64_t timestamp, int64_t arrival);
+
+    std::atomic<QuforiaClockDomain> domain_;
+    std::atomic<int64_t> queryOffset_;  // EXTERNAL offset at the last mapped timestamp
+
+    // Reported by state(); concurrent feeders may overwrite each other's latency sample
+    std::atomic<int64_t> lastOffset_;
+    std::atomic<float> latencyNs_;
+
+    // Guarded by mutex_
+    std::mutex mutex_;
+    FitPoint points_[MAX_FIT_POINTS];
+    int pointCount_;
+    int nextPoint_;
+    bool haveSyncPoints_;       // Explicit sync points replace the envelope
+    int64_t windowStart_;       // First input timestamp of the open envelope window
+    int64_t windowMinOffset_;
+    int64_t windowMinExternal_;
+    bool windowOpen_;
+
+    // Fitted line: offset(t) = fitOffset_ + fitDrift_ * (t - fitBase_)
+    int64_t fitBase_;
+    int64_t fitOffset_;
+    double fitDrift_;
+    bool haveFit_;
+};
+
+#endif // QUEST_CLOCK_DOMAIN_H
@@ -0,0 +1,101 @@
+#include "driver_stats.h"
+#include <cstring>
+
+// =============================================================================
+// LatencyHistogram
+// =============================================================================
+
+void LatencyHistogram::record(int64_t valueNs) {
+    const uint64_t value = valueNs > 0 ? static_cast<uint64_t>(valueNs) : 0;
+
+    // Bucket by the bit length of the value in microseconds
+    uint64_t us = value / 1000;
+    int bucket = 0;
+    while (us != 0 && bucket < QUFORIA_HISTOGRAM_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sumNs_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t currentMax = maxNs_.load(std::memory_order_relaxed);
+    while (value > currentMax &&
+           !maxNs_.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::snapshot(QuforiaHistogram* out) const {
+    // Fields are read independently; a snapshot taken mid-record may be off by one sample
+    out->count = count_.load(std::memory_order_relaxed);
+    out->sumNs = sumNs_.load(std::memory_order_relaxed);
+    out->maxNs = maxNs_.load(std::memory_order_relaxed);
+    for (int i = 0; i < QUFORIA_HISTOGRAM_BUCKETS; i++) {
+        out->buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::reset() {
+    count_.store(0, std::memory_order_relaxed);
+    sumNs_.store(0, std::memory_order_relaxed);
+    maxNs_.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < QUFORIA_HISTOGRAM_BUCKETS; i++) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+// =============================================================================
+// DriverStats
+// =============================================================================
+
+void DriverStats::snapshot(QuforiaStats* out) const {
+    memset(out, 0, sizeof(*out));
+    out->size = sizeof(QuforiaStats);
+
+    out->framesFed = framesFed_.load(std::memory_order_relaxed);
+    out->framesRejected = framesRejected_.load(std::memory_order_relaxed);
+    out->framesDelivered = framesDelivered_.load(std::memory_order_relaxed);
+    out->framesDropped = framesDropped_.load(std::memory_order_relaxed);
+    out->framesDuplicated = framesDuplicated_.load(std::memory_order_relaxed);
+    out->framesSkipped = framesSkipped_.load(std::memory_order_relaxed);
+    out->posesFed = posesFed_.load(std::memory_order_relaxed);
+    out->posesDelivered = posesDelivered_.load(std::memory_order_relaxed);
+    out->posesMissing = posesMissing_.load(std::memory_order_relaxed);
+
+    feedToDeliverLatency_.snapshot(&out->feedToDeliverLatency);
+    poseMatchError_.snapshot(&out->poseMatchError);
+    frameCallbackTime_.snapshot(&out->frameCallbackTime);
+    mutexWaitTime_.snapshot(&out->mutexWaitTime);
+    rectifyTime_.snapshot(&out->rectifyTime);
+
+    out->framesBlurred = framesBlurred_.load(std::memory_order_relaxed);
+
+    out->cameraStarts = cameraStarts_.load(std::memory_order_relaxed);
+    out->warmStarts = warmStarts_.load(std::memory_order_relaxed);
+    startCallTime_.snapshot(&out->startCallTime);
+    startToFirstFrame_.snapshot(&out->startToFirstFrame);
+}
+
+void DriverStats::reset() {
+    framesFed_.store(0, std::memory_order_relaxed);
+    framesRejected_.store(0, std::memory_order_relaxed);
+    framesDelivered_.store(0, std::memory_order_relaxed);
+    framesDropped_.store(0, std::memory_order_relaxed);
+    framesDuplicated_.store(0, std::memory_order_relaxed);
+    framesSkipped_.store(0, std::memory_order_relaxed);
+    posesFed_.store(0, std::memory_order_relaxed);
+    posesDelivered_.store(0, std::memory_order_relaxed);
+    posesMissing_.store(0, std::memory_order_relaxed);
+    framesBlurred_.store(0, std::memory_order_relaxed);
+    cameraStarts_.store(0, std::memory_order_relaxed);
+    warmStarts_.store(0, std::memory_order_relaxed);
+
+    feedToDeliverLatency_.reset();
+    poseMatchError_.reset();
+    frameCallbackTime_.reset();
+    mutexWaitTime_.reset();
+    rectifyTime_.reset();
+    startCallTime_.reset();
+    startToFirstFrame_.reset();
+}
@@ -0,0 +1,169 @@
+#ifndef QUEST_DRIVER_STATS_H
+#define QUEST_DRIVER_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__ANDROID__) && defined(QUFORIA_ENABLE_ATRACE)
+#include <android/trace.h>
+#endif
+
+// CLOCK_MONOTONIC in nanoseconds (the clock all driver-internal latencies are measured on)
+inline int64_t monotonicNowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// Number of histogram buckets; bucket i counts samples in [2^(i-1), 2^i) microseconds,
+// bucket 0 counts samples below 1 us and the last bucket everything from ~16 s up
+static const int QUFORIA_HISTOGRAM_BUCKETS = 24;
+
+// Plain-data histogram as exported to Unity
+struct QuforiaHistogram {
+    uint64_t count;
+    uint64_t sumNs;
+    uint64_t maxNs;
+    uint64_t buckets[QUFORIA_HISTOGRAM_BUCKETS];
+};
+
+/**
+ * Snapshot returned by nativeGetStats(). Mirrored by QuestVuforiaBridge.DriverStats, so
+ * fields are only ever appended; `size` is how many bytes of it the library filled in.
+ */
+struct QuforiaStats {
+    uint32_t size;
+    uint32_t reserved;
+
+    uint64_t framesFed;         // Published to the frame ring
+    uint64_t framesRejected;    // Refused at feed time (pool exhausted, bad size, conversion)
+    uint64_t framesDelivered;   // Handed to onNewCameraFrame
+    uint64_t framesDropped;     // Overwritten in the ring before the delivery thread got to them
+    uint64_t framesDuplicated;  // Delivered with the same timestamp as the previous frame
+    uint64_t framesSkipped;     // Not matching the active camera mode
+    uint64_t posesFed;
+    uint64_t posesDelivered;
+    uint64_t posesMissing;      // Frames for which no pose could be matched
+
+    QuforiaHistogram feedToDeliverLatency;  // Publish -> onNewCameraFrame entry
+    QuforiaHistogram poseMatchError;        // |frame timestamp - nearest pose sample|
+    QuforiaHistogram frameCallbackTime;     // Time spent inside onNewCameraFrame
+    QuforiaHistogram mutexWaitTime;         // Waiting for driver mutexes on the hot path
+    QuforiaHistogram rectifyTime;           // Undistorting a frame before publishing it
+
+    uint64_t framesBlurred;     // Dropped by the quality gate as motion blurred
+
+    uint64_t cameraStarts;      // Camera start() calls that began delivery
+    uint64_t warmStarts;        // Of those, how many reused the parked delivery thread
+    QuforiaHistogram startCallTime;      // Time spent inside camera start()
+    QuforiaHistogram startToFirstFrame;  // Camera start() -> first onNewCameraFrame after it
+};
+
+// The first QuforiaStats layout (up to mutexWaitTime); callers built against it still get that
+static const size_t QUFORIA_STATS_V1_SIZE = offsetof(QuforiaStats, rectifyTime);
+
+/**
+ * Lock-free histogram with log2 microsecond buckets. record() is a handful of relaxed
+ * atomic adds, cheap enough for every frame.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram() { reset(); }
+
+    void record(int64_t valueNs);
+    void snapshot(QuforiaHistogram* out) const;
+    void reset();
+
+private:
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sumNs_;
+    std::atomic<uint64_t> maxNs_;
+    std::atomic<uint64_t> buckets_[QUFORIA_HISTOGRAM_BUCKETS];
+};
+
+/**
+ * Driver-wide hot-path counters. Every recorder is wait-free (relaxed atomics) so the
+ * producer, delivery thread and Unity readers never contend on a lock for metrics.
+ */
+class DriverStats {
+public:
+    DriverStats() { reset(); }
+
+    void frameFed() { framesFed_.fetch_add(1, std::memory_order_relaxed); }
+    void frameRejected() { framesRejected_.fetch_add(1, std::memory_order_relaxed); }
+    void framesDropped(uint64_t count) { framesDropped_.fetch_add(count, std::memory_order_relaxed); }
+    void frameDuplicated() { framesDuplicated_.fetch_add(1, std::memory_order_relaxed); }
+    void frameSkipped() { framesSkipped_.fetch_add(1, std::memory_order_relaxed); }
+    void frameBlurred() { framesBlurred_.fetch_add(1, std::memory_order_relaxed); }
+    void poseFed(uint64_t count = 1) { posesFed_.fetch_add(count, std::memory_order_relaxed); }
+    void poseDelivered() { posesDelivered_.fetch_add(1, std::memory_order_relaxed); }
+    void poseMissing() { posesMissing_.fetch_add(1, std::memory_order_relaxed); }
+
+    void frameDelivered(int64_t feedToDeliverNs, int64_t callbackNs) {
+        framesDelivered_.fetch_add(1, std::memory_order_relaxed);
+        feedToDeliverLatency_.record(feedToDeliverNs);
+        frameCallbackTime_.record(callbackNs);
+    }
+
+    void poseMatched(int64_t matchErrorNs) { poseMatchError_.record(matchErrorNs); }
+    void mutexWait(int64_t waitNs) { mutexWaitTime_.record(waitNs); }
+    void frameRectified(int64_t rectifyNs) { rectifyTime_.record(rectifyNs); }
+
+    void cameraStarted(bool warm, int64_t callNs) {
+        cameraStarts_.fetch_add(1, std::memory_order_relaxed);
+        if (warm) {
+            warmStarts_.fetch_add(1, std::memory_order_relaxed);
+        }
+        startCallTime_.record(callNs);
+    }
+    void firstFrameDelivered(int64_t sinceStartNs) { startToFirstFrame_.record(sinceStartNs); }
+
+    void snapshot(QuforiaStats* out) const;
+    void reset();
+
+private:
+    std::atomic<uint64_t> framesFed_;
+    std::atomic<uint64_t> framesRejected_;
+    std::atomic<uint64_t> framesDelivered_;
+    std::atomic<uint64_t> framesDropped_;
+    std::atomic<uint64_t> framesDuplicated_;
+    std::atomic<uint64_t> framesSkipped_;
+    std::atomic<uint64_t> posesFed_;
+    std::atomic<uint64_t> posesDelivered_;
+    std::atomic<uint64_t> posesMissing_;
+    std::atomic<uint64_t> framesBlurred_;
+    std::atomic<uint64_t> cameraStarts_;
+    std::atomic<uint64_t> warmStarts_;
+
+    LatencyHistogram feedToDeliverLatency_;
+    LatencyHistogram poseMatchError_;
+    LatencyHistogram frameCallbackTime_;
+    LatencyHistogram mutexWaitTime_;
+    LatencyHistogram rectifyTime_;
+    LatencyHistogram startCallTime_;
+    LatencyHistogram startToFirstFrame_;
+};
+
+/**
+ * ATrace section for systrace/Perfetto, compiled in only with QUFORIA_ENABLE_ATRACE
+ * (CMake option QUFORIA_ATRACE). Otherwise QUFORIA_TRACE_SCOPE expands to nothing.
+ */
+#if defined(__ANDROID__) && defined(QUFORIA_ENABLE_ATRACE)
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) { ATrace_beginSection(name); }
+    ~TraceScope() { ATrace_endSection(); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+#define QUFORIA_TRACE_CONCAT_(a, b) a##b
+#define QUFORIA_TRACE_CONCAT(a, b) QUFORIA_TRACE_CONCAT_(a, b)
+#define QUFORIA_TRACE_SCOPE(name) TraceScope QUFORIA_TRACE_CONCAT(traceScope_, __LINE__)(name)
+#else
+#define QUFORIA_TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif // QUEST_DRIVER_STATS_H
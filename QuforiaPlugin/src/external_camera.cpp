@@ -1,32 +1,61 @@
 #include "external_camera.h"
 #include "vuforia_driver.h"
-#include <android/log.h>
+#include "pixel_convert.h"
+#include "thread_config.h"
+#include "quforia_log.h"
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <cstring>
-
-#define LOG_TAG "QUFORIA"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#include <cstdint>
+
+// Camera modes advertised to Vuforia. RGB888 stays first as the default; RGBA8888 lets the
+// Unity Color32 buffer pass straight through and the YUV 4:2:0 layouts carry half the bytes.
+// The 640x480 modes are box-filtered from full-resolution input for thermally throttled
+// sessions where tracking at lower resolution beats dropping frames. The 960x720 modes are
+// a window cut from the full frame (centred, or wherever Unity moves it) at full detail.
+static const VuforiaDriver::CameraMode kSupportedModes[] = {
+    { 1280, 960, 30, VuforiaDriver::PixelFormat::RGB888 },
+    { 1280, 960, 30, VuforiaDriver::PixelFormat::RGBA8888 },
+    { 1280, 960, 30, VuforiaDriver::PixelFormat::NV21 },
+    { 1280, 960, 30, VuforiaDriver::PixelFormat::NV12 },
+    { 1280, 960, 30, VuforiaDriver::PixelFormat::YUV420P },
+    {  640, 480, 30, VuforiaDriver::PixelFormat::NV21 },
+    {  640, 480, 30, VuforiaDriver::PixelFormat::RGB888 },
+    {  960, 720, 30, VuforiaDriver::PixelFormat::NV21 },
+    {  960, 720, 30, VuforiaDriver::PixelFormat::RGB888 },
+};
+static const uint32_t kNumSupportedModes = sizeof(kSupportedModes) / sizeof(kSupportedModes[0]);
+static_assert(kNumSupportedModes <= 16, "QuestExternalCamera::modes_ is too small");
 
 QuestExternalCamera::QuestExternalCamera(QuestVuforiaDriver* driver)
     : driver_(driver)
     , callback_(nullptr)
     , isRunning_(false)
     , isOpen_(false)
+    , parked_(false)
+    , exiting_(false)
+    , startTimeNs_(0)
+    , startSequence_(0)
     , exposureMode_(VuforiaDriver::ExposureMode::CONTINUOUS_AUTO)
     , focusMode_(VuforiaDriver::FocusMode::CONTINUOUS_AUTO)
-    , frameBuffer_(nullptr)
+    , lastExposureNs_(0)
 {
     LOGI("QuestExternalCamera constructor");
 
-    // Initialize default camera mode (1280x960 @ 30fps RGB888)
-    currentMode_.width = 1280;
-    currentMode_.height = 960;
-    currentMode_.fps = 30;
-    currentMode_.format = VuforiaDriver::PixelFormat::RGB888;
+    // Advertise the modes the frame pool was sized for, in kSupportedModes order
+    numModes_ = 0;
+    for (uint32_t i = 0; i < kNumSupportedModes; i++) {
+        if (driver_->supportsCameraMode(kSupportedModes[i])) {
+            modes_[numModes_++] = kSupportedModes[i];
+        } else {
+            LOGI("Not advertising %ux%u %s: over the memory budget", kSupportedModes[i].width,
+                 kSupportedModes[i].height, pixelFormatName(kSupportedModes[i].format));
+        }
+    }
+
+    // Default camera mode: the first advertised (1280x960 @ 30fps RGB888 without limits)
+    currentMode_ = modes_[0];
 }
 
 QuestExternalCamera::~QuestExternalCamera() {
@@ -34,11 +63,7 @@ QuestExternalCamera::~QuestExternalCamera() {
 
     stop();
     close();
-
-    if (frameBuffer_) {
-        delete[] frameBuffer_;
-        frameBuffer_ = nullptr;
-    }
+    exitDeliveryThread();
 }
 
 // =============================================================================
@@ -53,15 +78,7 @@ bool QuestExternalCamera::open() {
         return true;
     }
 
-    // Allocate frame buffer
-    int bufferSize = currentMode_.width * currentMode_.height * 3;  // RGB888
-    frameBuffer_ = new uint8_t[bufferSize];
-
-    if (!frameBuffer_) {
-        LOGE("Failed to allocate frame buffer");
-        return false;
-    }
-
+    // Nothing to allocate: frames live in the driver's pool, allocated at init
     isOpen_ = true;
     LOGI("Camera opened successfully");
     return true;
@@ -80,13 +97,7 @@ bool QuestExternalCamera::close() {
         stop();
     }
 
-    // Free frame buffer
-    if (frameBuffer_) {
-        std::lock_guard<std::mutex> lock(bufferMutex_);
-        delete[] frameBuffer_;
-        frameBuffer_ = nullptr;
-    }
-
+    // The delivery thread stays parked and the frame pool allocated for the next open()
     isOpen_ = false;
     LOGI("Camera closed");
     return true;
@@ -94,8 +105,9 @@ bool QuestExternalCamera::close() {
 
 bool QuestExternalCamera::start(VuforiaDriver::CameraMode mode,
                                 VuforiaDriver::CameraCallback* callback) {
-    LOGI("start() with mode: %ux%u@%ufps, format=%d",
-         mode.width, mode.height, mode.fps, mode.format);
+    const int64_t startNs = monotonicNowNs();
+    LOGI("start() with mode: %ux%u@%ufps, format=%s",
+         mode.width, mode.height, mode.fps, pixelFormatName(mode.format));
 
     if (!isOpen_) {
         LOGE("Camera not open");
@@ -112,23 +124,54 @@ bool QuestExternalCamera::start(VuforiaDriver::CameraMode mode,
         return false;
     }
 
-    // Validate mode (we only support one mode for now)
-    if (mode.width != currentMode_.width ||
-        mode.height != currentMode_.height ||
-        mode.format != currentMode_.format) {
-        LOGE("Unsupported camera mode: %ux%u, format=%d",
-             mode.width, mode.height, mode.format);
+    // Validate mode against the advertised list
+    bool supported = false;
+    for (uint32_t i = 0; i < numModes_; i++) {
+        if (mode.width == modes_[i].width &&
+            mode.height == modes_[i].height &&
+            mode.format == modes_[i].format) {
+            supported = true;
+            break;
+        }
+    }
+
+    if (!supported) {
+        LOGE("Unsupported camera mode: %ux%u, format=%s",
+             mode.width, mode.height, pixelFormatName(mode.format));
         return false;
     }
 
     currentMode_ = mode;
     callback_ = callback;
-    isRunning_ = true;
 
-    // Start frame delivery thread
-    frameThread_ = std::thread(&QuestExternalCamera::frameDeliveryThread, this);
+    // Frames still in the ring from before this session (the last ones before stop()) are
+    // not delivered: the session starts after the newest one
+    const uint64_t startSequence = driver_->latestFrameSequence();
+
+    // Producers normalize frames to this mode's format from now on. The delivery thread
+    // is parked (or not created yet), so resetting its policies here is safe.
+    driver_->setActiveCameraMode(&currentMode_);
+    driver_->governor().reset(mode.fps);
+    driver_->qualityGate().reset();
+    driver_->motionThrottle().reset();
+
+    // Resume the parked delivery thread; only the first start() creates it
+    const bool warm = frameThread_.joinable();
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        startTimeNs_ = startNs;
+        startSequence_ = startSequence;
+        isRunning_ = true;
+    }
+    if (warm) {
+        parkCv_.notify_all();
+    } else {
+        frameThread_ = std::thread(&QuestExternalCamera::frameDeliveryThread, this);
+    }
 
-    LOGI("Camera started successfully");
+    const int64_t callNs = monotonicNowNs() - startNs;
+    driver_->stats().cameraStarted(warm, callNs);
+    LOGI("Camera started successfully (%s, %.3f ms)", warm ? "warm" : "cold", callNs / 1e6);
     return true;
 }
 
@@ -140,12 +183,18 @@ bool QuestExternalCamera::stop() {
         return true;
     }
 
-    // Signal thread to stop
-    isRunning_ = false;
+    // Signal the thread to stop and wake it if it is waiting for a frame
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        isRunning_ = false;
+    }
+    driver_->setActiveCameraMode(nullptr);
+    driver_->wakeFrameWaiters();
 
-    // Wait for thread to finish
-    if (frameThread_.joinable()) {
-        frameThread_.join();
+    // Wait until it has parked: no callback runs once stop() returns
+    {
+        std::unique_lock<std::mutex> lock(parkMutex_);
+        parkCv_.wait(lock, [this] { return parked_; });
     }
 
     callback_ = nullptr;
@@ -158,27 +207,28 @@ bool QuestExternalCamera::stop() {
 // =============================================================================
 
 uint32_t QuestExternalCamera::getNumSupportedCameraModes() {
-    // We support one camera mode: 1280x960@30fps RGB888
-    return 1;
+    return numModes_;
 }
 
 bool QuestExternalCamera::getSupportedCameraMode(uint32_t index,
                                                  VuforiaDriver::CameraMode* cameraMode) {
-    if (index != 0 || cameraMode == nullptr) {
+    if (index >= numModes_ || cameraMode == nullptr) {
         return false;
     }
 
-    // Return the single supported mode
-    cameraMode->width = 1280;
-    cameraMode->height = 960;
-    cameraMode->fps = 30;
-    cameraMode->format = VuforiaDriver::PixelFormat::RGB888;
+    *cameraMode = modes_[index];
 
-    LOGD("getSupportedCameraMode(%u): %ux%u@%ufps",
-         index, cameraMode->width, cameraMode->height, cameraMode->fps);
+    LOGD("getSupportedCameraMode(%u): %ux%u@%ufps %s",
+         index, cameraMode->width, cameraMode->height, cameraMode->fps,
+         pixelFormatName(cameraMode->format));
     return true;
 }
 
+const VuforiaDriver::CameraMode* QuestExternalCamera::allCameraModes(uint32_t* count) {
+    *count = kNumSupportedModes;
+    return kSupportedModes;
+}
+
 // =============================================================================
 // Exposure Control
 // =============================================================================
@@ -194,12 +244,12 @@ VuforiaDriver::ExposureMode QuestExternalCamera::getExposureMode() {
 
 bool QuestExternalCamera::setExposureMode(VuforiaDriver::ExposureMode mode) {
     if (!supportsExposureMode(mode)) {
-        LOGW("Unsupported exposure mode: %d", mode);
+        LOGW("Unsupported exposure mode: %d", static_cast<int>(mode));
         return false;
     }
 
     exposureMode_ = mode;
-    LOGD("Exposure mode set to: %d", mode);
+    LOGD("Exposure mode set to: %d", static_cast<int>(mode));
     return true;
 }
 
@@ -218,12 +268,12 @@ VuforiaDriver::FocusMode QuestExternalCamera::getFocusMode() {
 
 bool QuestExternalCamera::setFocusMode(VuforiaDriver::FocusMode mode) {
     if (!supportsFocusMode(mode)) {
-        LOGW("Unsupported focus mode: %d", mode);
+        LOGW("Unsupported focus mode: %d", static_cast<int>(mode));
         return false;
     }
 
     focusMode_ = mode;
-    LOGD("Focus mode set to: %d", mode);
+    LOGD("Focus mode set to: %d", static_cast<int>(mode));
     return true;
 }
 
@@ -245,7 +295,9 @@ uint64_t QuestExternalCamera::getExposureValueMax() {
 }
 
 uint64_t QuestExternalCamera::getExposureValue() {
-    return 33333333;  // Return nominal 33.33ms @ 30fps
+    // Exposure of the last delivered frame, a full frame interval until one is known
+    const uint64_t exposure = lastExposureNs_.load(std::memory_order_relaxed);
+    return exposure != 0 ? exposure : 1000000000ULL / std::max(currentMode_.fps, 1u);
 }
 
 bool QuestExternalCamera::setExposureValue(uint64_t exposureTime) {
@@ -285,59 +337,154 @@ bool QuestExternalCamera::setFocusValue(float focusValue) {
 // Frame Delivery Thread
 // =============================================================================
 
+void QuestExternalCamera::exitDeliveryThread() {
+    if (!frameThread_.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        exiting_ = true;
+    }
+    parkCv_.notify_all();
+    frameThread_.join();
+}
+
 void QuestExternalCamera::frameDeliveryThread() {
+    ScopedThreadRole threadRole(QuforiaThreadRole::FRAME_DELIVERY, "QuforiaFrames");
     LOGI("Frame delivery thread started");
 
-    const int targetFPS = currentMode_.fps;
-    const auto frameDuration = std::chrono::milliseconds(1000 / targetFPS);
+    for (;;) {
+        {
+            // Park until the next start() (the first one has already set isRunning_)
+            std::unique_lock<std::mutex> lock(parkMutex_);
+            parked_ = true;
+            parkCv_.notify_all();
+            parkCv_.wait(lock, [this] { return exiting_ || isRunning_.load(); });
+            if (exiting_) {
+                break;
+            }
+            parked_ = false;
+        }
+        deliverFrames();
+    }
+
+    LOGI("Frame delivery thread exiting");
+}
+
+void QuestExternalCamera::deliverFrames() {
+    // Wake up periodically even without frames so stop() is noticed promptly
+    const auto waitTimeout = std::chrono::milliseconds(100);
 
     int frameCount = 0;
+    uint64_t droppedCount = 0;
+    uint64_t mismatchCount = 0;
+    uint64_t lastSequence = startSequence_;
+    int64_t lastTimestamp = INT64_MIN;
+    DriverStats& stats = driver_->stats();
+    FrameGovernor& governor = driver_->governor();
+    FrameQualityGate& quality = driver_->qualityGate();
+    MotionThrottle& throttle = driver_->motionThrottle();
+    bool firstFrame = true;
+
+    // Reported for frames fed without exposure metadata: a full frame interval
+    const uint64_t nominalExposureNs = 1000000000ULL / std::max(currentMode_.fps, 1u);
 
     while (isRunning_) {
-        auto frameStartTime = std::chrono::steady_clock::now();
-
-        // Acquire latest frame from driver
-        auto frameData = driver_->acquireLatestFrame();
-
-        if (frameData && callback_) {
-            // Prepare Vuforia frame structure
-            VuforiaDriver::CameraFrame vuforiaFrame;
-            memset(&vuforiaFrame, 0, sizeof(vuforiaFrame));
-
-            // Set frame data
-            vuforiaFrame.buffer = frameData->imageData;
-            vuforiaFrame.width = frameData->width;
-            vuforiaFrame.height = frameData->height;
-            vuforiaFrame.stride = frameData->width * 3;  // RGB888: 3 bytes per pixel
-            vuforiaFrame.bufferSize = vuforiaFrame.stride * frameData->height;
-            vuforiaFrame.format = VuforiaDriver::PixelFormat::RGB888;
-            vuforiaFrame.timestamp = frameData->timestamp;
-            vuforiaFrame.exposureTime = 33333333;  // 33.33ms @ 30fps (nanoseconds)
-            vuforiaFrame.intrinsics = frameData->intrinsics;
-
-            // Deliver frame to Vuforia (pass pointer, not value)
-            callback_->onNewCameraFrame(&vuforiaFrame);
+        // Sleep until feedCameraFrame publishes something we haven't delivered yet
+        uint64_t sequence = 0;
+        auto frameData = driver_->waitForNextFrame(lastSequence, &sequence, waitTimeout);
+
+        if (!frameData || !callback_) {
+            continue;
+        }
 
-            frameCount++;
-            if (frameCount % 30 == 0) {
-                LOGD("Delivered %d frames (latest timestamp: %lld)",
-                     frameCount, (long long)frameData->timestamp);
+        // Sequence gaps are frames that were overwritten before we got to them
+        if (lastSequence != 0 && sequence > lastSequence + 1) {
+            droppedCount += sequence - lastSequence - 1;
+            stats.framesDropped(sequence - lastSequence - 1);
+        }
+        lastSequence = sequence;
+
+        // Frames published before start() (or fed at a size we can't scale) don't match the mode
+        if (frameData->format != currentMode_.format ||
+            static_cast<uint32_t>(frameData->width) != currentMode_.width ||
+            static_cast<uint32_t>(frameData->height) != currentMode_.height) {
+            stats.frameSkipped();
+            if (mismatchCount++ == 0) {
+                LOGW("Skipping %dx%d %s frame, camera mode is %ux%u %s",
+                     frameData->width, frameData->height, pixelFormatName(frameData->format),
+                     currentMode_.width, currentMode_.height, pixelFormatName(currentMode_.format));
             }
-        } else {
-            // No frame available, wait a bit
-            LOGD("No frame available from driver");
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
         }
 
-        // Sleep to maintain target frame rate
-        auto frameEndTime = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            frameEndTime - frameStartTime);
+        // Shed frames while Vuforia can't keep up with the input rate
+        if (!governor.shouldDeliver(sequence, frameData->timestamp)) {
+            continue;
+        }
+
+        // Head motion at capture time, for the motion-aware policies below
+        PoseMotion motion;
+        const bool hasMotion = (throttle.isEnabled() || quality.isEnabled()) &&
+                               driver_->motionAt(frameData->midExposureTimestamp(), &motion);
+
+        // Deliver fewer frames while the headset is static
+        if (!throttle.shouldDeliver(frameData->timestamp, hasMotion ? &motion : nullptr)) {
+            continue;
+        }
+
+        // Drop frames smeared by fast head turns; Vuforia would spend a callback on them for nothing
+        if (!quality.shouldDeliver(*frameData.get(), hasMotion ? motion.angularSpeed : -1.0f)) {
+            stats.frameBlurred();
+            continue;
+        }
+
+        // Prepare Vuforia frame structure
+        VuforiaDriver::CameraFrame vuforiaFrame;
+
+        // Set frame data
+        vuforiaFrame.buffer = frameData->imageData;
+        vuforiaFrame.width = frameData->width;
+        vuforiaFrame.height = frameData->height;
+        vuforiaFrame.stride = frameData->stride;
+        vuforiaFrame.bufferSize = static_cast<uint32_t>(frameData->size);
+        vuforiaFrame.format = frameData->format;
+        vuforiaFrame.timestamp = frameData->timestamp;
+        vuforiaFrame.exposureTime = frameData->exposureTimeNs != 0 ? frameData->exposureTimeNs
+                                                                   : nominalExposureNs;
+        lastExposureNs_.store(frameData->exposureTimeNs, std::memory_order_relaxed);
+        vuforiaFrame.index = static_cast<uint32_t>(sequence);
+        vuforiaFrame.intrinsics = frameData->intrinsics;
+
+        if (frameData->timestamp == lastTimestamp) {
+            stats.frameDuplicated();
+        }
+        lastTimestamp = frameData->timestamp;
+
+        // Pose for this frame first (Vuforia requires pose-before-frame), then the frame
+        driver_->deliverPoseForFrame(*frameData.get());
+
+        const int64_t callbackStart = monotonicNowNs();
+        {
+            QUFORIA_TRACE_SCOPE("quforia::onNewCameraFrame");
+            callback_->onNewCameraFrame(&vuforiaFrame);
+        }
+        const int64_t callbackNs = monotonicNowNs() - callbackStart;
+        stats.frameDelivered(callbackStart - frameData->publishTimeNs, callbackNs);
+        if (firstFrame) {
+            stats.firstFrameDelivered(callbackStart - startTimeNs_);
+            firstFrame = false;
+        }
+        governor.frameDelivered(callbackNs, driver_->latestFrameSequence() - sequence);
 
-        if (elapsed < frameDuration) {
-            std::this_thread::sleep_for(frameDuration - elapsed);
+        frameCount++;
+        if (frameCount % 30 == 0) {
+            LOGD("Delivered %d frames, dropped %llu (latest timestamp: %lld)",
+                 frameCount, (unsigned long long)droppedCount, (long long)frameData->timestamp);
         }
     }
 
-    LOGI("Frame delivery thread stopped (delivered %d frames)", frameCount);
+    LOGI("Frame delivery stopped (delivered %d frames, dropped %llu)",
+         frameCount, (unsigned long long)droppedCount);
 }
@@ -2,8 +2,11 @@
 #define QUEST_EXTERNAL_CAMERA_H
 
 #include <VuforiaEngine/Driver/Driver.h>
+#include <cstddef>
+#include <cstdint>
 #include <thread>
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 
 // Forward declaration
@@ -12,6 +15,12 @@ class QuestVuforiaDriver;
 /**
  * ExternalCamera implementation for Meta Quest passthrough camera.
  * Handles camera lifecycle and frame delivery to Vuforia Engine.
+ *
+ * Vuforia stops and restarts the camera on every app focus change, so the delivery thread
+ * is created by the first start() and then parks on a condition variable between stop() and
+ * the next start() instead of being joined and recreated; it only exits with the camera
+ * object. stop() still returns only once the thread is parked, so no callback runs after it.
+ * Frame memory lives in the driver's pre-faulted pool and survives open()/close() as well.
  */
 class QuestExternalCamera : public VuforiaDriver::ExternalCamera {
 public:
@@ -50,25 +59,44 @@ public:
     virtual float getFocusValue() override;
     virtual bool setFocusValue(float focusValue) override;
 
+    // Every camera mode the camera can produce; the advertised ones are those whose frames
+    // fit the driver's memory layout
+    static const VuforiaDriver::CameraMode* allCameraModes(uint32_t* count);
+
 private:
-    // Frame delivery thread
+    // Frame delivery thread: parks until start(), delivers until stop(), repeats
     void frameDeliveryThread();
+    // One start() .. stop() session of delivering frames
+    void deliverFrames();
+    // Wake the parked delivery thread and wait for it to exit (destructor)
+    void exitDeliveryThread();
 
     QuestVuforiaDriver* driver_;
     VuforiaDriver::CameraCallback* callback_;
     VuforiaDriver::CameraMode currentMode_;
 
+    // Modes advertised to Vuforia (allCameraModes() within the memory budget)
+    static const uint32_t MAX_CAMERA_MODES = 16;
+    VuforiaDriver::CameraMode modes_[MAX_CAMERA_MODES];
+    uint32_t numModes_;
+
     std::thread frameThread_;
     std::atomic<bool> isRunning_;
     std::atomic<bool> isOpen_;
 
+    // Delivery thread parking, guarded by parkMutex_
+    std::mutex parkMutex_;
+    std::condition_variable parkCv_;
+    bool parked_;         // Waiting for the next start()
+    bool exiting_;
+    int64_t startTimeNs_; // start() entry of the current session, for first-frame latency
+    uint64_t startSequence_;  // Newest frame before start(); the session delivers later ones
+
     // Exposure and focus settings
     VuforiaDriver::ExposureMode exposureMode_;
     VuforiaDriver::FocusMode focusMode_;
-
-    // Frame buffer for conversion
-    uint8_t* frameBuffer_;
-    std::mutex bufferMutex_;
+    // Exposure of the last delivered frame (0 = not reported), for getExposureValue()
+    std::atomic<uint64_t> lastExposureNs_;
 };
 
 #endif // QUEST_EXTERNAL_CAMERA_H
@@ -1,23 +1,16 @@
 #include "external_tracker.h"
 #include "vuforia_driver.h"
-#include <android/log.h>
-#include <chrono>
-#include <thread>
-#include <cstring>
-#include <cmath>
-
-#define LOG_TAG "QUFORIA"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#include "pose_transform.h"
+#include "quforia_log.h"
 
 QuestExternalTracker::QuestExternalTracker(QuestVuforiaDriver* driver)
     : driver_(driver)
     , callback_(nullptr)
+    , anchorCallback_(nullptr)
     , isRunning_(false)
     , isOpen_(false)
     , lastPoseTimestamp_(0)
+    , poseCount_(0)
 {
     LOGI("QuestExternalTracker constructor");
 }
@@ -82,14 +75,19 @@ bool QuestExternalTracker::start(VuforiaDriver::PoseCallback* cb, VuforiaDriver:
     }
 
     callback_ = cb;
-    // anchorCb is optional and not used (anchor support not implemented)
-    (void)anchorCb;
+    anchorCallback_ = anchorCb;
 
     isRunning_ = true;
     lastPoseTimestamp_ = 0;
+    poseCount_ = 0;
 
-    // Start pose delivery thread
-    poseThread_ = std::thread(&QuestExternalTracker::poseDeliveryThread, this);
+    // Anchors Unity already knows (e.g. persisted ones) are news to this Vuforia session
+    if (anchorCallback_) {
+        driver_->anchors().announceAll();
+    }
+
+    // Poses are delivered from the camera's delivery thread, ahead of each frame
+    driver_->setPoseSink(this);
 
     LOGI("Tracker started successfully");
     return true;
@@ -103,16 +101,13 @@ bool QuestExternalTracker::stop() {
         return true;
     }
 
-    // Signal thread to stop
+    // Unregister from the delivery thread; waits for an in-flight onNewPose to return
+    driver_->setPoseSink(nullptr);
     isRunning_ = false;
 
-    // Wait for thread to finish
-    if (poseThread_.joinable()) {
-        poseThread_.join();
-    }
-
     callback_ = nullptr;
-    LOGI("Tracker stopped");
+    anchorCallback_ = nullptr;
+    LOGI("Tracker stopped (delivered %d poses)", poseCount_);
     return true;
 }
 
@@ -129,163 +124,98 @@ bool QuestExternalTracker::resetTracking() {
 }
 
 // =============================================================================
-// Pose Delivery Thread
+// Pose Delivery
 // =============================================================================
 
-void QuestExternalTracker::poseDeliveryThread() {
-    LOGI("Pose delivery thread started");
-
-    int poseCount = 0;
-    const auto pollInterval = std::chrono::milliseconds(10);  // Poll every 10ms
-
-    while (isRunning_) {
-        auto pollStartTime = std::chrono::steady_clock::now();
-
-        // Acquire latest frame to get its timestamp
-        auto frameData = driver_->acquireLatestFrame();
-
-        if (frameData && callback_) {
-            int64_t frameTimestamp = frameData->timestamp;
-
-            // Only deliver pose if timestamp is new (avoid duplicates)
-            if (frameTimestamp != lastPoseTimestamp_) {
-                // Acquire pose for this frame's timestamp
-                auto poseData = driver_->acquirePoseForTimestamp(frameTimestamp);
-
-                if (poseData) {
-                    // Transform pose from OpenXR to Vuforia CV convention
-                    float transformedPosition[3];
-                    float transformedRotation[9];  // 3x3 rotation matrix
-
-                    transformOpenXRToCV(poseData->position, poseData->rotation,
-                                       transformedPosition, transformedRotation);
-
-                    // Prepare Vuforia pose structure
-                    VuforiaDriver::Pose vuforiaPose;
-                    vuforiaPose.timestamp = frameTimestamp;
-                    memcpy(vuforiaPose.translationData, transformedPosition, 3 * sizeof(float));
-                    memcpy(vuforiaPose.rotationData, transformedRotation, 9 * sizeof(float));
-                    vuforiaPose.reason = VuforiaDriver::PoseReason::VALID;
-                    vuforiaPose.coordinateSystem = VuforiaDriver::PoseCoordSystem::CAMERA;
-                    vuforiaPose.validity = VuforiaDriver::PoseValidity::VALID;
-
-                    // **CRITICAL:** Deliver pose BEFORE frame
-                    // This is a requirement of the Vuforia Driver Framework
-                    callback_->onNewPose(&vuforiaPose);
-
-                    lastPoseTimestamp_ = frameTimestamp;
-                    poseCount++;
-
-                    if (poseCount % 30 == 0) {
-                        LOGD("Delivered %d poses (latest timestamp: %lld)",
-                             poseCount, (long long)frameTimestamp);
-                    }
-                } else {
-                    LOGD("No pose available for timestamp %lld", (long long)frameTimestamp);
-                }
-            }
-        }
+bool QuestExternalTracker::deliverPose(int64_t frameTimestamp, int64_t sampleTimestamp) {
+    if (!callback_) {
+        return false;
+    }
 
-        // Sleep to avoid busy waiting
-        auto pollEndTime = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            pollEndTime - pollStartTime);
+    // Only deliver pose if timestamp is new (avoid duplicates)
+    if (frameTimestamp == lastPoseTimestamp_) {
+        return true;
+    }
 
-        if (elapsed < pollInterval) {
-            std::this_thread::sleep_for(pollInterval - elapsed);
-        }
+    // Acquire pose for the moment this frame was exposed
+    PoseData poseData;
+    if (!driver_->acquirePoseForTimestamp(sampleTimestamp, &poseData)) {
+        LOGD("No pose available for timestamp %lld", (long long)sampleTimestamp);
+        return false;
+    }
+
+    return deliverPose(frameTimestamp, poseData);
+}
+
+bool QuestExternalTracker::deliverPose(int64_t frameTimestamp, const PoseData& poseData) {
+    if (!callback_) {
+        return false;
     }
 
-    LOGI("Pose delivery thread stopped (delivered %d poses)", poseCount);
+    if (frameTimestamp == lastPoseTimestamp_) {
+        return true;
+    }
+
+    // Transform pose from OpenXR to Vuforia CV convention
+    PoseMatrix34 matrix;
+    transformPosesOpenXRToCV(&poseData, 1, &matrix);
+
+    // Prepare Vuforia pose structure
+    VuforiaDriver::Pose vuforiaPose;
+    vuforiaPose.timestamp = frameTimestamp;
+    splitPoseMatrix(matrix, vuforiaPose.translationData, vuforiaPose.rotationData);
+    vuforiaPose.reason = VuforiaDriver::PoseReason::VALID;
+    vuforiaPose.coordinateSystem = VuforiaDriver::PoseCoordSystem::CAMERA;
+    vuforiaPose.validity = VuforiaDriver::PoseValidity::VALID;
+
+    // **CRITICAL:** Deliver pose BEFORE frame
+    // This is a requirement of the Vuforia Driver Framework; the caller sends the frame next
+    callback_->onNewPose(&vuforiaPose);
+    driver_->stats().poseDelivered();
+
+    lastPoseTimestamp_ = frameTimestamp;
+    poseCount_++;
+
+    if (poseCount_ % 30 == 0) {
+        LOGD("Delivered %d poses (latest timestamp: %lld)",
+             poseCount_, (long long)frameTimestamp);
+    }
+    return true;
 }
 
 // =============================================================================
-// Coordinate System Transformation
+// Anchors
 // =============================================================================
 
-void QuestExternalTracker::transformOpenXRToCV(const float* positionIn, const float* rotationIn,
-                                               float* positionOut, float* rotationOut) {
-    /**
-     * Coordinate system transformation:
-     *
-     * Unity/OpenXR convention:
-     *   X: Right
-     *   Y: Up
-     *   Z: Back (toward user)
-     *   Handedness: Left-handed
-     *
-     * Vuforia CV convention:
-     *   X: Right
-     *   Y: Down
-     *   Z: Away from camera (into scene)
-     *   Handedness: Right-handed
-     *
-     * Transformation:
-     *   X' = X (unchanged)
-     *   Y' = -Y (flip Y axis: up → down)
-     *   Z' = -Z (flip Z axis: back → forward)
-     */
-
-    // Transform position
-    positionOut[0] = positionIn[0];   // X unchanged
-    positionOut[1] = -positionIn[1];  // Y flipped
-    positionOut[2] = -positionIn[2];  // Z flipped
-
-    // Transform rotation (quaternion to rotation matrix)
-    // Input quaternion: (x, y, z, w)
-    float qx = rotationIn[0];
-    float qy = rotationIn[1];
-    float qz = rotationIn[2];
-    float qw = rotationIn[3];
-
-    // Apply 180-degree rotation around X-axis to flip Y and Z
-    // This is equivalent to: R_cv = R_x(180°) * R_openxr
-    // R_x(180°) = [1, 0, 0; 0, -1, 0; 0, 0, -1]
-
-    // Transform the quaternion
-    // q' = q_x(180°) * q_openxr
-    // q_x(180°) = (1, 0, 0, 0) - represents 180° rotation around X
-    float transformedQuat[4];
-    transformedQuat[0] = qw;   // x' = w (from quaternion multiplication)
-    transformedQuat[1] = -qz;  // y' = -z
-    transformedQuat[2] = -qy;  // z' = -y
-    transformedQuat[3] = qx;   // w' = x
-
-    // Convert transformed quaternion to 3x3 rotation matrix (row-major)
-    quaternionToMatrix(transformedQuat, rotationOut);
+const char* QuestExternalTracker::createAnchor(VuforiaDriver::AnchorPose* anchorPose) {
+    if (!anchorPose) {
+        LOGE("createAnchor: null pose");
+        return nullptr;
+    }
+    return driver_->anchors().create(*anchorPose);
+}
+
+bool QuestExternalTracker::removeAnchor(const char* uuid) {
+    return driver_->anchors().remove(uuid);
 }
 
-void QuestExternalTracker::quaternionToMatrix(const float* quat, float* matrix) {
-    /**
-     * Convert quaternion (x, y, z, w) to 3x3 rotation matrix (row-major)
-     * Reference: https://www.euclideanspace.com/maths/geometry/rotations/conversions/quaternionToMatrix/
-     */
-
-    float x = quat[0];
-    float y = quat[1];
-    float z = quat[2];
-    float w = quat[3];
-
-    float xx = x * x;
-    float xy = x * y;
-    float xz = x * z;
-    float xw = x * w;
-    float yy = y * y;
-    float yz = y * z;
-    float yw = y * w;
-    float zz = z * z;
-    float zw = z * w;
-
-    // Row-major 3x3 matrix
-    matrix[0] = 1.0f - 2.0f * (yy + zz);  // m00
-    matrix[1] = 2.0f * (xy - zw);         // m01
-    matrix[2] = 2.0f * (xz + yw);         // m02
-
-    matrix[3] = 2.0f * (xy + zw);         // m10
-    matrix[4] = 1.0f - 2.0f * (xx + zz);  // m11
-    matrix[5] = 2.0f * (yz - xw);         // m12
-
-    matrix[6] = 2.0f * (xz - yw);         // m20
-    matrix[7] = 2.0f * (yz + xw);         // m21
-    matrix[8] = 1.0f - 2.0f * (xx + yy);  // m22
+void QuestExternalTracker::deliverAnchorUpdates() {
+    if (!anchorCallback_) {
+        return;
+    }
+
+    // Removals first, so a UUID that is dropped and re-added in one go ends up present
+    static const VuforiaDriver::AnchorStatus ORDER[] = {
+        VuforiaDriver::AnchorStatus::REMOVED,
+        VuforiaDriver::AnchorStatus::ADDED,
+        VuforiaDriver::AnchorStatus::UPDATED,
+        VuforiaDriver::AnchorStatus::PAUSED,
+    };
+    AnchorStore& anchors = driver_->anchors();
+    for (VuforiaDriver::AnchorStatus status : ORDER) {
+        const int count = anchors.takeUpdates(status, anchorBatch_, AnchorStore::MAX_ANCHORS);
+        if (count > 0) {
+            anchorCallback_->onAnchorUpdate(anchorBatch_, count, status);
+        }
+    }
 }
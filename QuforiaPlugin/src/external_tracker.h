@@ -2,7 +2,8 @@
 #define QUEST_EXTERNAL_TRACKER_H
 
 #include <VuforiaEngine/Driver/Driver.h>
-#include <thread>
+#include "pose_ring.h"
+#include "anchor_store.h"
 #include <atomic>
 #include <mutex>
 
@@ -12,6 +13,10 @@ class QuestVuforiaDriver;
 /**
  * ExternalPositionalDeviceTracker implementation for Meta Quest 6DoF tracking.
  * Handles pose delivery to Vuforia Engine with coordinate system transformation.
+ *
+ * The tracker has no thread of its own: while started it is registered with the driver
+ * as the pose sink, and the camera's delivery thread calls deliverPose() right before
+ * each onNewCameraFrame, which guarantees pose-before-frame ordering.
  */
 class QuestExternalTracker : public VuforiaDriver::ExternalPositionalDeviceTracker {
 public:
@@ -25,25 +30,33 @@ public:
     virtual bool stop() override;
     virtual bool resetTracking() override;
 
-private:
-    // Pose delivery thread
-    void poseDeliveryThread();
+    // Anchors, backed by the driver's AnchorStore (Quest spatial anchors on the Unity side)
+    virtual bool isAnchorSupported() override { return true; }
+    virtual const char* createAnchor(VuforiaDriver::AnchorPose* anchorPose) override;
+    virtual bool removeAnchor(const char* uuid) override;
+
+    // Deliver pending anchor changes in per-status batches (called on the delivery thread)
+    void deliverAnchorUpdates();
 
-    // Coordinate transformation: OpenXR to Vuforia CV convention
-    void transformOpenXRToCV(const float* positionIn, const float* rotationIn,
-                            float* positionOut, float* rotationOut);
+    // Deliver the pose at `sampleTimestamp` (the frame's mid-exposure) to Vuforia, stamped
+    // with the frame timestamp it belongs to (called on the delivery thread)
+    bool deliverPose(int64_t frameTimestamp, int64_t sampleTimestamp);
 
-    // Quaternion to rotation matrix conversion
-    void quaternionToMatrix(const float* quat, float* matrix);
+    // Deliver a pose that was submitted together with the frame (no lookup)
+    bool deliverPose(int64_t frameTimestamp, const PoseData& pose);
 
+private:
     QuestVuforiaDriver* driver_;
     VuforiaDriver::PoseCallback* callback_;
+    VuforiaDriver::AnchorCallback* anchorCallback_;
 
-    std::thread poseThread_;
     std::atomic<bool> isRunning_;
     std::atomic<bool> isOpen_;
 
     int64_t lastPoseTimestamp_;
+    int poseCount_;
+
+    VuforiaDriver::Anchor anchorBatch_[AnchorStore::MAX_ANCHORS];
 };
 
 #endif // QUEST_EXTERNAL_TRACKER_H
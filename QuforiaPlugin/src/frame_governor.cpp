@@ -0,0 +1,151 @@
+#include "frame_governor.h"
+#include "frame_pacing.h"
+#include "quforia_log.h"
+#include <algorithm>
+
+constexpr float FrameGovernor::STEP_UP_PRESSURE;
+constexpr float FrameGovernor::STEP_DOWN_PRESSURE;
+
+FrameGovernor::FrameGovernor()
+    : enabled_(true)
+    , level_(0)
+    , intervalNs_(0)
+    , callbackNs_(0)
+    , backlog_(0.0f)
+    , lastSequence_(0)
+    , lastTimestamp_(0)
+    , lastDeliveredTimestamp_(0)
+    , overloadedFrames_(0)
+    , underloadedFrames_(0)
+    , publishedIntervalNs_(0)
+    , publishedCallbackNs_(0)
+    , publishedPressure_(0.0f)
+    , framesShed_(0)
+{
+}
+
+void FrameGovernor::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+    LOGI("Frame governor %s", enabled ? "enabled" : "disabled");
+}
+
+void FrameGovernor::reset(uint32_t fps) {
+    intervalNs_ = fps > 0 ? 1000000000LL / fps : 0;
+    callbackNs_ = 0;
+    backlog_ = 0.0f;
+    lastSequence_ = 0;
+    lastTimestamp_ = 0;
+    lastDeliveredTimestamp_ = 0;
+    overloadedFrames_ = 0;
+    underloadedFrames_ = 0;
+    setLevel(0);
+    publishedIntervalNs_.store(intervalNs_, std::memory_order_relaxed);
+    publishedCallbackNs_.store(0, std::memory_order_relaxed);
+    publishedPressure_.store(0.0f, std::memory_order_relaxed);
+}
+
+bool FrameGovernor::shouldDeliver(uint64_t sequence, int64_t timestamp) {
+    // Track the producer's rate from every frame we see, delivered or not. Sequence gaps
+    // (frames overwritten before we woke up) spread the elapsed time over the frames in between.
+    if (lastSequence_ != 0 && sequence > lastSequence_ && timestamp > lastTimestamp_) {
+        const int64_t interval = (timestamp - lastTimestamp_) /
+                                 static_cast<int64_t>(sequence - lastSequence_);
+        intervalNs_ = smoothNs(intervalNs_, interval);
+        publishedIntervalNs_.store(intervalNs_, std::memory_order_relaxed);
+    }
+    lastSequence_ = sequence;
+    lastTimestamp_ = timestamp;
+
+    const int level = level_.load(std::memory_order_relaxed);
+    if (!enabled_.load(std::memory_order_relaxed)) {
+        if (level != 0) {
+            setLevel(0);
+        }
+        lastDeliveredTimestamp_ = timestamp;
+        return true;
+    }
+
+    // Keep one frame per divisor x interval
+    const int divisor = divisorForLevel(level);
+    if (divisor > 1 && lastDeliveredTimestamp_ != 0 &&
+        withinInterval(timestamp - lastDeliveredTimestamp_, intervalNs_ * divisor)) {
+        framesShed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    lastDeliveredTimestamp_ = timestamp;
+    return true;
+}
+
+void FrameGovernor::frameDelivered(int64_t callbackNs, uint64_t backlog) {
+    callbackNs_ = smoothNs(callbackNs_, callbackNs);
+    backlog_ = smoothValue(backlog_, static_cast<float>(backlog));
+    publishedCallbackNs_.store(callbackNs_, std::memory_order_relaxed);
+
+    if (intervalNs_ <= 0) {
+        return;
+    }
+
+    const int level = level_.load(std::memory_order_relaxed);
+    const int divisor = divisorForLevel(level);
+
+    // Share of the per-delivery budget Vuforia uses, or frames piling up behind it
+    const float callbackLoad = static_cast<float>(callbackNs_) /
+                               static_cast<float>(intervalNs_ * divisor);
+    const float backlogLoad = backlog_ / divisor;
+    const float pressure = std::max(callbackLoad, backlogLoad);
+    publishedPressure_.store(pressure, std::memory_order_relaxed);
+
+    if (!enabled_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    if (pressure > STEP_UP_PRESSURE) {
+        underloadedFrames_ = 0;
+        if (++overloadedFrames_ >= STEP_UP_FRAMES && level < MAX_LEVEL) {
+            setLevel(level + 1);
+        }
+        return;
+    }
+    overloadedFrames_ = 0;
+
+    // Would the next lower level still have headroom?
+    if (level > 0) {
+        const float lowerPressure = pressure * divisor / divisorForLevel(level - 1);
+        if (lowerPressure < STEP_DOWN_PRESSURE) {
+            if (++underloadedFrames_ >= STEP_DOWN_FRAMES) {
+                setLevel(level - 1);
+            }
+        } else {
+            underloadedFrames_ = 0;
+        }
+    }
+}
+
+void FrameGovernor::setLevel(int level) {
+    const int previous = level_.exchange(level, std::memory_order_relaxed);
+    overloadedFrames_ = 0;
+    underloadedFrames_ = 0;
+
+    if (previous != level) {
+        LOGI("Frame governor: level %d -> %d (deliver 1/%d%s, callback %.1f ms, interval %.1f ms)",
+             previous, level, divisorForLevel(level),
+             level == MAX_LEVEL ? ", half resolution recommended" : "",
+             callbackNs_ / 1e6, intervalNs_ / 1e6);
+    }
+}
+
+void FrameGovernor::state(QuforiaGovernorState* out) const {
+    const int level = level_.load(std::memory_order_relaxed);
+    const int64_t intervalNs = publishedIntervalNs_.load(std::memory_order_relaxed);
+
+    out->enabled = enabled_.load(std::memory_order_relaxed) ? 1 : 0;
+    out->level = level;
+    out->frameDivisor = divisorForLevel(level);
+    out->recommendHalfResolution = level == MAX_LEVEL ? 1 : 0;
+    out->inputFps = intervalNs > 0 ? 1e9f / static_cast<float>(intervalNs) : 0.0f;
+    out->callbackMs = publishedCallbackNs_.load(std::memory_order_relaxed) / 1e6f;
+    out->pressure = publishedPressure_.load(std::memory_order_relaxed);
+    out->reserved = 0;
+    out->framesShed = framesShed_.load(std::memory_order_relaxed);
+}
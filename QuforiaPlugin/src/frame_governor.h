@@ -0,0 +1,86 @@
+#ifndef QUEST_FRAME_GOVERNOR_H
+#define QUEST_FRAME_GOVERNOR_H
+
+#include <atomic>
+#include <cstdint>
+
+// Governor state as exported to Unity (mirrored by QuestVuforiaBridge.GovernorState)
+struct QuforiaGovernorState {
+    int32_t enabled;
+    int32_t level;                    // 0 = full rate, FrameGovernor::MAX_LEVEL = most shedding
+    int32_t frameDivisor;             // Deliver one of every N input frames
+    int32_t recommendHalfResolution;  // Vuforia can't keep up even at the lowest rate
+    float inputFps;                   // Measured producer rate
+    float callbackMs;                 // Smoothed time spent in onNewCameraFrame
+    float pressure;                   // Load relative to the current budget (1 = saturated)
+    uint32_t reserved;
+    uint64_t framesShed;              // Frames the governor chose not to deliver
+};
+
+/**
+ * Adapts the delivered frame rate to how fast Vuforia consumes frames.
+ *
+ * The camera's delivery thread reports each onNewCameraFrame duration and how many frames
+ * were published meanwhile. Pressure is the smoothed callback time over the time budget of
+ * the current level (input interval x divisor), or the backlog per delivered frame if that is
+ * higher. Sustained pressure above STEP_UP_PRESSURE raises the level, which halves the
+ * delivered rate (e.g. 60 -> 30 -> 15 fps); the top level additionally recommends a half
+ * resolution camera mode, since the mode itself is chosen by Vuforia at start(). A level is
+ * only dropped after pressure at the next lower level would stay under STEP_DOWN_PRESSURE for
+ * a few seconds, so the rate doesn't oscillate.
+ *
+ * Updates come from the delivery thread only; state() may be called from any thread.
+ */
+class FrameGovernor {
+public:
+    static const int MAX_LEVEL = 3;
+
+    FrameGovernor();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Delivery thread: forget history when the camera (re)starts with a `fps` mode
+    void reset(uint32_t fps);
+
+    // Delivery thread: whether to deliver the frame captured at `timestamp` (published
+    // under `sequence`) at the current level; false means it is shed
+    bool shouldDeliver(uint64_t sequence, int64_t timestamp);
+
+    // Delivery thread: onNewCameraFrame took `callbackNs`, `backlog` newer frames were
+    // published while it ran
+    void frameDelivered(int64_t callbackNs, uint64_t backlog);
+
+    int level() const { return level_.load(std::memory_order_relaxed); }
+    void state(QuforiaGovernorState* out) const;
+
+private:
+    static constexpr float STEP_UP_PRESSURE = 0.9f;
+    static constexpr float STEP_DOWN_PRESSURE = 0.6f;
+    static const int STEP_UP_FRAMES = 15;     // Consecutive overloaded deliveries
+    static const int STEP_DOWN_FRAMES = 90;   // Consecutive deliveries with headroom
+
+    static int divisorForLevel(int level) { return level >= 2 ? 4 : 1 << level; }
+    void setLevel(int level);
+
+    std::atomic<bool> enabled_;
+    std::atomic<int> level_;
+
+    // Delivery thread only
+    int64_t intervalNs_;        // Smoothed input frame interval
+    int64_t callbackNs_;        // Smoothed callback duration
+    float backlog_;             // Smoothed frames published per callback
+    uint64_t lastSequence_;
+    int64_t lastTimestamp_;
+    int64_t lastDeliveredTimestamp_;
+    int overloadedFrames_;
+    int underloadedFrames_;
+
+    // Published for state()
+    std::atomic<int64_t> publishedIntervalNs_;
+    std::atomic<int64_t> publishedCallbackNs_;
+    std::atomic<float> publishedPressure_;
+    std::atomic<uint64_t> framesShed_;
+};
+
+#endif // QUEST_FRAME_GOVERNOR_H
@@ -0,0 +1,198 @@
+#include "frame_ingest.h"
+#include "vuforia_driver.h"
+#include "thread_config.h"
+#include "quforia_log.h"
+#include <algorithm>
+#include <cstdio>
+
+// Bands are kept large enough that per-tile overhead stays negligible
+static const uint32_t MIN_TILE_ROWS = 16;
+
+FrameIngestPool::FrameIngestPool()
+    : driver_(nullptr)
+    , workerCount_(0)
+    , head_(0)
+    , count_(0)
+    , nextTicket_(0)
+    , publishing_(false)
+    , stopping_(false)
+    , completedTicket_(0)
+{
+}
+
+FrameIngestPool::~FrameIngestPool() {
+    stop();
+}
+
+bool FrameIngestPool::start(int workerCount, QuestVuforiaDriver* driver) {
+    if (workerCount < 1 || workerCount > MAX_WORKERS || !driver) {
+        LOGE("Invalid ingest worker count: %d (1-%d)", workerCount, MAX_WORKERS);
+        return false;
+    }
+
+    stop();
+
+    driver_ = driver;
+    stopping_ = false;
+
+    // Conversion is bandwidth bound: the little cores do it without taking time from Unity
+    const uint64_t littleCores = cpuClusterMask(0);
+    workers_.reserve(workerCount);
+    for (int i = 0; i < workerCount; i++) {
+        workers_.emplace_back(&FrameIngestPool::workerLoop, this, i, littleCores);
+    }
+    workerCount_.store(workerCount, std::memory_order_release);
+
+    LOGI("Frame ingest pool started: %d workers (cpu mask 0x%llx)",
+         workerCount, (unsigned long long)littleCores);
+    return true;
+}
+
+void FrameIngestPool::stop() {
+    if (workers_.empty()) {
+        return;
+    }
+
+    // Producers fall back to the synchronous path from here on
+    workerCount_.store(0, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workCv_.notify_all();
+
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    LOGI("Frame ingest pool stopped");
+}
+
+uint64_t FrameIngestPool::submit(IngestJob& job, bool block) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (count_ == MAX_PENDING_JOBS) {
+        if (!block) {
+            return 0;
+        }
+        doneCv_.wait(lock, [this] { return count_ < MAX_PENDING_JOBS; });
+    }
+
+    // About two bands per worker, so a worker that finishes early picks up another one
+    const uint32_t outHeight = job.dst ? static_cast<uint32_t>(job.dst->height) : 0;
+    uint32_t tileRows = outHeight;
+    if (job.convert) {
+        const uint32_t bands = static_cast<uint32_t>(workers_.size() * 2);
+        tileRows = std::max((outHeight + bands - 1) / bands, MIN_TILE_ROWS);
+        tileRows = (tileRows + 1) & ~1u;  // YUV 4:2:0 bands start on even rows
+    }
+
+    IngestJob& queued = jobs_[(head_ + count_) % MAX_PENDING_JOBS];
+    queued = std::move(job);
+    queued.ticket = ++nextTicket_;
+    queued.tileRows = std::max(tileRows, 1u);
+    queued.tileCount = queued.convert ? (outHeight + queued.tileRows - 1) / queued.tileRows : 1;
+    queued.tileCount = std::max(queued.tileCount, 1u);
+    queued.nextTile = 0;
+    queued.tilesDone = 0;
+    queued.failed = false;
+    count_++;
+
+    const uint64_t ticket = queued.ticket;
+    lock.unlock();
+    workCv_.notify_all();
+    return ticket;
+}
+
+void FrameIngestPool::wait(uint64_t ticket) {
+    if (completedTicket() >= ticket) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [this, ticket] { return completedTicket() >= ticket; });
+}
+
+uint64_t FrameIngestPool::completeInline() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t ticket = ++nextTicket_;
+    completedTicket_.store(ticket, std::memory_order_release);
+    return ticket;
+}
+
+IngestJob* FrameIngestPool::claimTile(uint32_t* tile) {
+    for (size_t i = 0; i < count_; i++) {
+        IngestJob& job = jobs_[(head_ + i) % MAX_PENDING_JOBS];
+        if (job.nextTile < job.tileCount) {
+            *tile = job.nextTile++;
+            return &job;
+        }
+    }
+    return nullptr;
+}
+
+void FrameIngestPool::publishCompleted(std::unique_lock<std::mutex>& lock) {
+    // Whoever is already publishing picks up jobs that finish meanwhile
+    if (publishing_) {
+        return;
+    }
+    publishing_ = true;
+
+    while (count_ > 0 && jobs_[head_].tilesDone == jobs_[head_].tileCount) {
+        IngestJob job = std::move(jobs_[head_]);
+        head_ = (head_ + 1) % MAX_PENDING_JOBS;
+        count_--;
+
+        lock.unlock();
+        driver_->finishIngest(job);
+        job.srcFrame.reset();
+        job.dst.reset();
+        lock.lock();
+
+        completedTicket_.store(job.ticket, std::memory_order_release);
+        doneCv_.notify_all();
+    }
+
+    publishing_ = false;
+    if (stopping_ && count_ == 0) {
+        workCv_.notify_all();  // Idle workers wait for the queue to drain before exiting
+    }
+}
+
+void FrameIngestPool::workerLoop(int index, uint64_t defaultCpuMask) {
+    char name[16];
+    snprintf(name, sizeof(name), "QuforiaIngest%d", index);
+    ScopedThreadRole threadRole(QuforiaThreadRole::INGEST_WORKER, name, defaultCpuMask);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        IngestJob* job = nullptr;
+        uint32_t tile = 0;
+        workCv_.wait(lock, [&] {
+            job = claimTile(&tile);
+            return job != nullptr || (stopping_ && count_ == 0);
+        });
+        if (!job) {
+            break;  // Stopping and every pending frame is out
+        }
+
+        // Convert outside the lock; bands write disjoint rows of the output slot
+        bool ok = true;
+        if (job->convert) {
+            const uint32_t outHeight = static_cast<uint32_t>(job->dst->height);
+            const uint32_t rowBegin = tile * job->tileRows;
+            const uint32_t rowEnd = std::min(rowBegin + job->tileRows, outHeight);
+            const CameraFrameData* dst = job->dst.get();
+            lock.unlock();
+            ok = convertFrameRows(job->src, job->srcStride, job->srcFormat,
+                                  dst->imageData, dst->stride, dst->format,
+                                  job->width, job->height, rowBegin, rowEnd, job->options);
+            lock.lock();
+        }
+
+        if (!ok) {
+            job->failed = true;
+        }
+        if (++job->tilesDone == job->tileCount) {
+            publishCompleted(lock);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef QUEST_FRAME_INGEST_H
+#define QUEST_FRAME_INGEST_H
+
+#include "frame_pool.h"
+#include "pixel_convert.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class QuestVuforiaDriver;
+
+// One frame on its way from the producer to the ring: source pixels, the slot they are
+// converted into, and what publishFrame() needs afterwards
+struct IngestJob {
+    // Source pixels (caller's buffer, or the slot in srcFrame)
+    const uint8_t* src = nullptr;
+    uint32_t srcStride = 0;
+    VuforiaDriver::PixelFormat srcFormat = VuforiaDriver::PixelFormat::UNKNOWN;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    FrameHandle srcFrame;     // Keeps a borrowed slot alive until the job is done
+
+    FrameHandle dst;          // Output slot, already sized for the target format
+    bool convert = false;     // false: dst already holds the frame (src is ignored)
+    ConvertOptions options;
+    CropWindow crop;          // Window of the calibrated image that src holds
+
+    float intrinsics[14];     // Unity array layout, valid if hasIntrinsics
+    bool hasIntrinsics = false;
+    PoseData pose;
+    bool hasPose = false;
+    int64_t timestamp = 0;
+
+    // Filled in by the pool
+    uint64_t ticket = 0;
+    uint32_t tileRows = 0;
+    uint32_t tileCount = 0;
+    uint32_t nextTile = 0;    // First tile no worker has claimed yet
+    uint32_t tilesDone = 0;
+    bool failed = false;
+};
+
+/**
+ * Worker pool for asynchronous frame ingestion.
+ *
+ * The producer submits a job and gets a ticket back straight away. Workers (pinned to the
+ * little cores unless Unity configures the INGEST_WORKER role) split each frame into bands
+ * of output rows and run convertFrameRows() on them in parallel; whichever worker finishes
+ * a frame's last band publishes it through the driver. Frames are published strictly in
+ * ticket order, by one worker at a time, so the frame ring keeps a single producer.
+ *
+ * Tickets increase by one per submitted frame; completedTicket() is the newest frame that
+ * has been published or rejected, which tells the caller when its source buffer is free.
+ */
+class FrameIngestPool {
+public:
+    static const int MAX_WORKERS = 4;
+    // Frames queued or being converted; submit() refuses (or waits) beyond this
+    static const size_t MAX_PENDING_JOBS = 2;
+
+    FrameIngestPool();
+    ~FrameIngestPool();
+
+    FrameIngestPool(const FrameIngestPool&) = delete;
+    FrameIngestPool& operator=(const FrameIngestPool&) = delete;
+
+    // Start `workerCount` workers (1..MAX_WORKERS) publishing into `driver`. start() and
+    // stop() are called from the producer thread, never concurrently with submit().
+    bool start(int workerCount, QuestVuforiaDriver* driver);
+    // Finish the pending jobs, then join the workers
+    void stop();
+    bool running() const { return workerCount() > 0; }
+    int workerCount() const { return workerCount_.load(std::memory_order_acquire); }
+
+    // Queue `job` and return its ticket. When the queue is full, waits for a free entry if
+    // `block`, otherwise returns 0 and leaves the job untouched.
+    uint64_t submit(IngestJob& job, bool block);
+
+    // Block until the frame with `ticket` has been published or rejected
+    void wait(uint64_t ticket);
+
+    // Ticket for a frame ingested on the calling thread while no workers run
+    uint64_t completeInline();
+
+    uint64_t completedTicket() const { return completedTicket_.load(std::memory_order_acquire); }
+
+private:
+    void workerLoop(int index, uint64_t defaultCpuMask);
+    // Oldest job with an unclaimed tile (mutex_ held)
+    IngestJob* claimTile(uint32_t* tile);
+    // Publish finished jobs at the head of the queue, in ticket order (mutex_ held)
+    void publishCompleted(std::unique_lock<std::mutex>& lock);
+
+    QuestVuforiaDriver* driver_;
+    std::vector<std::thread> workers_;
+    std::atomic<int> workerCount_;
+
+    std::mutex mutex_;
+    std::condition_variable workCv_;  // Workers: new tiles, or stop
+    std::condition_variable doneCv_;  // Producers: a frame completed
+    IngestJob jobs_[MAX_PENDING_JOBS];
+    size_t head_;
+    size_t count_;
+    uint64_t nextTicket_;
+    bool publishing_;                 // A worker is inside publishCompleted()'s driver call
+    bool stopping_;
+    std::atomic<uint64_t> completedTicket_;
+};
+
+#endif // QUEST_FRAME_INGEST_H
@@ -0,0 +1,27 @@
+#ifndef QUEST_FRAME_PACING_H
+#define QUEST_FRAME_PACING_H
+
+#include <cstdint>
+
+// Shared by the stages that pace frame delivery (governor, quality gate, motion throttle), so
+// they measure and space frames the same way
+
+// Exponential smoothing weight of a new sample (1/8)
+static const int QUFORIA_SMOOTHING_SHIFT = 3;
+
+// Smoothed duration or interval; the first sample (nothing measured yet) is taken as-is
+inline int64_t smoothNs(int64_t averageNs, int64_t sampleNs) {
+    return averageNs == 0 ? sampleNs : averageNs + ((sampleNs - averageNs) >> QUFORIA_SMOOTHING_SHIFT);
+}
+
+inline float smoothValue(float average, float sample) {
+    return average + (sample - average) / (1 << QUFORIA_SMOOTHING_SHIFT);
+}
+
+// A frame closer than 3/4 of `intervalNs` to the last delivered one is inside that interval;
+// the slack absorbs timestamp jitter, so a steady source isn't cut to every other interval
+inline bool withinInterval(int64_t sinceDeliveredNs, int64_t intervalNs) {
+    return sinceDeliveredNs < (intervalNs * 3) / 4;
+}
+
+#endif // QUEST_FRAME_PACING_H
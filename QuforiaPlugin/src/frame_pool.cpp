@@ -0,0 +1,151 @@
+#include "frame_pool.h"
+#include "quforia_log.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// =============================================================================
+// FrameHandle
+// =============================================================================
+
+FrameHandle::FrameHandle(const FrameHandle& other) : slot_(other.slot_) {
+    if (slot_) {
+        slot_->refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+FrameHandle& FrameHandle::operator=(const FrameHandle& other) {
+    if (this != &other) {
+        if (other.slot_) {
+            other.slot_->refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        reset();
+        slot_ = other.slot_;
+    }
+    return *this;
+}
+
+FrameHandle& FrameHandle::operator=(FrameHandle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        slot_ = other.slot_;
+        other.slot_ = nullptr;
+    }
+    return *this;
+}
+
+void FrameHandle::reset() {
+    if (slot_) {
+        // Release makes our writes to the slab visible to whoever claims the slot next
+        slot_->refCount.fetch_sub(1, std::memory_order_acq_rel);
+        slot_ = nullptr;
+    }
+}
+
+// =============================================================================
+// FramePool
+// =============================================================================
+
+FramePool::FramePool()
+    : slots_(nullptr)
+    , slotCount_(0)
+    , slabSize_(0)
+    , nextSlot_(0)
+{
+}
+
+FramePool::~FramePool() {
+    freeSlabs();
+}
+
+void FramePool::allocate(size_t slotCount, size_t slabSize) {
+    freeSlabs();
+
+    // Round slabs up to a whole number of cache lines
+    slabSize = (slabSize + SLAB_ALIGNMENT - 1) & ~(SLAB_ALIGNMENT - 1);
+
+    slots_ = new FrameSlot[slotCount];
+    slotCount_ = slotCount;
+    slabSize_ = slabSize;
+
+    for (size_t i = 0; i < slotCount; i++) {
+        void* slab = nullptr;
+        if (posix_memalign(&slab, SLAB_ALIGNMENT, slabSize) != 0) {
+            LOGE("Failed to allocate frame slab %zu (%zu bytes)", i, slabSize);
+            freeSlabs();
+            throw std::bad_alloc();
+        }
+
+        // Touch every page now, at driver init, so the first frames after a resume
+        // don't take page faults in the conversion copy
+        memset(slab, 0, slabSize);
+
+        slots_[i].frame.imageData = static_cast<uint8_t*>(slab);
+        slots_[i].frame.capacity = slabSize;
+        slots_[i].index = static_cast<uint32_t>(i);
+    }
+
+    LOGI("Frame pool allocated and pre-faulted: %zu slots x %zu bytes", slotCount, slabSize);
+}
+
+FrameHandle FramePool::acquire() {
+    const size_t start = nextSlot_.fetch_add(1, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < slotCount_; i++) {
+        FrameSlot& slot = slots_[(start + i) % slotCount_];
+
+        uint32_t expected = 0;
+        if (slot.refCount.compare_exchange_strong(expected, 1, std::memory_order_acquire,
+                                                  std::memory_order_relaxed)) {
+            return FrameHandle(&slot);
+        }
+    }
+
+    return FrameHandle();
+}
+
+FrameHandle FramePool::retain(uint32_t index, uint64_t sequence) {
+    if (index >= slotCount_) {
+        return FrameHandle();
+    }
+
+    FrameSlot& slot = slots_[index];
+
+    // Only bump the refcount while someone else still holds the slot; a free slot is never revived
+    uint32_t count = slot.refCount.load(std::memory_order_relaxed);
+    do {
+        if (count == 0) {
+            return FrameHandle();
+        }
+    } while (!slot.refCount.compare_exchange_weak(count, count + 1, std::memory_order_acquire,
+                                                  std::memory_order_relaxed));
+
+    FrameHandle handle(&slot);
+
+    // The publisher clears publishedSeq before dropping its reference, so once we
+    // hold a reference a matching sequence means the slab still holds that frame
+    if (slot.publishedSeq.load(std::memory_order_acquire) != sequence) {
+        return FrameHandle();
+    }
+
+    return handle;
+}
+
+void FramePool::freeSlabs() {
+    if (!slots_) {
+        return;
+    }
+
+    for (size_t i = 0; i < slotCount_; i++) {
+        if (slots_[i].refCount.load(std::memory_order_acquire) != 0) {
+            LOGE("Freeing frame slot %zu while still referenced", i);
+        }
+        free(slots_[i].frame.imageData);
+        slots_[i].frame.imageData = nullptr;
+    }
+
+    delete[] slots_;
+    slots_ = nullptr;
+    slotCount_ = 0;
+    slabSize_ = 0;
+}
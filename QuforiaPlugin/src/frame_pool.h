@@ -0,0 +1,119 @@
+#ifndef QUEST_FRAME_POOL_H
+#define QUEST_FRAME_POOL_H
+
+#include <VuforiaEngine/Driver/Driver.h>
+#include "pose_ring.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Frame data structure for passing from Java/Kotlin layer.
+// Instances live inside FramePool slots; imageData points into the slot's slab.
+struct CameraFrameData {
+    uint8_t* imageData;
+    size_t capacity;    // Slab size in bytes
+    size_t size;        // Bytes of the slab holding image data
+    int width;
+    int height;
+    uint32_t stride;    // Bytes per row of the first plane
+    VuforiaDriver::PixelFormat format;
+    int64_t timestamp;  // Nanoseconds, end of exposure (of the last row, as CameraFrame::timestamp)
+    int64_t publishTimeNs;  // CLOCK_MONOTONIC when the frame entered the ring (for latency stats)
+    VuforiaDriver::CameraIntrinsics intrinsics;
+    PoseData pose;      // Device pose submitted together with the frame
+    bool hasPose;       // False: the delivery thread looks the pose up by timestamp
+    uint32_t exposureTimeNs;  // Exposure of each row (0 = unknown)
+    uint32_t readoutTimeNs;   // Rolling shutter: first to last row exposure start (0 = global)
+
+    CameraFrameData()
+        : imageData(nullptr), capacity(0), size(0), width(0), height(0), stride(0)
+        , format(VuforiaDriver::PixelFormat::UNKNOWN), timestamp(0), publishTimeNs(0)
+        , hasPose(false), exposureTimeNs(0), readoutTimeNs(0) {}
+
+    // Middle of the centre row's exposure: the single instant that best represents a
+    // rolling-shutter frame. The first row starts exposing exposure + readout before the
+    // timestamp; without exposure metadata this is the timestamp itself.
+    int64_t midExposureTimestamp() const {
+        return timestamp - (static_cast<int64_t>(exposureTimeNs) + readoutTimeNs) / 2;
+    }
+};
+
+/**
+ * Pool slot: frame metadata plus a refcount.
+ * Aligned to a cache line so refcount traffic on neighbouring slots doesn't false-share.
+ */
+struct alignas(64) FrameSlot {
+    CameraFrameData frame;
+    std::atomic<uint32_t> refCount;
+    std::atomic<uint64_t> publishedSeq;  // FrameRing sequence this slot is published under (0 = none)
+    uint32_t index;
+
+    FrameSlot() : refCount(0), publishedSeq(0), index(0) {}
+};
+
+/**
+ * Refcounted reference to a pool slot.
+ * The slot becomes free again once the last handle referring to it is destroyed.
+ */
+class FrameHandle {
+public:
+    FrameHandle() : slot_(nullptr) {}
+    FrameHandle(const FrameHandle& other);
+    FrameHandle(FrameHandle&& other) noexcept : slot_(other.slot_) { other.slot_ = nullptr; }
+    FrameHandle& operator=(const FrameHandle& other);
+    FrameHandle& operator=(FrameHandle&& other) noexcept;
+    ~FrameHandle() { reset(); }
+
+    void reset();
+
+    FrameSlot* slot() const { return slot_; }
+    CameraFrameData* get() const { return slot_ ? &slot_->frame : nullptr; }
+    CameraFrameData* operator->() const { return &slot_->frame; }
+    explicit operator bool() const { return slot_ != nullptr; }
+
+private:
+    friend class FramePool;
+    explicit FrameHandle(FrameSlot* slot) : slot_(slot) {}
+
+    FrameSlot* slot_;
+};
+
+/**
+ * Fixed-size pool of preallocated, cache-aligned frame slabs.
+ * Replaces the per-frame new[]/delete[] of the frame queue: slabs are allocated
+ * once and recycled when every holder (frame queue, delivery thread, Vuforia
+ * callback) has dropped its FrameHandle.
+ */
+class FramePool {
+public:
+    static const size_t SLAB_ALIGNMENT = 64;
+
+    FramePool();
+    ~FramePool();
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // Allocate slotCount slabs of slabSize bytes each, pre-faulted. Throws std::bad_alloc on failure.
+    void allocate(size_t slotCount, size_t slabSize);
+
+    // Grab a free slot. Returns an empty handle if every slot is in use.
+    FrameHandle acquire();
+
+    // Take an extra reference on slot `index` if it is still published under `sequence`.
+    // Lock-free; returns an empty handle if the slot was retired or recycled meanwhile.
+    FrameHandle retain(uint32_t index, uint64_t sequence);
+
+    size_t slotCount() const { return slotCount_; }
+    size_t slabSize() const { return slabSize_; }
+
+private:
+    void freeSlabs();
+
+    FrameSlot* slots_;
+    size_t slotCount_;
+    size_t slabSize_;
+    std::atomic<size_t> nextSlot_;  // Round-robin scan start, spreads reuse across slots
+};
+
+#endif // QUEST_FRAME_POOL_H
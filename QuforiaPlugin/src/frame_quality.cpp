@@ -0,0 +1,221 @@
+#include "frame_quality.h"
+#include "frame_pacing.h"
+#include "pixel_convert.h"
+#include "driver_stats.h"
+#include "quforia_log.h"
+#include <algorithm>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define QUFORIA_HAVE_NEON 1
+#endif
+
+using VuforiaDriver::PixelFormat;
+
+constexpr float FrameQualityGate::DEFAULT_MIN_SHARPNESS;
+constexpr float FrameQualityGate::DEFAULT_MIN_ANGULAR_SPEED;
+
+// =============================================================================
+// Laplacian variance
+// =============================================================================
+
+#ifdef QUFORIA_HAVE_NEON
+// Luma of 8 consecutive pixels of a packed row with `BPP` bytes per pixel
+template <int BPP>
+static inline uint8x8_t loadLuma8(const uint8_t* p) {
+    if constexpr (BPP == 1) {
+        return vld1_u8(p);
+    } else if constexpr (BPP == 2) {
+        return vld2_u8(p).val[0];  // YUYV: Y0 U Y1 V
+    } else if constexpr (BPP == 3) {
+        return vld3_u8(p).val[1];  // G
+    } else {
+        return vld4_u8(p).val[1];
+    }
+}
+#endif
+
+// Sum and sum of squares of the Laplacian along one row (pixels 1 .. width - 2)
+template <int BPP>
+static void laplacianRow(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+                         uint32_t width, int64_t* sum, int64_t* sumSq) {
+    const int LUMA = BPP >= 3 ? 1 : 0;
+    uint32_t x = 1;
+
+#ifdef QUFORIA_HAVE_NEON
+    // Per-lane int32 sums can't overflow within a row: |L| <= 1020 and each lane takes
+    // width / 4 squares, which fits up to 4096 pixel wide frames
+    int32x4_t accSum = vdupq_n_s32(0);
+    int32x4_t accSq = vdupq_n_s32(0);
+    for (; x + 8 < width; x += 8) {
+        const uint8x8_t center = loadLuma8<BPP>(row + x * BPP);
+        const uint16x8_t horizontal = vaddl_u8(loadLuma8<BPP>(row + (x - 1) * BPP),
+                                               loadLuma8<BPP>(row + (x + 1) * BPP));
+        const uint16x8_t vertical = vaddl_u8(loadLuma8<BPP>(above + x * BPP),
+                                             loadLuma8<BPP>(below + x * BPP));
+        const int16x8_t lap = vsubq_s16(vreinterpretq_s16_u16(vshll_n_u8(center, 2)),
+                                        vreinterpretq_s16_u16(vaddq_u16(horizontal, vertical)));
+        accSum = vpadalq_s16(accSum, lap);
+        accSq = vmlal_s16(accSq, vget_low_s16(lap), vget_low_s16(lap));
+        accSq = vmlal_s16(accSq, vget_high_s16(lap), vget_high_s16(lap));
+    }
+
+    int32_t lanes[4];
+    vst1q_s32(lanes, accSum);
+    *sum += static_cast<int64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    vst1q_s32(lanes, accSq);
+    *sumSq += static_cast<int64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+    for (; x + 1 < width; x++) {
+        const int lap = 4 * row[x * BPP + LUMA] - row[(x - 1) * BPP + LUMA] - row[(x + 1) * BPP + LUMA] -
+                        above[x * BPP + LUMA] - below[x * BPP + LUMA];
+        *sum += lap;
+        *sumSq += lap * lap;
+    }
+}
+
+template <int BPP>
+static float laplacianVariance(const uint8_t* pixels, uint32_t stride, uint32_t width, uint32_t height) {
+    int64_t sum = 0;
+    int64_t sumSq = 0;
+    uint64_t count = 0;
+
+    for (uint32_t y = 1; y + 1 < height; y += FrameQualityGate::ROW_STEP) {
+        const uint8_t* row = pixels + static_cast<size_t>(y) * stride;
+        laplacianRow<BPP>(row - stride, row, row + stride, width, &sum, &sumSq);
+        count += width - 2;
+    }
+
+    if (count == 0) {
+        return 0.0f;
+    }
+    const double mean = static_cast<double>(sum) / count;
+    return static_cast<float>(static_cast<double>(sumSq) / count - mean * mean);
+}
+
+float lumaSharpness(const uint8_t* pixels, uint32_t stride, PixelFormat format,
+                    uint32_t width, uint32_t height) {
+    if (!pixels || width < 3 || height < 3) {
+        return 0.0f;
+    }
+
+    // 4:2:0 formats start with the full resolution Y plane
+    if (isYuv420(format)) {
+        return laplacianVariance<1>(pixels, stride, width, height);
+    }
+    switch (format) {
+        case PixelFormat::YUYV:     return laplacianVariance<2>(pixels, stride, width, height);
+        case PixelFormat::RGB888:   return laplacianVariance<3>(pixels, stride, width, height);
+        case PixelFormat::RGBA8888: return laplacianVariance<4>(pixels, stride, width, height);
+        default:                    return 0.0f;
+    }
+}
+
+// =============================================================================
+// FrameQualityGate
+// =============================================================================
+
+FrameQualityGate::FrameQualityGate()
+    : enabled_(false)
+    , minSharpness_(DEFAULT_MIN_SHARPNESS)
+    , minAngularSpeed_(DEFAULT_MIN_ANGULAR_SPEED)
+    , reference_(0.0f)
+    , stillFrames_(0)
+    , scoreNs_(0)
+    , consecutiveRejects_(0)
+    , lastScore_(0.0f)
+    , publishedReference_(0.0f)
+    , angularSpeed_(-1.0f)
+    , publishedScoreNs_(0)
+    , framesScored_(0)
+{
+}
+
+void FrameQualityGate::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+    LOGI("Frame quality gate %s", enabled ? "enabled" : "disabled");
+}
+
+void FrameQualityGate::setThresholds(float minSharpness, float minAngularSpeed) {
+    if (minSharpness > 0.0f) {
+        minSharpness_.store(std::min(minSharpness, 1.0f), std::memory_order_relaxed);
+    }
+    if (minAngularSpeed > 0.0f) {
+        minAngularSpeed_.store(minAngularSpeed, std::memory_order_relaxed);
+    }
+    LOGI("Frame quality gate: min sharpness %.2f of reference, scoring above %.2f rad/s",
+         minSharpness_.load(std::memory_order_relaxed), minAngularSpeed_.load(std::memory_order_relaxed));
+}
+
+void FrameQualityGate::reset() {
+    reference_ = 0.0f;
+    stillFrames_ = 0;
+    scoreNs_ = 0;
+    consecutiveRejects_.store(0, std::memory_order_relaxed);
+    lastScore_.store(0.0f, std::memory_order_relaxed);
+    publishedReference_.store(0.0f, std::memory_order_relaxed);
+    angularSpeed_.store(-1.0f, std::memory_order_relaxed);
+    publishedScoreNs_.store(0, std::memory_order_relaxed);
+}
+
+float FrameQualityGate::score(const CameraFrameData& frame) {
+    const int64_t start = monotonicNowNs();
+    const float result = lumaSharpness(frame.imageData, frame.stride, frame.format,
+                                       static_cast<uint32_t>(frame.width),
+                                       static_cast<uint32_t>(frame.height));
+    const int64_t elapsed = monotonicNowNs() - start;
+
+    scoreNs_ = smoothNs(scoreNs_, elapsed);
+    publishedScoreNs_.store(scoreNs_, std::memory_order_relaxed);
+    lastScore_.store(result, std::memory_order_relaxed);
+    framesScored_.fetch_add(1, std::memory_order_relaxed);
+    return result;
+}
+
+void FrameQualityGate::updateReference(float score) {
+    // Sharper scenes are picked up at once, a drop (less texture in view) only gradually
+    reference_ = score >= reference_ ? score : smoothValue(reference_, score);
+    publishedReference_.store(reference_, std::memory_order_relaxed);
+}
+
+bool FrameQualityGate::shouldDeliver(const CameraFrameData& frame, float angularSpeed) {
+    if (!enabled_.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    angularSpeed_.store(angularSpeed, std::memory_order_relaxed);
+
+    // Head (nearly) still: sharp by assumption, occasionally scored to keep the reference current
+    if (angularSpeed >= 0.0f && angularSpeed < minAngularSpeed_.load(std::memory_order_relaxed)) {
+        consecutiveRejects_.store(0, std::memory_order_relaxed);
+        if (stillFrames_++ % REFERENCE_INTERVAL == 0) {
+            updateReference(score(frame));
+        }
+        return true;
+    }
+    stillFrames_ = 0;
+
+    const float sharpness = score(frame);
+    const int rejects = consecutiveRejects_.load(std::memory_order_relaxed);
+    if (reference_ > 0.0f && sharpness < minSharpness_.load(std::memory_order_relaxed) * reference_ &&
+        rejects < MAX_CONSECUTIVE_REJECTS) {
+        consecutiveRejects_.store(rejects + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    consecutiveRejects_.store(0, std::memory_order_relaxed);
+    updateReference(sharpness);
+    return true;
+}
+
+void FrameQualityGate::state(QuforiaQualityState* out) const {
+    out->enabled = enabled_.load(std::memory_order_relaxed) ? 1 : 0;
+    out->consecutiveRejects = consecutiveRejects_.load(std::memory_order_relaxed);
+    out->minSharpness = minSharpness_.load(std::memory_order_relaxed);
+    out->minAngularSpeed = minAngularSpeed_.load(std::memory_order_relaxed);
+    out->lastScore = lastScore_.load(std::memory_order_relaxed);
+    out->referenceScore = publishedReference_.load(std::memory_order_relaxed);
+    out->angularSpeed = angularSpeed_.load(std::memory_order_relaxed);
+    out->scoreMs = publishedScoreNs_.load(std::memory_order_relaxed) / 1e6f;
+    out->framesScored = framesScored_.load(std::memory_order_relaxed);
+}
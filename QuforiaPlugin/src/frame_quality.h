@@ -0,0 +1,87 @@
+#ifndef QUEST_FRAME_QUALITY_H
+#define QUEST_FRAME_QUALITY_H
+
+#include "frame_pool.h"
+#include <atomic>
+#include <cstdint>
+
+// Quality gate state as exported to Unity (mirrored by QuestVuforiaBridge.QualityState)
+struct QuforiaQualityState {
+    int32_t enabled;
+    int32_t consecutiveRejects;  // Moving frames dropped in a row so far
+    float minSharpness;          // Share of the reference score a moving frame must reach
+    float minAngularSpeed;       // rad/s; slower frames are delivered without scoring
+    float lastScore;             // Laplacian variance of the last scored frame
+    float referenceScore;        // What a sharp frame of the current scene scores
+    float angularSpeed;          // Head rotation speed at the last frame (-1 = no pose)
+    float scoreMs;               // Smoothed time spent scoring a frame
+    uint64_t framesScored;
+};
+
+// Variance of the 4-neighbour Laplacian of the luma plane (G for RGB formats), sampled on
+// every ROW_STEP-th row. Higher is sharper; 0 for images too small to score.
+float lumaSharpness(const uint8_t* pixels, uint32_t stride, VuforiaDriver::PixelFormat format,
+                    uint32_t width, uint32_t height);
+
+/**
+ * Drops frames smeared by head motion before they reach Vuforia.
+ *
+ * Head rotation speed from the pose history is the prior: below minAngularSpeed a frame is
+ * taken to be sharp and delivered as is, and only an occasional still frame is scored to
+ * learn what "sharp" looks like for the current scene (the reference score). Faster frames
+ * are scored with lumaSharpness() and dropped if they fall below minSharpness x reference.
+ * Without a pose every frame is scored. At most MAX_CONSECUTIVE_REJECTS frames are dropped
+ * in a row, so a long fast pan still reaches Vuforia at a reduced rate.
+ *
+ * Disabled by default. Updates come from the delivery thread only; state() may be called
+ * from any thread.
+ */
+class FrameQualityGate {
+public:
+    static const int ROW_STEP = 4;
+    static const int MAX_CONSECUTIVE_REJECTS = 3;
+    static constexpr float DEFAULT_MIN_SHARPNESS = 0.5f;
+    static constexpr float DEFAULT_MIN_ANGULAR_SPEED = 0.35f;  // ~20 deg/s
+
+    FrameQualityGate();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Values <= 0 keep the current setting
+    void setThresholds(float minSharpness, float minAngularSpeed);
+
+    // Delivery thread: forget the reference when the camera (re)starts
+    void reset();
+
+    // Delivery thread: whether to deliver `frame`, captured while the head turned at
+    // `angularSpeed` rad/s (negative if unknown); false means it is too blurred
+    bool shouldDeliver(const CameraFrameData& frame, float angularSpeed);
+
+    void state(QuforiaQualityState* out) const;
+
+private:
+    static const int REFERENCE_INTERVAL = 8;  // Score one in N still frames
+
+    float score(const CameraFrameData& frame);
+    void updateReference(float score);
+
+    std::atomic<bool> enabled_;
+    std::atomic<float> minSharpness_;
+    std::atomic<float> minAngularSpeed_;
+
+    // Delivery thread only
+    float reference_;
+    int stillFrames_;
+    int64_t scoreNs_;           // Smoothed scoring time
+
+    // Published for state()
+    std::atomic<int> consecutiveRejects_;
+    std::atomic<float> lastScore_;
+    std::atomic<float> publishedReference_;
+    std::atomic<float> angularSpeed_;
+    std::atomic<int64_t> publishedScoreNs_;
+    std::atomic<uint64_t> framesScored_;
+};
+
+#endif // QUEST_FRAME_QUALITY_H
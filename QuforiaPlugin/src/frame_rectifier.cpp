@@ -0,0 +1,251 @@
+#include "frame_rectifier.h"
+#include "pixel_convert.h"
+#include "driver_stats.h"
+#include "quforia_log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define QUFORIA_HAVE_NEON 1
+#endif
+
+using VuforiaDriver::PixelFormat;
+
+// Bilinear weights are Q7: the four taps of a pixel sum to 128
+static const int WEIGHT_ONE = 128;
+static const int WEIGHT_SHIFT = 7;
+
+// Undistorted normalized image point -> distorted (Vuforia [r0, r1, t0, t1, r2, r3, r4, r5])
+static void distortPoint(const float* d, float x, float y, float* xd, float* yd) {
+    const float r2 = x * x + y * y;
+    const float r4 = r2 * r2;
+    const float r6 = r4 * r2;
+    const float radial = (1.0f + d[0] * r2 + d[1] * r4 + d[4] * r6) /
+                         (1.0f + d[5] * r2 + d[6] * r4 + d[7] * r6);
+    *xd = x * radial + 2.0f * d[2] * x * y + d[3] * (r2 + 2.0f * x * x);
+    *yd = y * radial + d[2] * (r2 + 2.0f * y * y) + 2.0f * d[3] * x * y;
+}
+
+// Blend `CHANNELS` interleaved channels of one plane row through the remap table
+template <int CHANNELS>
+static void remapRow(const uint8_t* src, uint32_t stride, const uint32_t* offsets,
+                     const uint8_t* weights, uint8_t* out, uint32_t width) {
+    uint32_t x = 0;
+
+#ifdef QUFORIA_HAVE_NEON
+    for (; x + 8 <= width; x += 8) {
+        // vld4 splits the per-pixel (w00, w01, w10, w11) records into four weight vectors
+        const uint8x8x4_t w = vld4_u8(weights + x * 4);
+
+        uint8x8_t result[CHANNELS];
+        for (int c = 0; c < CHANNELS; c++) {
+            // No gather in NEON: collect the four taps of 8 pixels, then blend them at once
+            uint8_t p00[8], p01[8], p10[8], p11[8];
+            for (int k = 0; k < 8; k++) {
+                const uint8_t* p = src + offsets[x + k] + c;
+                p00[k] = p[0];
+                p01[k] = p[CHANNELS];
+                p10[k] = p[stride];
+                p11[k] = p[stride + CHANNELS];
+            }
+            uint16x8_t sum = vmull_u8(vld1_u8(p00), w.val[0]);
+            sum = vmlal_u8(sum, vld1_u8(p01), w.val[1]);
+            sum = vmlal_u8(sum, vld1_u8(p10), w.val[2]);
+            sum = vmlal_u8(sum, vld1_u8(p11), w.val[3]);
+            result[c] = vrshrn_n_u16(sum, WEIGHT_SHIFT);
+        }
+
+        uint8_t* dst = out + x * CHANNELS;
+        if constexpr (CHANNELS == 1) {
+            vst1_u8(dst, result[0]);
+        } else if constexpr (CHANNELS == 2) {
+            const uint8x8x2_t interleaved = { { result[0], result[1] } };
+            vst2_u8(dst, interleaved);
+        } else if constexpr (CHANNELS == 3) {
+            const uint8x8x3_t interleaved = { { result[0], result[1], result[2] } };
+            vst3_u8(dst, interleaved);
+        } else {
+            const uint8x8x4_t interleaved = { { result[0], result[1], result[2], result[3] } };
+            vst4_u8(dst, interleaved);
+        }
+    }
+#endif
+
+    for (; x < width; x++) {
+        const uint8_t* p = src + offsets[x];
+        const uint8_t* w = weights + x * 4;
+        for (int c = 0; c < CHANNELS; c++) {
+            const int sum = p[c] * w[0] + p[c + CHANNELS] * w[1] +
+                            p[c + stride] * w[2] + p[c + stride + CHANNELS] * w[3];
+            out[x * CHANNELS + c] = static_cast<uint8_t>((sum + WEIGHT_ONE / 2) >> WEIGHT_SHIFT);
+        }
+    }
+}
+
+template <int CHANNELS>
+static void remapPlane(const uint8_t* src, uint8_t* dst, uint32_t stride,
+                       const uint32_t* offsets, const uint8_t* weights,
+                       uint32_t width, uint32_t height) {
+    for (uint32_t y = 0; y < height; y++) {
+        const size_t row = static_cast<size_t>(y) * width;
+        remapRow<CHANNELS>(src, stride, offsets + row, weights + row * 4,
+                           dst + static_cast<size_t>(y) * stride, width);
+    }
+}
+
+void FrameRectifier::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+    LOGI("Frame rectification %s", enabled ? "enabled" : "disabled");
+}
+
+bool FrameRectifier::hasDistortion(const VuforiaDriver::CameraIntrinsics& intrinsics) {
+    for (int i = 0; i < 8; i++) {
+        if (intrinsics.distortionCoefficients[i] != 0.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameRectifier::buildTable(const VuforiaDriver::CameraIntrinsics& intrinsics,
+                                uint32_t width, uint32_t height, uint32_t channels,
+                                uint32_t stride, float scale, RemapTable* table) {
+    table->width = width;
+    table->height = height;
+    table->channels = channels;
+    table->stride = stride;
+    table->offsets.resize(static_cast<size_t>(width) * height);
+    table->weights.resize(static_cast<size_t>(width) * height * 4);
+
+    const float fx = intrinsics.focalLengthX;
+    const float fy = intrinsics.focalLengthY;
+    const float cx = intrinsics.principalPointX;
+    const float cy = intrinsics.principalPointY;
+    const float maxX = static_cast<float>(width - 1);
+    const float maxY = static_cast<float>(height - 1);
+
+    size_t i = 0;
+    for (uint32_t v = 0; v < height; v++) {
+        for (uint32_t u = 0; u < width; u++, i++) {
+            // Plane pixel centre in full-resolution pixels -> distorted source position
+            const float fullU = (u + 0.5f) * scale - 0.5f;
+            const float fullV = (v + 0.5f) * scale - 0.5f;
+            float xd, yd;
+            distortPoint(intrinsics.distortionCoefficients, (fullU - cx) / fx, (fullV - cy) / fy,
+                         &xd, &yd);
+            const float sx = std::max(0.0f, std::min(((xd * fx + cx) + 0.5f) / scale - 0.5f, maxX));
+            const float sy = std::max(0.0f, std::min(((yd * fy + cy) + 0.5f) / scale - 0.5f, maxY));
+
+            // The top-left tap stays one pixel inside so its right/bottom neighbours exist
+            const uint32_t x0 = std::min(static_cast<uint32_t>(sx), width - 2);
+            const uint32_t y0 = std::min(static_cast<uint32_t>(sy), height - 2);
+            const int a = static_cast<int>(std::lround((sx - x0) * WEIGHT_ONE));
+            const int b = static_cast<int>(std::lround((sy - y0) * WEIGHT_ONE));
+            const int w11 = (a * b + WEIGHT_ONE / 2) >> WEIGHT_SHIFT;
+
+            table->offsets[i] = y0 * stride + x0 * channels;
+            uint8_t* w = &table->weights[i * 4];
+            w[0] = static_cast<uint8_t>(WEIGHT_ONE - a - b + w11);
+            w[1] = static_cast<uint8_t>(a - w11);
+            w[2] = static_cast<uint8_t>(b - w11);
+            w[3] = static_cast<uint8_t>(w11);
+        }
+    }
+}
+
+bool FrameRectifier::prepare(const CameraFrameData& frame) {
+    if (frame.width == lutWidth_ && frame.height == lutHeight_ && frame.format == lutFormat_ &&
+        memcmp(&frame.intrinsics, &lutIntrinsics_, sizeof(lutIntrinsics_)) == 0) {
+        return true;
+    }
+
+    const uint32_t width = static_cast<uint32_t>(frame.width);
+    const uint32_t height = static_cast<uint32_t>(frame.height);
+    if (width < 4 || height < 4 || frame.stride != packedStride(frame.format, width) ||
+        frame.intrinsics.focalLengthX <= 0.0f || frame.intrinsics.focalLengthY <= 0.0f) {
+        LOGW_EVERY_MS(5000, "Can't rectify %dx%d %s frame (stride %u, fx %.1f)",
+                      frame.width, frame.height, pixelFormatName(frame.format), frame.stride,
+                      frame.intrinsics.focalLengthX);
+        return false;
+    }
+
+    const int64_t buildStart = monotonicNowNs();
+    switch (frame.format) {
+        case PixelFormat::RGB888:
+        case PixelFormat::RGBA8888: {
+            const uint32_t channels = frame.format == PixelFormat::RGB888 ? 3 : 4;
+            buildTable(frame.intrinsics, width, height, channels, frame.stride, 1.0f, &primary_);
+            chroma_ = RemapTable();
+            break;
+        }
+        case PixelFormat::NV12:
+        case PixelFormat::NV21:
+            buildTable(frame.intrinsics, width, height, 1, frame.stride, 1.0f, &primary_);
+            buildTable(frame.intrinsics, width / 2, height / 2, 2, frame.stride, 2.0f, &chroma_);
+            break;
+        case PixelFormat::YUV420P:
+        case PixelFormat::YV12:
+            buildTable(frame.intrinsics, width, height, 1, frame.stride, 1.0f, &primary_);
+            buildTable(frame.intrinsics, width / 2, height / 2, 1, frame.stride / 2, 2.0f, &chroma_);
+            break;
+        default:
+            LOGW_EVERY_MS(5000, "Can't rectify %s frames", pixelFormatName(frame.format));
+            return false;
+    }
+
+    lutIntrinsics_ = frame.intrinsics;
+    lutWidth_ = frame.width;
+    lutHeight_ = frame.height;
+    lutFormat_ = frame.format;
+
+    LOGI("Built %dx%d %s rectification LUT in %.1f ms (%zu KB)",
+         frame.width, frame.height, pixelFormatName(frame.format),
+         (monotonicNowNs() - buildStart) / 1e6,
+         (primary_.offsets.size() + chroma_.offsets.size()) * 8 / 1024);
+    return true;
+}
+
+void FrameRectifier::applyTable(const uint8_t* src, uint8_t* dst, const RemapTable& table) {
+    const uint32_t* offsets = table.offsets.data();
+    const uint8_t* weights = table.weights.data();
+    switch (table.channels) {
+        case 1: remapPlane<1>(src, dst, table.stride, offsets, weights, table.width, table.height); break;
+        case 2: remapPlane<2>(src, dst, table.stride, offsets, weights, table.width, table.height); break;
+        case 3: remapPlane<3>(src, dst, table.stride, offsets, weights, table.width, table.height); break;
+        default: remapPlane<4>(src, dst, table.stride, offsets, weights, table.width, table.height); break;
+    }
+}
+
+bool FrameRectifier::rectify(const CameraFrameData& src, CameraFrameData* dst) {
+    if (!prepare(src) || dst->capacity < src.size) {
+        return false;
+    }
+
+    applyTable(src.imageData, dst->imageData, primary_);
+
+    if (!chroma_.offsets.empty()) {
+        const size_t lumaSize = static_cast<size_t>(src.stride) * src.height;
+        const size_t chromaPlaneSize = static_cast<size_t>(chroma_.stride) * chroma_.height;
+        const int planes = chroma_.channels == 2 ? 1 : 2;
+        for (int plane = 0; plane < planes; plane++) {
+            const size_t offset = lumaSize + plane * chromaPlaneSize;
+            applyTable(src.imageData + offset, dst->imageData + offset, chroma_);
+        }
+    }
+
+    dst->size = src.size;
+    dst->width = src.width;
+    dst->height = src.height;
+    dst->stride = src.stride;
+    dst->format = src.format;
+    dst->timestamp = src.timestamp;
+    dst->pose = src.pose;
+    dst->hasPose = src.hasPose;
+    dst->exposureTimeNs = src.exposureTimeNs;
+    dst->readoutTimeNs = src.readoutTimeNs;
+    dst->intrinsics = src.intrinsics;
+    memset(dst->intrinsics.distortionCoefficients, 0, sizeof(dst->intrinsics.distortionCoefficients));
+    return true;
+}
@@ -0,0 +1,75 @@
+#ifndef QUEST_FRAME_RECTIFIER_H
+#define QUEST_FRAME_RECTIFIER_H
+
+#include "frame_pool.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Optional undistortion stage, so Vuforia receives pinhole frames whatever the lens.
+ *
+ * For every output pixel a remap LUT holds the byte offset of the top-left source tap and
+ * four Q7 bilinear weights (8 bytes per pixel, plus a half-resolution table for YUV chroma).
+ * The table is built once per calibration and frame geometry on the producer thread; each
+ * frame then costs a gather and a bilinear blend, 8 pixels at a time with NEON on ARM.
+ *
+ * The distortion model is OpenCV's rational one, whose [k1, k2, p1, p2, k3, k4, k5, k6]
+ * are Vuforia's [r0, r1, t0, t1, r2, r3, r4, r5]. Rectified frames keep the focal length
+ * and principal point, with zero distortion; samples that fall outside the source image
+ * repeat its edge.
+ *
+ * Only the frame producer calls rectify(); setEnabled() may be called from any thread.
+ */
+class FrameRectifier {
+public:
+    FrameRectifier() : enabled_(false) {}
+
+    FrameRectifier(const FrameRectifier&) = delete;
+    FrameRectifier& operator=(const FrameRectifier&) = delete;
+
+    void setEnabled(bool enabled);
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Whether any of the distortion coefficients is non-zero
+    static bool hasDistortion(const VuforiaDriver::CameraIntrinsics& intrinsics);
+
+    // Undistort `src` into `dst` (a slot of the same size and format) and give `dst` the
+    // pinhole intrinsics. Returns false for layouts the rectifier doesn't handle (YUYV,
+    // padded rows, frames smaller than 4x4).
+    bool rectify(const CameraFrameData& src, CameraFrameData* dst);
+
+private:
+    // Source tap + weights for one plane of the frame
+    struct RemapTable {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t channels = 0;              // Interleaved channels (RGB 3, NV12 chroma 2)
+        uint32_t stride = 0;                // Bytes per row, of source and output alike
+        std::vector<uint32_t> offsets;      // Byte offset of the top-left tap, per pixel
+        std::vector<uint8_t> weights;       // w00, w01, w10, w11 per pixel (sum 128)
+    };
+
+    // Plane `width` x `height` with `stride` bytes per row, sampled `scale` times coarser
+    // than the image the intrinsics describe
+    static void buildTable(const VuforiaDriver::CameraIntrinsics& intrinsics,
+                           uint32_t width, uint32_t height, uint32_t channels,
+                           uint32_t stride, float scale, RemapTable* table);
+
+    static void applyTable(const uint8_t* src, uint8_t* dst, const RemapTable& table);
+
+    // Rebuild the tables if the frame's intrinsics or geometry changed
+    bool prepare(const CameraFrameData& frame);
+
+    std::atomic<bool> enabled_;
+
+    // LUTs for the calibration and geometry below (producer thread only)
+    VuforiaDriver::CameraIntrinsics lutIntrinsics_;
+    int lutWidth_ = 0;
+    int lutHeight_ = 0;
+    VuforiaDriver::PixelFormat lutFormat_ = VuforiaDriver::PixelFormat::UNKNOWN;
+    RemapTable primary_;  // RGB, or the Y plane
+    RemapTable chroma_;   // NV12/NV21 UV plane, or each of the YUV420P/YV12 U and V planes
+};
+
+#endif // QUEST_FRAME_RECTIFIER_H
@@ -0,0 +1,151 @@
+#include "frame_ring.h"
+#include "quforia_log.h"
+#include <new>
+
+FrameRing::FrameRing(FramePool& pool)
+    : pool_(pool)
+    , capacity_(0)
+    , head_(0)
+    , waiters_(0)
+    , interruptGeneration_(0)
+{
+}
+
+FrameRing::~FrameRing() {
+    clear();
+}
+
+void FrameRing::allocate(size_t capacity) {
+    if (pool_.slotCount() > SLOT_MASK + 1) {
+        LOGE("Frame pool has %zu slots, ring can address at most %llu",
+             pool_.slotCount(), (unsigned long long)(SLOT_MASK + 1));
+        throw std::bad_alloc();
+    }
+
+    clear();
+
+    entries_.reset(new std::atomic<uint64_t>[capacity]);
+    held_.reset(new FrameHandle[capacity]);
+    capacity_ = capacity;
+
+    for (size_t i = 0; i < capacity; i++) {
+        entries_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t FrameRing::publish(FrameHandle frame) {
+    const uint64_t sequence = head_.load(std::memory_order_relaxed) + 1;
+    const size_t position = sequence % capacity_;
+
+    // Release the frame this entry held capacity_ publishes ago
+    retire(position);
+
+    FrameSlot* slot = frame.slot();
+    slot->publishedSeq.store(sequence, std::memory_order_release);
+    entries_[position].store((sequence << SLOT_BITS) | slot->index, std::memory_order_release);
+    held_[position] = std::move(frame);
+
+    // seq_cst store/load pair with waitForPublish(): either the waiter sees the new
+    // head, or we see the waiter and notify it under the mutex
+    head_.store(sequence, std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_seq_cst) > 0) {
+        { std::lock_guard<std::mutex> lock(waitMutex_); }
+        waitCondition_.notify_all();
+    }
+    return sequence;
+}
+
+bool FrameRing::waitForPublish(uint64_t afterSequence, std::chrono::milliseconds timeout) {
+    if (head_.load(std::memory_order_acquire) > afterSequence) {
+        return true;
+    }
+
+    const uint64_t generation = interruptGeneration_.load(std::memory_order_acquire);
+
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    bool published;
+    {
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        waitCondition_.wait_for(lock, timeout, [&]() {
+            return head_.load(std::memory_order_seq_cst) > afterSequence ||
+                   interruptGeneration_.load(std::memory_order_acquire) != generation;
+        });
+        published = head_.load(std::memory_order_acquire) > afterSequence;
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+
+    return published;
+}
+
+void FrameRing::wakeWaiters() {
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        interruptGeneration_.fetch_add(1, std::memory_order_release);
+    }
+    waitCondition_.notify_all();
+}
+
+bool FrameRing::evictOldest() {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+
+    for (uint64_t sequence = oldestSequence(head); sequence <= head; sequence++) {
+        const size_t position = sequence % capacity_;
+        if (held_[position]) {
+            retire(position);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void FrameRing::clear() {
+    for (size_t i = 0; i < capacity_; i++) {
+        retire(i);
+    }
+}
+
+FrameHandle FrameRing::acquireLatest(uint64_t* sequence) {
+    // A retry only happens when the producer laps us between the loads below
+    for (int attempt = 0; attempt < 4; attempt++) {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        if (head == 0) {
+            return FrameHandle();
+        }
+
+        FrameHandle frame = acquire(head);
+        if (frame) {
+            if (sequence) {
+                *sequence = head;
+            }
+            return frame;
+        }
+    }
+
+    return FrameHandle();
+}
+
+FrameHandle FrameRing::acquire(uint64_t sequence) {
+    if (sequence == 0 || capacity_ == 0) {
+        return FrameHandle();
+    }
+
+    const uint64_t entry = entries_[sequence % capacity_].load(std::memory_order_acquire);
+    if ((entry >> SLOT_BITS) != sequence) {
+        return FrameHandle();
+    }
+
+    return pool_.retain(static_cast<uint32_t>(entry & SLOT_MASK), sequence);
+}
+
+void FrameRing::retire(size_t position) {
+    FrameHandle& held = held_[position];
+    if (!held) {
+        return;
+    }
+
+    // Invalidate before dropping our reference so a racing retain() can't mistake
+    // a recycled slab for the frame it was looking for
+    held.slot()->publishedSeq.store(0, std::memory_order_release);
+    held.reset();
+}
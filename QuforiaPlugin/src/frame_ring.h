@@ -0,0 +1,88 @@
+#ifndef QUEST_FRAME_RING_H
+#define QUEST_FRAME_RING_H
+
+#include "frame_pool.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/**
+ * Lock-free, fixed-capacity ring of published frames (single producer, multiple readers).
+ *
+ * The producer publishes pool slots under an ascending sequence number and the ring keeps
+ * a reference on the last `capacity` of them. Readers never block the producer: they look
+ * up an entry, take a reference through FramePool::retain() and simply retry if the producer
+ * recycled that slot in the meantime. Delivery threads can also sleep in waitForPublish()
+ * until the producer publishes, instead of polling.
+ */
+class FrameRing {
+public:
+    explicit FrameRing(FramePool& pool);
+    ~FrameRing();
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    void allocate(size_t capacity);
+
+    // Producer only: publish a filled slot, returns its sequence number (starting at 1)
+    uint64_t publish(FrameHandle frame);
+
+    // Producer only: drop the ring's reference on the oldest frame it still holds.
+    // Used when the pool runs dry so the producer can reclaim a slab.
+    bool evictOldest();
+
+    // Producer only: drop every frame the ring holds
+    void clear();
+
+    // Readers: newest published frame, or an empty handle if none is available
+    FrameHandle acquireLatest(uint64_t* sequence = nullptr);
+
+    // Readers: frame published under `sequence`, or an empty handle if it has been overwritten
+    FrameHandle acquire(uint64_t sequence);
+
+    // Sequence number of the newest published frame (0 if nothing was published yet)
+    uint64_t latestSequence() const { return head_.load(std::memory_order_acquire); }
+
+    // Oldest sequence that may still be held, given the newest one
+    uint64_t oldestSequence(uint64_t head) const {
+        return head >= capacity_ ? head - capacity_ + 1 : 1;
+    }
+
+    // Readers: block until a frame newer than `afterSequence` is published.
+    // Returns false on timeout or when interrupted by wakeWaiters().
+    bool waitForPublish(uint64_t afterSequence, std::chrono::milliseconds timeout);
+
+    // Release every thread blocked in waitForPublish()
+    void wakeWaiters();
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    static const unsigned SLOT_BITS = 8;
+    static const uint64_t SLOT_MASK = (1u << SLOT_BITS) - 1;
+
+    void retire(size_t position);
+
+    FramePool& pool_;
+    size_t capacity_;
+
+    // Entry encoding: (sequence << SLOT_BITS) | slotIndex
+    std::unique_ptr<std::atomic<uint64_t>[]> entries_;
+
+    // References held by the ring, touched only by the producer
+    std::unique_ptr<FrameHandle[]> held_;
+
+    alignas(64) std::atomic<uint64_t> head_;
+
+    // Wakeup for blocked readers. The producer only touches the mutex when someone waits.
+    std::atomic<int> waiters_;
+    std::atomic<uint64_t> interruptGeneration_;
+    std::mutex waitMutex_;
+    std::condition_variable waitCondition_;
+};
+
+#endif // QUEST_FRAME_RING_H
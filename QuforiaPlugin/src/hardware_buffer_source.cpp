@@ -0,0 +1,135 @@
+#include "hardware_buffer_source.h"
+
+#ifdef __ANDROID__
+
+#include "vuforia_driver.h"
+#include "pixel_convert.h"
+#include "quforia_log.h"
+#include <android/hardware_buffer_jni.h>
+
+bool HardwareBufferSource::submit(QuestVuforiaDriver* driver, AHardwareBuffer* buffer,
+                                  bool flipVertically, const PoseData* pose,
+                                  const float* intrinsics, int64_t timestamp) {
+    if (!driver || !buffer) {
+        return false;
+    }
+
+    AHardwareBuffer_Desc desc;
+    AHardwareBuffer_describe(buffer, &desc);
+
+    if ((desc.usage & AHARDWAREBUFFER_USAGE_CPU_READ_MASK) == 0) {
+        LOGE("HardwareBuffer was not allocated with CPU read usage");
+        return false;
+    }
+
+    VuforiaDriver::PixelFormat format;
+    switch (desc.format) {
+        case AHARDWAREBUFFER_FORMAT_R8G8B8A8_UNORM:
+        case AHARDWAREBUFFER_FORMAT_R8G8B8X8_UNORM:
+            format = VuforiaDriver::PixelFormat::RGBA8888;
+            break;
+        case AHARDWAREBUFFER_FORMAT_R8G8B8_UNORM:
+            format = VuforiaDriver::PixelFormat::RGB888;
+            break;
+        case AHARDWAREBUFFER_FORMAT_Y8Cb8Cr8_420:
+            return submitYuv(driver, buffer, desc, flipVertically, pose, intrinsics, timestamp);
+        default:
+            LOGE("Unsupported HardwareBuffer format: %u", desc.format);
+            return false;
+    }
+
+    void* data = nullptr;
+    if (AHardwareBuffer_lock(buffer, AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN, -1, nullptr, &data) != 0) {
+        LOGE("AHardwareBuffer_lock failed");
+        return false;
+    }
+
+    // desc.stride is in pixels
+    const uint32_t stride = packedStride(format, desc.stride);
+    const uint8_t* pixels = static_cast<const uint8_t*>(data);
+    const bool submitted = pose
+        ? driver->submitFrame(pixels, desc.width, desc.height, format, stride, *pose,
+                              intrinsics, timestamp, flipVertically)
+        : driver->feedCameraFrame(pixels, desc.width, desc.height, format, stride,
+                                  intrinsics, timestamp, flipVertically);
+
+    AHardwareBuffer_unlock(buffer, nullptr);
+    return submitted;
+}
+
+bool HardwareBufferSource::submitYuv(QuestVuforiaDriver* driver, AHardwareBuffer* buffer,
+                                     const AHardwareBuffer_Desc& desc, bool flipVertically,
+                                     const PoseData* pose, const float* intrinsics,
+                                     int64_t timestamp) {
+    // A YUV source has no contiguous layout convertFrame() could read, so repack it plane by
+    // plane straight into a borrowed slab in the active mode's format (NV21 before start())
+    VuforiaDriver::CameraMode mode;
+    const VuforiaDriver::PixelFormat target = driver->getActiveCameraMode(&mode)
+        ? mode.format : VuforiaDriver::PixelFormat::NV21;
+
+    AHardwareBuffer_Planes planes;
+    if (AHardwareBuffer_lockPlanes(buffer, AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN, -1, nullptr,
+                                   &planes) != 0 || planes.planeCount < 3) {
+        LOGE("AHardwareBuffer_lockPlanes failed");
+        return false;
+    }
+
+    YuvPlanes yuv;
+    yuv.y = static_cast<const uint8_t*>(planes.planes[0].data);
+    yuv.u = static_cast<const uint8_t*>(planes.planes[1].data);
+    yuv.v = static_cast<const uint8_t*>(planes.planes[2].data);
+    yuv.yRowStride = planes.planes[0].rowStride;
+    yuv.uvRowStride = planes.planes[1].rowStride;
+    yuv.uvPixelStride = planes.planes[1].pixelStride;
+
+    // Crop modes: repack only the window, starting from offset plane pointers
+    uint32_t width = desc.width;
+    uint32_t height = desc.height;
+    CropWindow window;
+    const bool cropped = driver->cropWindow(desc.width, desc.height, &window) &&
+                         cropYuvPlanes(&yuv, desc.width, desc.height, window, flipVertically);
+    if (cropped) {
+        width = window.width;
+        height = window.height;
+    }
+
+    bool submitted = false;
+    uint8_t* slab = driver->beginCameraFrame(width, height, target, cropped ? &window : nullptr);
+    if (slab) {
+        ConvertOptions options;
+        options.flipVertically = flipVertically;
+
+        if (convertYuvPlanes(yuv, slab, 0, target, width, height, options)) {
+            submitted = driver->commitCameraFrame(intrinsics, timestamp, pose);
+        } else {
+            LOGW("Cannot repack %ux%u YUV HardwareBuffer to %s",
+                 width, height, pixelFormatName(target));
+            driver->cancelCameraFrame();
+        }
+    }
+
+    AHardwareBuffer_unlock(buffer, nullptr);
+    return submitted;
+}
+
+bool HardwareBufferSource::submitJava(QuestVuforiaDriver* driver, jobject hardwareBuffer,
+                                      bool flipVertically, const PoseData* pose,
+                                      const float* intrinsics, int64_t timestamp) {
+    JavaVM* vm = driver ? driver->getJavaVM() : nullptr;
+    if (!vm || !hardwareBuffer) {
+        LOGE("No JavaVM available for HardwareBuffer conversion");
+        return false;
+    }
+
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK || !env) {
+        LOGE("Calling thread is not attached to the JavaVM");
+        return false;
+    }
+
+    // Borrowed reference, valid as long as the Java object is
+    AHardwareBuffer* buffer = AHardwareBuffer_fromHardwareBuffer(env, hardwareBuffer);
+    return submit(driver, buffer, flipVertically, pose, intrinsics, timestamp);
+}
+
+#endif // __ANDROID__
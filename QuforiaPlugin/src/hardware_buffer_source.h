@@ -0,0 +1,40 @@
+#ifndef QUEST_HARDWARE_BUFFER_SOURCE_H
+#define QUEST_HARDWARE_BUFFER_SOURCE_H
+
+#ifdef __ANDROID__
+
+#include <android/hardware_buffer.h>
+#include <jni.h>
+#include <cstdint>
+#include "pose_ring.h"
+
+class QuestVuforiaDriver;
+
+/**
+ * Camera frames that arrive as AHardwareBuffers (e.g. from an ImageReader with
+ * USAGE_CPU_READ_OFTEN) instead of Unity Color32 arrays.
+ *
+ * The buffer is locked for CPU reads and converted straight from its mapping into a pool
+ * slab in the active camera mode's format, so a frame costs a single CPU pass and never
+ * touches managed memory. Supports R8G8B8A8/R8G8B8X8, R8G8B8 and Y8Cb8Cr8_420 buffers.
+ */
+class HardwareBufferSource {
+public:
+    // Submit `buffer` as a frame with optional pose/intrinsics (same conventions as submitFrame).
+    // Returns false if the buffer can't be read or the driver dropped the frame.
+    static bool submit(QuestVuforiaDriver* driver, AHardwareBuffer* buffer, bool flipVertically,
+                       const PoseData* pose, const float* intrinsics, int64_t timestamp);
+
+    // Same, for an android.hardware.HardwareBuffer Java object
+    static bool submitJava(QuestVuforiaDriver* driver, jobject hardwareBuffer, bool flipVertically,
+                           const PoseData* pose, const float* intrinsics, int64_t timestamp);
+
+private:
+    static bool submitYuv(QuestVuforiaDriver* driver, AHardwareBuffer* buffer,
+                          const AHardwareBuffer_Desc& desc, bool flipVertically,
+                          const PoseData* pose, const float* intrinsics, int64_t timestamp);
+};
+
+#endif // __ANDROID__
+
+#endif // QUEST_HARDWARE_BUFFER_SOURCE_H
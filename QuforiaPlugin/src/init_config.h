@@ -0,0 +1,23 @@
+#ifndef QUEST_INIT_CONFIG_H
+#define QUEST_INIT_CONFIG_H
+
+#include "thread_config.h"
+#include "memory_config.h"
+#include <cstdint>
+
+/**
+ * Optional driver configuration passed as the userData of vuforiaDriver_init, for native
+ * hosts (like the bench) that initialize the driver themselves. Unity passes a null userData
+ * and sets the same configuration up front with nativeSetThreadConfig/nativeSetMemoryConfig.
+ *
+ * `size` is sizeof(QuforiaInitConfig) as the caller knows it, so fields can be appended
+ * without breaking older callers. The pointed-to arrays only need to live for the call.
+ */
+struct QuforiaInitConfig {
+    uint32_t size;
+    uint32_t threadConfigCount;
+    const QuforiaThreadConfig* threadConfigs;
+    const QuforiaMemoryConfig* memoryConfig;  // Null: use nativeSetMemoryConfig's (or defaults)
+};
+
+#endif // QUEST_INIT_CONFIG_H
@@ -0,0 +1,57 @@
+#include "intrinsics_store.h"
+#include "quforia_log.h"
+#include <cstring>
+
+void intrinsicsFromArray(const float* intrinsics, VuforiaDriver::CameraIntrinsics* out) {
+    // Width/height (indices 0-1) are not part of CameraIntrinsics
+    out->focalLengthX = intrinsics[2];
+    out->focalLengthY = intrinsics[3];
+    out->principalPointX = intrinsics[4];
+    out->principalPointY = intrinsics[5];
+
+    // Distortion coefficients (8 values starting at index 6)
+    for (int i = 0; i < 8; i++) {
+        out->distortionCoefficients[i] = intrinsics[i + 6];
+    }
+}
+
+void intrinsicsToArray(const VuforiaDriver::CameraIntrinsics& intrinsics, float* out) {
+    out[2] = intrinsics.focalLengthX;
+    out[3] = intrinsics.focalLengthY;
+    out[4] = intrinsics.principalPointX;
+    out[5] = intrinsics.principalPointY;
+    for (int i = 0; i < 8; i++) {
+        out[i + 6] = intrinsics.distortionCoefficients[i];
+    }
+}
+
+const IntrinsicsSnapshot* IntrinsicsStore::publish(const float* intrinsics) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    std::unique_ptr<IntrinsicsSnapshot> snapshot(new IntrinsicsSnapshot());
+    snapshot->width = intrinsics[0];
+    snapshot->height = intrinsics[1];
+    intrinsicsFromArray(intrinsics, &snapshot->intrinsics);
+
+    // Newest first: an unchanged calibration is the current one
+    const IntrinsicsSnapshot* previous = current_.load(std::memory_order_relaxed);
+    for (auto it = snapshots_.rbegin(); it != snapshots_.rend(); ++it) {
+        const IntrinsicsSnapshot* existing = it->get();
+        if (existing->width == snapshot->width && existing->height == snapshot->height &&
+            memcmp(&existing->intrinsics, &snapshot->intrinsics, sizeof(snapshot->intrinsics)) == 0) {
+            if (existing != previous) {
+                current_.store(existing, std::memory_order_release);
+                LOGD("Intrinsics version %llu is current again", (unsigned long long)existing->version);
+            }
+            return existing;
+        }
+    }
+
+    snapshot->version = snapshots_.size() + 1;
+    const IntrinsicsSnapshot* published = snapshot.get();
+    snapshots_.push_back(std::move(snapshot));
+    current_.store(published, std::memory_order_release);
+
+    LOGD("Intrinsics version %llu published", (unsigned long long)published->version);
+    return published;
+}
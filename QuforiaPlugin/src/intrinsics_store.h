@@ -0,0 +1,53 @@
+#ifndef QUEST_INTRINSICS_STORE_H
+#define QUEST_INTRINSICS_STORE_H
+
+#include <VuforiaEngine/Driver/Driver.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Unity's intrinsics array layout: [width, height, fx, fy, cx, cy, d0-d7]
+void intrinsicsFromArray(const float* intrinsics, VuforiaDriver::CameraIntrinsics* out);
+void intrinsicsToArray(const VuforiaDriver::CameraIntrinsics& intrinsics, float* out);
+
+// One published calibration; never modified after publication
+struct IntrinsicsSnapshot {
+    uint64_t version;   // Identifies the calibration: 1 for the first, +1 per distinct one
+    float width;        // Resolution the calibration was given for (informational)
+    float height;
+    VuforiaDriver::CameraIntrinsics intrinsics;
+};
+
+/**
+ * Versioned camera calibration. setCameraIntrinsics() publishes an immutable snapshot and
+ * every frame reads the current one with a single acquire load, instead of copying the
+ * calibration under a mutex shared with the Unity thread.
+ *
+ * A reader may still be copying the previous snapshot when a new one is published, so
+ * snapshots stay allocated for the lifetime of the store. A calibration that was published
+ * before becomes current again instead of being copied, so the store holds one snapshot per
+ * distinct calibration however often a looped replay switches between them.
+ */
+class IntrinsicsStore {
+public:
+    IntrinsicsStore() : current_(nullptr) {}
+
+    IntrinsicsStore(const IntrinsicsStore&) = delete;
+    IntrinsicsStore& operator=(const IntrinsicsStore&) = delete;
+
+    // Publish `intrinsics` (Unity array layout). Returns the current snapshot, which is an
+    // earlier one if the same calibration was published before.
+    const IntrinsicsSnapshot* publish(const float* intrinsics);
+
+    // Newest snapshot, or null before the first publish (lock-free)
+    const IntrinsicsSnapshot* current() const { return current_.load(std::memory_order_acquire); }
+
+private:
+    std::mutex writeMutex_;  // Serializes writers only
+    std::vector<std::unique_ptr<IntrinsicsSnapshot>> snapshots_;
+    std::atomic<const IntrinsicsSnapshot*> current_;
+};
+
+#endif // QUEST_INTRINSICS_STORE_H
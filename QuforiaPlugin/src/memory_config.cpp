@@ -0,0 +1,115 @@
+#include "memory_config.h"
+#include "frame_pool.h"
+#include "pixel_convert.h"
+#include "pose_history.h"
+#include "quforia_log.h"
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+// Sanity limits for setMemoryConfig
+static const uint32_t MAX_FRAME_QUEUE_DEPTH = 32;
+static const uint32_t MAX_POSE_HISTORY_MS = 60000;
+static const uint32_t MAX_POSE_RATE_HZ = 10000;
+
+namespace {
+
+std::mutex g_memoryConfigMutex;
+QuforiaMemoryConfig g_memoryConfig = {};
+
+size_t slabBytes(const VuforiaDriver::CameraMode& mode) {
+    const size_t size = frameBufferSize(mode.format, mode.width, mode.height);
+    return (size + FramePool::SLAB_ALIGNMENT - 1) & ~(FramePool::SLAB_ALIGNMENT - 1);
+}
+
+bool withinResolution(const VuforiaDriver::CameraMode& mode, uint32_t maxWidth, uint32_t maxHeight) {
+    return (maxWidth == 0 || mode.width <= maxWidth) && (maxHeight == 0 || mode.height <= maxHeight);
+}
+
+} // namespace
+
+bool MemoryLayout::fits(const VuforiaDriver::CameraMode& mode) const {
+    return withinResolution(mode, maxFrameWidth, maxFrameHeight) && slabBytes(mode) <= slabSize;
+}
+
+MemoryLayout planMemoryLayout(const QuforiaMemoryConfig& config, const VuforiaDriver::CameraMode* modes,
+                              uint32_t modeCount, size_t extraPoolSlots) {
+    MemoryLayout layout;
+    layout.frameQueueDepth = config.frameQueueDepth ? config.frameQueueDepth : QUFORIA_DEFAULT_FRAME_QUEUE_DEPTH;
+    layout.maxFrameWidth = config.maxFrameWidth;
+    layout.maxFrameHeight = config.maxFrameHeight;
+    layout.poseWindowNs = static_cast<int64_t>(config.poseHistoryMs ? config.poseHistoryMs
+                                                                    : QUFORIA_DEFAULT_POSE_HISTORY_MS) * 1000000LL;
+    layout.maxPoseRateHz = config.maxPoseRateHz ? config.maxPoseRateHz : QUFORIA_DEFAULT_MAX_POSE_RATE_HZ;
+    layout.poseCapacity = PoseHistory::capacityFor(layout.poseWindowNs, layout.maxPoseRateHz);
+    // Plus the driver's staging buffer for mapping input pose batches
+    layout.poseHistoryBytes = PoseHistory::bytesFor(layout.poseCapacity) + layout.poseCapacity * sizeof(PoseData);
+    layout.budgetBytes = config.budgetBytes;
+
+    // Largest and smallest slab among the modes within the resolution limit
+    size_t largest = 0;
+    size_t smallest = SIZE_MAX;
+    for (uint32_t i = 0; i < modeCount; i++) {
+        if (withinResolution(modes[i], config.maxFrameWidth, config.maxFrameHeight)) {
+            largest = std::max(largest, slabBytes(modes[i]));
+            smallest = std::min(smallest, slabBytes(modes[i]));
+        }
+    }
+    if (largest == 0) {
+        // Nothing is that small: keep the smallest mode rather than none
+        LOGW("No camera mode fits %ux%u, keeping the smallest", config.maxFrameWidth, config.maxFrameHeight);
+        layout.maxFrameWidth = 0;
+        layout.maxFrameHeight = 0;
+        for (uint32_t i = 0; i < modeCount; i++) {
+            smallest = std::min(smallest, slabBytes(modes[i]));
+        }
+        largest = smallest;
+    }
+    layout.slabSize = largest;
+    layout.framePoolSlots = layout.frameQueueDepth + extraPoolSlots;
+
+    // Over budget: drop the modes with the largest frames, then shorten the queue
+    while (layout.budgetBytes > 0 && layout.totalBytes() > layout.budgetBytes) {
+        if (layout.slabSize > smallest) {
+            size_t next = smallest;
+            for (uint32_t i = 0; i < modeCount; i++) {
+                const size_t size = slabBytes(modes[i]);
+                if (size < layout.slabSize && size > next &&
+                    withinResolution(modes[i], layout.maxFrameWidth, layout.maxFrameHeight)) {
+                    next = size;
+                }
+            }
+            layout.slabSize = next;
+        } else if (layout.frameQueueDepth > 1) {
+            layout.frameQueueDepth--;
+            layout.framePoolSlots--;
+        } else {
+            break;
+        }
+    }
+    layout.budgetMet = layout.budgetBytes == 0 || layout.totalBytes() <= layout.budgetBytes;
+
+    if (!layout.budgetMet) {
+        LOGW("Memory budget of %llu bytes can't be met, using %zu bytes",
+             (unsigned long long)layout.budgetBytes, layout.totalBytes());
+    }
+    return layout;
+}
+
+bool setMemoryConfig(const QuforiaMemoryConfig& config) {
+    if (config.frameQueueDepth > MAX_FRAME_QUEUE_DEPTH || config.poseHistoryMs > MAX_POSE_HISTORY_MS ||
+        config.maxPoseRateHz > MAX_POSE_RATE_HZ) {
+        LOGE("Invalid memory config: queue %u, pose history %u ms at %u Hz",
+             config.frameQueueDepth, config.poseHistoryMs, config.maxPoseRateHz);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_memoryConfigMutex);
+    g_memoryConfig = config;
+    return true;
+}
+
+QuforiaMemoryConfig memoryConfig() {
+    std::lock_guard<std::mutex> lock(g_memoryConfigMutex);
+    return g_memoryConfig;
+}
@@ -0,0 +1,83 @@
+#ifndef QUEST_MEMORY_CONFIG_H
+#define QUEST_MEMORY_CONFIG_H
+
+#include <VuforiaEngine/Driver/Driver.h>
+#include <cstddef>
+#include <cstdint>
+
+// Frame and pose memory requested for the driver (mirrored by QuestVuforiaBridge.MemoryConfig).
+// Zero fields keep the defaults.
+struct QuforiaMemoryConfig {
+    uint32_t frameQueueDepth;  // Frames queued for delivery (default 3)
+    uint32_t maxFrameWidth;    // Camera modes larger than this aren't advertised (0 = no limit)
+    uint32_t maxFrameHeight;
+    uint32_t poseHistoryMs;    // Pose history window (default 3000)
+    uint32_t maxPoseRateHz;    // Highest pose feed rate the window must hold (default 500)
+    uint32_t reserved;
+    uint64_t budgetBytes;      // Limit for frame pool + pose history (0 = none)
+};
+
+// What the driver actually allocated (mirrored by QuestVuforiaBridge.MemoryReport)
+struct QuforiaMemoryReport {
+    uint32_t frameQueueDepth;
+    uint32_t framePoolSlots;   // Queue depth plus the slots in delivery, recording and ingestion
+    uint32_t maxFrameWidth;    // Largest advertised camera mode
+    uint32_t maxFrameHeight;
+    uint32_t poseHistoryMs;
+    uint32_t poseCapacity;     // Poses the history ring holds
+    uint64_t slabBytes;        // Per frame pool slot
+    uint64_t framePoolBytes;
+    uint64_t poseHistoryBytes;
+    uint64_t totalBytes;       // Resident (pre-faulted at init) frame and pose memory
+    uint64_t budgetBytes;
+    int32_t budgetMet;         // 0: even the leanest layout is over budgetBytes
+    int32_t modesAdvertised;   // Camera modes left after the resolution and budget limits
+};
+
+/**
+ * Frame pool and pose history sizing chosen for a QuforiaMemoryConfig.
+ *
+ * Slabs are sized for the largest camera mode still advertised, so the limits work by
+ * dropping modes: first those over maxFrameWidth x maxFrameHeight, then, while the pool
+ * and pose history are over budget, the modes with the largest frames (RGBA before RGB
+ * before YUV 4:2:0 at the same size), down to the modes of the smallest frame size.
+ * After that the queue is shortened down to one frame. If even that is over budget, the
+ * leanest layout is used and budgetMet is false.
+ */
+struct MemoryLayout {
+    size_t frameQueueDepth;
+    size_t framePoolSlots;
+    size_t slabSize;           // Largest frame buffer of the advertised modes
+    uint32_t maxFrameWidth;    // Resolution limit (0 = none)
+    uint32_t maxFrameHeight;
+    int64_t poseWindowNs;
+    uint32_t maxPoseRateHz;
+    size_t poseCapacity;
+    size_t poseHistoryBytes;
+    uint64_t budgetBytes;
+    bool budgetMet;
+
+    // Whether a camera mode is advertised with this layout
+    bool fits(const VuforiaDriver::CameraMode& mode) const;
+    size_t totalBytes() const { return framePoolSlots * slabSize + poseHistoryBytes; }
+};
+
+// Frame queue and pose history used when the config leaves them at 0
+static const uint32_t QUFORIA_DEFAULT_FRAME_QUEUE_DEPTH = 3;
+static const uint32_t QUFORIA_DEFAULT_POSE_HISTORY_MS = 3000;
+static const uint32_t QUFORIA_DEFAULT_MAX_POSE_RATE_HZ = 500;
+
+// Lay out `config` over the camera's `modes`; `extraPoolSlots` are the pool slots needed
+// on top of the frame queue
+MemoryLayout planMemoryLayout(const QuforiaMemoryConfig& config, const VuforiaDriver::CameraMode* modes,
+                              uint32_t modeCount, size_t extraPoolSlots);
+
+/**
+ * Process-wide memory configuration, like the thread configuration: set from Unity before
+ * Vuforia initializes the driver, which reads it (unless a native host's
+ * vuforiaDriver_init userData carries one) and sizes its buffers once. Later changes apply to the next driver.
+ */
+bool setMemoryConfig(const QuforiaMemoryConfig& config);
+QuforiaMemoryConfig memoryConfig();
+
+#endif // QUEST_MEMORY_CONFIG_H
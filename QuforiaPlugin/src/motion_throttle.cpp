@@ -0,0 +1,135 @@
+#include "motion_throttle.h"
+#include "frame_pacing.h"
+#include "quforia_log.h"
+
+constexpr float MotionThrottle::DEFAULT_STATIC_FPS;
+constexpr float MotionThrottle::DEFAULT_STATIC_LINEAR_SPEED;
+constexpr float MotionThrottle::DEFAULT_STATIC_ANGULAR_SPEED;
+
+MotionThrottle::MotionThrottle()
+    : enabled_(false)
+    , hold_(false)
+    , recommendLowResolution_(false)
+    , staticFps_(DEFAULT_STATIC_FPS)
+    , linearThreshold_(DEFAULT_STATIC_LINEAR_SPEED)
+    , angularThreshold_(DEFAULT_STATIC_ANGULAR_SPEED)
+    , static_(false)
+    , staticSince_(0)
+    , lastDeliveredTimestamp_(0)
+    , throttled_(false)
+    , linearSpeed_(-1.0f)
+    , angularSpeed_(-1.0f)
+    , staticNs_(0)
+    , framesThrottled_(0)
+{
+}
+
+void MotionThrottle::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+    LOGI("Motion throttle %s", enabled ? "enabled" : "disabled");
+}
+
+void MotionThrottle::configure(float staticFps, float linearSpeed, float angularSpeed,
+                               bool recommendLowResolution) {
+    if (staticFps > 0.0f) {
+        staticFps_.store(staticFps, std::memory_order_relaxed);
+    }
+    if (linearSpeed > 0.0f) {
+        linearThreshold_.store(linearSpeed, std::memory_order_relaxed);
+    }
+    if (angularSpeed > 0.0f) {
+        angularThreshold_.store(angularSpeed, std::memory_order_relaxed);
+    }
+    recommendLowResolution_.store(recommendLowResolution, std::memory_order_relaxed);
+
+    LOGI("Motion throttle: %.1f fps when static (below %.3f m/s and %.3f rad/s)%s",
+         staticFps_.load(std::memory_order_relaxed), linearThreshold_.load(std::memory_order_relaxed),
+         angularThreshold_.load(std::memory_order_relaxed),
+         recommendLowResolution ? ", low resolution recommended" : "");
+}
+
+void MotionThrottle::setFullRateHold(bool hold) {
+    if (hold_.exchange(hold, std::memory_order_relaxed) != hold) {
+        LOGI("Motion throttle: full rate %s", hold ? "held" : "released");
+    }
+}
+
+void MotionThrottle::reset() {
+    static_ = false;
+    staticSince_ = 0;
+    lastDeliveredTimestamp_ = 0;
+    setThrottled(false);
+    linearSpeed_.store(-1.0f, std::memory_order_relaxed);
+    angularSpeed_.store(-1.0f, std::memory_order_relaxed);
+    staticNs_.store(0, std::memory_order_relaxed);
+}
+
+bool MotionThrottle::shouldDeliver(int64_t timestamp, const PoseMotion* motion) {
+    if (!enabled_.load(std::memory_order_relaxed)) {
+        if (throttled_.load(std::memory_order_relaxed)) {
+            setThrottled(false);
+        }
+        static_ = false;
+        return true;
+    }
+
+    linearSpeed_.store(motion ? motion->linearSpeed : -1.0f, std::memory_order_relaxed);
+    angularSpeed_.store(motion ? motion->angularSpeed : -1.0f, std::memory_order_relaxed);
+
+    // Any motion (or not knowing) resumes full rate with this very frame
+    const bool isStatic = motion &&
+                          motion->linearSpeed < linearThreshold_.load(std::memory_order_relaxed) &&
+                          motion->angularSpeed < angularThreshold_.load(std::memory_order_relaxed);
+    if (!isStatic) {
+        static_ = false;
+        staticNs_.store(0, std::memory_order_relaxed);
+        setThrottled(false);
+        lastDeliveredTimestamp_ = timestamp;
+        return true;
+    }
+
+    if (!static_) {
+        static_ = true;
+        staticSince_ = timestamp;
+    }
+    const int64_t staticNs = timestamp - staticSince_;
+    staticNs_.store(staticNs, std::memory_order_relaxed);
+
+    // Brief pauses and detection in progress keep the full rate
+    if (staticNs < STATIC_DELAY_NS || hold_.load(std::memory_order_relaxed)) {
+        setThrottled(false);
+        lastDeliveredTimestamp_ = timestamp;
+        return true;
+    }
+    setThrottled(true);
+
+    // One frame per static interval
+    const int64_t intervalNs = static_cast<int64_t>(1e9f / staticFps_.load(std::memory_order_relaxed));
+    if (lastDeliveredTimestamp_ != 0 && withinInterval(timestamp - lastDeliveredTimestamp_, intervalNs)) {
+        framesThrottled_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    lastDeliveredTimestamp_ = timestamp;
+    return true;
+}
+
+void MotionThrottle::setThrottled(bool throttled) {
+    if (throttled_.exchange(throttled, std::memory_order_relaxed) != throttled) {
+        LOGI("Motion throttle: %s", throttled ? "headset static, throttling" : "motion, full rate");
+    }
+}
+
+void MotionThrottle::state(QuforiaMotionThrottleState* out) const {
+    const bool throttled = throttled_.load(std::memory_order_relaxed);
+
+    out->enabled = enabled_.load(std::memory_order_relaxed) ? 1 : 0;
+    out->throttled = throttled ? 1 : 0;
+    out->holdFullRate = hold_.load(std::memory_order_relaxed) ? 1 : 0;
+    out->recommendLowResolution = throttled && recommendLowResolution_.load(std::memory_order_relaxed) ? 1 : 0;
+    out->linearSpeed = linearSpeed_.load(std::memory_order_relaxed);
+    out->angularSpeed = angularSpeed_.load(std::memory_order_relaxed);
+    out->staticSeconds = staticNs_.load(std::memory_order_relaxed) / 1e9f;
+    out->staticFps = staticFps_.load(std::memory_order_relaxed);
+    out->framesThrottled = framesThrottled_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,88 @@
+#ifndef QUEST_MOTION_THROTTLE_H
+#define QUEST_MOTION_THROTTLE_H
+
+#include "pose_history.h"
+#include <atomic>
+#include <cstdint>
+
+// Motion throttle state as exported to Unity (mirrored by QuestVuforiaBridge.MotionThrottleState)
+struct QuforiaMotionThrottleState {
+    int32_t enabled;
+    int32_t throttled;               // Headset static: delivering at staticFps
+    int32_t holdFullRate;            // Full rate forced (e.g. while a target is being detected)
+    int32_t recommendLowResolution;  // Throttled and configured to suggest a smaller mode
+    float linearSpeed;               // m/s at the last frame (-1 = no pose)
+    float angularSpeed;              // rad/s at the last frame (-1 = no pose)
+    float staticSeconds;             // How long the headset has been static
+    float staticFps;                 // Delivered rate while throttled
+    uint64_t framesThrottled;        // Frames not delivered because the headset was static
+};
+
+/**
+ * Lowers the delivered frame rate while the headset is static.
+ *
+ * The delivery thread passes the head motion at each frame's capture time (from the pose
+ * history). Once linear and angular speed have both stayed under their thresholds for
+ * STATIC_DELAY_NS, only staticFps frames per second are delivered; the first frame with
+ * motion above either threshold (or without a pose) goes back to full rate immediately.
+ * Optionally the state also recommends a lower resolution camera mode while throttled; like
+ * the governor's recommendation, acting on it is up to Unity since Vuforia picks the mode.
+ *
+ * setFullRateHold() forces full rate regardless of motion, for when Vuforia is still trying
+ * to find a target: a static view of an undetected target is exactly when detection needs
+ * every frame.
+ *
+ * Disabled by default. Updates come from the delivery thread only; state() may be called
+ * from any thread.
+ */
+class MotionThrottle {
+public:
+    static const int64_t STATIC_DELAY_NS = 1000000000LL;
+    static constexpr float DEFAULT_STATIC_FPS = 5.0f;
+    static constexpr float DEFAULT_STATIC_LINEAR_SPEED = 0.05f;   // m/s
+    static constexpr float DEFAULT_STATIC_ANGULAR_SPEED = 0.1f;   // rad/s, ~6 deg/s
+
+    MotionThrottle();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Values <= 0 keep the current setting
+    void configure(float staticFps, float linearSpeed, float angularSpeed, bool recommendLowResolution);
+
+    void setFullRateHold(bool hold);
+
+    // Delivery thread: forget motion history when the camera (re)starts
+    void reset();
+
+    // Delivery thread: whether to deliver the frame captured at `timestamp`, with the head
+    // moving at `motion` (null if no pose); false means it is throttled
+    bool shouldDeliver(int64_t timestamp, const PoseMotion* motion);
+
+    bool isThrottled() const { return throttled_.load(std::memory_order_relaxed); }
+    void state(QuforiaMotionThrottleState* out) const;
+
+private:
+    void setThrottled(bool throttled);
+
+    std::atomic<bool> enabled_;
+    std::atomic<bool> hold_;
+    std::atomic<bool> recommendLowResolution_;
+    std::atomic<float> staticFps_;
+    std::atomic<float> linearThreshold_;
+    std::atomic<float> angularThreshold_;
+
+    // Delivery thread only
+    bool static_;
+    int64_t staticSince_;
+    int64_t lastDeliveredTimestamp_;
+
+    // Published for state()
+    std::atomic<bool> throttled_;
+    std::atomic<float> linearSpeed_;
+    std::atomic<float> angularSpeed_;
+    std::atomic<int64_t> staticNs_;
+    std::atomic<uint64_t> framesThrottled_;
+};
+
+#endif // QUEST_MOTION_THROTTLE_H
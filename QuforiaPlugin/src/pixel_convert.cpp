@@ -0,0 +1,628 @@
+#include "pixel_convert.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define QUFORIA_HAVE_NEON 1
+#endif
+
+using VuforiaDriver::PixelFormat;
+
+uint32_t packedStride(PixelFormat format, uint32_t width) {
+    switch (format) {
+        case PixelFormat::RGB888:
+            return width * 3;
+        case PixelFormat::RGBA8888:
+            return width * 4;
+        case PixelFormat::YUYV:
+            return width * 2;
+        case PixelFormat::NV12:
+        case PixelFormat::NV21:
+        case PixelFormat::YUV420P:
+        case PixelFormat::YV12:
+            return width;
+        default:
+            return 0;
+    }
+}
+
+size_t frameBufferSize(PixelFormat format, uint32_t width, uint32_t height, uint32_t stride) {
+    if (stride == 0) {
+        stride = packedStride(format, width);
+    }
+
+    const size_t planeSize = static_cast<size_t>(stride) * height;
+
+    switch (format) {
+        case PixelFormat::RGB888:
+        case PixelFormat::RGBA8888:
+        case PixelFormat::YUYV:
+            return planeSize;
+        case PixelFormat::NV12:
+        case PixelFormat::NV21:
+            return planeSize + static_cast<size_t>(stride) * (height / 2);
+        case PixelFormat::YUV420P:
+        case PixelFormat::YV12:
+            return planeSize + 2 * static_cast<size_t>(stride / 2) * (height / 2);
+        default:
+            return 0;
+    }
+}
+
+bool isYuv420(PixelFormat format) {
+    return format == PixelFormat::NV12 || format == PixelFormat::NV21 ||
+           format == PixelFormat::YUV420P || format == PixelFormat::YV12;
+}
+
+static bool isRgb(PixelFormat format) {
+    return format == PixelFormat::RGB888 || format == PixelFormat::RGBA8888;
+}
+
+bool canConvert(PixelFormat srcFormat, PixelFormat dstFormat, const ConvertOptions& options) {
+    if (options.downscale2x && !isRgb(srcFormat)) {
+        return false;
+    }
+    if (srcFormat == dstFormat) {
+        return packedStride(srcFormat, 1) != 0;
+    }
+    return isRgb(srcFormat) && (isRgb(dstFormat) || isYuv420(dstFormat));
+}
+
+const char* pixelFormatName(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::YUYV:     return "YUYV";
+        case PixelFormat::NV12:     return "NV12";
+        case PixelFormat::NV21:     return "NV21";
+        case PixelFormat::RGB888:   return "RGB888";
+        case PixelFormat::RGBA8888: return "RGBA8888";
+        case PixelFormat::YUV420P:  return "YUV420P";
+        case PixelFormat::YV12:     return "YV12";
+        default:                    return "UNKNOWN";
+    }
+}
+
+// =============================================================================
+// Plane layout
+// =============================================================================
+
+namespace {
+
+// Chroma plane pointers/strides of a YUV 4:2:0 frame with the given Y stride
+struct ChromaPlanes {
+    uint8_t* u;
+    uint8_t* v;
+    uint32_t stride;   // Row stride of the chroma plane(s)
+    uint32_t step;     // Distance between neighbouring samples (2 when interleaved)
+};
+
+ChromaPlanes chromaPlanes(uint8_t* base, uint32_t stride, uint32_t height, PixelFormat format) {
+    uint8_t* chroma = base + static_cast<size_t>(stride) * height;
+    const size_t quarterPlane = static_cast<size_t>(stride / 2) * (height / 2);
+
+    switch (format) {
+        case PixelFormat::NV12:
+            return { chroma, chroma + 1, stride, 2 };
+        case PixelFormat::NV21:
+            return { chroma + 1, chroma, stride, 2 };
+        case PixelFormat::YUV420P:
+            return { chroma, chroma + quarterPlane, stride / 2, 1 };
+        case PixelFormat::YV12:
+        default:
+            return { chroma + quarterPlane, chroma, stride / 2, 1 };
+    }
+}
+
+// Source rows are addressed as `first + row * step`, so a flipped source is simply its
+// last row with a negative step (no separate flip pass)
+struct SourceRows {
+    const uint8_t* first;
+    ptrdiff_t step;
+
+    const uint8_t* row(uint32_t y) const { return first + static_cast<ptrdiff_t>(y) * step; }
+};
+
+SourceRows sourceRows(const uint8_t* plane, uint32_t stride, uint32_t rows, bool flip) {
+    if (flip && rows > 0) {
+        return { plane + static_cast<size_t>(stride) * (rows - 1), -static_cast<ptrdiff_t>(stride) };
+    }
+    return { plane, static_cast<ptrdiff_t>(stride) };
+}
+
+void copyPlane(SourceRows src, uint8_t* dst, uint32_t dstStride, uint32_t rowBytes, uint32_t rows) {
+    if (src.step == static_cast<ptrdiff_t>(rowBytes) && dstStride == rowBytes) {
+        memcpy(dst, src.first, static_cast<size_t>(rowBytes) * rows);
+        return;
+    }
+    for (uint32_t y = 0; y < rows; y++) {
+        memcpy(dst + static_cast<size_t>(y) * dstStride, src.row(y), rowBytes);
+    }
+}
+
+// Neutral chroma for the chroma rows of luma rows [rowBegin, rowEnd), so Vuforia sees a
+// grayscale image
+void fillNeutralChroma(uint8_t* dst, uint32_t dstStride, PixelFormat format,
+                       uint32_t width, uint32_t height, uint32_t rowBegin, uint32_t rowEnd) {
+    const ChromaPlanes chroma = chromaPlanes(dst, dstStride, height, format);
+    const uint32_t rowBytes = chroma.step == 2 ? width : width / 2;
+    for (uint32_t y = rowBegin / 2; y < rowEnd / 2; y++) {
+        // Interleaved planes: u and v share a row, starting at the lower of the two pointers
+        uint8_t* u = chroma.u + static_cast<size_t>(y) * chroma.stride;
+        uint8_t* v = chroma.v + static_cast<size_t>(y) * chroma.stride;
+        if (chroma.step == 2) {
+            memset(std::min(u, v), 128, rowBytes);
+        } else {
+            memset(u, 128, rowBytes);
+            memset(v, 128, rowBytes);
+        }
+    }
+}
+
+// Copy output rows [rowBegin, rowEnd) of a same-format frame (and their chroma rows)
+void copyFrame(const uint8_t* src, uint32_t srcStride, uint8_t* dst, uint32_t dstStride,
+               PixelFormat format, uint32_t width, uint32_t height, bool flip, bool lumaOnly,
+               uint32_t rowBegin, uint32_t rowEnd) {
+    const uint32_t rowBytes = packedStride(format, width);
+    const SourceRows luma = sourceRows(src, srcStride, height, flip);
+    copyPlane({ luma.row(rowBegin), luma.step }, dst + static_cast<size_t>(dstStride) * rowBegin,
+              dstStride, rowBytes, rowEnd - rowBegin);
+
+    if (lumaOnly && isYuv420(format)) {
+        fillNeutralChroma(dst, dstStride, format, width, height, rowBegin, rowEnd);
+        return;
+    }
+
+    const uint8_t* srcChroma = src + static_cast<size_t>(srcStride) * height;
+    uint8_t* dstChroma = dst + static_cast<size_t>(dstStride) * height;
+    const uint32_t chromaBegin = rowBegin / 2;
+    const uint32_t chromaRows = rowEnd / 2 - chromaBegin;
+
+    if (format == PixelFormat::NV12 || format == PixelFormat::NV21) {
+        const SourceRows rows = sourceRows(srcChroma, srcStride, height / 2, flip);
+        copyPlane({ rows.row(chromaBegin), rows.step },
+                  dstChroma + static_cast<size_t>(dstStride) * chromaBegin, dstStride,
+                  rowBytes, chromaRows);
+    } else if (format == PixelFormat::YUV420P || format == PixelFormat::YV12) {
+        for (int plane = 0; plane < 2; plane++) {
+            const SourceRows rows = sourceRows(srcChroma, srcStride / 2, height / 2, flip);
+            copyPlane({ rows.row(chromaBegin), rows.step },
+                      dstChroma + static_cast<size_t>(dstStride / 2) * chromaBegin, dstStride / 2,
+                      width / 2, chromaRows);
+            srcChroma += static_cast<size_t>(srcStride / 2) * (height / 2);
+            dstChroma += static_cast<size_t>(dstStride / 2) * (height / 2);
+        }
+    }
+}
+
+// =============================================================================
+// Row kernels: RGB repacking and RGB -> YUV 4:2:0 (BT.601 video range)
+// =============================================================================
+
+inline uint8_t lumaOf(int r, int g, int b) {
+    return static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+inline uint8_t chromaUOf(int r, int g, int b) {
+    return static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+}
+
+inline uint8_t chromaVOf(int r, int g, int b) {
+    return static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+}
+
+#ifdef QUFORIA_HAVE_NEON
+
+// 16 pixels of RGB888 or RGBA8888 split into channels
+inline void loadRgb16(const uint8_t* p, uint32_t bpp, uint8x16_t* r, uint8x16_t* g, uint8x16_t* b) {
+    if (bpp == 4) {
+        uint8x16x4_t px = vld4q_u8(p);
+        *r = px.val[0]; *g = px.val[1]; *b = px.val[2];
+    } else {
+        uint8x16x3_t px = vld3q_u8(p);
+        *r = px.val[0]; *g = px.val[1]; *b = px.val[2];
+    }
+}
+
+inline uint8x8_t lumaHalf(uint8x8_t r, uint8x8_t g, uint8x8_t b) {
+    // 66r + 129g + 25b + 128 peaks at 56228, so the sum stays in u16
+    uint16x8_t y = vmull_u8(r, vdup_n_u8(66));
+    y = vmlal_u8(y, g, vdup_n_u8(129));
+    y = vmlal_u8(y, b, vdup_n_u8(25));
+    y = vaddq_u16(y, vdupq_n_u16(128));
+    return vadd_u8(vshrn_n_u16(y, 8), vdup_n_u8(16));
+}
+
+inline uint8x16_t luma16(uint8x16_t r, uint8x16_t g, uint8x16_t b) {
+    return vcombine_u8(lumaHalf(vget_low_u8(r), vget_low_u8(g), vget_low_u8(b)),
+                       lumaHalf(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b)));
+}
+
+// Rounded average of horizontally adjacent pairs across two rows (8 results)
+inline int16x8_t blockAverage(uint8x16_t top, uint8x16_t bottom) {
+    uint16x8_t sum = vaddq_u16(vpaddlq_u8(top), vpaddlq_u8(bottom));
+    return vreinterpretq_s16_u16(vshrq_n_u16(vaddq_u16(sum, vdupq_n_u16(2)), 2));
+}
+
+// (c0*x + c1*y + c2*z + 128) >> 8, + 128; each product sum stays within +-28688
+inline uint8x8_t chroma8(int16x8_t x, int16x8_t y, int16x8_t z, int16_t c0, int16_t c1, int16_t c2) {
+    int16x8_t acc = vmulq_n_s16(x, c0);
+    acc = vmlaq_n_s16(acc, y, c1);
+    acc = vmlaq_n_s16(acc, z, c2);
+    acc = vshrq_n_s16(vaddq_s16(acc, vdupq_n_s16(128)), 8);
+    return vqmovun_s16(vaddq_s16(acc, vdupq_n_s16(128)));
+}
+
+#endif // QUFORIA_HAVE_NEON
+
+// 2x2 box filter of two source rows into one half-width row of the same layout
+void downscaleRow(const uint8_t* row0, const uint8_t* row1, uint32_t bpp, uint8_t* out,
+                  uint32_t outWidth) {
+    uint32_t x = 0;
+
+#ifdef QUFORIA_HAVE_NEON
+    if (bpp == 4) {
+        for (; x + 8 <= outWidth; x += 8) {
+            uint8x16x4_t top = vld4q_u8(row0 + x * 8);
+            uint8x16x4_t bottom = vld4q_u8(row1 + x * 8);
+            uint8x8x4_t half;
+            for (int c = 0; c < 4; c++) {
+                uint16x8_t sum = vaddq_u16(vpaddlq_u8(top.val[c]), vpaddlq_u8(bottom.val[c]));
+                half.val[c] = vrshrn_n_u16(sum, 2);
+            }
+            vst4_u8(out + x * 4, half);
+        }
+    } else {
+        for (; x + 8 <= outWidth; x += 8) {
+            uint8x16x3_t top = vld3q_u8(row0 + x * 6);
+            uint8x16x3_t bottom = vld3q_u8(row1 + x * 6);
+            uint8x8x3_t half;
+            for (int c = 0; c < 3; c++) {
+                uint16x8_t sum = vaddq_u16(vpaddlq_u8(top.val[c]), vpaddlq_u8(bottom.val[c]));
+                half.val[c] = vrshrn_n_u16(sum, 2);
+            }
+            vst3_u8(out + x * 3, half);
+        }
+    }
+#endif
+
+    for (; x < outWidth; x++) {
+        const uint8_t* p0 = row0 + x * 2 * bpp;
+        const uint8_t* p1 = row1 + x * 2 * bpp;
+        for (uint32_t c = 0; c < bpp; c++) {
+            out[x * bpp + c] = static_cast<uint8_t>((p0[c] + p0[c + bpp] + p1[c] + p1[c + bpp] + 2) >> 2);
+        }
+    }
+}
+
+// Source rows as seen by the kernels: either the caller's rows, or 2x-downscaled copies of
+// them produced one at a time into a per-thread scratch row
+class RowReader {
+public:
+    RowReader(SourceRows src, uint32_t bpp, uint32_t outWidth, bool downscale)
+        : src_(src), bpp_(bpp), outWidth_(outWidth), downscale_(downscale) {
+        if (downscale_) {
+            static thread_local std::vector<uint8_t> scratch;
+            if (scratch.size() < 2 * static_cast<size_t>(outWidth) * bpp) {
+                scratch.resize(2 * static_cast<size_t>(outWidth) * bpp);
+            }
+            scratch_ = scratch.data();
+        }
+    }
+
+    // `slot` (0 or 1) picks which scratch row a downscaled row is written to, so two rows
+    // can be live at once
+    const uint8_t* row(uint32_t y, int slot) const {
+        if (!downscale_) {
+            return src_.row(y);
+        }
+        uint8_t* out = scratch_ + slot * static_cast<size_t>(outWidth_) * bpp_;
+        downscaleRow(src_.row(2 * y), src_.row(2 * y + 1), bpp_, out, outWidth_);
+        return out;
+    }
+
+private:
+    SourceRows src_;
+    uint32_t bpp_;
+    uint32_t outWidth_;
+    bool downscale_;
+    uint8_t* scratch_ = nullptr;
+};
+
+void rgbToRgbRow(const uint8_t* s, uint32_t srcBpp, uint8_t* d, uint32_t dstBpp, uint32_t width) {
+    uint32_t x = 0;
+
+#ifdef QUFORIA_HAVE_NEON
+    if (srcBpp == 4 && dstBpp == 3) {
+        for (; x + 16 <= width; x += 16) {
+            uint8x16x4_t px = vld4q_u8(s + x * 4);
+            uint8x16x3_t out = { { px.val[0], px.val[1], px.val[2] } };
+            vst3q_u8(d + x * 3, out);
+        }
+    } else if (srcBpp == 3 && dstBpp == 4) {
+        for (; x + 16 <= width; x += 16) {
+            uint8x16x3_t px = vld3q_u8(s + x * 3);
+            uint8x16x4_t out = { { px.val[0], px.val[1], px.val[2], vdupq_n_u8(0xFF) } };
+            vst4q_u8(d + x * 4, out);
+        }
+    }
+#endif
+
+    for (; x < width; x++) {
+        const uint8_t* sp = s + x * srcBpp;
+        uint8_t* dp = d + x * dstBpp;
+        dp[0] = sp[0];
+        dp[1] = sp[1];
+        dp[2] = sp[2];
+        if (dstBpp == 4) {
+            dp[3] = 0xFF;
+        }
+    }
+}
+
+// Two source rows -> two luma rows + one chroma row (luma only when u/v are null)
+void rgbToYuv420Rows(const uint8_t* row0, const uint8_t* row1, uint32_t srcBpp,
+                     uint8_t* luma0, uint8_t* luma1, uint8_t* u, uint8_t* v, uint32_t chromaStep,
+                     uint32_t width) {
+    uint32_t x = 0;
+
+#ifdef QUFORIA_HAVE_NEON
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t r0, g0, b0, r1, g1, b1;
+        loadRgb16(row0 + x * srcBpp, srcBpp, &r0, &g0, &b0);
+        loadRgb16(row1 + x * srcBpp, srcBpp, &r1, &g1, &b1);
+
+        vst1q_u8(luma0 + x, luma16(r0, g0, b0));
+        vst1q_u8(luma1 + x, luma16(r1, g1, b1));
+
+        if (!u) {
+            continue;
+        }
+
+        const int16x8_t r = blockAverage(r0, r1);
+        const int16x8_t g = blockAverage(g0, g1);
+        const int16x8_t b = blockAverage(b0, b1);
+        const uint8x8_t cu = chroma8(r, g, b, -38, -74, 112);
+        const uint8x8_t cv = chroma8(r, g, b, 112, -94, -18);
+
+        uint8_t* uOut = u + (x / 2) * chromaStep;
+        uint8_t* vOut = v + (x / 2) * chromaStep;
+        if (chromaStep == 2) {
+            // Interleaved: store at whichever of u/v comes first in memory
+            if (uOut < vOut) {
+                uint8x8x2_t uv = { { cu, cv } };
+                vst2_u8(uOut, uv);
+            } else {
+                uint8x8x2_t vu = { { cv, cu } };
+                vst2_u8(vOut, vu);
+            }
+        } else {
+            vst1_u8(uOut, cu);
+            vst1_u8(vOut, cv);
+        }
+    }
+#endif
+
+    for (; x < width; x += 2) {
+        const uint8_t* p00 = row0 + x * srcBpp;
+        const uint8_t* p01 = p00 + srcBpp;
+        const uint8_t* p10 = row1 + x * srcBpp;
+        const uint8_t* p11 = p10 + srcBpp;
+
+        luma0[x] = lumaOf(p00[0], p00[1], p00[2]);
+        luma0[x + 1] = lumaOf(p01[0], p01[1], p01[2]);
+        luma1[x] = lumaOf(p10[0], p10[1], p10[2]);
+        luma1[x + 1] = lumaOf(p11[0], p11[1], p11[2]);
+
+        if (!u) {
+            continue;
+        }
+
+        // Chroma from the 2x2 block average
+        const int r = (p00[0] + p01[0] + p10[0] + p11[0] + 2) >> 2;
+        const int g = (p00[1] + p01[1] + p10[1] + p11[1] + 2) >> 2;
+        const int b = (p00[2] + p01[2] + p10[2] + p11[2] + 2) >> 2;
+
+        u[(x / 2) * chromaStep] = chromaUOf(r, g, b);
+        v[(x / 2) * chromaStep] = chromaVOf(r, g, b);
+    }
+}
+
+void rgbToRgb(const RowReader& src, uint32_t srcBpp, uint8_t* dst, uint32_t dstStride,
+              uint32_t dstBpp, uint32_t width, uint32_t rowBegin, uint32_t rowEnd) {
+    for (uint32_t y = rowBegin; y < rowEnd; y++) {
+        rgbToRgbRow(src.row(y, 0), srcBpp, dst + static_cast<size_t>(y) * dstStride, dstBpp, width);
+    }
+}
+
+void rgbToYuv420(const RowReader& src, uint32_t srcBpp, uint8_t* dst, uint32_t dstStride,
+                 PixelFormat dstFormat, uint32_t width, uint32_t height, bool lumaOnly,
+                 uint32_t rowBegin, uint32_t rowEnd) {
+    ChromaPlanes chroma = chromaPlanes(dst, dstStride, height, dstFormat);
+    if (lumaOnly) {
+        fillNeutralChroma(dst, dstStride, dstFormat, width, height, rowBegin, rowEnd);
+    }
+
+    for (uint32_t y = rowBegin; y < rowEnd; y += 2) {
+        uint8_t* luma0 = dst + static_cast<size_t>(y) * dstStride;
+        const uint8_t* row0 = src.row(y, 0);
+        const uint8_t* row1 = src.row(y + 1, 1);
+        rgbToYuv420Rows(row0, row1, srcBpp, luma0, luma0 + dstStride,
+                        lumaOnly ? nullptr : chroma.u + static_cast<size_t>(y / 2) * chroma.stride,
+                        lumaOnly ? nullptr : chroma.v + static_cast<size_t>(y / 2) * chroma.stride,
+                        chroma.step, width);
+    }
+}
+
+} // namespace
+
+bool convertFrame(const uint8_t* src, uint32_t srcStride, PixelFormat srcFormat,
+                  uint8_t* dst, uint32_t dstStride, PixelFormat dstFormat,
+                  uint32_t width, uint32_t height, const ConvertOptions& options) {
+    const uint32_t outHeight = options.downscale2x ? height / 2 : height;
+    return convertFrameRows(src, srcStride, srcFormat, dst, dstStride, dstFormat,
+                            width, height, 0, outHeight, options);
+}
+
+bool convertFrameRows(const uint8_t* src, uint32_t srcStride, PixelFormat srcFormat,
+                      uint8_t* dst, uint32_t dstStride, PixelFormat dstFormat,
+                      uint32_t width, uint32_t height, uint32_t rowBegin, uint32_t rowEnd,
+                      const ConvertOptions& options) {
+    if (!src || !dst || !canConvert(srcFormat, dstFormat, options)) {
+        return false;
+    }
+
+    const uint32_t outWidth = options.downscale2x ? width / 2 : width;
+    const uint32_t outHeight = options.downscale2x ? height / 2 : height;
+
+    if (isYuv420(dstFormat) && ((outWidth | outHeight | rowBegin | rowEnd) & 1)) {
+        return false;
+    }
+    if (rowBegin > rowEnd || rowEnd > outHeight) {
+        return false;
+    }
+
+    if (srcStride == 0) {
+        srcStride = packedStride(srcFormat, width);
+    }
+    if (dstStride == 0) {
+        dstStride = packedStride(dstFormat, outWidth);
+    }
+
+    if (srcFormat == dstFormat && !options.downscale2x) {
+        copyFrame(src, srcStride, dst, dstStride, srcFormat, width, height,
+                  options.flipVertically, options.lumaOnly, rowBegin, rowEnd);
+        return true;
+    }
+
+    const uint32_t srcBpp = srcFormat == PixelFormat::RGBA8888 ? 4 : 3;
+    const RowReader rows(sourceRows(src, srcStride, height, options.flipVertically), srcBpp,
+                         outWidth, options.downscale2x);
+
+    if (isRgb(dstFormat)) {
+        const uint32_t dstBpp = dstFormat == PixelFormat::RGBA8888 ? 4 : 3;
+        rgbToRgb(rows, srcBpp, dst, dstStride, dstBpp, outWidth, rowBegin, rowEnd);
+    } else {
+        rgbToYuv420(rows, srcBpp, dst, dstStride, dstFormat, outWidth, outHeight, options.lumaOnly,
+                    rowBegin, rowEnd);
+    }
+    return true;
+}
+
+// =============================================================================
+// Plane-described YUV 4:2:0 sources
+// =============================================================================
+
+static inline uint8_t clampToByte(int value) {
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+bool convertYuvPlanes(const YuvPlanes& src, uint8_t* dst, uint32_t dstStride, PixelFormat dstFormat,
+                      uint32_t width, uint32_t height, const ConvertOptions& options) {
+    if (!src.y || !src.u || !src.v || !dst || options.downscale2x ||
+        src.uvPixelStride == 0 || ((width | height) & 1) ||
+        !(isYuv420(dstFormat) || isRgb(dstFormat))) {
+        return false;
+    }
+
+    if (dstStride == 0) {
+        dstStride = packedStride(dstFormat, width);
+    }
+
+    const bool flip = options.flipVertically;
+    const SourceRows yRows = sourceRows(src.y, src.yRowStride, height, flip);
+    const SourceRows uRows = sourceRows(src.u, src.uvRowStride, height / 2, flip);
+    const SourceRows vRows = sourceRows(src.v, src.uvRowStride, height / 2, flip);
+    const uint32_t step = src.uvPixelStride;
+
+    if (isYuv420(dstFormat)) {
+        copyPlane(yRows, dst, dstStride, width, height);
+
+        if (options.lumaOnly) {
+            fillNeutralChroma(dst, dstStride, dstFormat, width, height, 0, height);
+            return true;
+        }
+
+        ChromaPlanes chroma = chromaPlanes(dst, dstStride, height, dstFormat);
+        for (uint32_t y = 0; y < height / 2; y++) {
+            const uint8_t* u = uRows.row(y);
+            const uint8_t* v = vRows.row(y);
+            uint8_t* uOut = chroma.u + static_cast<size_t>(y) * chroma.stride;
+            uint8_t* vOut = chroma.v + static_cast<size_t>(y) * chroma.stride;
+            for (uint32_t x = 0; x < width / 2; x++) {
+                uOut[x * chroma.step] = u[x * step];
+                vOut[x * chroma.step] = v[x * step];
+            }
+        }
+        return true;
+    }
+
+    // YUV -> RGB: each chroma sample covers a 2x2 block
+    const uint32_t dstBpp = dstFormat == PixelFormat::RGBA8888 ? 4 : 3;
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* luma = yRows.row(y);
+        const uint8_t* u = uRows.row(y / 2);
+        const uint8_t* v = vRows.row(y / 2);
+        uint8_t* out = dst + static_cast<size_t>(y) * dstStride;
+
+        for (uint32_t x = 0; x < width; x++) {
+            const int c = 298 * (luma[x] - 16);
+            const int d = options.lumaOnly ? 0 : u[(x / 2) * step] - 128;
+            const int e = options.lumaOnly ? 0 : v[(x / 2) * step] - 128;
+
+            out[0] = clampToByte((c + 409 * e + 128) >> 8);
+            out[1] = clampToByte((c - 100 * d - 208 * e + 128) >> 8);
+            out[2] = clampToByte((c + 516 * d + 128) >> 8);
+            if (dstBpp == 4) {
+                out[3] = 0xFF;
+            }
+            out += dstBpp;
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// Cropping
+// =============================================================================
+
+static bool windowFits(uint32_t width, uint32_t height, const CropWindow& window) {
+    return window.width > 0 && window.height > 0 &&
+           window.x + window.width <= width && window.y + window.height <= height;
+}
+
+bool cropPackedFrame(const uint8_t** pixels, uint32_t stride, PixelFormat format,
+                     uint32_t width, uint32_t height, const CropWindow& window,
+                     bool flipVertically) {
+    if (format != PixelFormat::RGB888 && format != PixelFormat::RGBA8888 &&
+        format != PixelFormat::YUYV) {
+        return false;
+    }
+    // YUYV pairs share their chroma, so windows start on an even column
+    if (!windowFits(width, height, window) || (format == PixelFormat::YUYV && (window.x & 1))) {
+        return false;
+    }
+    if (stride == 0) {
+        stride = packedStride(format, width);
+    }
+
+    const uint32_t row = flipVertically ? height - window.y - window.height : window.y;
+    *pixels += static_cast<size_t>(row) * stride + packedStride(format, window.x);
+    return true;
+}
+
+bool cropYuvPlanes(YuvPlanes* planes, uint32_t width, uint32_t height, const CropWindow& window,
+                   bool flipVertically) {
+    if (!windowFits(width, height, window) ||
+        ((window.x | window.y | window.width | window.height) & 1)) {
+        return false;
+    }
+
+    const uint32_t row = flipVertically ? height - window.y - window.height : window.y;
+    const size_t chromaOffset = static_cast<size_t>(row / 2) * planes->uvRowStride +
+                                static_cast<size_t>(window.x / 2) * planes->uvPixelStride;
+    planes->y += static_cast<size_t>(row) * planes->yRowStride + window.x;
+    planes->u += chromaOffset;
+    planes->v += chromaOffset;
+    return true;
+}
@@ -0,0 +1,98 @@
+#ifndef QUEST_PIXEL_CONVERT_H
+#define QUEST_PIXEL_CONVERT_H
+
+#include <VuforiaEngine/Driver/Driver.h>
+#include <cstddef>
+#include <cstdint>
+
+// Bytes per row of the first plane of a tightly packed frame
+uint32_t packedStride(VuforiaDriver::PixelFormat format, uint32_t width);
+
+// Bytes needed for a frame whose first plane has `stride` bytes per row (0 = tightly packed).
+// For NV12/NV21 the UV plane shares the Y stride; for YUV420P/YV12 the U/V planes use half of it.
+size_t frameBufferSize(VuforiaDriver::PixelFormat format, uint32_t width, uint32_t height,
+                       uint32_t stride = 0);
+
+// True for YUV 4:2:0 layouts (Y plane followed by subsampled chroma)
+bool isYuv420(VuforiaDriver::PixelFormat format);
+
+// Optional processing folded into the conversion pass
+struct ConvertOptions {
+    bool flipVertically = false;  // Read the source bottom-up (Unity textures are upside down)
+    bool lumaOnly = false;        // YUV targets: constant (128) chroma instead of computing it
+    bool downscale2x = false;     // 2x2 box filter to half width/height (RGB sources only)
+};
+
+// Whether convertFrame() can turn srcFormat into dstFormat with the given options
+bool canConvert(VuforiaDriver::PixelFormat srcFormat, VuforiaDriver::PixelFormat dstFormat,
+                const ConvertOptions& options = ConvertOptions());
+
+/**
+ * Copy or convert a width x height source frame between pixel formats.
+ * Supports any format to itself (restriding), RGB888 <-> RGBA8888, and RGB888/RGBA8888
+ * to NV12, NV21, YUV420P and YV12 (BT.601 video range). YUV 4:2:0 needs even output dimensions.
+ * With downscale2x the destination is width/2 x height/2.
+ * Uses NEON kernels on ARM, scalar code elsewhere. Returns false for unsupported conversions.
+ */
+bool convertFrame(const uint8_t* src, uint32_t srcStride, VuforiaDriver::PixelFormat srcFormat,
+                  uint8_t* dst, uint32_t dstStride, VuforiaDriver::PixelFormat dstFormat,
+                  uint32_t width, uint32_t height,
+                  const ConvertOptions& options = ConvertOptions());
+
+/**
+ * convertFrame() restricted to output rows [rowBegin, rowEnd) (and, for YUV 4:2:0, their
+ * chroma rows), so a frame can be converted in tiles on several threads. Every tile writes
+ * a disjoint part of dst. Row bounds must be even for YUV 4:2:0 outputs.
+ */
+bool convertFrameRows(const uint8_t* src, uint32_t srcStride, VuforiaDriver::PixelFormat srcFormat,
+                      uint8_t* dst, uint32_t dstStride, VuforiaDriver::PixelFormat dstFormat,
+                      uint32_t width, uint32_t height, uint32_t rowBegin, uint32_t rowEnd,
+                      const ConvertOptions& options = ConvertOptions());
+
+// A YUV 4:2:0 image described plane by plane, as android.media.Image and
+// AHardwareBuffer_lockPlanes() report it (planes need not be contiguous)
+struct YuvPlanes {
+    const uint8_t* y;
+    const uint8_t* u;
+    const uint8_t* v;
+    uint32_t yRowStride;
+    uint32_t uvRowStride;
+    uint32_t uvPixelStride;  // 1 = planar, 2 = semi-planar (interleaved)
+};
+
+/**
+ * Repack a plane-described YUV 4:2:0 image into a contiguous NV12/NV21/YUV420P/YV12 frame,
+ * or convert it to RGB888/RGBA8888 (BT.601 video range). Honors flipVertically and lumaOnly;
+ * downscale2x is not supported. Needs even dimensions.
+ */
+bool convertYuvPlanes(const YuvPlanes& src, uint8_t* dst, uint32_t dstStride,
+                      VuforiaDriver::PixelFormat dstFormat, uint32_t width, uint32_t height,
+                      const ConvertOptions& options = ConvertOptions());
+
+// Window of a frame, in upright image coordinates (the orientation frames are delivered in)
+struct CropWindow {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t width = 0;   // 0 = no crop
+    uint32_t height = 0;
+};
+
+/**
+ * Crop without copying: point *pixels at `window` of a single-plane frame (RGB888, RGBA8888,
+ * YUYV) that is `height` rows of `stride` bytes. Rows keep their stride, so the result feeds
+ * convertFrame() as a window.width x window.height frame. With flipVertically the source is
+ * stored bottom-up and the window's rows are counted from the end. False for planar layouts
+ * or a window outside the frame.
+ */
+bool cropPackedFrame(const uint8_t** pixels, uint32_t stride, VuforiaDriver::PixelFormat format,
+                     uint32_t width, uint32_t height, const CropWindow& window,
+                     bool flipVertically = false);
+
+// Same for a plane-described YUV 4:2:0 image; the window origin and size must be even
+bool cropYuvPlanes(YuvPlanes* planes, uint32_t width, uint32_t height, const CropWindow& window,
+                   bool flipVertically = false);
+
+// Human-readable format name for logging
+const char* pixelFormatName(VuforiaDriver::PixelFormat format);
+
+#endif // QUEST_PIXEL_CONVERT_H
@@ -0,0 +1,290 @@
+#include "pose_history.h"
+#include "quforia_log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Never extrapolate further ahead than one more sample interval
+static const double MAX_EXTRAPOLATION_FACTOR = 2.0;
+
+PoseHistory::PoseHistory()
+    : windowNs_(0)
+    , newestTimestamp_(INT64_MIN)
+    , windowStart_(0)
+    , publishedWindowStart_(0)
+    , maxExtrapolationNs_(DEFAULT_MAX_EXTRAPOLATION_NS)
+    , maxInterpolationGapNs_(DEFAULT_MAX_INTERPOLATION_GAP_NS)
+{
+}
+
+size_t PoseHistory::capacityFor(int64_t windowNs, uint32_t maxRateHz) {
+    // A quarter headroom for rate jitter, plus the sample just outside the window that
+    // lookups at the edge bracket with
+    return static_cast<size_t>(windowNs * maxRateHz / 1000000000LL) * 5 / 4 + 2;
+}
+
+void PoseHistory::allocate(int64_t windowNs, uint32_t maxRateHz) {
+    ring_.allocate(capacityFor(windowNs, maxRateHz));
+    windowNs_ = windowNs;
+    newestTimestamp_ = INT64_MIN;
+    windowStart_ = 0;
+    publishedWindowStart_.store(0, std::memory_order_release);
+}
+
+bool PoseHistory::push(const PoseData& pose) {
+    if (pose.timestamp < newestTimestamp_) {
+        return false;
+    }
+
+    newestTimestamp_ = pose.timestamp;
+    ring_.push(pose);
+    advanceWindow();
+    return true;
+}
+
+size_t PoseHistory::pushBatch(const PoseData* poses, size_t count) {
+    size_t accepted = 0;
+    size_t runStart = 0;
+    int64_t newest = newestTimestamp_;
+
+    // Publish each in-order run at once; a normal batch is a single run
+    for (size_t i = 0; i < count; i++) {
+        if (poses[i].timestamp >= newest) {
+            newest = poses[i].timestamp;
+            continue;
+        }
+        if (i > runStart) {
+            ring_.pushBatch(poses + runStart, i - runStart);
+            accepted += i - runStart;
+        }
+        runStart = i + 1;
+    }
+    if (count > runStart) {
+        ring_.pushBatch(poses + runStart, count - runStart);
+        accepted += count - runStart;
+    }
+
+    if (accepted > 0) {
+        newestTimestamp_ = newest;
+        advanceWindow();
+    }
+    return accepted;
+}
+
+void PoseHistory::advanceWindow() {
+    const uint64_t head = ring_.head();
+    const uint64_t ringOldest = ring_.oldest(head);
+
+    if (windowStart_ < ringOldest) {
+        // The ring wrapped before the window was up: poses arrive faster than it was sized for
+        LOGW_EVERY_MS(5000, "Pose rate exceeds the history capacity (%zu poses for %.1f s)",
+                      ring_.capacity(), windowNs_ / 1e9);
+        windowStart_ = ringOldest;
+    }
+
+    // Keep one sample older than the window start, so lookups at the edge still bracket
+    const int64_t cutoff = newestTimestamp_ - windowNs_;
+    PoseData pose;
+    while (windowStart_ + 1 < head && ring_.read(windowStart_ + 1, &pose) &&
+           pose.timestamp <= cutoff) {
+        windowStart_++;
+    }
+
+    publishedWindowStart_.store(windowStart_, std::memory_order_release);
+}
+
+uint64_t PoseHistory::oldest(uint64_t head) const {
+    // The window start may already be past a head loaded before it moved
+    const uint64_t windowStart = publishedWindowStart_.load(std::memory_order_acquire);
+    return std::min(std::max(ring_.oldest(head), windowStart), head);
+}
+
+int64_t PoseHistory::newestTimestamp() const {
+    const uint64_t head = ring_.head();
+    PoseData newest;
+    return head > 0 && ring_.read(head - 1, &newest) ? newest.timestamp : INT64_MIN;
+}
+
+uint64_t PoseHistory::size() const {
+    const uint64_t head = ring_.head();
+    return head - oldest(head);
+}
+
+uint64_t PoseHistory::lowerBound(int64_t timestamp, uint64_t lo, uint64_t hi) const {
+    while (lo < hi) {
+        const uint64_t mid = lo + (hi - lo) / 2;
+
+        PoseData pose;
+        if (!ring_.read(mid, &pose)) {
+            // Overwritten by the producer: everything up to mid has aged out
+            lo = mid + 1;
+            continue;
+        }
+
+        if (pose.timestamp < timestamp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool PoseHistory::sample(int64_t timestamp, PoseData* outPose, int64_t* matchErrorNs) const {
+    const uint64_t head = ring_.head();
+    if (head == 0) {
+        return false;
+    }
+
+    const uint64_t lo = oldest(head);
+    const uint64_t index = lowerBound(timestamp, lo, head);
+
+    PoseData before;
+    PoseData after;
+    const bool hasBefore = index > lo && ring_.read(index - 1, &before);
+    const bool hasAfter = index < head && ring_.read(index, &after);
+
+    const int64_t maxGap = maxInterpolationGapNs_.load(std::memory_order_relaxed);
+    const int64_t maxExtrapolation = maxExtrapolationNs_.load(std::memory_order_relaxed);
+
+    // Bracketed: interpolate between the two neighbours
+    if (hasBefore && hasAfter) {
+        const int64_t gap = after.timestamp - before.timestamp;
+        const int64_t errorBefore = timestamp - before.timestamp;
+        const int64_t errorAfter = after.timestamp - timestamp;
+
+        if (gap <= maxGap) {
+            const double t = gap > 0 ? static_cast<double>(errorBefore) / gap : 0.0;
+            interpolatePose(before, after, t, outPose);
+        } else {
+            // Too far apart to trust a blend, use the nearer sample if it's close enough
+            const PoseData& nearest = errorBefore <= errorAfter ? before : after;
+            if (std::min(errorBefore, errorAfter) > DEFAULT_MAX_NEAREST_DISTANCE_NS) {
+                return false;
+            }
+            *outPose = nearest;
+        }
+
+        outPose->timestamp = timestamp;
+        if (matchErrorNs) {
+            *matchErrorNs = std::min(errorBefore, errorAfter);
+        }
+        return true;
+    }
+
+    // Past the newest sample: short extrapolation, otherwise hold the newest pose
+    if (hasBefore) {
+        const int64_t ahead = timestamp - before.timestamp;
+
+        PoseData previous;
+        if (ahead <= maxExtrapolation && index >= lo + 2 &&
+            ring_.read(index - 2, &previous) &&
+            before.timestamp > previous.timestamp &&
+            before.timestamp - previous.timestamp <= maxGap) {
+            double t = static_cast<double>(timestamp - previous.timestamp) /
+                       (before.timestamp - previous.timestamp);
+            interpolatePose(previous, before, std::min(t, MAX_EXTRAPOLATION_FACTOR), outPose);
+        } else if (ahead <= DEFAULT_MAX_NEAREST_DISTANCE_NS) {
+            *outPose = before;
+        } else {
+            return false;
+        }
+
+        outPose->timestamp = timestamp;
+        if (matchErrorNs) {
+            *matchErrorNs = ahead;
+        }
+        return true;
+    }
+
+    // Before the oldest sample: nearest only
+    if (hasAfter && after.timestamp - timestamp <= DEFAULT_MAX_NEAREST_DISTANCE_NS) {
+        *outPose = after;
+        outPose->timestamp = timestamp;
+        if (matchErrorNs) {
+            *matchErrorNs = after.timestamp - timestamp;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool PoseHistory::motionAt(int64_t timestamp, int64_t spanNs, PoseMotion* out) const {
+    PoseData from;
+    PoseData to;
+    if (spanNs <= 0 || !sample(timestamp - spanNs, &from) || !sample(timestamp, &to)) {
+        return false;
+    }
+
+    double distance = 0.0;
+    for (int i = 0; i < 3; i++) {
+        const double d = static_cast<double>(to.position[i]) - from.position[i];
+        distance += d * d;
+    }
+
+    // Rotation angle between the two orientations, either sign of the quaternion
+    double dot = 0.0;
+    for (int i = 0; i < 4; i++) {
+        dot += static_cast<double>(from.rotation[i]) * to.rotation[i];
+    }
+    const double angle = 2.0 * std::acos(std::min(std::fabs(dot), 1.0));
+
+    const double seconds = spanNs / 1e9;
+    out->linearSpeed = static_cast<float>(std::sqrt(distance) / seconds);
+    out->angularSpeed = static_cast<float>(angle / seconds);
+    return true;
+}
+
+// =============================================================================
+// Interpolation
+// =============================================================================
+
+void interpolatePose(const PoseData& a, const PoseData& b, double t, PoseData* out) {
+    // Position: linear
+    for (int i = 0; i < 3; i++) {
+        out->position[i] = static_cast<float>(a.position[i] + (b.position[i] - a.position[i]) * t);
+    }
+
+    // Rotation: SLERP along the shortest arc
+    double qa[4] = { a.rotation[0], a.rotation[1], a.rotation[2], a.rotation[3] };
+    double qb[4] = { b.rotation[0], b.rotation[1], b.rotation[2], b.rotation[3] };
+
+    double dot = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3];
+    if (dot < 0.0) {
+        dot = -dot;
+        for (int i = 0; i < 4; i++) {
+            qb[i] = -qb[i];
+        }
+    }
+
+    double wa;
+    double wb;
+    if (dot > 0.9995) {
+        // Nearly parallel: normalized lerp avoids dividing by a tiny sin()
+        wa = 1.0 - t;
+        wb = t;
+    } else {
+        const double theta = std::acos(dot);
+        const double sinTheta = std::sin(theta);
+        wa = std::sin((1.0 - t) * theta) / sinTheta;
+        wb = std::sin(t * theta) / sinTheta;
+    }
+
+    double q[4];
+    double norm = 0.0;
+    for (int i = 0; i < 4; i++) {
+        q[i] = wa * qa[i] + wb * qb[i];
+        norm += q[i] * q[i];
+    }
+
+    if (norm > 0.0) {
+        norm = 1.0 / std::sqrt(norm);
+        for (int i = 0; i < 4; i++) {
+            out->rotation[i] = static_cast<float>(q[i] * norm);
+        }
+    } else {
+        memcpy(out->rotation, a.rotation, sizeof(out->rotation));
+    }
+    out->timestamp = static_cast<int64_t>(a.timestamp + (b.timestamp - a.timestamp) * t);
+}
@@ -0,0 +1,94 @@
+#ifndef QUEST_POSE_HISTORY_H
+#define QUEST_POSE_HISTORY_H
+
+#include "pose_ring.h"
+#include <atomic>
+#include <cstdint>
+
+// Head motion around a point in time
+struct PoseMotion {
+    float linearSpeed;   // m/s
+    float angularSpeed;  // rad/s
+};
+
+/**
+ * Timestamp-indexed pose history on top of PoseRing.
+ *
+ * Poses are kept sorted by timestamp, so lookups are a binary search over the ring
+ * followed by lerp/SLERP between the two bracketing samples. Queries slightly past
+ * the newest sample are extrapolated from the last two samples, up to a configurable
+ * tolerance. All lookups are lock-free and allocation-free.
+ *
+ * The history covers a fixed time window rather than a pose count: the ring is sized for
+ * the highest expected pose rate, and samples older than the window behind the newest pose
+ * age out, so feeding poses at display or IMU rate keeps the same window as one per frame.
+ */
+class PoseHistory {
+public:
+    // Defaults: extrapolate up to 20 ms, interpolate across gaps up to 100 ms,
+    // otherwise fall back to the nearest sample within 50 ms
+    static const int64_t DEFAULT_MAX_EXTRAPOLATION_NS = 20000000;
+    static const int64_t DEFAULT_MAX_INTERPOLATION_GAP_NS = 100000000;
+    static const int64_t DEFAULT_MAX_NEAREST_DISTANCE_NS = 50000000;
+
+    PoseHistory();
+
+    PoseHistory(const PoseHistory&) = delete;
+    PoseHistory& operator=(const PoseHistory&) = delete;
+
+    // Keep `windowNs` of history for pose rates up to `maxRateHz`
+    void allocate(int64_t windowNs, uint32_t maxRateHz);
+
+    // Ring entries allocate() reserves, and their size in bytes
+    static size_t capacityFor(int64_t windowNs, uint32_t maxRateHz);
+    static size_t bytesFor(size_t capacity) { return capacity * PoseRing::entryBytes(); }
+    size_t capacity() const { return ring_.capacity(); }
+
+    // Producer only. Samples older than the newest one are rejected to keep the ring sorted.
+    bool push(const PoseData& pose);
+
+    // Producer only. Appends a batch (normally in timestamp order) with one ring publish;
+    // samples older than their predecessor are dropped. Returns how many were kept.
+    size_t pushBatch(const PoseData* poses, size_t count);
+
+    // Pose at `timestamp`, interpolated or extrapolated as configured.
+    // matchErrorNs (optional) receives the distance to the closest real sample.
+    bool sample(int64_t timestamp, PoseData* outPose, int64_t* matchErrorNs = nullptr) const;
+
+    // Average motion over [timestamp - spanNs, timestamp], from two sample() lookups
+    bool motionAt(int64_t timestamp, int64_t spanNs, PoseMotion* out) const;
+
+    void setMaxExtrapolation(int64_t ns) { maxExtrapolationNs_.store(ns, std::memory_order_relaxed); }
+    void setMaxInterpolationGap(int64_t ns) { maxInterpolationGapNs_.store(ns, std::memory_order_relaxed); }
+
+    // Timestamp of the newest pose (INT64_MIN if there is none); lock-free
+    int64_t newestTimestamp() const;
+
+    // Poses currently inside the window
+    uint64_t size() const;
+    int64_t windowNs() const { return windowNs_; }
+
+private:
+    // Index of the first pose with timestamp >= `timestamp` in [lo, hi), or hi if none
+    uint64_t lowerBound(int64_t timestamp, uint64_t lo, uint64_t hi) const;
+
+    // Oldest readable index that is still inside the window
+    uint64_t oldest(uint64_t head) const;
+
+    // Producer only: move the window start past samples older than newest - window
+    void advanceWindow();
+
+    PoseRing ring_;
+    int64_t windowNs_;
+    int64_t newestTimestamp_;  // Producer only
+    uint64_t windowStart_;     // Producer only
+    std::atomic<uint64_t> publishedWindowStart_;
+
+    std::atomic<int64_t> maxExtrapolationNs_;
+    std::atomic<int64_t> maxInterpolationGapNs_;
+};
+
+// Interpolate between two poses; t = 0 gives a, t = 1 gives b, t > 1 extrapolates
+void interpolatePose(const PoseData& a, const PoseData& b, double t, PoseData* out);
+
+#endif // QUEST_POSE_HISTORY_H
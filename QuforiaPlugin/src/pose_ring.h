@@ -0,0 +1,112 @@
+#ifndef QUEST_POSE_RING_H
+#define QUEST_POSE_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+// Pose data structure for 6DoF tracking
+struct PoseData {
+    int64_t timestamp;  // Nanoseconds
+    float position[3];   // World space position (x, y, z)
+    float rotation[4];   // Quaternion (x, y, z, w)
+
+    PoseData() : timestamp(0) {
+        position[0] = position[1] = position[2] = 0.0f;
+        rotation[0] = rotation[1] = rotation[2] = 0.0f;
+        rotation[3] = 1.0f;  // Identity quaternion
+    }
+};
+
+/**
+ * Contiguous, fixed-capacity ring of PoseData (single producer, multiple readers).
+ *
+ * Each entry is guarded by its own seqlock version, so the producer never waits for
+ * readers and readers never block the producer; a reader that races with an overwrite
+ * just sees read() fail for that index.
+ */
+class PoseRing {
+public:
+    PoseRing() : capacity_(0), head_(0) {}
+
+    PoseRing(const PoseRing&) = delete;
+    PoseRing& operator=(const PoseRing&) = delete;
+
+    void allocate(size_t capacity) {
+        entries_.reset(new Entry[capacity]);
+        capacity_ = capacity;
+        head_.store(0, std::memory_order_release);
+    }
+
+    // Producer only
+    void push(const PoseData& pose) {
+        const uint64_t index = head_.load(std::memory_order_relaxed);
+        write(index, pose);
+        head_.store(index + 1, std::memory_order_release);
+    }
+
+    // Producer only. Appends `count` poses and publishes them with a single head update,
+    // so readers see either none or all of the batch.
+    void pushBatch(const PoseData* poses, size_t count) {
+        const uint64_t index = head_.load(std::memory_order_relaxed);
+
+        // Only the newest `capacity_` poses of an oversized batch would survive anyway
+        const size_t skip = count > capacity_ ? count - capacity_ : 0;
+        for (size_t i = skip; i < count; i++) {
+            write(index + i, poses[i]);
+        }
+
+        head_.store(index + count, std::memory_order_release);
+    }
+
+    // Total number of poses pushed; readable indices are [oldest(), head())
+    uint64_t head() const { return head_.load(std::memory_order_acquire); }
+
+    uint64_t oldest(uint64_t head) const {
+        return head > capacity_ ? head - capacity_ : 0;
+    }
+
+    // Copy the pose pushed as `index`. Fails if it was never written or has been overwritten.
+    bool read(uint64_t index, PoseData* out) const {
+        const Entry& entry = entries_[index % capacity_];
+        const uint64_t expected = 2 * index + 2;
+
+        if (entry.version.load(std::memory_order_acquire) != expected) {
+            return false;
+        }
+
+        memcpy(out, &entry.pose, sizeof(PoseData));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        return entry.version.load(std::memory_order_relaxed) == expected;
+    }
+
+    size_t capacity() const { return capacity_; }
+    static size_t entryBytes() { return sizeof(Entry); }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> version;
+        PoseData pose;
+
+        Entry() : version(0) {}
+    };
+
+    void write(uint64_t index, const PoseData& pose) {
+        Entry& entry = entries_[index % capacity_];
+
+        // Odd version marks the entry as being written
+        entry.version.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&entry.pose, &pose, sizeof(PoseData));
+        entry.version.store(2 * index + 2, std::memory_order_release);
+    }
+
+    std::unique_ptr<Entry[]> entries_;
+    size_t capacity_;
+    alignas(64) std::atomic<uint64_t> head_;
+};
+
+#endif // QUEST_POSE_RING_H
@@ -0,0 +1,178 @@
+#include "pose_transform.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define QUFORIA_HAVE_NEON 1
+#endif
+
+// The basis change must stay a signed permutation for the folded quaternion products below
+static_assert(OPENXR_TO_CV.quaternionIndex[0] + OPENXR_TO_CV.quaternionIndex[1] +
+              OPENXR_TO_CV.quaternionIndex[2] + OPENXR_TO_CV.quaternionIndex[3] == 6,
+              "OPENXR_TO_CV must permute the quaternion components");
+
+// PoseData records gathered per transformPosesOpenXRToCV(PoseStreamSoA) call
+static const size_t GATHER_BLOCK = 32;
+
+// Quaternion (x, y, z, w) + position to a row-major 3x4 matrix
+static inline void poseToMatrix(float x, float y, float z, float w,
+                                float tx, float ty, float tz, PoseMatrix34* out) {
+    const float xx = x * x, yy = y * y, zz = z * z;
+    const float xy = x * y, xz = x * z, yz = y * z;
+    const float xw = x * w, yw = y * w, zw = z * w;
+
+    float* m = out->m;
+    m[0] = 1.0f - 2.0f * (yy + zz);
+    m[1] = 2.0f * (xy - zw);
+    m[2] = 2.0f * (xz + yw);
+    m[3] = tx;
+
+    m[4] = 2.0f * (xy + zw);
+    m[5] = 1.0f - 2.0f * (xx + zz);
+    m[6] = 2.0f * (yz - xw);
+    m[7] = ty;
+
+    m[8] = 2.0f * (xz - yw);
+    m[9] = 2.0f * (yz + xw);
+    m[10] = 1.0f - 2.0f * (xx + yy);
+    m[11] = tz;
+}
+
+#ifdef QUFORIA_HAVE_NEON
+
+// Store one matrix row for four poses; vst4 interleaves the columns into per-pose rows
+static inline void storeRows(float32x4_t c0, float32x4_t c1, float32x4_t c2, float32x4_t c3,
+                             int row, PoseMatrix34* out) {
+    float block[16];
+    float32x4x4_t columns = { { c0, c1, c2, c3 } };
+    vst4q_f32(block, columns);
+    for (int k = 0; k < 4; k++) {
+        memcpy(out[k].m + row * 4, block + k * 4, 4 * sizeof(float));
+    }
+}
+
+#endif // QUFORIA_HAVE_NEON
+
+void transformPosesOpenXRToCV(const PoseStreamSoA& poses, size_t count, PoseMatrix34* out) {
+    const float* quaternion[4] = { poses.qx, poses.qy, poses.qz, poses.qw };
+    const float* srcX = quaternion[OPENXR_TO_CV.quaternionIndex[0]];
+    const float* srcY = quaternion[OPENXR_TO_CV.quaternionIndex[1]];
+    const float* srcZ = quaternion[OPENXR_TO_CV.quaternionIndex[2]];
+    const float* srcW = quaternion[OPENXR_TO_CV.quaternionIndex[3]];
+
+    size_t i = 0;
+
+#ifdef QUFORIA_HAVE_NEON
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t two = vdupq_n_f32(2.0f);
+
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t x = vmulq_n_f32(vld1q_f32(srcX + i), OPENXR_TO_CV.quaternionSign[0]);
+        const float32x4_t y = vmulq_n_f32(vld1q_f32(srcY + i), OPENXR_TO_CV.quaternionSign[1]);
+        const float32x4_t z = vmulq_n_f32(vld1q_f32(srcZ + i), OPENXR_TO_CV.quaternionSign[2]);
+        const float32x4_t w = vmulq_n_f32(vld1q_f32(srcW + i), OPENXR_TO_CV.quaternionSign[3]);
+
+        const float32x4_t xx = vmulq_f32(x, x), yy = vmulq_f32(y, y), zz = vmulq_f32(z, z);
+        const float32x4_t xy = vmulq_f32(x, y), xz = vmulq_f32(x, z), yz = vmulq_f32(y, z);
+        const float32x4_t xw = vmulq_f32(x, w), yw = vmulq_f32(y, w), zw = vmulq_f32(z, w);
+
+        const float32x4_t tx = vmulq_n_f32(vld1q_f32(poses.px + i), OPENXR_TO_CV.positionSign[0]);
+        const float32x4_t ty = vmulq_n_f32(vld1q_f32(poses.py + i), OPENXR_TO_CV.positionSign[1]);
+        const float32x4_t tz = vmulq_n_f32(vld1q_f32(poses.pz + i), OPENXR_TO_CV.positionSign[2]);
+
+        storeRows(vmlsq_f32(one, two, vaddq_f32(yy, zz)),
+                  vmulq_f32(two, vsubq_f32(xy, zw)),
+                  vmulq_f32(two, vaddq_f32(xz, yw)),
+                  tx, 0, out + i);
+        storeRows(vmulq_f32(two, vaddq_f32(xy, zw)),
+                  vmlsq_f32(one, two, vaddq_f32(xx, zz)),
+                  vmulq_f32(two, vsubq_f32(yz, xw)),
+                  ty, 1, out + i);
+        storeRows(vmulq_f32(two, vsubq_f32(xz, yw)),
+                  vmulq_f32(two, vaddq_f32(yz, xw)),
+                  vmlsq_f32(one, two, vaddq_f32(xx, yy)),
+                  tz, 2, out + i);
+    }
+#endif
+
+    for (; i < count; i++) {
+        poseToMatrix(OPENXR_TO_CV.quaternionSign[0] * srcX[i],
+                     OPENXR_TO_CV.quaternionSign[1] * srcY[i],
+                     OPENXR_TO_CV.quaternionSign[2] * srcZ[i],
+                     OPENXR_TO_CV.quaternionSign[3] * srcW[i],
+                     OPENXR_TO_CV.positionSign[0] * poses.px[i],
+                     OPENXR_TO_CV.positionSign[1] * poses.py[i],
+                     OPENXR_TO_CV.positionSign[2] * poses.pz[i],
+                     &out[i]);
+    }
+}
+
+void transformPosesOpenXRToCV(const PoseData* poses, size_t count, PoseMatrix34* out) {
+    float px[GATHER_BLOCK], py[GATHER_BLOCK], pz[GATHER_BLOCK];
+    float qx[GATHER_BLOCK], qy[GATHER_BLOCK], qz[GATHER_BLOCK], qw[GATHER_BLOCK];
+    const PoseStreamSoA stream = { px, py, pz, qx, qy, qz, qw };
+
+    for (size_t start = 0; start < count; start += GATHER_BLOCK) {
+        const size_t n = std::min(GATHER_BLOCK, count - start);
+        for (size_t i = 0; i < n; i++) {
+            const PoseData& pose = poses[start + i];
+            px[i] = pose.position[0];
+            py[i] = pose.position[1];
+            pz[i] = pose.position[2];
+            qx[i] = pose.rotation[0];
+            qy[i] = pose.rotation[1];
+            qz[i] = pose.rotation[2];
+            qw[i] = pose.rotation[3];
+        }
+        transformPosesOpenXRToCV(stream, n, out + start);
+    }
+}
+
+void transformPoseCVToOpenXR(const float* translation, const float* rotation, PoseData* out) {
+    // Rotation matrix to quaternion, pivoting on the largest diagonal term for stability
+    const float* r = rotation;
+    double q[4];  // x, y, z, w in the CV basis
+    const double trace = static_cast<double>(r[0]) + r[4] + r[8];
+    if (trace > 0.0) {
+        const double s = 2.0 * std::sqrt(trace + 1.0);
+        q[3] = 0.25 * s;
+        q[0] = (r[7] - r[5]) / s;
+        q[1] = (r[2] - r[6]) / s;
+        q[2] = (r[3] - r[1]) / s;
+    } else if (r[0] > r[4] && r[0] > r[8]) {
+        const double s = 2.0 * std::sqrt(1.0 + r[0] - r[4] - r[8]);
+        q[3] = (r[7] - r[5]) / s;
+        q[0] = 0.25 * s;
+        q[1] = (r[1] + r[3]) / s;
+        q[2] = (r[2] + r[6]) / s;
+    } else if (r[4] > r[8]) {
+        const double s = 2.0 * std::sqrt(1.0 + r[4] - r[0] - r[8]);
+        q[3] = (r[2] - r[6]) / s;
+        q[0] = (r[1] + r[3]) / s;
+        q[1] = 0.25 * s;
+        q[2] = (r[5] + r[7]) / s;
+    } else {
+        const double s = 2.0 * std::sqrt(1.0 + r[8] - r[0] - r[4]);
+        q[3] = (r[3] - r[1]) / s;
+        q[0] = (r[2] + r[6]) / s;
+        q[1] = (r[5] + r[7]) / s;
+        q[2] = 0.25 * s;
+    }
+
+    double norm = 0.0;
+    for (int i = 0; i < 4; i++) {
+        norm += q[i] * q[i];
+    }
+    norm = norm > 0.0 ? 1.0 / std::sqrt(norm) : 0.0;
+
+    // Undo the signed permutation: q'[i] = sign[i] * q[index[i]], and the signs are +-1
+    for (int i = 0; i < 4; i++) {
+        out->rotation[OPENXR_TO_CV.quaternionIndex[i]] =
+            static_cast<float>(OPENXR_TO_CV.quaternionSign[i] * q[i] * norm);
+    }
+    for (int i = 0; i < 3; i++) {
+        out->position[i] = OPENXR_TO_CV.positionSign[i] * translation[i];
+    }
+}
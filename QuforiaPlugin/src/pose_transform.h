@@ -0,0 +1,68 @@
+#ifndef QUEST_POSE_TRANSFORM_H
+#define QUEST_POSE_TRANSFORM_H
+
+#include "pose_ring.h"
+#include <cstddef>
+
+/**
+ * Basis change between the OpenXR/Unity pose convention and Vuforia's CV convention.
+ *
+ *   OpenXR: X right, Y up, Z back (toward the user)
+ *   CV:     X right, Y down, Z forward (into the scene)
+ *
+ * Positions flip Y and Z. Rotations are pre-multiplied by a 180 degree turn about X, which
+ * for a quaternion (x, y, z, w) is a signed permutation: q' = (w, -z, -y, x).
+ * Folded at compile time so the kernels only see constant indices and signs.
+ */
+struct PoseBasisChange {
+    float positionSign[3];
+    int quaternionIndex[4];   // q'[i] = quaternionSign[i] * q[quaternionIndex[i]]
+    float quaternionSign[4];
+};
+
+constexpr PoseBasisChange OPENXR_TO_CV = {
+    { 1.0f, -1.0f, -1.0f },
+    { 3, 2, 1, 0 },
+    { 1.0f, -1.0f, -1.0f, 1.0f },
+};
+
+// Row-major [R | t]: rows m[0..3], m[4..7], m[8..11]
+struct PoseMatrix34 {
+    float m[12];
+};
+
+// Structure-of-arrays pose stream (each array holds `count` values)
+struct PoseStreamSoA {
+    const float* px;
+    const float* py;
+    const float* pz;
+    const float* qx;
+    const float* qy;
+    const float* qz;
+    const float* qw;
+};
+
+/**
+ * Convert OpenXR poses to CV-convention 3x4 matrices, four at a time with NEON on ARM
+ * (scalar elsewhere and for the tail). Quaternions are expected to be unit length.
+ */
+void transformPosesOpenXRToCV(const PoseStreamSoA& poses, size_t count, PoseMatrix34* out);
+
+// Same for PoseData records (gathered into SoA blocks internally)
+void transformPosesOpenXRToCV(const PoseData* poses, size_t count, PoseMatrix34* out);
+
+// Inverse basis change for a single CV pose (e.g. an anchor Vuforia created): Vuforia's
+// translation + row-major rotation back to an OpenXR position and unit quaternion
+void transformPoseCVToOpenXR(const float* translation, const float* rotation, PoseData* out);
+
+// Split a 3x4 matrix into Vuforia's 3 translation + 9 row-major rotation floats
+inline void splitPoseMatrix(const PoseMatrix34& matrix, float* translation, float* rotation) {
+    for (int row = 0; row < 3; row++) {
+        rotation[row * 3 + 0] = matrix.m[row * 4 + 0];
+        rotation[row * 3 + 1] = matrix.m[row * 4 + 1];
+        rotation[row * 3 + 2] = matrix.m[row * 4 + 2];
+        translation[row] = matrix.m[row * 4 + 3];
+    }
+}
+
+#endif // QUEST_POSE_TRANSFORM_H
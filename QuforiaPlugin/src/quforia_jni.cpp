@@ -1,19 +1,57 @@
-#include <android/log.h>
+#include "quforia_log.h"
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include "vuforia_driver.h"
-
-#define LOG_TAG "QUFORIA"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#include "pixel_convert.h"
+#include "hardware_buffer_source.h"
+#include "thread_config.h"
+#include "memory_config.h"
 
 /**
  * Unity P/Invoke Bridge
  *
  * These functions are called directly from Unity C# using [DllImport].
  * Unity handles all array marshaling - no JNI needed!
+ * The *Ptr variants take raw pointers (NativeArray.GetUnsafePtr(), blittable structs passed
+ * by ref) so per-frame calls neither pin managed arrays nor allocate on the C# side.
  */
 
+// QuestVuforiaBridge.PoseSample mirrors PoseData field for field
+static_assert(sizeof(PoseData) == 40, "PoseData layout must match QuestVuforiaBridge.PoseSample");
+static_assert(offsetof(PoseData, position) == 8, "PoseData layout must match QuestVuforiaBridge.PoseSample");
+static_assert(offsetof(PoseData, rotation) == 20, "PoseData layout must match QuestVuforiaBridge.PoseSample");
+static_assert(sizeof(QuforiaHistogram) == 216, "QuforiaHistogram layout must match QuestVuforiaBridge.LatencyHistogram");
+static_assert(sizeof(QuforiaStats) == 1616, "QuforiaStats layout must match QuestVuforiaBridge.DriverStats");
+static_assert(sizeof(QuforiaGovernorState) == 40, "QuforiaGovernorState layout must match QuestVuforiaBridge.GovernorState");
+static_assert(sizeof(QuforiaQualityState) == 40, "QuforiaQualityState layout must match QuestVuforiaBridge.QualityState");
+static_assert(sizeof(QuforiaMotionThrottleState) == 40, "QuforiaMotionThrottleState layout must match QuestVuforiaBridge.MotionThrottleState");
+static_assert(sizeof(QuforiaAnchorRequest) == 72, "QuforiaAnchorRequest layout must match QuestVuforiaBridge.AnchorRequest");
+static_assert(sizeof(QuforiaAnchorUpdate) == 72, "QuforiaAnchorUpdate layout must match QuestVuforiaBridge.AnchorUpdate");
+static_assert(sizeof(QuforiaClockState) == 24, "QuforiaClockState layout must match QuestVuforiaBridge.ClockState");
+static_assert(sizeof(QuforiaThreadConfig) == 48, "QuforiaThreadConfig layout must match QuestVuforiaBridge.ThreadConfig");
+static_assert(sizeof(QuforiaThreadReport) == 48, "QuforiaThreadReport layout must match QuestVuforiaBridge.ThreadReport");
+static_assert(sizeof(QuforiaMemoryConfig) == 32, "QuforiaMemoryConfig layout must match QuestVuforiaBridge.MemoryConfig");
+static_assert(sizeof(QuforiaMemoryReport) == 72, "QuforiaMemoryReport layout must match QuestVuforiaBridge.MemoryReport");
+
+// Check that an unmanaged image buffer is large enough for the frame it claims to hold
+static bool validateImageBuffer(int imageSize, int width, int height,
+                                VuforiaDriver::PixelFormat format, int stride) {
+    const uint32_t rowBytes = packedStride(format, static_cast<uint32_t>(width));
+    if (rowBytes == 0 || (stride != 0 && static_cast<uint32_t>(stride) < rowBytes)) {
+        LOGE("Invalid format %d or stride %d for width %d", static_cast<int>(format), stride, width);
+        return false;
+    }
+
+    const size_t required = frameBufferSize(format, width, height, stride);
+    if (static_cast<size_t>(imageSize) < required) {
+        LOGE("Image buffer too small: %d bytes, %dx%d %s needs %zu",
+             imageSize, width, height, pixelFormatName(format), required);
+        return false;
+    }
+    return true;
+}
+
 extern "C" {
 
 /**
@@ -42,6 +80,26 @@ bool nativeSetCameraIntrinsics(float* intrinsics, int length) {
     return true;
 }
 
+/**
+ * Set how far (in nanoseconds) a frame timestamp may lie past the newest pose
+ * before pose lookup stops extrapolating and holds the newest pose instead
+ */
+bool nativeSetPoseExtrapolationTolerance(long long toleranceNs) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (toleranceNs < 0) {
+        LOGE("Invalid extrapolation tolerance: %lld", toleranceNs);
+        return false;
+    }
+
+    g_driverInstance->setPoseExtrapolationTolerance(toleranceNs);
+    return true;
+}
+
 /**
  * Feed device pose to the Vuforia Driver
  * CRITICAL: Must be called BEFORE feedCameraFrame with same timestamp
@@ -58,7 +116,75 @@ bool nativeFeedDevicePose(float* position, float* rotation, long long timestamp)
         return false;
     }
 
-    g_driverInstance->feedDevicePose(position, rotation, timestamp);
+    g_driverInstance->feedDevicePose(position, rotation, g_driverInstance->clock().toMonotonic(timestamp));
+    return true;
+}
+
+/**
+ * Feed device pose from a PoseSample struct (no per-call arrays)
+ * CRITICAL: Must be called BEFORE feedCameraFrame with same timestamp
+ */
+bool nativeFeedDevicePosePtr(const PoseData* pose) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!pose) {
+        LOGE("Null pose");
+        return false;
+    }
+
+    g_driverInstance->feedDevicePose(pose->position, pose->rotation,
+                                     g_driverInstance->clock().toMonotonic(pose->timestamp));
+    return true;
+}
+
+/**
+ * Feed a contiguous batch of device poses (e.g. every head pose since the last call, at
+ * display or IMU rate) independently of camera frames. The batch should be in timestamp
+ * order and is appended to the pose history with one publish, mapped to CLOCK_MONOTONIC with
+ * one offset per batch. Poses and frames must be fed from the same thread. Returns how many
+ * poses were kept, or -1 on error.
+ */
+int nativeFeedDevicePoses(const PoseData* batch, int count) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return -1;
+    }
+
+    if (!batch || count < 0) {
+        LOGE("Invalid pose batch");
+        return -1;
+    }
+
+    return static_cast<int>(g_driverInstance->feedInputPoses(batch, static_cast<size_t>(count)));
+}
+
+/**
+ * Head pose at `timestamp` (same clock domain as the feed functions), interpolated from the
+ * pose history or extrapolated a little past the newest pose. Lock-free, so Unity can call it
+ * from the render thread just before submission to re-project anchored content with the
+ * freshest head pose. outPose->timestamp is set to `timestamp`.
+ */
+bool nativeGetPoseAt(long long timestamp, PoseData* outPose) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!outPose) {
+        LOGE("Null pose output");
+        return false;
+    }
+
+    if (!g_driverInstance->samplePose(g_driverInstance->clock().queryToMonotonic(timestamp), outPose)) {
+        return false;
+    }
+    outPose->timestamp = timestamp;
     return true;
 }
 
@@ -78,10 +204,881 @@ bool nativeFeedCameraFrame(unsigned char* imageData, int width, int height,
         return false;
     }
 
-    g_driverInstance->feedCameraFrame(imageData, width, height, intrinsics, timestamp);
+    g_driverInstance->feedCameraFrame(imageData, width, height, intrinsics,
+                                      g_driverInstance->clock().toMonotonic(timestamp));
+    return true;
+}
+
+/**
+ * Feed a camera frame in any supported pixel format (VuforiaDriver::PixelFormat value).
+ * stride is the first plane's bytes per row, 0 for tightly packed. The frame is converted
+ * to the active camera mode's format if it differs.
+ */
+bool nativeFeedCameraFrameWithFormat(unsigned char* imageData, int width, int height,
+                                     int format, int stride,
+                                     float* intrinsics, int intrinsicsLength, long long timestamp) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!imageData || stride < 0) {
+        LOGE("Invalid image data");
+        return false;
+    }
+
+    const float* frameIntrinsics = (intrinsics && intrinsicsLength >= 14) ? intrinsics : nullptr;
+    g_driverInstance->feedCameraFrame(imageData, width, height,
+                                      static_cast<VuforiaDriver::PixelFormat>(format),
+                                      static_cast<uint32_t>(stride), frameIntrinsics,
+                                      g_driverInstance->clock().toMonotonic(timestamp));
+    return true;
+}
+
+/**
+ * Feed a camera frame from unmanaged memory with an explicit buffer size.
+ * format is a VuforiaDriver::PixelFormat value, stride the first plane's bytes per row
+ * (0 = tightly packed). imageSize is checked against what width/height/stride require.
+ */
+bool nativeFeedCameraFramePtr(const void* imageData, int imageSize, int width, int height,
+                              int format, int stride,
+                              const float* intrinsics, int intrinsicsLength, long long timestamp) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!imageData || width <= 0 || height <= 0 || stride < 0 || imageSize < 0) {
+        LOGE("Invalid image data");
+        return false;
+    }
+
+    const VuforiaDriver::PixelFormat pixelFormat = static_cast<VuforiaDriver::PixelFormat>(format);
+    if (!validateImageBuffer(imageSize, width, height, pixelFormat, stride)) {
+        return false;
+    }
+
+    const float* frameIntrinsics = (intrinsics && intrinsicsLength >= 14) ? intrinsics : nullptr;
+    g_driverInstance->feedCameraFrame(static_cast<const uint8_t*>(imageData), width, height,
+                                      pixelFormat, static_cast<uint32_t>(stride),
+                                      frameIntrinsics, g_driverInstance->clock().toMonotonic(timestamp));
+    return true;
+}
+
+/**
+ * Submit a camera frame together with its device pose in one call (replaces the
+ * pose-then-frame protocol). The pose is stored on the frame record and delivered to
+ * Vuforia right before the frame; pose->timestamp is ignored. With exposure metadata set,
+ * Vuforia gets the pose at mid-exposure instead, interpolated from the pose history towards
+ * the submitted one (which stands in if the history can't place mid-exposure any closer).
+ */
+bool nativeSubmitFrame(const void* imageData, int imageSize, int width, int height,
+                       int format, int stride, bool flipVertically, const PoseData* pose,
+                       const float* intrinsics, int intrinsicsLength, long long timestamp) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!imageData || !pose || width <= 0 || height <= 0 || stride < 0 || imageSize < 0) {
+        LOGE("Invalid image data or pose");
+        return false;
+    }
+
+    const VuforiaDriver::PixelFormat pixelFormat = static_cast<VuforiaDriver::PixelFormat>(format);
+    if (!validateImageBuffer(imageSize, width, height, pixelFormat, stride)) {
+        return false;
+    }
+
+    const float* frameIntrinsics = (intrinsics && intrinsicsLength >= 14) ? intrinsics : nullptr;
+    g_driverInstance->submitFrame(static_cast<const uint8_t*>(imageData), width, height,
+                                  pixelFormat, static_cast<uint32_t>(stride), *pose,
+                                  frameIntrinsics, g_driverInstance->clock().toMonotonic(timestamp),
+                                  flipVertically);
+    return true;
+}
+
+/**
+ * Number of native workers converting frames (0-4, default 0 = on the calling thread).
+ * Workers run on the little cores unless the INGEST_WORKER thread role is configured.
+ */
+bool nativeSetIngestWorkers(int count) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    return g_driverInstance->setIngestWorkers(count);
+}
+
+/**
+ * Queue a frame for the ingest workers and return immediately. Same arguments as
+ * nativeSubmitFrame, except that pose may be null. Returns the frame's ticket (0 if it was
+ * rejected or the queue is full); imageData must stay valid until
+ * nativeGetCompletedIngestTicket() returns a value >= the ticket.
+ */
+long long nativeFeedCameraFrameAsync(const void* imageData, int imageSize, int width, int height,
+                                     int format, int stride, bool flipVertically, const PoseData* pose,
+                                     const float* intrinsics, int intrinsicsLength, long long timestamp) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return 0;
+    }
+
+    if (!imageData || width <= 0 || height <= 0 || stride < 0 || imageSize < 0) {
+        LOGE("Invalid image data");
+        return 0;
+    }
+
+    const VuforiaDriver::PixelFormat pixelFormat = static_cast<VuforiaDriver::PixelFormat>(format);
+    if (!validateImageBuffer(imageSize, width, height, pixelFormat, stride)) {
+        return 0;
+    }
+
+    const float* frameIntrinsics = (intrinsics && intrinsicsLength >= 14) ? intrinsics : nullptr;
+    return static_cast<long long>(g_driverInstance->feedCameraFrameAsync(
+        static_cast<const uint8_t*>(imageData), width, height, pixelFormat,
+        static_cast<uint32_t>(stride), pose, frameIntrinsics,
+        g_driverInstance->clock().toMonotonic(timestamp), flipVertically));
+}
+
+/**
+ * Ticket of the newest frame the ingest workers have published or dropped; every buffer
+ * passed with a ticket up to this one may be reused
+ */
+long long nativeGetCompletedIngestTicket() {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return 0;
+    }
+
+    return static_cast<long long>(g_driverInstance->completedIngestTicket());
+}
+
+#ifdef __ANDROID__
+
+/**
+ * Submit a frame from an AHardwareBuffer* (CPU-readable RGBA/RGB/YUV_420_888). The buffer is
+ * locked and converted into the driver's pool in one pass; pose may be null (pose lookup by
+ * timestamp then applies). The caller keeps ownership of the buffer.
+ */
+bool nativeSubmitHardwareBuffer(void* hardwareBuffer, bool flipVertically, const PoseData* pose,
+                                long long timestamp) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    return HardwareBufferSource::submit(g_driverInstance,
+                                        static_cast<AHardwareBuffer*>(hardwareBuffer),
+                                        flipVertically, pose, nullptr,
+                                        g_driverInstance->clock().toMonotonic(timestamp));
+}
+
+/**
+ * Same as nativeSubmitHardwareBuffer, for an android.hardware.HardwareBuffer jobject
+ * (AndroidJavaObject.GetRawObject()). Must be called from a thread attached to the JVM.
+ */
+bool nativeSubmitJavaHardwareBuffer(jobject hardwareBuffer, bool flipVertically,
+                                    const PoseData* pose, long long timestamp) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    return HardwareBufferSource::submitJava(g_driverInstance, hardwareBuffer, flipVertically,
+                                            pose, nullptr,
+                                            g_driverInstance->clock().toMonotonic(timestamp));
+}
+
+#endif // __ANDROID__
+
+/**
+ * Feed a Unity Color32 (RGBA8888) buffer straight from its NativeArray pointer.
+ * Repacking to the camera mode's format and the optional vertical flip happen in one
+ * native pass, so the C# side does no per-pixel work. imageSize is the buffer length in
+ * bytes and is checked against width x height.
+ */
+bool nativeFeedCameraFrameRGBA(const unsigned char* rgbaData, int imageSize, int width, int height,
+                               bool flipVertically,
+                               float* intrinsics, int intrinsicsLength, long long timestamp) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!rgbaData || width <= 0 || height <= 0 || imageSize < 0) {
+        LOGE("Invalid image data");
+        return false;
+    }
+
+    if (!validateImageBuffer(imageSize, width, height, VuforiaDriver::PixelFormat::RGBA8888, 0)) {
+        return false;
+    }
+
+    const float* frameIntrinsics = (intrinsics && intrinsicsLength >= 14) ? intrinsics : nullptr;
+    g_driverInstance->feedCameraFrame(rgbaData, width, height, VuforiaDriver::PixelFormat::RGBA8888,
+                                      0, frameIntrinsics, g_driverInstance->clock().toMonotonic(timestamp),
+                                      flipVertically);
+    return true;
+}
+
+/**
+ * Borrow a pooled frame buffer (width * height * 3 bytes, RGB888) to write pixels into.
+ * Returns null if the driver is not initialized or no buffer is free.
+ * Must be followed by nativeCommitCameraFrame or nativeCancelCameraFrame.
+ */
+unsigned char* nativeBeginCameraFrame(int width, int height) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return nullptr;
+    }
+
+    return g_driverInstance->beginCameraFrame(width, height);
+}
+
+/**
+ * Borrow a tightly packed pooled frame buffer in the given pixel format
+ * (e.g. RGBA8888 to hand over Color32 rows without repacking them)
+ */
+unsigned char* nativeBeginCameraFrameWithFormat(int width, int height, int format) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return nullptr;
+    }
+
+    return g_driverInstance->beginCameraFrame(width, height,
+                                              static_cast<VuforiaDriver::PixelFormat>(format));
+}
+
+/**
+ * Publish the buffer obtained from nativeBeginCameraFrame (no copy unless the
+ * active camera mode needs another pixel format)
+ */
+bool nativeCommitCameraFrame(float* intrinsics, int intrinsicsLength, long long timestamp) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    // Per-frame intrinsics are [width, height, fx, fy, cx, cy, d0-d7]
+    const float* frameIntrinsics = (intrinsics && intrinsicsLength >= 14) ? intrinsics : nullptr;
+    return g_driverInstance->commitCameraFrame(frameIntrinsics,
+                                               g_driverInstance->clock().toMonotonic(timestamp));
+}
+
+/**
+ * Return the buffer obtained from nativeBeginCameraFrame without publishing it
+ */
+void nativeCancelCameraFrame() {
+
+    if (!g_driverInstance) {
+        return;
+    }
+
+    g_driverInstance->cancelCameraFrame();
+}
+
+/**
+ * Select how frames are handed to Vuforia: 0 = latest only, 1 = every frame (in order)
+ */
+bool nativeSetFrameDeliveryPolicy(int policy) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (policy != static_cast<int>(FrameDeliveryPolicy::LATEST_ONLY) &&
+        policy != static_cast<int>(FrameDeliveryPolicy::EVERY_FRAME)) {
+        LOGE("Invalid frame delivery policy: %d", policy);
+        return false;
+    }
+
+    g_driverInstance->setFrameDeliveryPolicy(static_cast<FrameDeliveryPolicy>(policy));
+    return true;
+}
+
+/**
+ * Publish YUV camera modes with constant chroma: only the Y plane is computed/copied
+ */
+bool nativeSetLumaOnlyTracking(bool enabled) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->setLumaOnlyTracking(enabled);
     return true;
 }
 
+/**
+ * Exposure duration and rolling-shutter readout time (nanoseconds) of the frames fed next,
+ * from the passthrough camera's capture result. A latest-value setting: call it with each
+ * frame's values before feeding it (or once for a fixed exposure); frames then report that
+ * exposure and get the pose at mid-exposure, before their end-of-exposure timestamp.
+ */
+bool nativeSetCameraExposure(long long exposureNs, long long readoutNs) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    return g_driverInstance->setCameraExposure(exposureNs, readoutNs);
+}
+
+/**
+ * Undistort frames with the calibration's distortion coefficients before Vuforia sees them.
+ * Rectified frames report zero distortion; frames without distortion are passed through.
+ */
+bool nativeSetFrameRectification(bool enabled) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->setFrameRectification(enabled);
+    return true;
+}
+
+/**
+ * Centre of the window crop modes cut from each frame, in normalized upright image
+ * coordinates (0.5, 0.5 = image centre). Move it to follow the tracked target.
+ */
+bool nativeSetCropCenter(float x, float y) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->setCropCenter(x, y);
+    return true;
+}
+
+/**
+ * Cut camera modes of exactly half the input size as a window instead of downscaling
+ */
+bool nativeSetCropHalfSizeModes(bool enabled) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->setCropHalfSizeModes(enabled);
+    return true;
+}
+
+/**
+ * Window of a width x height input the active mode crops to: outWindow = [x, y, width, height]
+ * in upright image pixels. Returns false if frames of that size aren't cropped.
+ */
+bool nativeGetCropWindow(int width, int height, int* outWindow) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!outWindow) {
+        LOGE("Null crop window");
+        return false;
+    }
+
+    CropWindow window;
+    if (!g_driverInstance->cropWindow(width, height, &window)) {
+        return false;
+    }
+    outWindow[0] = static_cast<int>(window.x);
+    outWindow[1] = static_cast<int>(window.y);
+    outWindow[2] = static_cast<int>(window.width);
+    outWindow[3] = static_cast<int>(window.height);
+    return true;
+}
+
+/**
+ * Camera mode Vuforia started the camera with: outMode = [width, height, fps, format].
+ * Returns false while the camera is stopped.
+ */
+bool nativeGetActiveCameraMode(int* outMode) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!outMode) {
+        LOGE("Null output array");
+        return false;
+    }
+
+    VuforiaDriver::CameraMode mode;
+    if (!g_driverInstance->getActiveCameraMode(&mode)) {
+        return false;
+    }
+
+    outMode[0] = static_cast<int>(mode.width);
+    outMode[1] = static_cast<int>(mode.height);
+    outMode[2] = static_cast<int>(mode.fps);
+    outMode[3] = static_cast<int>(mode.format);
+    return true;
+}
+
+/**
+ * Record every frame, pose and intrinsics update fed to the driver into `path`.
+ * compress: LZ4-compress frames (ignored if the plugin was built without LZ4)
+ */
+bool nativeStartRecording(const char* path, bool compress) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    return g_driverInstance->startRecording(path, compress);
+}
+
+bool nativeStopRecording() {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->stopRecording();
+    return true;
+}
+
+/**
+ * Play a recorded session back through the driver.
+ * speed: 1 = original timing, 0 = as fast as possible
+ */
+bool nativeStartReplay(const char* path, float speed, bool loop) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    return g_driverInstance->startReplay(path, speed, loop);
+}
+
+bool nativeStopReplay() {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->stopReplay();
+    return true;
+}
+
+bool nativeIsReplaying() {
+    return g_driverInstance && g_driverInstance->isReplaying();
+}
+
+/**
+ * Enable or disable the frame governor (enabled by default). Disabling it restores
+ * full-rate delivery.
+ */
+bool nativeSetFrameGovernorEnabled(bool enabled) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->governor().setEnabled(enabled);
+    return true;
+}
+
+/**
+ * Current governor level, delivered-rate divisor and load
+ */
+bool nativeGetFrameGovernorState(QuforiaGovernorState* outState) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!outState) {
+        LOGE("Null governor state");
+        return false;
+    }
+
+    g_driverInstance->governor().state(outState);
+    return true;
+}
+
+/**
+ * Enable or disable the motion-blur quality gate (disabled by default). Rejected frames
+ * are counted in QuforiaStats::framesBlurred.
+ */
+bool nativeSetFrameQualityGateEnabled(bool enabled) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->qualityGate().setEnabled(enabled);
+    return true;
+}
+
+/**
+ * Quality gate thresholds: moving frames scoring below `minSharpness` (0-1) of the
+ * reference are dropped; below `minAngularSpeed` rad/s frames are not scored at all.
+ * Values <= 0 keep the current setting.
+ */
+bool nativeSetFrameQualityThresholds(float minSharpness, float minAngularSpeed) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->qualityGate().setThresholds(minSharpness, minAngularSpeed);
+    return true;
+}
+
+/**
+ * Last and reference sharpness scores, head speed and scoring cost of the quality gate
+ */
+bool nativeGetFrameQualityState(QuforiaQualityState* outState) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!outState) {
+        LOGE("Null quality state");
+        return false;
+    }
+
+    g_driverInstance->qualityGate().state(outState);
+    return true;
+}
+
+/**
+ * Enable or disable lowering the delivered frame rate while the headset is static
+ * (disabled by default)
+ */
+bool nativeSetMotionThrottleEnabled(bool enabled) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->motionThrottle().setEnabled(enabled);
+    return true;
+}
+
+/**
+ * Motion throttle settings: delivered rate while static, the linear (m/s) and angular
+ * (rad/s) speeds below which the headset counts as static, and whether to recommend a
+ * lower resolution mode while throttled. Values <= 0 keep the current setting.
+ */
+bool nativeConfigureMotionThrottle(float staticFps, float linearSpeed, float angularSpeed,
+                                   bool recommendLowResolution) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->motionThrottle().configure(staticFps, linearSpeed, angularSpeed,
+                                                 recommendLowResolution);
+    return true;
+}
+
+/**
+ * Force full-rate delivery regardless of motion, e.g. while no target has been detected yet
+ */
+bool nativeSetMotionThrottleHold(bool hold) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->motionThrottle().setFullRateHold(hold);
+    return true;
+}
+
+/**
+ * Whether delivery is currently throttled, the head speed it is based on and frames skipped
+ */
+bool nativeGetMotionThrottleState(QuforiaMotionThrottleState* outState) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!outState) {
+        LOGE("Null motion throttle state");
+        return false;
+    }
+
+    g_driverInstance->motionThrottle().state(outState);
+    return true;
+}
+
+/**
+ * Move up to `maxRequests` pending anchor requests from Vuforia (place a spatial anchor,
+ * erase one) into `outRequests`. Returns how many were written, or -1 on error.
+ */
+int nativeGetAnchorRequests(QuforiaAnchorRequest* outRequests, int maxRequests) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return -1;
+    }
+
+    if (!outRequests || maxRequests < 0) {
+        LOGE("Invalid anchor request buffer");
+        return -1;
+    }
+
+    return g_driverInstance->anchors().takeRequests(outRequests, maxRequests);
+}
+
+/**
+ * Report spatial anchor poses (Unity world, like device poses). Anchors Vuforia doesn't
+ * know yet, e.g. ones loaded from storage, are added. Vuforia gets the changes with the
+ * next frame. Returns how many updates were accepted, or -1 on error.
+ */
+int nativeUpdateAnchors(const QuforiaAnchorUpdate* updates, int count) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return -1;
+    }
+
+    if (!updates || count < 0) {
+        LOGE("Invalid anchor updates");
+        return -1;
+    }
+
+    return g_driverInstance->anchors().update(updates, count);
+}
+
+/**
+ * The spatial anchor for `uuid` no longer exists; Vuforia is told it was removed
+ */
+bool nativeRemoveAnchor(const char* uuid) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    return g_driverInstance->anchors().drop(uuid);
+}
+
+/**
+ * Forget every anchor (Vuforia is told they were removed) and any pending requests
+ */
+bool nativeClearAnchors() {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->anchors().clear();
+    return true;
+}
+
+/**
+ * Copy the driver's hot-path counters and latency histograms into `outStats`.
+ * The caller sets outStats->size to the sizeof(QuforiaStats) it was built against, at least
+ * the first layout's; the fields both sides know are filled in and `size` is set to how many
+ * bytes that was, so older and newer callers keep working as the layout grows.
+ */
+bool nativeGetStats(QuforiaStats* outStats) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!outStats || outStats->size < QUFORIA_STATS_V1_SIZE) {
+        LOGE("Invalid stats buffer (expected at least %zu bytes)", QUFORIA_STATS_V1_SIZE);
+        return false;
+    }
+
+    const uint32_t size = std::min(outStats->size, static_cast<uint32_t>(sizeof(QuforiaStats)));
+    QuforiaStats stats;
+    g_driverInstance->stats().snapshot(&stats);
+    stats.size = size;
+    memcpy(outStats, &stats, size);
+    return true;
+}
+
+/**
+ * Zero all counters and histograms
+ */
+bool nativeResetStats() {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->stats().reset();
+    return true;
+}
+
+/**
+ * CLOCK_MONOTONIC in nanoseconds, the clock the driver and Vuforia timestamp in.
+ * Producers without a capture timestamp should stamp with this rather than DateTime.Now.
+ */
+long long nativeGetMonotonicTimeNs() {
+    return monotonicNowNs();
+}
+
+/**
+ * Clock (QuforiaClockDomain) of every timestamp passed to the feed/submit functions.
+ * They are converted to CLOCK_MONOTONIC on entry.
+ */
+bool nativeSetTimestampDomain(int domain) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (domain < 0 || domain >= QUFORIA_CLOCK_DOMAIN_COUNT) {
+        LOGE("Invalid clock domain: %d", domain);
+        return false;
+    }
+
+    g_driverInstance->clock().setDomain(static_cast<QuforiaClockDomain>(domain));
+    return true;
+}
+
+/**
+ * Pin the EXTERNAL clock domain: externalNs and monotonicNs denote the same instant
+ * (e.g. an XrTime and its xrConvertTimeToTimespecTimeKHR result)
+ */
+bool nativeAddClockSyncPoint(long long externalNs, long long monotonicNs) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    g_driverInstance->clock().addSyncPoint(externalNs, monotonicNs);
+    return true;
+}
+
+/**
+ * Current input clock domain, offset, drift and capture -> arrival latency
+ */
+bool nativeGetClockState(QuforiaClockState* outState) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!outState) {
+        LOGE("Null clock state");
+        return false;
+    }
+
+    g_driverInstance->clock().state(outState);
+    return true;
+}
+
+/**
+ * Set name, scheduling and affinity for one of the driver's threads.
+ * Works before the driver exists; running threads of that role switch immediately.
+ */
+bool nativeSetThreadConfig(const QuforiaThreadConfig* config) {
+
+    if (!config) {
+        LOGE("Null thread config");
+        return false;
+    }
+
+    return setThreadConfig(*config);
+}
+
+/**
+ * What a driver thread actually runs with (tid 0 while it isn't running)
+ */
+bool nativeGetThreadReport(int role, QuforiaThreadReport* outReport) {
+
+    if (!outReport) {
+        LOGE("Null thread report");
+        return false;
+    }
+
+    return getThreadReport(static_cast<QuforiaThreadRole>(role), outReport);
+}
+
+/**
+ * Frame queue depth, camera resolution limit, pose history and memory budget.
+ * Works before the driver exists; read once when the driver initializes.
+ */
+bool nativeSetMemoryConfig(const QuforiaMemoryConfig* config) {
+
+    if (!config) {
+        LOGE("Null memory config");
+        return false;
+    }
+
+    return setMemoryConfig(*config);
+}
+
+/**
+ * Frame pool and pose history the driver allocated, and whether the budget was met
+ */
+bool nativeGetMemoryReport(QuforiaMemoryReport* outReport) {
+
+    if (!g_driverInstance) {
+        LOGE("Driver not initialized");
+        return false;
+    }
+
+    if (!outReport) {
+        LOGE("Null memory report");
+        return false;
+    }
+
+    g_driverInstance->memoryReport(outReport);
+    return true;
+}
+
+/**
+ * CPU mask of cluster `cluster`, clusters ordered by max frequency (0 = slowest; 0 if unknown)
+ */
+uint64_t nativeGetCpuClusterMask(int cluster) {
+    return cpuClusterMask(cluster);
+}
+
 /**
  * Check if driver is initialized
  */
@@ -0,0 +1,92 @@
+#ifndef QUEST_QUFORIA_LOG_H
+#define QUEST_QUFORIA_LOG_H
+
+#include <android/log.h>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * Logging macros shared by every libquforia translation unit.
+ *
+ * QUFORIA_LOG_LEVEL is the lowest level compiled in (set with -DQUFORIA_LOG_LEVEL=DEBUG|INFO|
+ * WARN|ERROR in CMake). Levels below it expand to a dead `if (false)` branch: the arguments
+ * are still type-checked but no formatting or logd call is emitted. Without an explicit level,
+ * debug builds keep everything and NDEBUG builds start at INFO.
+ */
+
+#define LOG_TAG "QUFORIA"
+
+#define QUFORIA_LOG_LEVEL_DEBUG 3
+#define QUFORIA_LOG_LEVEL_INFO  4
+#define QUFORIA_LOG_LEVEL_WARN  5
+#define QUFORIA_LOG_LEVEL_ERROR 6
+
+#ifndef QUFORIA_LOG_LEVEL
+#ifdef NDEBUG
+#define QUFORIA_LOG_LEVEL QUFORIA_LOG_LEVEL_INFO
+#else
+#define QUFORIA_LOG_LEVEL QUFORIA_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#define QUFORIA_LOG_ENABLED(level) (QUFORIA_LOG_LEVEL_##level >= QUFORIA_LOG_LEVEL)
+
+#define QUFORIA_LOG(level, ...) \
+    do { \
+        if (QUFORIA_LOG_ENABLED(level)) { \
+            __android_log_print(ANDROID_LOG_##level, LOG_TAG, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOGD(...) QUFORIA_LOG(DEBUG, __VA_ARGS__)
+#define LOGI(...) QUFORIA_LOG(INFO, __VA_ARGS__)
+#define LOGW(...) QUFORIA_LOG(WARN, __VA_ARGS__)
+#define LOGE(...) QUFORIA_LOG(ERROR, __VA_ARGS__)
+
+// ============================================================================
+// Rate-limited logging for hot paths
+// ============================================================================
+
+// True at most once per `intervalNs` for a given call site (`lastNs` is its static state)
+inline bool quforiaLogRateLimit(std::atomic<int64_t>& lastNs, int64_t intervalNs) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    const int64_t now = static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+
+    int64_t last = lastNs.load(std::memory_order_relaxed);
+    if (last != 0 && now - last < intervalNs) {
+        return false;
+    }
+    // Only one of several racing threads wins the slot
+    return lastNs.compare_exchange_strong(last, now, std::memory_order_relaxed);
+}
+
+// Log at most once every `intervalMs` from this call site
+#define QUFORIA_LOG_EVERY_MS(level, intervalMs, ...) \
+    do { \
+        if (QUFORIA_LOG_ENABLED(level)) { \
+            static std::atomic<int64_t> quforiaLogLast_(0); \
+            if (quforiaLogRateLimit(quforiaLogLast_, (intervalMs) * 1000000LL)) { \
+                __android_log_print(ANDROID_LOG_##level, LOG_TAG, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+// Log the 1st, (n+1)th, (2n+1)th... time this call site is reached
+#define QUFORIA_LOG_EVERY_N(level, n, ...) \
+    do { \
+        if (QUFORIA_LOG_ENABLED(level)) { \
+            static std::atomic<uint64_t> quforiaLogCount_(0); \
+            if (quforiaLogCount_.fetch_add(1, std::memory_order_relaxed) % (n) == 0) { \
+                __android_log_print(ANDROID_LOG_##level, LOG_TAG, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+#define LOGD_EVERY_MS(intervalMs, ...) QUFORIA_LOG_EVERY_MS(DEBUG, intervalMs, __VA_ARGS__)
+#define LOGW_EVERY_MS(intervalMs, ...) QUFORIA_LOG_EVERY_MS(WARN, intervalMs, __VA_ARGS__)
+#define LOGE_EVERY_MS(intervalMs, ...) QUFORIA_LOG_EVERY_MS(ERROR, intervalMs, __VA_ARGS__)
+#define LOGD_EVERY_N(n, ...) QUFORIA_LOG_EVERY_N(DEBUG, n, __VA_ARGS__)
+
+#endif // QUEST_QUFORIA_LOG_H
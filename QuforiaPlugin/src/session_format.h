@@ -0,0 +1,73 @@
+#ifndef QUEST_SESSION_FORMAT_H
+#define QUEST_SESSION_FORMAT_H
+
+#include <cstdint>
+
+/**
+ * On-disk layout of a recorded session (.qfr), shared by SessionRecorder and SessionReplay.
+ *
+ * File:   SessionFileHeader, then records back to back in arrival order.
+ * Record: SessionRecordHeader followed by `payloadSize` bytes:
+ *   INTRINSICS  float[14] as passed to setCameraIntrinsics ([w, h, fx, fy, cx, cy, d0-d7])
+ *   POSE        SessionPose
+ *   FRAME       SessionFrameHeader + `storedSize` bytes of pixels (raw or LZ4 block)
+ *
+ * Everything is little-endian and naturally aligned; records are padded to 8 bytes so
+ * a memory-mapped file can be read in place.
+ */
+
+static const uint32_t SESSION_FILE_MAGIC = 0x52434651;  // "QFCR"
+static const uint32_t SESSION_FILE_VERSION = 1;
+static const uint32_t SESSION_INTRINSICS_COUNT = 14;
+
+enum class SessionRecordType : uint32_t {
+    INTRINSICS = 1,
+    POSE = 2,
+    FRAME = 3,
+};
+
+enum class SessionCompression : uint32_t {
+    NONE = 0,
+    LZ4 = 1,
+};
+
+struct SessionFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    int64_t startTimestamp;  // First pose or frame timestamp, written on stop (0 if unknown)
+};
+
+struct SessionRecordHeader {
+    uint32_t type;         // SessionRecordType
+    uint32_t payloadSize;  // Bytes following this header, excluding padding
+    int64_t timestamp;     // Nanoseconds, as fed to the driver
+};
+
+struct SessionPose {
+    float position[3];
+    float rotation[4];
+    uint32_t reserved;
+};
+
+struct SessionFrameHeader {
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t format;       // VuforiaDriver::PixelFormat
+    uint32_t compression;  // SessionCompression
+    uint32_t storedSize;   // Bytes of pixel data that follow
+    uint32_t rawSize;      // Bytes after decompression
+    uint32_t reserved;
+    float intrinsics[SESSION_INTRINSICS_COUNT];  // Same layout as INTRINSICS, for this frame
+};
+
+static_assert(sizeof(SessionFileHeader) == 16, "SessionFileHeader layout");
+static_assert(sizeof(SessionRecordHeader) == 16, "SessionRecordHeader layout");
+static_assert(sizeof(SessionPose) == 32, "SessionPose layout");
+static_assert(sizeof(SessionFrameHeader) == 88, "SessionFrameHeader layout");
+
+inline uint32_t sessionPadding(uint32_t size) {
+    return (8 - (size & 7)) & 7;
+}
+
+#endif // QUEST_SESSION_FORMAT_H
@@ -0,0 +1,346 @@
+#include "session_recorder.h"
+#include "thread_config.h"
+#include "quforia_log.h"
+#include <cstddef>
+#include <cstring>
+
+#ifdef QUFORIA_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+// Large stdio buffer so the writer issues few, big writes
+static const size_t FILE_BUFFER_SIZE = 1 << 20;
+
+SessionRecorder::SessionRecorder()
+    : recording_(false)
+    , compress_(false)
+    , file_(nullptr)
+    , queueHead_(0)
+    , queueCount_(0)
+    , stopRequested_(false)
+    , framesInFlight_(0)
+    , recordedFrames_(0)
+    , droppedFrames_(0)
+    , droppedRecords_(0)
+    , compressBufferSize_(0)
+    , startTimestamp_(0)
+{
+}
+
+SessionRecorder::~SessionRecorder() {
+    stop();
+}
+
+bool SessionRecorder::compressionAvailable() {
+#ifdef QUFORIA_HAVE_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool SessionRecorder::start(const char* path, bool compress) {
+    if (recording_.load(std::memory_order_relaxed)) {
+        LOGE("Session recorder already running");
+        return false;
+    }
+
+    // A write failure stops recording but leaves the writer thread (and file) to stop()
+    if (writerThread_.joinable()) {
+        stop();
+    }
+
+    if (!path || !path[0]) {
+        LOGE("Session recorder: no output path");
+        return false;
+    }
+
+    if (compress && !compressionAvailable()) {
+        LOGW("Session recorder: built without LZ4, storing frames uncompressed");
+        compress = false;
+    }
+
+    file_ = fopen(path, "wb");
+    if (!file_) {
+        LOGE("Session recorder: cannot open %s", path);
+        return false;
+    }
+    setvbuf(file_, nullptr, _IOFBF, FILE_BUFFER_SIZE);
+
+    SessionFileHeader header;
+    header.magic = SESSION_FILE_MAGIC;
+    header.version = SESSION_FILE_VERSION;
+    header.startTimestamp = 0;
+    if (fwrite(&header, sizeof(header), 1, file_) != 1) {
+        LOGE("Session recorder: failed to write %s", path);
+        fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+
+    // All allocation happens here, never on the live path
+    queue_.clear();
+    queue_.resize(QUEUE_CAPACITY);
+    queueHead_ = 0;
+    queueCount_ = 0;
+    stopRequested_ = false;
+    compress_ = compress;
+    startTimestamp_ = 0;
+    framesInFlight_.store(0, std::memory_order_relaxed);
+    recordedFrames_.store(0, std::memory_order_relaxed);
+    droppedFrames_.store(0, std::memory_order_relaxed);
+    droppedRecords_.store(0, std::memory_order_relaxed);
+
+    writerThread_ = std::thread(&SessionRecorder::writerLoop, this);
+    recording_.store(true, std::memory_order_release);
+
+    LOGI("Recording session to %s%s", path, compress ? " (LZ4)" : "");
+    return true;
+}
+
+void SessionRecorder::stop() {
+    if (!writerThread_.joinable()) {
+        return;
+    }
+
+    recording_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        stopRequested_ = true;
+    }
+    queueCondition_.notify_one();
+    writerThread_.join();
+
+    if (file_) {
+        fclose(file_);
+        file_ = nullptr;
+    }
+    {
+        // Late producers see stopRequested_ and leave the queue alone
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queue_.clear();
+        queueCount_ = 0;
+    }
+    compressBuffer_.reset();
+    compressBufferSize_ = 0;
+
+    LOGI("Session recording stopped: %llu frames written, %llu frames and %llu records dropped",
+         (unsigned long long)recordedFrames_.load(std::memory_order_relaxed),
+         (unsigned long long)droppedFrames_.load(std::memory_order_relaxed),
+         (unsigned long long)droppedRecords_.load(std::memory_order_relaxed));
+}
+
+// =============================================================================
+// Live path
+// =============================================================================
+
+void SessionRecorder::recordFrame(const FrameHandle& frame) {
+    if (!isRecording() || !frame) {
+        return;
+    }
+
+    // Bound the slabs we hold: skip this frame rather than starve the pool
+    if (framesInFlight_.fetch_add(1, std::memory_order_acq_rel) >= MAX_FRAMES_IN_FLIGHT) {
+        framesInFlight_.fetch_sub(1, std::memory_order_relaxed);
+        droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Entry entry;
+    entry.type = SessionRecordType::FRAME;
+    entry.timestamp = frame->timestamp;
+    entry.frame = frame;
+    if (!push(entry)) {
+        framesInFlight_.fetch_sub(1, std::memory_order_relaxed);
+        droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SessionRecorder::recordPose(const PoseData& pose) {
+    if (!isRecording()) {
+        return;
+    }
+
+    Entry entry;
+    entry.type = SessionRecordType::POSE;
+    entry.timestamp = pose.timestamp;
+    memcpy(entry.values, pose.position, 3 * sizeof(float));
+    memcpy(entry.values + 3, pose.rotation, 4 * sizeof(float));
+    push(entry);
+}
+
+void SessionRecorder::recordIntrinsics(const float* intrinsics) {
+    if (!isRecording() || !intrinsics) {
+        return;
+    }
+
+    Entry entry;
+    entry.type = SessionRecordType::INTRINSICS;
+    entry.timestamp = 0;
+    memcpy(entry.values, intrinsics, sizeof(entry.values));
+    push(entry);
+}
+
+bool SessionRecorder::push(Entry& entry) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (stopRequested_ || queueCount_ == queue_.size()) {
+            droppedRecords_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Entry& slot = queue_[(queueHead_ + queueCount_) % queue_.size()];
+        slot.type = entry.type;
+        slot.timestamp = entry.timestamp;
+        slot.frame = std::move(entry.frame);
+        memcpy(slot.values, entry.values, sizeof(slot.values));
+        queueCount_++;
+    }
+    queueCondition_.notify_one();
+    return true;
+}
+
+// =============================================================================
+// Writer thread
+// =============================================================================
+
+void SessionRecorder::writerLoop() {
+    ScopedThreadRole threadRole(QuforiaThreadRole::SESSION_WRITER, "QuforiaRecorder");
+    Entry entry;
+    bool ioFailed = false;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCondition_.wait(lock, [this]() { return queueCount_ > 0 || stopRequested_; });
+            if (queueCount_ == 0) {
+                break;  // Stop requested and everything queued has been written
+            }
+
+            Entry& slot = queue_[queueHead_];
+            entry.type = slot.type;
+            entry.timestamp = slot.timestamp;
+            entry.frame = std::move(slot.frame);
+            memcpy(entry.values, slot.values, sizeof(entry.values));
+            queueHead_ = (queueHead_ + 1) % queue_.size();
+            queueCount_--;
+        }
+
+        if (!ioFailed && !writeEntry(entry)) {
+            LOGE("Session recorder: write failed, discarding the rest of the session");
+            ioFailed = true;
+            recording_.store(false, std::memory_order_release);
+        } else if (!ioFailed && startTimestamp_ == 0 && entry.type != SessionRecordType::INTRINSICS) {
+            startTimestamp_ = entry.timestamp;
+        }
+
+        if (entry.frame) {
+            entry.frame.reset();
+            framesInFlight_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    // The header went out before any record; fill in where the session starts
+    if (file_ && !ioFailed && startTimestamp_ != 0) {
+        if (fseek(file_, offsetof(SessionFileHeader, startTimestamp), SEEK_SET) != 0 ||
+            fwrite(&startTimestamp_, sizeof(startTimestamp_), 1, file_) != 1) {
+            LOGW("Session recorder: cannot write the start timestamp");
+        }
+    }
+
+    if (file_) {
+        fflush(file_);
+    }
+}
+
+bool SessionRecorder::writeEntry(const Entry& entry) {
+    switch (entry.type) {
+        case SessionRecordType::INTRINSICS:
+            return writeRecord(entry.type, entry.timestamp, entry.values, sizeof(entry.values),
+                               nullptr, 0);
+
+        case SessionRecordType::POSE: {
+            SessionPose pose;
+            memcpy(pose.position, entry.values, sizeof(pose.position));
+            memcpy(pose.rotation, entry.values + 3, sizeof(pose.rotation));
+            pose.reserved = 0;
+            return writeRecord(entry.type, entry.timestamp, &pose, sizeof(pose), nullptr, 0);
+        }
+
+        case SessionRecordType::FRAME: {
+            const CameraFrameData* frame = entry.frame.get();
+
+            SessionFrameHeader header;
+            memset(&header, 0, sizeof(header));
+            header.width = static_cast<uint32_t>(frame->width);
+            header.height = static_cast<uint32_t>(frame->height);
+            header.stride = frame->stride;
+            header.format = static_cast<uint32_t>(frame->format);
+            header.rawSize = static_cast<uint32_t>(frame->size);
+            header.intrinsics[0] = static_cast<float>(frame->width);
+            header.intrinsics[1] = static_cast<float>(frame->height);
+            header.intrinsics[2] = frame->intrinsics.focalLengthX;
+            header.intrinsics[3] = frame->intrinsics.focalLengthY;
+            header.intrinsics[4] = frame->intrinsics.principalPointX;
+            header.intrinsics[5] = frame->intrinsics.principalPointY;
+            for (int i = 0; i < 8; i++) {
+                header.intrinsics[6 + i] = frame->intrinsics.distortionCoefficients[i];
+            }
+
+            const void* data = frame->imageData;
+            header.compression = static_cast<uint32_t>(SessionCompression::NONE);
+            header.storedSize = header.rawSize;
+
+#ifdef QUFORIA_HAVE_LZ4
+            if (compress_) {
+                const size_t bound = static_cast<size_t>(LZ4_compressBound(static_cast<int>(frame->size)));
+                if (bound > compressBufferSize_) {
+                    compressBuffer_.reset(new uint8_t[bound]);
+                    compressBufferSize_ = bound;
+                }
+                const int compressed = LZ4_compress_default(
+                    reinterpret_cast<const char*>(frame->imageData),
+                    reinterpret_cast<char*>(compressBuffer_.get()),
+                    static_cast<int>(frame->size), static_cast<int>(compressBufferSize_));
+                // Keep the raw pixels when LZ4 doesn't pay off
+                if (compressed > 0 && static_cast<size_t>(compressed) < frame->size) {
+                    data = compressBuffer_.get();
+                    header.compression = static_cast<uint32_t>(SessionCompression::LZ4);
+                    header.storedSize = static_cast<uint32_t>(compressed);
+                }
+            }
+#endif
+
+            if (!writeRecord(entry.type, entry.timestamp, &header, sizeof(header),
+                             data, header.storedSize)) {
+                return false;
+            }
+            recordedFrames_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return true;
+}
+
+bool SessionRecorder::writeRecord(SessionRecordType type, int64_t timestamp,
+                                  const void* header, uint32_t headerSize,
+                                  const void* data, uint32_t dataSize) {
+    static const uint8_t zeros[8] = {};
+
+    SessionRecordHeader record;
+    record.type = static_cast<uint32_t>(type);
+    record.payloadSize = headerSize + dataSize;
+    record.timestamp = timestamp;
+
+    if (fwrite(&record, sizeof(record), 1, file_) != 1 ||
+        fwrite(header, headerSize, 1, file_) != 1) {
+        return false;
+    }
+    if (dataSize > 0 && fwrite(data, dataSize, 1, file_) != 1) {
+        return false;
+    }
+
+    const uint32_t padding = sessionPadding(record.payloadSize);
+    return padding == 0 || fwrite(zeros, padding, 1, file_) == 1;
+}
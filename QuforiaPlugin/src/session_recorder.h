@@ -0,0 +1,92 @@
+#ifndef QUEST_SESSION_RECORDER_H
+#define QUEST_SESSION_RECORDER_H
+
+#include "frame_pool.h"
+#include "session_format.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Streams frames, poses and intrinsics passing through the driver to a session file.
+ *
+ * The live path only appends to a bounded in-memory queue: poses and intrinsics are copied
+ * (a few dozen bytes), frames are queued by reference to their pool slab so no pixels are
+ * copied. A background writer thread drains the queue, LZ4-compresses frames if enabled and
+ * the library was available at build time, and writes the records. When the writer falls
+ * behind, new frames are left out of the recording (counted in droppedFrames()) instead of
+ * holding more slabs or blocking the producer.
+ */
+class SessionRecorder {
+public:
+    // Frames the recorder may hold at once; the driver's pool has one spare slab per frame
+    static const size_t MAX_FRAMES_IN_FLIGHT = 1;
+
+    SessionRecorder();
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    bool start(const char* path, bool compress);
+    void stop();
+
+    bool isRecording() const { return recording_.load(std::memory_order_relaxed); }
+
+    // Live path: never block on I/O
+    void recordFrame(const FrameHandle& frame);
+    void recordPose(const PoseData& pose);
+    void recordIntrinsics(const float* intrinsics);
+
+    uint64_t recordedFrames() const { return recordedFrames_.load(std::memory_order_relaxed); }
+    uint64_t droppedFrames() const { return droppedFrames_.load(std::memory_order_relaxed); }
+
+    // Whether LZ4 compression was compiled in
+    static bool compressionAvailable();
+
+private:
+    static const size_t QUEUE_CAPACITY = 512;
+
+    struct Entry {
+        SessionRecordType type;
+        int64_t timestamp;
+        FrameHandle frame;
+        float values[SESSION_INTRINSICS_COUNT];  // Pose (7 floats) or intrinsics (14)
+    };
+
+    bool push(Entry& entry);
+    void writerLoop();
+    bool writeEntry(const Entry& entry);
+    bool writeRecord(SessionRecordType type, int64_t timestamp,
+                     const void* header, uint32_t headerSize,
+                     const void* data, uint32_t dataSize);
+
+    std::atomic<bool> recording_;
+    bool compress_;
+    FILE* file_;
+    std::thread writerThread_;
+
+    // Bounded ring of pending entries (guarded by queueMutex_), preallocated in start()
+    std::mutex queueMutex_;
+    std::condition_variable queueCondition_;
+    std::vector<Entry> queue_;
+    size_t queueHead_;
+    size_t queueCount_;
+    bool stopRequested_;
+
+    std::atomic<size_t> framesInFlight_;
+    std::atomic<uint64_t> recordedFrames_;
+    std::atomic<uint64_t> droppedFrames_;
+    std::atomic<uint64_t> droppedRecords_;
+
+    // Writer thread only
+    std::unique_ptr<uint8_t[]> compressBuffer_;
+    size_t compressBufferSize_;
+    int64_t startTimestamp_;  // First pose or frame written (0 until then)
+};
+
+#endif // QUEST_SESSION_RECORDER_H
@@ -0,0 +1,303 @@
+#include "session_replay.h"
+#include "vuforia_driver.h"
+#include "pixel_convert.h"
+#include "driver_stats.h"
+#include "thread_config.h"
+#include "quforia_log.h"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef QUFORIA_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+SessionReplay::SessionReplay()
+    : mapping_(nullptr)
+    , mappingSize_(0)
+    , frameCount_(0)
+    , poseCount_(0)
+    , firstTimestamp_(0)
+    , lastTimestamp_(0)
+    , stopRequested_(false)
+    , playing_(false)
+    , decodeBufferSize_(0)
+{
+}
+
+SessionReplay::~SessionReplay() {
+    close();
+}
+
+bool SessionReplay::open(const char* path) {
+    close();
+
+    if (!path || !path[0]) {
+        LOGE("Session replay: no input path");
+        return false;
+    }
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        LOGE("Session replay: cannot open %s", path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SessionFileHeader))) {
+        LOGE("Session replay: %s is not a session file", path);
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file alive
+    if (mapping == MAP_FAILED) {
+        LOGE("Session replay: failed to map %s", path);
+        return false;
+    }
+
+    mapping_ = static_cast<const uint8_t*>(mapping);
+    mappingSize_ = static_cast<size_t>(st.st_size);
+
+    // Playback walks the records front to back
+    madvise(mapping, mappingSize_, MADV_SEQUENTIAL);
+
+    if (!index()) {
+        LOGE("Session replay: %s is corrupt or from an unsupported version", path);
+        close();
+        return false;
+    }
+
+    LOGI("Session replay: %s has %zu frames, %zu poses over %.1f s",
+         path, frameCount_, poseCount_, durationNs() / 1e9);
+    return true;
+}
+
+void SessionReplay::close() {
+    stop();
+
+    if (mapping_) {
+        munmap(const_cast<uint8_t*>(mapping_), mappingSize_);
+        mapping_ = nullptr;
+        mappingSize_ = 0;
+    }
+    records_.clear();
+    frameCount_ = 0;
+    poseCount_ = 0;
+    firstTimestamp_ = 0;
+    lastTimestamp_ = 0;
+    decodeBuffer_.reset();
+    decodeBufferSize_ = 0;
+}
+
+bool SessionReplay::index() {
+    const SessionFileHeader* header = reinterpret_cast<const SessionFileHeader*>(mapping_);
+    if (header->magic != SESSION_FILE_MAGIC || header->version != SESSION_FILE_VERSION) {
+        return false;
+    }
+
+    bool haveTimestamp = false;
+    size_t offset = sizeof(SessionFileHeader);
+
+    // A truncated tail (recording cut short) is dropped, not treated as corruption
+    while (offset + sizeof(SessionRecordHeader) <= mappingSize_) {
+        const SessionRecordHeader* record =
+            reinterpret_cast<const SessionRecordHeader*>(mapping_ + offset);
+        const size_t payloadOffset = offset + sizeof(SessionRecordHeader);
+        if (record->payloadSize > mappingSize_ - payloadOffset) {
+            break;
+        }
+
+        const uint8_t* payload = mapping_ + payloadOffset;
+        switch (static_cast<SessionRecordType>(record->type)) {
+            case SessionRecordType::INTRINSICS:
+                if (record->payloadSize < SESSION_INTRINSICS_COUNT * sizeof(float)) {
+                    return false;
+                }
+                break;
+
+            case SessionRecordType::POSE:
+                if (record->payloadSize < sizeof(SessionPose)) {
+                    return false;
+                }
+                poseCount_++;
+                break;
+
+            case SessionRecordType::FRAME: {
+                if (record->payloadSize < sizeof(SessionFrameHeader)) {
+                    return false;
+                }
+                const SessionFrameHeader* frame = reinterpret_cast<const SessionFrameHeader*>(payload);
+                if (frame->storedSize > record->payloadSize - sizeof(SessionFrameHeader)) {
+                    return false;
+                }
+                // feedCameraFrame() reads a whole frame from the (decoded) pixels
+                const auto format = static_cast<VuforiaDriver::PixelFormat>(frame->format);
+                const uint32_t rowBytes = packedStride(format, frame->width);
+                const size_t frameSize = frameBufferSize(format, frame->width, frame->height, frame->stride);
+                const uint32_t pixelBytes =
+                    frame->compression == static_cast<uint32_t>(SessionCompression::NONE) ? frame->storedSize
+                                                                                           : frame->rawSize;
+                if (rowBytes == 0 || (frame->stride != 0 && frame->stride < rowBytes) ||
+                    frameSize == 0 || pixelBytes < frameSize) {
+                    LOGE("Session replay: frame record too small for %ux%u %s",
+                         frame->width, frame->height, pixelFormatName(format));
+                    return false;
+                }
+                frameCount_++;
+                break;
+            }
+
+            default:
+                // Unknown record types from newer recorders are skipped
+                offset = payloadOffset + record->payloadSize + sessionPadding(record->payloadSize);
+                continue;
+        }
+
+        if (record->type != static_cast<uint32_t>(SessionRecordType::INTRINSICS)) {
+            if (!haveTimestamp) {
+                firstTimestamp_ = record->timestamp;
+                haveTimestamp = true;
+            }
+            lastTimestamp_ = record->timestamp;
+        }
+
+        records_.push_back(Record{ record, payload });
+        offset = payloadOffset + record->payloadSize + sessionPadding(record->payloadSize);
+    }
+
+    return true;
+}
+
+bool SessionReplay::start(QuestVuforiaDriver* driver, float speed, bool loop) {
+    if (!mapping_ || !driver) {
+        LOGE("Session replay: nothing to play");
+        return false;
+    }
+
+    stop();
+
+    stopRequested_.store(false, std::memory_order_relaxed);
+    playing_.store(true, std::memory_order_release);
+    playbackThread_ = std::thread(&SessionReplay::playbackLoop, this, driver, speed, loop);
+    return true;
+}
+
+void SessionReplay::stop() {
+    if (!playbackThread_.joinable()) {
+        return;
+    }
+
+    stopRequested_.store(true, std::memory_order_release);
+    playbackThread_.join();
+    playing_.store(false, std::memory_order_release);
+}
+
+void SessionReplay::playbackLoop(QuestVuforiaDriver* driver, float speed, bool loop) {
+    ScopedThreadRole threadRole(QuforiaThreadRole::SESSION_REPLAY, "QuforiaReplay");
+    float appliedIntrinsics[SESSION_INTRINSICS_COUNT] = {};
+    uint64_t framesFed = 0;
+
+    // Keep rebased timestamps strictly increasing across loops
+    int64_t base = monotonicNowNs();
+
+    do {
+        const int64_t passStart = monotonicNowNs();
+        if (base < passStart) {
+            base = passStart;
+        }
+
+        for (const Record& record : records_) {
+            if (stopRequested_.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            const SessionRecordHeader* header = record.header;
+            const int64_t offset = header->timestamp - firstTimestamp_;
+
+            if (speed > 0.0f && header->type != static_cast<uint32_t>(SessionRecordType::INTRINSICS)) {
+                const int64_t due = passStart + static_cast<int64_t>(offset / speed);
+                const int64_t remaining = due - monotonicNowNs();
+                if (remaining > 0) {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(remaining));
+                }
+            }
+
+            const int64_t timestamp = base + offset;
+
+            switch (static_cast<SessionRecordType>(header->type)) {
+                case SessionRecordType::INTRINSICS:
+                    memcpy(appliedIntrinsics, record.payload, sizeof(appliedIntrinsics));
+                    driver->setCameraIntrinsics(appliedIntrinsics);
+                    break;
+
+                case SessionRecordType::POSE: {
+                    const SessionPose* pose = reinterpret_cast<const SessionPose*>(record.payload);
+                    driver->feedDevicePose(pose->position, pose->rotation, timestamp);
+                    break;
+                }
+
+                case SessionRecordType::FRAME: {
+                    // Frames carry the intrinsics they were published with (e.g. after a 2x
+                    // downscale); restore them when they differ from what the driver caches
+                    const SessionFrameHeader* frame =
+                        reinterpret_cast<const SessionFrameHeader*>(record.payload);
+                    if (memcmp(appliedIntrinsics, frame->intrinsics, sizeof(appliedIntrinsics)) != 0) {
+                        memcpy(appliedIntrinsics, frame->intrinsics, sizeof(appliedIntrinsics));
+                        driver->setCameraIntrinsics(appliedIntrinsics);
+                    }
+                    if (feedFrame(driver, record, timestamp)) {
+                        framesFed++;
+                    }
+                    break;
+                }
+            }
+        }
+
+        // Next pass continues one frame interval after this one ended
+        base += durationNs() + 1;
+        if (frameCount_ > 1) {
+            base += durationNs() / static_cast<int64_t>(frameCount_ - 1);
+        }
+    } while (loop && !stopRequested_.load(std::memory_order_acquire));
+
+    LOGI("Session replay finished: %llu frames fed", (unsigned long long)framesFed);
+    playing_.store(false, std::memory_order_release);
+}
+
+bool SessionReplay::feedFrame(QuestVuforiaDriver* driver, const Record& record, int64_t timestamp) {
+    const SessionFrameHeader* frame = reinterpret_cast<const SessionFrameHeader*>(record.payload);
+    const uint8_t* pixels = record.payload + sizeof(SessionFrameHeader);
+    const auto format = static_cast<VuforiaDriver::PixelFormat>(frame->format);
+
+    if (frame->compression == static_cast<uint32_t>(SessionCompression::LZ4)) {
+#ifdef QUFORIA_HAVE_LZ4
+        if (frame->rawSize > decodeBufferSize_) {
+            decodeBuffer_.reset(new uint8_t[frame->rawSize]);
+            decodeBufferSize_ = frame->rawSize;
+        }
+        const int decoded = LZ4_decompress_safe(reinterpret_cast<const char*>(pixels),
+                                                reinterpret_cast<char*>(decodeBuffer_.get()),
+                                                static_cast<int>(frame->storedSize),
+                                                static_cast<int>(frame->rawSize));
+        if (decoded != static_cast<int>(frame->rawSize)) {
+            LOGE_EVERY_MS(1000, "Session replay: corrupt LZ4 frame");
+            return false;
+        }
+        pixels = decodeBuffer_.get();
+#else
+        LOGE_EVERY_MS(1000, "Session replay: LZ4 frame in a build without LZ4");
+        return false;
+#endif
+    } else if (frame->compression != static_cast<uint32_t>(SessionCompression::NONE)) {
+        return false;
+    }
+
+    driver->feedCameraFrame(pixels, static_cast<int>(frame->width), static_cast<int>(frame->height),
+                            format, frame->stride, frame->intrinsics, timestamp);
+    return true;
+}
@@ -0,0 +1,73 @@
+#ifndef QUEST_SESSION_REPLAY_H
+#define QUEST_SESSION_REPLAY_H
+
+#include "session_format.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class QuestVuforiaDriver;
+
+/**
+ * Plays a recorded session back through the driver.
+ *
+ * The file is memory-mapped and indexed once in open(); playback then feeds intrinsics,
+ * poses and frames to the driver in recorded order from a background thread, exactly as
+ * Unity would, so QuestExternalCamera / QuestExternalTracker deliver them to Vuforia (or
+ * to the benchmark's mock callbacks). Uncompressed frames are fed straight from the mapping.
+ * Timestamps are rebased onto CLOCK_MONOTONIC at playback start so pose lookups and the
+ * latency stats behave like a live session.
+ */
+class SessionReplay {
+public:
+    SessionReplay();
+    ~SessionReplay();
+
+    SessionReplay(const SessionReplay&) = delete;
+    SessionReplay& operator=(const SessionReplay&) = delete;
+
+    bool open(const char* path);
+    void close();
+
+    // speed 1.0 = original timing, 2.0 = twice as fast, 0 = as fast as possible
+    bool start(QuestVuforiaDriver* driver, float speed, bool loop);
+    void stop();
+
+    // True while the playback thread is feeding records
+    bool isPlaying() const { return playing_.load(std::memory_order_acquire); }
+
+    size_t frameCount() const { return frameCount_; }
+    size_t poseCount() const { return poseCount_; }
+    int64_t durationNs() const { return lastTimestamp_ - firstTimestamp_; }
+
+private:
+    struct Record {
+        const SessionRecordHeader* header;
+        const uint8_t* payload;
+    };
+
+    bool index();
+    void playbackLoop(QuestVuforiaDriver* driver, float speed, bool loop);
+    bool feedFrame(QuestVuforiaDriver* driver, const Record& record, int64_t timestamp);
+
+    const uint8_t* mapping_;
+    size_t mappingSize_;
+    std::vector<Record> records_;
+    size_t frameCount_;
+    size_t poseCount_;
+    int64_t firstTimestamp_;
+    int64_t lastTimestamp_;
+
+    std::thread playbackThread_;
+    std::atomic<bool> stopRequested_;
+    std::atomic<bool> playing_;
+
+    // Decompression target for LZ4 frames (playback thread only)
+    std::unique_ptr<uint8_t[]> decodeBuffer_;
+    size_t decodeBufferSize_;
+};
+
+#endif // QUEST_SESSION_REPLAY_H
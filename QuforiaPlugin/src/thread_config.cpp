@@ -0,0 +1,269 @@
+#include "thread_config.h"
+#include "quforia_log.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+const int ROLE_COUNT = static_cast<int>(QuforiaThreadRole::COUNT);
+
+// Running threads tracked per role (the ingest pool is the only role with more than one)
+const int MAX_THREADS_PER_ROLE = 8;
+
+struct RoleState {
+    QuforiaThreadConfig config;
+    bool configured;
+    QuforiaThreadReport report;  // Oldest running thread of the role
+    int32_t tids[MAX_THREADS_PER_ROLE];
+    int threadCount;
+};
+
+std::mutex g_threadConfigMutex;
+RoleState g_roles[ROLE_COUNT];
+
+int32_t currentTid() {
+    return static_cast<int32_t>(syscall(SYS_gettid));
+}
+
+bool validRole(int32_t role) {
+    return role >= 0 && role < ROLE_COUNT;
+}
+
+// Rename any thread of this process (pthread_setname_np only reaches our own pthread_t)
+bool setThreadName(int32_t tid, const char* name) {
+    if (tid == currentTid()) {
+        return pthread_setname_np(pthread_self(), name) == 0;
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%d/comm", tid);
+    FILE* comm = fopen(path, "w");
+    if (!comm) {
+        return false;
+    }
+    const bool ok = fputs(name, comm) >= 0;
+    fclose(comm);
+    return ok;
+}
+
+// Apply `config` to thread `tid` and record the outcome in `report`
+void applyConfig(int32_t tid, const QuforiaThreadConfig& config, const char* name,
+                 QuforiaThreadReport* report) {
+    int32_t errors = 0;
+
+    if (name && name[0] && !setThreadName(tid, name)) {
+        errors |= QUFORIA_THREAD_NAME_FAILED;
+    }
+
+    bool fifo = false;
+    if (config.policy == QUFORIA_SCHED_FIFO) {
+        sched_param param;
+        param.sched_priority = std::max(1, std::min(config.priority, 99));
+        if (sched_setscheduler(tid, SCHED_FIFO, &param) == 0) {
+            fifo = true;
+        } else {
+            // Apps usually lack CAP_SYS_NICE; nice (if requested) is the fallback
+            errors |= QUFORIA_THREAD_SCHED_FAILED;
+        }
+    } else if (sched_getscheduler(tid) == SCHED_FIFO) {
+        sched_param param;
+        param.sched_priority = 0;
+        if (sched_setscheduler(tid, SCHED_OTHER, &param) != 0) {
+            errors |= QUFORIA_THREAD_SCHED_FAILED;
+        }
+    }
+
+    // On Linux, PRIO_PROCESS with a tid addresses that single thread
+    if (!fifo && config.setNice && setpriority(PRIO_PROCESS, tid, config.nice) != 0) {
+        errors |= QUFORIA_THREAD_NICE_FAILED;
+    }
+
+    if (config.cpuMask != 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+            if (config.cpuMask & (1ull << cpu)) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        if (sched_setaffinity(tid, sizeof(set), &set) != 0) {
+            errors |= QUFORIA_THREAD_AFFINITY_FAILED;
+        }
+    }
+
+    // Read back what the kernel actually gave us
+    report->role = config.role;
+    report->tid = tid;
+    report->errors = errors;
+
+    const int policy = sched_getscheduler(tid);
+    report->policy = policy == SCHED_FIFO ? QUFORIA_SCHED_FIFO : QUFORIA_SCHED_DEFAULT;
+
+    sched_param param;
+    report->priority = sched_getparam(tid, &param) == 0 ? param.sched_priority : 0;
+
+    errno = 0;
+    const int nice = getpriority(PRIO_PROCESS, tid);
+    report->nice = errno == 0 ? nice : 0;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    report->cpuMask = 0;
+    if (sched_getaffinity(tid, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) {
+                report->cpuMask |= 1ull << cpu;
+            }
+        }
+    }
+
+    if (name) {
+        strncpy(report->name, name, sizeof(report->name) - 1);
+        report->name[sizeof(report->name) - 1] = '\0';
+    }
+
+    if (errors) {
+        LOGW("Thread %s (tid %d): some settings were refused (errors 0x%x)",
+             report->name, tid, errors);
+    }
+    LOGI("Thread %s (tid %d): %s priority %d, nice %d, cpus 0x%llx",
+         report->name, tid, report->policy == QUFORIA_SCHED_FIFO ? "SCHED_FIFO" : "SCHED_OTHER",
+         report->priority, report->nice, (unsigned long long)report->cpuMask);
+}
+
+} // namespace
+
+bool setThreadConfig(const QuforiaThreadConfig& config) {
+    if (!validRole(config.role)) {
+        LOGE("Invalid thread role: %d", config.role);
+        return false;
+    }
+    if (config.policy != QUFORIA_SCHED_DEFAULT && config.policy != QUFORIA_SCHED_FIFO) {
+        LOGE("Invalid scheduling policy: %d", config.policy);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_threadConfigMutex);
+    RoleState& state = g_roles[config.role];
+    state.config = config;
+    state.config.name[sizeof(state.config.name) - 1] = '\0';
+    state.configured = true;
+
+    // Running threads switch right away (names are kept: they are per thread)
+    for (int i = 0; i < state.threadCount; i++) {
+        QuforiaThreadReport scratch;
+        memset(&scratch, 0, sizeof(scratch));
+        QuforiaThreadReport* report = state.tids[i] == state.report.tid ? &state.report : &scratch;
+        const char* name = state.config.name[0] && state.threadCount == 1 ? state.config.name : nullptr;
+        applyConfig(state.tids[i], state.config, name, report);
+    }
+    return true;
+}
+
+bool getThreadReport(QuforiaThreadRole role, QuforiaThreadReport* out) {
+    const int32_t index = static_cast<int32_t>(role);
+    if (!validRole(index) || !out) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_threadConfigMutex);
+    *out = g_roles[index].report;
+    out->role = index;
+    return true;
+}
+
+uint64_t cpuClusterMask(int cluster) {
+    const long cpuCount = std::min(sysconf(_SC_NPROCESSORS_CONF), 64L);
+
+    std::vector<long> maxFreq(static_cast<size_t>(std::max(cpuCount, 0L)), 0);
+    for (long cpu = 0; cpu < cpuCount; cpu++) {
+        char path[96];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%ld/cpufreq/cpuinfo_max_freq", cpu);
+        FILE* file = fopen(path, "r");
+        if (!file) {
+            continue;
+        }
+        if (fscanf(file, "%ld", &maxFreq[cpu]) != 1) {
+            maxFreq[cpu] = 0;
+        }
+        fclose(file);
+    }
+
+    // Distinct max frequencies, slowest first, are the clusters
+    std::vector<long> clusters;
+    for (long freq : maxFreq) {
+        if (freq > 0 && std::find(clusters.begin(), clusters.end(), freq) == clusters.end()) {
+            clusters.push_back(freq);
+        }
+    }
+    std::sort(clusters.begin(), clusters.end());
+
+    if (cluster < 0 || cluster >= static_cast<int>(clusters.size())) {
+        return 0;
+    }
+
+    uint64_t mask = 0;
+    for (long cpu = 0; cpu < cpuCount; cpu++) {
+        if (maxFreq[cpu] == clusters[cluster]) {
+            mask |= 1ull << cpu;
+        }
+    }
+    return mask;
+}
+
+// =============================================================================
+// ScopedThreadRole
+// =============================================================================
+
+ScopedThreadRole::ScopedThreadRole(QuforiaThreadRole role, const char* defaultName,
+                                   uint64_t defaultCpuMask)
+    : role_(role)
+    , tid_(currentTid())
+{
+    const int32_t index = static_cast<int32_t>(role);
+    std::lock_guard<std::mutex> lock(g_threadConfigMutex);
+    RoleState& state = g_roles[index];
+
+    QuforiaThreadConfig config;
+    if (state.configured) {
+        config = state.config;
+    } else {
+        memset(&config, 0, sizeof(config));
+        config.role = index;
+        config.cpuMask = defaultCpuMask;
+    }
+
+    // The first thread of a role owns the report; later ones only apply the settings
+    const char* name = config.name[0] && state.threadCount == 0 ? config.name : defaultName;
+    QuforiaThreadReport scratch;
+    memset(&scratch, 0, sizeof(scratch));
+    applyConfig(tid_, config, name, state.threadCount == 0 ? &state.report : &scratch);
+
+    if (state.threadCount < MAX_THREADS_PER_ROLE) {
+        state.tids[state.threadCount++] = tid_;
+    }
+}
+
+ScopedThreadRole::~ScopedThreadRole() {
+    std::lock_guard<std::mutex> lock(g_threadConfigMutex);
+    RoleState& state = g_roles[static_cast<int32_t>(role_)];
+
+    for (int i = 0; i < state.threadCount; i++) {
+        if (state.tids[i] == tid_) {
+            state.tids[i] = state.tids[--state.threadCount];
+            break;
+        }
+    }
+    if (state.report.tid == tid_) {
+        state.report.tid = 0;
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef QUEST_THREAD_CONFIG_H
+#define QUEST_THREAD_CONFIG_H
+
+#include <cstdint>
+
+// Threads started by the driver
+enum class QuforiaThreadRole : int32_t {
+    FRAME_DELIVERY = 0,  // Camera delivery thread (pose + frame callbacks into Vuforia)
+    SESSION_WRITER = 1,  // Session recorder's writer
+    SESSION_REPLAY = 2,  // Session replay feeder
+    INGEST_WORKER = 3,   // Frame conversion workers (async ingestion), pinned to little cores
+    COUNT
+};
+
+enum QuforiaSchedPolicy : int32_t {
+    QUFORIA_SCHED_DEFAULT = 0,  // SCHED_OTHER, optionally with a nice value
+    QUFORIA_SCHED_FIFO = 1,     // Real-time FIFO at `priority` (needs permission; falls back)
+};
+
+// Error bits in QuforiaThreadReport::errors
+enum QuforiaThreadConfigError : int32_t {
+    QUFORIA_THREAD_NAME_FAILED = 1 << 0,
+    QUFORIA_THREAD_SCHED_FAILED = 1 << 1,
+    QUFORIA_THREAD_NICE_FAILED = 1 << 2,
+    QUFORIA_THREAD_AFFINITY_FAILED = 1 << 3,
+};
+
+// Requested settings for one thread role (mirrored by QuestVuforiaBridge.ThreadConfig)
+struct QuforiaThreadConfig {
+    int32_t role;      // QuforiaThreadRole
+    int32_t policy;    // QuforiaSchedPolicy
+    int32_t priority;  // SCHED_FIFO priority (1-99)
+    int32_t nice;      // Applied when setNice != 0 (also the fallback when FIFO is refused)
+    int32_t setNice;
+    int32_t reserved;
+    uint64_t cpuMask;  // Bit n = CPU n; 0 leaves affinity alone
+    char name[16];     // Thread name for systrace (empty = default)
+};
+
+// Settings a thread actually runs with (mirrored by QuestVuforiaBridge.ThreadReport)
+struct QuforiaThreadReport {
+    int32_t role;
+    int32_t tid;       // 0 while the thread isn't running
+    int32_t policy;    // QuforiaSchedPolicy in effect
+    int32_t priority;
+    int32_t nice;
+    int32_t errors;    // QuforiaThreadConfigError bits for settings that were refused
+    uint64_t cpuMask;  // Affinity in effect
+    char name[16];
+};
+
+/**
+ * Process-wide thread configuration for the driver's threads.
+ *
+ * Configuration can be set before Vuforia creates the driver (Unity sets it up front; native
+ * hosts can also pass it through the vuforiaDriver_init userData) and applies whenever a
+ * thread of that role starts. Threads that are already running pick up scheduling and
+ * affinity changes immediately. Each thread records what it actually got, for reporting back
+ * to Unity; for roles with several threads (the ingest workers) the report describes the
+ * oldest one.
+ */
+bool setThreadConfig(const QuforiaThreadConfig& config);
+bool getThreadReport(QuforiaThreadRole role, QuforiaThreadReport* out);
+
+// Mask of the CPUs in cluster `cluster`, clusters ordered by max frequency (0 = slowest).
+// Returns 0 if the cluster doesn't exist or the topology can't be read.
+uint64_t cpuClusterMask(int cluster);
+
+// Applies the configuration for `role` to the calling thread for its lifetime.
+// Every driver thread creates one of these first thing. `defaultCpuMask` is the affinity
+// used while Unity hasn't configured the role (0 = leave it alone).
+class ScopedThreadRole {
+public:
+    ScopedThreadRole(QuforiaThreadRole role, const char* defaultName, uint64_t defaultCpuMask = 0);
+    ~ScopedThreadRole();
+
+    ScopedThreadRole(const ScopedThreadRole&) = delete;
+    ScopedThreadRole& operator=(const ScopedThreadRole&) = delete;
+
+private:
+    QuforiaThreadRole role_;
+    int32_t tid_;
+};
+
+#endif // QUEST_THREAD_CONFIG_H
@@ -1,14 +1,13 @@
 #include "vuforia_driver.h"
 #include "external_camera.h"
 #include "external_tracker.h"
-#include <android/log.h>
+#include "pixel_convert.h"
+#include "init_config.h"
+#include "quforia_log.h"
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 
-#define LOG_TAG "QUFORIA"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-
 // Global driver instance
 QuestVuforiaDriver* g_driverInstance = nullptr;
 
@@ -82,19 +81,61 @@ QuestVuforiaDriver::QuestVuforiaDriver(VuforiaDriver::PlatformData* platformData
                                        void* userData)
     : camera_(nullptr)
     , tracker_(nullptr)
-    , intrinsicsSet_(false)
+    , frameRing_(framePool_)
+    , deliveryPolicy_(FrameDeliveryPolicy::LATEST_ONLY)
+    , activeMode_(0)
+    , lumaOnlyTracking_(false)
+    , cropCenterX_(0.5f)
+    , cropCenterY_(0.5f)
+    , cropHalfSizeModes_(false)
+    , exposure_(0)
+#ifdef __ANDROID__
+    , javaVM_(platformData ? platformData->javaVM : nullptr)
+#endif
+    , poseSink_(nullptr)
 {
-    (void)platformData;  // Unused parameter (provided by Vuforia for Android JNI access if needed)
-    (void)userData;      // Unused parameter
+    (void)platformData;  // Only the JavaVM is kept (Android), for HardwareBuffer ingestion
     LOGI("QuestVuforiaDriver constructor");
 
-    // Initialize cached intrinsics with default values
-    memset(&cachedIntrinsics_, 0, sizeof(cachedIntrinsics_));
+    // Thread settings must be in place before the camera starts its delivery thread. Configs
+    // from before memoryConfig was appended carry thread settings only.
+    const QuforiaInitConfig* config = static_cast<const QuforiaInitConfig*>(userData);
+    if (config) {
+        if (config->size < offsetof(QuforiaInitConfig, memoryConfig)) {
+            LOGW("Ignoring init config of unexpected size %u", config->size);
+        } else {
+            for (uint32_t i = 0; i < config->threadConfigCount && config->threadConfigs; i++) {
+                setThreadConfig(config->threadConfigs[i]);
+            }
+            if (config->size >= sizeof(QuforiaInitConfig) && config->memoryConfig) {
+                setMemoryConfig(*config->memoryConfig);
+            }
+        }
+    }
+
+    // Size the frame slabs for the largest mode the camera will advertise within the budget
+    uint32_t modeCount = 0;
+    const VuforiaDriver::CameraMode* modes = QuestExternalCamera::allCameraModes(&modeCount);
+    layout_ = planMemoryLayout(memoryConfig(), modes, modeCount, FRAME_POOL_EXTRA_SLOTS);
+    framePool_.allocate(layout_.framePoolSlots, layout_.slabSize);
+    frameRing_.allocate(layout_.frameQueueDepth);
+    poseHistory_.allocate(layout_.poseWindowNs, layout_.maxPoseRateHz);
+    mappedPoses_.resize(poseHistory_.capacity());
+
+    LOGI("Frame queue %zu, pose history %lld ms at %u Hz: %.1f MB resident",
+         layout_.frameQueueDepth, (long long)(layout_.poseWindowNs / 1000000), layout_.maxPoseRateHz,
+         layout_.totalBytes() / (1024.0 * 1024.0));
 }
 
 QuestVuforiaDriver::~QuestVuforiaDriver() {
     LOGI("QuestVuforiaDriver destructor");
 
+    // Replay feeds this driver, the ingest workers publish into it and the recorder holds
+    // pool slabs: stop them first, in that order
+    replay_.close();
+    ingest_.stop();
+    recorder_.stop();
+
     if (camera_) {
         delete camera_;
         camera_ = nullptr;
@@ -105,16 +146,32 @@ QuestVuforiaDriver::~QuestVuforiaDriver() {
         tracker_ = nullptr;
     }
 
-    // Clear frame queue
-    std::lock_guard<std::mutex> frameLock(frameMutex_);
-    while (!frameQueue_.empty()) {
-        frameQueue_.pop();
-    }
+    // Return any borrowed and queued slabs to the pool
+    borrowedFrame_.reset();
+    frameRing_.clear();
+}
 
-    // Clear pose queue
-    std::lock_guard<std::mutex> poseLock(poseMutex_);
-    while (!poseQueue_.empty()) {
-        poseQueue_.pop();
+void QuestVuforiaDriver::memoryReport(QuforiaMemoryReport* out) const {
+    memset(out, 0, sizeof(*out));
+    out->frameQueueDepth = static_cast<uint32_t>(layout_.frameQueueDepth);
+    out->framePoolSlots = static_cast<uint32_t>(framePool_.slotCount());
+    out->poseHistoryMs = static_cast<uint32_t>(layout_.poseWindowNs / 1000000);
+    out->poseCapacity = static_cast<uint32_t>(poseHistory_.capacity());
+    out->slabBytes = framePool_.slabSize();
+    out->framePoolBytes = framePool_.slotCount() * framePool_.slabSize();
+    out->poseHistoryBytes = PoseHistory::bytesFor(poseHistory_.capacity()) + mappedPoses_.size() * sizeof(PoseData);
+    out->totalBytes = out->framePoolBytes + out->poseHistoryBytes;
+    out->budgetBytes = layout_.budgetBytes;
+    out->budgetMet = layout_.budgetMet ? 1 : 0;
+
+    uint32_t modeCount = 0;
+    const VuforiaDriver::CameraMode* modes = QuestExternalCamera::allCameraModes(&modeCount);
+    for (uint32_t i = 0; i < modeCount; i++) {
+        if (layout_.fits(modes[i])) {
+            out->modesAdvertised++;
+            out->maxFrameWidth = std::max(out->maxFrameWidth, modes[i].width);
+            out->maxFrameHeight = std::max(out->maxFrameHeight, modes[i].height);
+        }
     }
 }
 
@@ -195,83 +252,564 @@ void QuestVuforiaDriver::destroyExternalPositionalDeviceTracker(
 // Frame and Pose Feeding (called from JNI layer)
 // =============================================================================
 
-void QuestVuforiaDriver::feedCameraFrame(const uint8_t* imageData, int width, int height,
+bool QuestVuforiaDriver::feedCameraFrame(const uint8_t* imageData, int width, int height,
                                         const float* intrinsics, int64_t timestamp) {
-    std::lock_guard<std::mutex> lock(frameMutex_);
+    return feedCameraFrame(imageData, width, height, VuforiaDriver::PixelFormat::RGB888, 0,
+                    intrinsics, timestamp);
+}
+
+bool QuestVuforiaDriver::feedCameraFrame(const uint8_t* imageData, int width, int height,
+                                        VuforiaDriver::PixelFormat format, uint32_t stride,
+                                        const float* intrinsics, int64_t timestamp,
+                                        bool flipVertically) {
+    return ingestFrame(imageData, width, height, format, stride, nullptr, intrinsics, timestamp,
+                       flipVertically, false) != 0;
+}
+
+bool QuestVuforiaDriver::submitFrame(const uint8_t* imageData, int width, int height,
+                                    VuforiaDriver::PixelFormat format, uint32_t stride,
+                                    const PoseData& pose, const float* intrinsics,
+                                    int64_t timestamp, bool flipVertically) {
+    const PoseData framePose = recordSubmittedPose(pose, timestamp);
+    return ingestFrame(imageData, width, height, format, stride, &framePose, intrinsics, timestamp,
+                       flipVertically, false) != 0;
+}
+
+uint64_t QuestVuforiaDriver::feedCameraFrameAsync(const uint8_t* imageData, int width, int height,
+                                                  VuforiaDriver::PixelFormat format, uint32_t stride,
+                                                  const PoseData* pose, const float* intrinsics,
+                                                  int64_t timestamp, bool flipVertically) {
+    PoseData framePose;
+    if (pose) {
+        framePose = recordSubmittedPose(*pose, timestamp);
+    }
+    return ingestFrame(imageData, width, height, format, stride, pose ? &framePose : nullptr,
+                       intrinsics, timestamp, flipVertically, true);
+}
+
+bool QuestVuforiaDriver::setIngestWorkers(int count) {
+    if (count < 0 || count > FrameIngestPool::MAX_WORKERS) {
+        LOGE("setIngestWorkers: invalid worker count %d (0-%d)", count, FrameIngestPool::MAX_WORKERS);
+        return false;
+    }
+    if (count == ingest_.workerCount()) {
+        return true;
+    }
+
+    // Pending frames are published before the old workers exit
+    ingest_.stop();
+    if (count == 0) {
+        LOGI("Frame ingestion is synchronous");
+        return true;
+    }
+    return ingest_.start(count, this);
+}
+
+PoseData QuestVuforiaDriver::recordSubmittedPose(const PoseData& pose, int64_t timestamp) {
+    PoseData framePose = pose;
+    framePose.timestamp = timestamp;
+
+    // Keep the history complete for consumers that sample by time
+    if (poseHistory_.push(framePose)) {
+        stats_.poseFed();
+        recorder_.recordPose(framePose);
+    } else {
+        LOGW_EVERY_MS(1000, "Submitted pose is older than the pose history: timestamp=%lld",
+                      (long long)timestamp);
+    }
+    return framePose;
+}
+
+uint64_t QuestVuforiaDriver::ingestFrame(const uint8_t* imageData, int width, int height,
+                                        VuforiaDriver::PixelFormat format, uint32_t stride,
+                                        const PoseData* pose, const float* intrinsics,
+                                        int64_t timestamp, bool flipVertically, bool async) {
+    FrameConversion conversion = planConversion(width, height, format);
+    conversion.options.flipVertically = flipVertically;
+
+    if (!canConvert(format, conversion.format, conversion.options)) {
+        LOGE_EVERY_MS(1000, "Cannot feed %s frame to a %s camera mode",
+                      pixelFormatName(format), pixelFormatName(conversion.format));
+        stats_.frameRejected();
+        return 0;
+    }
+
+    // A crop only moves the start of the source rows
+    if (conversion.crop.width > 0) {
+        if (!cropPackedFrame(&imageData, stride, format, width, height, conversion.crop,
+                             flipVertically)) {
+            LOGE_EVERY_MS(1000, "Cannot crop %s frames (single-plane RGB/YUYV input only)",
+                          pixelFormatName(format));
+            stats_.frameRejected();
+            return 0;
+        }
+        if (stride == 0) {
+            stride = packedStride(format, width);
+        }
+        width = conversion.crop.width;
+        height = conversion.crop.height;
+    }
+
+    FrameHandle frameData = acquireFrameSlot(conversion.width, conversion.height, conversion.format);
+    if (!frameData) {
+        return 0;
+    }
+
+    if (ingest_.running()) {
+        IngestJob job;
+        job.src = imageData;
+        job.srcStride = stride;
+        job.srcFormat = format;
+        job.width = static_cast<uint32_t>(width);
+        job.height = static_cast<uint32_t>(height);
+        job.dst = std::move(frameData);
+        job.convert = true;
+        job.options = conversion.options;
+        job.crop = conversion.crop;
+        job.hasIntrinsics = intrinsics != nullptr;
+        if (intrinsics) {
+            memcpy(job.intrinsics, intrinsics, sizeof(job.intrinsics));
+        }
+        if (pose) {
+            job.pose = *pose;
+            job.hasPose = true;
+        }
+        job.timestamp = timestamp;
+
+        // Async callers drop the frame rather than wait for a queue entry
+        const uint64_t ticket = ingest_.submit(job, !async);
+        if (ticket == 0) {
+            LOGW_EVERY_MS(1000, "Ingest queue full, dropping frame: timestamp=%lld",
+                          (long long)timestamp);
+            stats_.frameRejected();
+            return 0;
+        }
+        if (!async) {
+            ingest_.wait(ticket);
+        }
+        return ticket;
+    }
+
+    // Copy (or convert) straight from the caller's buffer into the pooled slab
+    if (!convertFrame(imageData, stride, format, frameData->imageData, frameData->stride,
+                      conversion.format, width, height, conversion.options)) {
+        LOGE_EVERY_MS(1000, "Failed to convert %dx%d frame from %s to %s",
+                      width, height, pixelFormatName(format), pixelFormatName(conversion.format));
+        stats_.frameRejected();
+        return 0;
+    }
+
+    if (pose) {
+        frameData->pose = *pose;
+        frameData->hasPose = true;
+    }
+
+    publishFrame(std::move(frameData), intrinsics, timestamp, conversion.options.downscale2x,
+                 conversion.crop);
+    return ingest_.completeInline();
+}
+
+void QuestVuforiaDriver::finishIngest(IngestJob& job) {
+    if (job.failed) {
+        LOGE_EVERY_MS(1000, "Failed to convert %ux%u frame from %s to %s",
+                      job.width, job.height, pixelFormatName(job.srcFormat),
+                      pixelFormatName(job.dst->format));
+        stats_.frameRejected();
+        return;
+    }
+
+    if (job.hasPose) {
+        job.dst->pose = job.pose;
+        job.dst->hasPose = true;
+    }
+
+    publishFrame(std::move(job.dst), job.hasIntrinsics ? job.intrinsics : nullptr, job.timestamp,
+                 job.options.downscale2x, job.crop);
+}
+
+uint8_t* QuestVuforiaDriver::beginCameraFrame(int width, int height,
+                                              VuforiaDriver::PixelFormat format,
+                                              const CropWindow* sourceWindow) {
+    if (borrowedFrame_) {
+        LOGE("beginCameraFrame: previous frame was never committed, discarding it");
+        borrowedFrame_.reset();
+    }
+
+    const FrameConversion conversion = planConversion(width, height, format);
+    if (!canConvert(format, conversion.format, conversion.options)) {
+        LOGE("beginCameraFrame: cannot convert %s to %s",
+             pixelFormatName(format), pixelFormatName(conversion.format));
+        stats_.frameRejected();
+        return nullptr;
+    }
+    if (conversion.crop.width > 0 && isYuv420(format)) {
+        LOGE("beginCameraFrame: %s frames can't be cropped on commit, write the crop window",
+             pixelFormatName(format));
+        stats_.frameRejected();
+        return nullptr;
+    }
+
+    borrowedWindow_ = sourceWindow ? *sourceWindow : CropWindow();
+    borrowedFrame_ = acquireFrameSlot(width, height, format);
+    return borrowedFrame_ ? borrowedFrame_->imageData : nullptr;
+}
+
+bool QuestVuforiaDriver::commitCameraFrame(const float* intrinsics, int64_t timestamp,
+                                           const PoseData* pose) {
+    if (!borrowedFrame_) {
+        LOGE("commitCameraFrame: no frame borrowed");
+        return false;
+    }
+
+    FrameHandle frameData = std::move(borrowedFrame_);
+
+    // The active mode may use another layout or size than the producer wrote:
+    // convert into a second slab
+    const FrameConversion conversion =
+        planConversion(frameData->width, frameData->height, frameData->format);
+
+    // Window of the calibrated image the published frame shows
+    CropWindow window = borrowedWindow_;
+    if (conversion.crop.width > 0) {
+        window.x += conversion.crop.x;
+        window.y += conversion.crop.y;
+        window.width = conversion.crop.width;
+        window.height = conversion.crop.height;
+    }
+
+    if (conversion.needed) {
+        FrameHandle converted = acquireFrameSlot(conversion.width, conversion.height,
+                                                 conversion.format);
+        if (!converted) {
+            return false;
+        }
+        converted->exposureTimeNs = frameData->exposureTimeNs;
+        converted->readoutTimeNs = frameData->readoutTimeNs;
+
+        const uint8_t* src = frameData->imageData;
+        uint32_t srcWidth = static_cast<uint32_t>(frameData->width);
+        uint32_t srcHeight = static_cast<uint32_t>(frameData->height);
+        if (conversion.crop.width > 0) {
+            // beginCameraFrame() only lends single-plane layouts while a crop mode is active
+            cropPackedFrame(&src, frameData->stride, frameData->format, srcWidth, srcHeight,
+                            conversion.crop);
+            srcWidth = conversion.crop.width;
+            srcHeight = conversion.crop.height;
+        }
+
+        if (ingest_.running()) {
+            // The workers convert from the borrowed slab, which the job keeps alive
+            IngestJob job;
+            job.src = src;
+            job.srcStride = frameData->stride;
+            job.srcFormat = frameData->format;
+            job.width = srcWidth;
+            job.height = srcHeight;
+            job.srcFrame = std::move(frameData);
+            job.dst = std::move(converted);
+            job.convert = true;
+            job.options = conversion.options;
+            job.crop = window;
+            job.hasIntrinsics = intrinsics != nullptr;
+            if (intrinsics) {
+                memcpy(job.intrinsics, intrinsics, sizeof(job.intrinsics));
+            }
+            if (pose) {
+                job.pose = recordSubmittedPose(*pose, timestamp);
+                job.hasPose = true;
+            }
+            job.timestamp = timestamp;
+            return ingest_.submit(job, true) != 0;
+        }
+
+        if (!convertFrame(src, frameData->stride, frameData->format,
+                          converted->imageData, converted->stride, conversion.format,
+                          srcWidth, srcHeight, conversion.options)) {
+            LOGE("commitCameraFrame: failed to convert %s to %s",
+                 pixelFormatName(frameData->format), pixelFormatName(conversion.format));
+            stats_.frameRejected();
+            return false;
+        }
+        frameData = std::move(converted);
+    }
+
+    if (pose) {
+        frameData->pose = recordSubmittedPose(*pose, timestamp);
+        frameData->hasPose = true;
+    }
+
+    if (ingest_.running()) {
+        // Nothing to convert, but the frame must be published after those already queued
+        IngestJob job;
+        job.dst = std::move(frameData);
+        job.crop = window;
+        job.hasIntrinsics = intrinsics != nullptr;
+        if (intrinsics) {
+            memcpy(job.intrinsics, intrinsics, sizeof(job.intrinsics));
+        }
+        job.timestamp = timestamp;
+        return ingest_.submit(job, true) != 0;
+    }
+
+    publishFrame(std::move(frameData), intrinsics, timestamp, conversion.options.downscale2x,
+                 window);
+    return true;
+}
+
+void QuestVuforiaDriver::cancelCameraFrame() {
+    borrowedFrame_.reset();
+}
+
+FrameHandle QuestVuforiaDriver::acquireFrameSlot(int width, int height,
+                                                 VuforiaDriver::PixelFormat format) {
+    if (width <= 0 || height <= 0) {
+        LOGE_EVERY_MS(1000, "Invalid frame size: %dx%d", width, height);
+        stats_.frameRejected();
+        return FrameHandle();
+    }
+
+    size_t dataSize = frameBufferSize(format, width, height);
+    if (dataSize == 0) {
+        LOGE("Unsupported pixel format: %s", pixelFormatName(format));
+        stats_.frameRejected();
+        return FrameHandle();
+    }
+
+    if (dataSize > framePool_.slabSize()) {
+        LOGE_EVERY_MS(1000, "Frame %dx%d %s (%zu bytes) exceeds frame slab size (%zu bytes)",
+                      width, height, pixelFormatName(format), dataSize, framePool_.slabSize());
+        stats_.frameRejected();
+        return FrameHandle();
+    }
+
+    FrameHandle frameData = framePool_.acquire();
+
+    if (!frameData) {
+        // Every slab is referenced: drop the oldest queued frame and retry once.
+        // The ring's slab only frees up if no reader is still holding it.
+        if (evictOldestFrame()) {
+            frameData = framePool_.acquire();
+        }
+    }
+
+    if (!frameData) {
+        LOGE_EVERY_MS(1000, "Frame pool exhausted, dropping frame");
+        stats_.frameRejected();
+        return FrameHandle();
+    }
 
-    // Create new frame data
-    auto frameData = std::make_shared<CameraFrameData>();
     frameData->width = width;
     frameData->height = height;
+    frameData->format = format;
+    frameData->stride = packedStride(format, width);
+
+    // Frames keep the exposure reported before they were fed, even if they are converted later
+    const uint64_t exposure = exposure_.load(std::memory_order_relaxed);
+    frameData->exposureTimeNs = static_cast<uint32_t>(exposure);
+    frameData->readoutTimeNs = static_cast<uint32_t>(exposure >> 32);
+    frameData->size = dataSize;
+    frameData->hasPose = false;
+    return frameData;
+}
+
+QuestVuforiaDriver::FrameConversion QuestVuforiaDriver::planConversion(
+    int width, int height, VuforiaDriver::PixelFormat format) const {
+    FrameConversion conversion;
+    conversion.format = format;
+    conversion.width = width;
+    conversion.height = height;
+
+    VuforiaDriver::CameraMode mode;
+    if (!getActiveCameraMode(&mode)) {
+        // Camera not started yet: publish frames as they come
+        return conversion;
+    }
+
+    conversion.format = mode.format;
+
+    // Half-resolution modes are produced from full-resolution input, other smaller modes
+    // (and half-size ones if asked to) cut a window out of it
+    if (static_cast<uint32_t>(width) == mode.width * 2 &&
+        static_cast<uint32_t>(height) == mode.height * 2 &&
+        !cropHalfSizeModes_.load(std::memory_order_relaxed)) {
+        conversion.width = width / 2;
+        conversion.height = height / 2;
+        conversion.options.downscale2x = true;
+    } else if (cropWindow(width, height, &conversion.crop)) {
+        conversion.width = static_cast<int>(conversion.crop.width);
+        conversion.height = static_cast<int>(conversion.crop.height);
+    }
+
+    conversion.options.lumaOnly = isYuv420(mode.format) &&
+                                  lumaOnlyTracking_.load(std::memory_order_relaxed);
+
+    conversion.needed = conversion.format != format || conversion.options.downscale2x ||
+                        conversion.options.lumaOnly || conversion.crop.width > 0;
+    return conversion;
+}
+
+void QuestVuforiaDriver::setCropCenter(float x, float y) {
+    cropCenterX_.store(std::max(0.0f, std::min(x, 1.0f)), std::memory_order_relaxed);
+    cropCenterY_.store(std::max(0.0f, std::min(y, 1.0f)), std::memory_order_relaxed);
+}
+
+void QuestVuforiaDriver::setCropHalfSizeModes(bool enabled) {
+    cropHalfSizeModes_.store(enabled, std::memory_order_relaxed);
+    LOGI("Half-size camera modes %s", enabled ? "cropped" : "downscaled");
+}
+
+bool QuestVuforiaDriver::cropWindow(int width, int height, CropWindow* window) const {
+    VuforiaDriver::CameraMode mode;
+    if (!getActiveCameraMode(&mode) || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    const uint32_t inputWidth = static_cast<uint32_t>(width);
+    const uint32_t inputHeight = static_cast<uint32_t>(height);
+    if (inputWidth < mode.width || inputHeight < mode.height ||
+        (inputWidth == mode.width && inputHeight == mode.height)) {
+        return false;
+    }
+
+    // Centre on the requested point, clamped inside the frame; an even origin keeps
+    // YUV 4:2:0 chroma and YUYV pairs aligned
+    auto origin = [](float centre, uint32_t size, uint32_t windowSize) {
+        const float start = centre * size - windowSize * 0.5f;
+        const float maxStart = static_cast<float>(size - windowSize);
+        return static_cast<uint32_t>(std::max(0.0f, std::min(start, maxStart))) & ~1u;
+    };
+    window->x = origin(cropCenterX_.load(std::memory_order_relaxed), inputWidth, mode.width);
+    window->y = origin(cropCenterY_.load(std::memory_order_relaxed), inputHeight, mode.height);
+    window->width = mode.width;
+    window->height = mode.height;
+    return true;
+}
+
+void QuestVuforiaDriver::publishFrame(FrameHandle frameData, const float* intrinsics,
+                                      int64_t timestamp, bool downscaled, const CropWindow& crop) {
+    QUFORIA_TRACE_SCOPE("quforia::publishFrame");
     frameData->timestamp = timestamp;
 
-    // Copy image data
-    int dataSize = width * height * 3;  // RGB888
-    frameData->imageData = new uint8_t[dataSize];
-    memcpy(frameData->imageData, imageData, dataSize);
+    // Intrinsics set through setCameraIntrinsics() win over the per-frame array
+    // ([width, height, fx, fy, cx, cy, d0-d7]); the snapshot is immutable, so no lock
+    const IntrinsicsSnapshot* snapshot = intrinsics_.current();
+    if (snapshot) {
+        frameData->intrinsics = snapshot->intrinsics;
+    } else if (intrinsics != nullptr) {
+        intrinsicsFromArray(intrinsics, &frameData->intrinsics);
+    } else {
+        frameData->intrinsics = VuforiaDriver::CameraIntrinsics();
+    }
 
-    // Set intrinsics (use cached if available, otherwise from parameter)
-    // Note: Intrinsics array format from Unity: [width, height, fx, fy, cx, cy, d0-d7]
-    // Width/height are in indices 0-1 (ignored here, used from frame dimensions)
-    // Focal lengths and principal point in indices 2-5
-    // Distortion coefficients in indices 6-13
-    {
-        std::lock_guard<std::mutex> intrinsicsLock(intrinsicsMutex_);
-        if (intrinsicsSet_) {
-            frameData->intrinsics = cachedIntrinsics_;
-        } else if (intrinsics != nullptr) {
-            frameData->intrinsics.focalLengthX = intrinsics[2];
-            frameData->intrinsics.focalLengthY = intrinsics[3];
-            frameData->intrinsics.principalPointX = intrinsics[4];
-            frameData->intrinsics.principalPointY = intrinsics[5];
-            // Distortion coefficients (8 values starting at index 6)
-            for (int i = 0; i < 8; i++) {
-                frameData->intrinsics.distortionCoefficients[i] = intrinsics[i + 6];
-            }
-        }
+    // A window keeps the focal length; its origin becomes the image origin
+    if (crop.width > 0) {
+        frameData->intrinsics.principalPointX -= static_cast<float>(crop.x);
+        frameData->intrinsics.principalPointY -= static_cast<float>(crop.y);
     }
 
-    // Add to queue
-    frameQueue_.push(frameData);
+    // Intrinsics describe the full-resolution input; a 2x2 box-filtered frame has pixel
+    // centres at (x + 0.5) / 2 - 0.5. Distortion is in normalized coordinates and unchanged.
+    if (downscaled) {
+        VuforiaDriver::CameraIntrinsics& k = frameData->intrinsics;
+        k.focalLengthX *= 0.5f;
+        k.focalLengthY *= 0.5f;
+        k.principalPointX = (k.principalPointX + 0.5f) * 0.5f - 0.5f;
+        k.principalPointY = (k.principalPointY + 0.5f) * 0.5f - 0.5f;
+    }
 
-    // Keep only last N frames
-    while (frameQueue_.size() > MAX_FRAME_QUEUE_SIZE) {
-        frameQueue_.pop();
+    if (rectifier_.enabled() && FrameRectifier::hasDistortion(frameData->intrinsics)) {
+        frameData = rectifyFrame(std::move(frameData));
     }
 
-    LOGD("Frame fed: %dx%d, timestamp=%lld, queue_size=%zu",
-         width, height, (long long)timestamp, frameQueue_.size());
+    int width = frameData->width;
+    int height = frameData->height;
+    VuforiaDriver::PixelFormat format = frameData->format;
+
+    // Publish to the ring (the ring keeps only the last N frames)
+    frameData->publishTimeNs = monotonicNowNs();
+    if (recorder_.isRecording()) {
+        recorder_.recordFrame(frameData);
+    }
+    uint64_t sequence;
+    {
+        const int64_t lockStart = monotonicNowNs();
+        std::lock_guard<std::mutex> lock(ringProducerMutex_);
+        stats_.mutexWait(monotonicNowNs() - lockStart);
+        sequence = frameRing_.publish(std::move(frameData));
+    }
+    stats_.frameFed();
+
+    LOGD("Frame fed: %dx%d %s, timestamp=%lld, seq=%llu",
+         width, height, pixelFormatName(format), (long long)timestamp, (unsigned long long)sequence);
 }
 
 void QuestVuforiaDriver::feedDevicePose(const float* position, const float* rotation,
                                        int64_t timestamp) {
-    std::lock_guard<std::mutex> lock(poseMutex_);
-
-    // Create new pose data
-    auto poseData = std::make_shared<PoseData>();
-    poseData->timestamp = timestamp;
+    PoseData poseData;
+    poseData.timestamp = timestamp;
 
     // Copy position (x, y, z)
     if (position != nullptr) {
-        memcpy(poseData->position, position, 3 * sizeof(float));
+        memcpy(poseData.position, position, 3 * sizeof(float));
     }
 
     // Copy rotation quaternion (x, y, z, w)
     if (rotation != nullptr) {
-        memcpy(poseData->rotation, rotation, 4 * sizeof(float));
+        memcpy(poseData.rotation, rotation, 4 * sizeof(float));
     }
 
-    // Add to queue
-    poseQueue_.push(poseData);
+    // Add to history (overwrites the oldest pose once full)
+    if (!poseHistory_.push(poseData)) {
+        LOGW_EVERY_MS(1000, "Dropping out-of-order pose: timestamp=%lld", (long long)timestamp);
+        return;
+    }
+    stats_.poseFed();
+    recorder_.recordPose(poseData);
 
-    // Keep only last N poses
-    while (poseQueue_.size() > MAX_POSE_QUEUE_SIZE) {
-        poseQueue_.pop();
+    LOGD("Pose fed: pos(%.3f,%.3f,%.3f), timestamp=%lld",
+         poseData.position[0], poseData.position[1], poseData.position[2],
+         (long long)timestamp);
+}
+
+size_t QuestVuforiaDriver::feedDevicePoses(const PoseData* poses, size_t count) {
+    const size_t accepted = poseHistory_.pushBatch(poses, count);
+    if (accepted < count) {
+        LOGW_EVERY_MS(1000, "Dropped %zu out-of-order poses from a batch of %zu",
+                      count - accepted, count);
+    }
+    stats_.poseFed(accepted);
+
+    // Dropped samples are recorded too; replay drops them again
+    if (recorder_.isRecording()) {
+        for (size_t i = 0; i < count; i++) {
+            recorder_.recordPose(poses[i]);
+        }
     }
 
-    LOGD("Pose fed: pos(%.3f,%.3f,%.3f), timestamp=%lld, queue_size=%zu",
-         poseData->position[0], poseData->position[1], poseData->position[2],
-         (long long)timestamp, poseQueue_.size());
+    LOGD("Pose batch fed: %zu poses, newest timestamp=%lld",
+         accepted, count > 0 ? (long long)poses[count - 1].timestamp : 0LL);
+    return accepted;
+}
+
+size_t QuestVuforiaDriver::feedInputPoses(const PoseData* poses, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+
+    // Older poses than the history holds would be overwritten within the same publish
+    if (count > mappedPoses_.size()) {
+        LOGW_EVERY_MS(1000, "Pose batch of %zu exceeds the history, keeping the newest %zu",
+                      count, mappedPoses_.size());
+        poses += count - mappedPoses_.size();
+        count = mappedPoses_.size();
+    }
+
+    const ClockDomainMapper::BatchMapping mapping = clock_.mapBatch(poses[count - 1].timestamp);
+    for (size_t i = 0; i < count; i++) {
+        mappedPoses_[i] = poses[i];
+        mappedPoses_[i].timestamp = mapping.map(poses[i].timestamp);
+    }
+    return feedDevicePoses(mappedPoses_.data(), count);
 }
 
 void QuestVuforiaDriver::setCameraIntrinsics(const float* intrinsics) {
@@ -280,80 +818,224 @@ void QuestVuforiaDriver::setCameraIntrinsics(const float* intrinsics) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(intrinsicsMutex_);
+    const IntrinsicsSnapshot* snapshot = intrinsics_.publish(intrinsics);
+    recorder_.recordIntrinsics(intrinsics);
 
-    // Intrinsics array format from Unity: [width, height, fx, fy, cx, cy, d0-d7]
-    // Width/height are at indices 0-1 (only for reference, not stored in CameraIntrinsics struct)
-    // Focal lengths and principal point at indices 2-5
-    // Distortion coefficients at indices 6-13
-    cachedIntrinsics_.focalLengthX = intrinsics[2];
-    cachedIntrinsics_.focalLengthY = intrinsics[3];
-    cachedIntrinsics_.principalPointX = intrinsics[4];
-    cachedIntrinsics_.principalPointY = intrinsics[5];
+    LOGI("Camera intrinsics set (version %llu): %.0fx%.0f, fx=%.2f, fy=%.2f, cx=%.2f, cy=%.2f",
+         (unsigned long long)snapshot->version,
+         snapshot->width, snapshot->height,  // width, height for logging only
+         snapshot->intrinsics.focalLengthX, snapshot->intrinsics.focalLengthY,
+         snapshot->intrinsics.principalPointX, snapshot->intrinsics.principalPointY);
+}
 
-    // Distortion coefficients (8 values starting at index 6)
-    for (int i = 0; i < 8; i++) {
-        cachedIntrinsics_.distortionCoefficients[i] = intrinsics[i + 6];
+bool QuestVuforiaDriver::setCameraExposure(int64_t exposureNs, int64_t readoutNs) {
+    if (exposureNs < 0 || exposureNs > MAX_EXPOSURE_NS || readoutNs < 0 || readoutNs > MAX_EXPOSURE_NS) {
+        LOGE("setCameraExposure: invalid exposure %lld ns / readout %lld ns",
+             (long long)exposureNs, (long long)readoutNs);
+        return false;
     }
 
-    intrinsicsSet_ = true;
+    // One word, so a frame never sees the exposure of one capture and the readout of another
+    exposure_.store(static_cast<uint64_t>(exposureNs) | static_cast<uint64_t>(readoutNs) << 32,
+                    std::memory_order_relaxed);
+    return true;
+}
+
+void QuestVuforiaDriver::setFrameRectification(bool enabled) {
+    rectifier_.setEnabled(enabled);
+}
 
-    LOGI("Camera intrinsics set: %.0fx%.0f, fx=%.2f, fy=%.2f, cx=%.2f, cy=%.2f",
-         intrinsics[0], intrinsics[1],  // width, height for logging only
-         cachedIntrinsics_.focalLengthX, cachedIntrinsics_.focalLengthY,
-         cachedIntrinsics_.principalPointX, cachedIntrinsics_.principalPointY);
+bool QuestVuforiaDriver::evictOldestFrame() {
+    std::lock_guard<std::mutex> lock(ringProducerMutex_);
+    return frameRing_.evictOldest();
+}
+
+FrameHandle QuestVuforiaDriver::rectifyFrame(FrameHandle frame) {
+    QUFORIA_TRACE_SCOPE("quforia::rectifyFrame");
+    const int64_t start = monotonicNowNs();
+
+    // Same eviction rule as acquireFrameSlot(); without a slot the frame goes out as is
+    FrameHandle rectified = framePool_.acquire();
+    if (!rectified && evictOldestFrame()) {
+        rectified = framePool_.acquire();
+    }
+    if (!rectified || !rectifier_.rectify(*frame.get(), rectified.get())) {
+        LOGW_EVERY_MS(5000, "Publishing frame without rectification");
+        return frame;
+    }
+
+    stats_.frameRectified(monotonicNowNs() - start);
+    return rectified;
+}
+
+void QuestVuforiaDriver::setPoseExtrapolationTolerance(int64_t toleranceNs) {
+    poseHistory_.setMaxExtrapolation(toleranceNs);
+    LOGI("Pose extrapolation tolerance set to %lld ns", (long long)toleranceNs);
 }
 
 // =============================================================================
 // Frame/Pose Retrieval (called by ExternalCamera and ExternalTracker)
 // =============================================================================
 
-std::shared_ptr<CameraFrameData> QuestVuforiaDriver::acquireLatestFrame() {
-    std::lock_guard<std::mutex> lock(frameMutex_);
+FrameHandle QuestVuforiaDriver::acquireLatestFrame() {
+    // Return the latest frame; older ones age out of the ring naturally
+    return frameRing_.acquireLatest();
+}
 
-    if (frameQueue_.empty()) {
-        return nullptr;
+FrameHandle QuestVuforiaDriver::waitForNextFrame(uint64_t lastSequence, uint64_t* sequence,
+                                              std::chrono::milliseconds timeout) {
+    if (!frameRing_.waitForPublish(lastSequence, timeout)) {
+        return FrameHandle();
+    }
+
+    if (getFrameDeliveryPolicy() == FrameDeliveryPolicy::LATEST_ONLY) {
+        return frameRing_.acquireLatest(sequence);
     }
 
-    // Return the latest frame (back of queue)
-    // Don't pop it - let it age out naturally
-    return frameQueue_.back();
+    // EVERY_FRAME: next frame in order, skipping any that were already overwritten
+    const uint64_t head = frameRing_.latestSequence();
+    uint64_t next = std::max(lastSequence + 1, frameRing_.oldestSequence(head));
+
+    for (; next <= head; next++) {
+        FrameHandle frame = frameRing_.acquire(next);
+        if (frame) {
+            *sequence = next;
+            return frame;
+        }
+    }
+
+    return FrameHandle();
 }
 
-std::shared_ptr<PoseData> QuestVuforiaDriver::acquirePoseForTimestamp(int64_t timestamp) {
-    std::lock_guard<std::mutex> lock(poseMutex_);
+void QuestVuforiaDriver::wakeFrameWaiters() {
+    frameRing_.wakeWaiters();
+}
 
-    if (poseQueue_.empty()) {
-        LOGD("Pose queue is empty");
-        return nullptr;
+void QuestVuforiaDriver::setLumaOnlyTracking(bool enabled) {
+    lumaOnlyTracking_.store(enabled, std::memory_order_relaxed);
+    LOGI("Luma-only tracking %s", enabled ? "enabled" : "disabled");
+}
+
+void QuestVuforiaDriver::setActiveCameraMode(const VuforiaDriver::CameraMode* mode) {
+    uint64_t packed = 0;
+    if (mode) {
+        packed = (static_cast<uint64_t>(mode->width) & 0xFFFF) |
+                 (static_cast<uint64_t>(mode->height) & 0xFFFF) << 16 |
+                 (static_cast<uint64_t>(mode->fps) & 0xFFFF) << 32 |
+                 static_cast<uint64_t>(mode->format) << 48;
+    }
+    activeMode_.store(packed, std::memory_order_release);
+}
+
+bool QuestVuforiaDriver::getActiveCameraMode(VuforiaDriver::CameraMode* mode) const {
+    const uint64_t packed = activeMode_.load(std::memory_order_acquire);
+    if (packed == 0) {
+        return false;
     }
 
-    // Find the pose with the closest timestamp
-    // In production, you should interpolate between poses
-    std::shared_ptr<PoseData> closestPose = nullptr;
-    int64_t minTimeDiff = INT64_MAX;
+    mode->width = static_cast<uint32_t>(packed & 0xFFFF);
+    mode->height = static_cast<uint32_t>((packed >> 16) & 0xFFFF);
+    mode->fps = static_cast<uint32_t>((packed >> 32) & 0xFFFF);
+    mode->format = static_cast<VuforiaDriver::PixelFormat>(packed >> 48);
+    return true;
+}
+
+void QuestVuforiaDriver::setPoseSink(QuestExternalTracker* tracker) {
+    // Taking the lock also waits out a deliverPoseForFrame() in progress on the delivery thread
+    std::lock_guard<std::mutex> lock(poseSinkMutex_);
+    poseSink_ = tracker;
+}
+
+void QuestVuforiaDriver::deliverPoseForFrame(const CameraFrameData& frame) {
+    QUFORIA_TRACE_SCOPE("quforia::deliverPose");
 
-    // Create a temporary queue to iterate without modifying the original
-    std::queue<std::shared_ptr<PoseData>> tempQueue = poseQueue_;
+    const int64_t lockStart = monotonicNowNs();
+    std::lock_guard<std::mutex> lock(poseSinkMutex_);
+    stats_.mutexWait(monotonicNowNs() - lockStart);
 
-    while (!tempQueue.empty()) {
-        auto pose = tempQueue.front();
-        tempQueue.pop();
+    if (!poseSink_) {
+        return;
+    }
+
+    // Anchor changes from Unity go out first, so this frame's pose already sees them
+    if (anchors_.hasUpdates()) {
+        poseSink_->deliverAnchorUpdates();
+    }
+
+    // The pose goes out stamped with the frame timestamp, as Vuforia pairs them, but with
+    // exposure metadata it is the pose at mid-exposure
+    const int64_t sampleTimestamp = frame.midExposureTimestamp();
+    if (!frame.hasPose) {
+        poseSink_->deliverPose(frame.timestamp, sampleTimestamp);
+        return;
+    }
 
-        int64_t timeDiff = std::abs(pose->timestamp - timestamp);
-        if (timeDiff < minTimeDiff) {
-            minTimeDiff = timeDiff;
-            closestPose = pose;
+    // A submitted pose is the one at the frame timestamp and normally in the history, so the
+    // mid-exposure pose is interpolated between it and the pose before. The submitted pose is
+    // sent as is when the lookup fails or only finds samples further from mid-exposure.
+    if (sampleTimestamp != frame.timestamp) {
+        PoseData pose;
+        int64_t matchError = 0;
+        if (poseHistory_.sample(sampleTimestamp, &pose, &matchError) &&
+            matchError <= frame.timestamp - sampleTimestamp) {
+            stats_.poseMatched(matchError);
+            poseSink_->deliverPose(frame.timestamp, pose);
+            return;
         }
     }
+    poseSink_->deliverPose(frame.timestamp, frame.pose);
+}
 
-    if (closestPose && minTimeDiff < 50000000) {  // Within 50ms
-        LOGD("Found pose for timestamp %lld (diff=%lld ns)",
-             (long long)timestamp, (long long)minTimeDiff);
-        return closestPose;
-    } else {
-        LOGD("No matching pose found for timestamp %lld (closest diff=%lld ns)",
-             (long long)timestamp, (long long)minTimeDiff);
-        return nullptr;
+void QuestVuforiaDriver::setFrameDeliveryPolicy(FrameDeliveryPolicy policy) {
+    deliveryPolicy_.store(policy, std::memory_order_relaxed);
+    LOGI("Frame delivery policy set to %s",
+         policy == FrameDeliveryPolicy::LATEST_ONLY ? "LATEST_ONLY" : "EVERY_FRAME");
+}
+
+bool QuestVuforiaDriver::startRecording(const char* path, bool compress) {
+    if (!recorder_.start(path, compress)) {
+        return false;
     }
+
+    // Start the log with the current calibration so replays don't depend on feed order
+    const IntrinsicsSnapshot* snapshot = intrinsics_.current();
+    if (snapshot) {
+        float intrinsics[SESSION_INTRINSICS_COUNT] = {};
+        intrinsics[0] = snapshot->width;
+        intrinsics[1] = snapshot->height;
+        intrinsicsToArray(snapshot->intrinsics, intrinsics);
+        recorder_.recordIntrinsics(intrinsics);
+    }
+    return true;
+}
+
+void QuestVuforiaDriver::stopRecording() {
+    recorder_.stop();
+}
+
+bool QuestVuforiaDriver::startReplay(const char* path, float speed, bool loop) {
+    if (!replay_.open(path)) {
+        return false;
+    }
+    return replay_.start(this, speed, loop);
+}
+
+void QuestVuforiaDriver::stopReplay() {
+    replay_.close();
+}
+
+bool QuestVuforiaDriver::acquirePoseForTimestamp(int64_t timestamp, PoseData* outPose) {
+    // Binary search + interpolation between the bracketing poses (lock-free)
+    int64_t matchError = 0;
+    if (poseHistory_.sample(timestamp, outPose, &matchError)) {
+        stats_.poseMatched(matchError);
+        LOGD("Found pose for timestamp %lld (nearest sample %lld ns away)",
+             (long long)timestamp, (long long)matchError);
+        return true;
+    }
+
+    stats_.poseMissing();
+    LOGD("No matching pose found for timestamp %lld (%llu poses in history)",
+         (long long)timestamp, (unsigned long long)poseHistory_.size());
+    return false;
 }
@@ -2,46 +2,35 @@
 #define QUEST_VUFORIA_DRIVER_H
 
 #include <VuforiaEngine/Driver/Driver.h>
+#include "frame_pool.h"
+#include "frame_ring.h"
+#include "pose_history.h"
+#include "pixel_convert.h"
+#include "driver_stats.h"
+#include "frame_governor.h"
+#include "frame_quality.h"
+#include "motion_throttle.h"
+#include "anchor_store.h"
+#include "clock_domain.h"
+#include "intrinsics_store.h"
+#include "frame_rectifier.h"
+#include "frame_ingest.h"
+#include "session_recorder.h"
+#include "session_replay.h"
+#include "memory_config.h"
 #include <mutex>
-#include <queue>
-#include <memory>
 #include <atomic>
+#include <chrono>
+#include <vector>
 
 // Forward declarations
 class QuestExternalCamera;
 class QuestExternalTracker;
 
-// Frame data structure for passing from Java/Kotlin layer
-struct CameraFrameData {
-    uint8_t* imageData;
-    int width;
-    int height;
-    int64_t timestamp;  // Nanoseconds
-    VuforiaDriver::CameraIntrinsics intrinsics;
-
-    CameraFrameData() : imageData(nullptr), width(0), height(0), timestamp(0) {
-        memset(&intrinsics, 0, sizeof(intrinsics));
-    }
-
-    ~CameraFrameData() {
-        if (imageData) {
-            delete[] imageData;
-            imageData = nullptr;
-        }
-    }
-};
-
-// Pose data structure for 6DoF tracking
-struct PoseData {
-    int64_t timestamp;  // Nanoseconds
-    float position[3];   // World space position (x, y, z)
-    float rotation[4];   // Quaternion (x, y, z, w)
-
-    PoseData() : timestamp(0) {
-        position[0] = position[1] = position[2] = 0.0f;
-        rotation[0] = rotation[1] = rotation[2] = 0.0f;
-        rotation[3] = 1.0f;  // Identity quaternion
-    }
+// How the frame delivery thread picks frames when it falls behind the producer
+enum class FrameDeliveryPolicy : int32_t {
+    LATEST_ONLY = 0,  // Always jump to the newest frame (lowest latency)
+    EVERY_FRAME = 1,  // Deliver frames in order while they are still in the ring
 };
 
 // Main driver class implementing Vuforia Driver Framework
@@ -57,34 +46,273 @@ public:
     virtual VuforiaDriver::ExternalPositionalDeviceTracker* createExternalPositionalDeviceTracker() override;
     virtual void destroyExternalPositionalDeviceTracker(VuforiaDriver::ExternalPositionalDeviceTracker* instance) override;
 
-    // Frame and pose feeding methods (called from JNI)
-    void feedCameraFrame(const uint8_t* imageData, int width, int height,
+    // Frame and pose feeding methods (called from JNI). The frame feeds return false when the
+    // frame was dropped (unconvertible, no free pool slot or a full ingest queue).
+    bool feedCameraFrame(const uint8_t* imageData, int width, int height,
                         const float* intrinsics, int64_t timestamp);
+    // Frame in any layout convertFrame() accepts; stride 0 means tightly packed.
+    // Converted to the active camera mode's format when the two differ, and optionally
+    // flipped vertically in the same pass.
+    bool feedCameraFrame(const uint8_t* imageData, int width, int height,
+                        VuforiaDriver::PixelFormat format, uint32_t stride,
+                        const float* intrinsics, int64_t timestamp, bool flipVertically = false);
+
+    // Frame and its device pose in one call: the pose travels on the frame record, so the
+    // delivery thread hands it to Vuforia without a timestamp lookup. It is also added to the
+    // pose history, stamped with the frame timestamp.
+    bool submitFrame(const uint8_t* imageData, int width, int height,
+                     VuforiaDriver::PixelFormat format, uint32_t stride, const PoseData& pose,
+                     const float* intrinsics, int64_t timestamp, bool flipVertically = false);
+
+    // Asynchronous ingestion: with workers running, frames are converted in row bands on the
+    // little cores and published by the pool. The synchronous entry points above still return
+    // once their frame is published (the caller's buffer is only valid until then), but
+    // convert in parallel. 0 workers (the default) converts on the calling thread.
+    bool setIngestWorkers(int count);
+    // Queue a frame and return without waiting for it: the result is a ticket (0 = rejected),
+    // and `imageData` must stay valid until completedIngestTicket() reaches it
+    uint64_t feedCameraFrameAsync(const uint8_t* imageData, int width, int height,
+                                  VuforiaDriver::PixelFormat format, uint32_t stride,
+                                  const PoseData* pose, const float* intrinsics,
+                                  int64_t timestamp, bool flipVertically = false);
+    uint64_t completedIngestTicket() const { return ingest_.completedTicket(); }
+
     void feedDevicePose(const float* position, const float* rotation, int64_t timestamp);
+    // Append a batch of poses (in timestamp order) to the history in one publish.
+    // Returns how many were kept; out-of-order samples are dropped.
+    size_t feedDevicePoses(const PoseData* poses, size_t count);
+    // Same for poses timestamped in the input clock domain: the batch is mapped with one
+    // clock() offset into a buffer allocated at init, so it is still a single publish
+    size_t feedInputPoses(const PoseData* poses, size_t count);
+    // Publishes a new calibration snapshot (frames pick it up with one atomic load)
     void setCameraIntrinsics(const float* intrinsics);
 
-    // Frame buffer management
-    std::shared_ptr<CameraFrameData> acquireLatestFrame();
-    std::shared_ptr<PoseData> acquirePoseForTimestamp(int64_t timestamp);
+    // Exposure of the frames fed from now on, from the passthrough camera's capture result
+    // (SENSOR_EXPOSURE_TIME, SENSOR_ROLLING_SHUTTER_SKEW): how long each row is exposed and
+    // how much later the last row starts than the first. This is a latest-value setting, not
+    // part of the frame calls: producers with per-frame capture results set it before each
+    // frame, others once. Frames carry the values to Vuforia, and their pose is sampled at
+    // mid-exposure, before the (end of exposure) frame timestamp it is stamped with. Zero
+    // means unknown (exposure) or a global shutter (readout); up to MAX_EXPOSURE_NS each.
+    bool setCameraExposure(int64_t exposureNs, int64_t readoutNs);
+    static const int64_t MAX_EXPOSURE_NS = 1000000000LL;
+
+    // Undistort frames natively before they are published, so Vuforia gets pinhole images
+    // (see FrameRectifier). Frames without distortion coefficients pass through untouched.
+    void setFrameRectification(bool enabled);
+
+    // How far past the newest pose acquirePoseForTimestamp may extrapolate
+    void setPoseExtrapolationTolerance(int64_t toleranceNs);
+
+    // Zero-copy frame feeding: borrow a pool slab, write pixels into it, then commit.
+    // Only one frame can be borrowed at a time (single producer). The buffer is tightly packed
+    // in `format`; it is converted on commit if the active camera mode uses another format.
+    // `sourceWindow`: the producer writes this window of a larger image (see cropWindow()),
+    // whose calibration the intrinsics describe.
+    uint8_t* beginCameraFrame(int width, int height,
+                              VuforiaDriver::PixelFormat format = VuforiaDriver::PixelFormat::RGB888,
+                              const CropWindow* sourceWindow = nullptr);
+    // A pose passed to commit travels with the frame, as with submitFrame()
+    bool commitCameraFrame(const float* intrinsics, int64_t timestamp,
+                           const PoseData* pose = nullptr);
+    void cancelCameraFrame();
+
+    // Frame buffer management (lock-free, safe to call from any delivery thread)
+    FrameHandle acquireLatestFrame();
+
+    // Block until a frame newer than lastSequence is available and return it according to
+    // the delivery policy. Returns an empty handle on timeout or after wakeFrameWaiters().
+    FrameHandle waitForNextFrame(uint64_t lastSequence, uint64_t* sequence,
+                                 std::chrono::milliseconds timeout);
+    void wakeFrameWaiters();
+
+    // Publish YUV modes with constant chroma (Vuforia tracks on luma), skipping chroma math
+    void setLumaOnlyTracking(bool enabled);
+
+    // Crop modes: when the active camera mode is smaller than the input (other than exactly
+    // half its size), each frame is cut to a mode-sized window centred on (x, y), normalized
+    // upright image coordinates (default 0.5, 0.5). Unity can move it to follow the tracked
+    // target. Delivered intrinsics have their principal point shifted with the window.
+    void setCropCenter(float x, float y);
+    // Also cut half-size modes as a window instead of box-filtering the whole frame
+    void setCropHalfSizeModes(bool enabled);
+    // Window a width x height input is cut to for the active mode; false if it isn't cropped
+    bool cropWindow(int width, int height, CropWindow* window) const;
+
+    // Mode Vuforia started the camera with (set by the camera on start/stop, read by producers)
+    void setActiveCameraMode(const VuforiaDriver::CameraMode* mode);
+    bool getActiveCameraMode(VuforiaDriver::CameraMode* mode) const;
+
+    // Pose/frame pipeline: the tracker registers itself while started, and the camera's
+    // delivery thread calls deliverPoseForFrame() before every onNewCameraFrame. Samples the
+    // pose history at the frame's mid-exposure; a pose submitted with the frame is used as is
+    // without exposure metadata, or when the history has nothing closer to mid-exposure.
+    void setPoseSink(QuestExternalTracker* tracker);
+    void deliverPoseForFrame(const CameraFrameData& frame);
+
+    void setFrameDeliveryPolicy(FrameDeliveryPolicy policy);
+    FrameDeliveryPolicy getFrameDeliveryPolicy() const { return deliveryPolicy_.load(std::memory_order_relaxed); }
+    bool acquirePoseForTimestamp(int64_t timestamp, PoseData* outPose);
+
+    // Session capture: everything fed to the driver is streamed to `path` by a background
+    // writer. Replay memory-maps a recording and feeds it back in place of Unity.
+    bool startRecording(const char* path, bool compress);
+    void stopRecording();
+    bool startReplay(const char* path, float speed, bool loop);
+    void stopReplay();
+    bool isReplaying() const { return replay_.isPlaying(); }
+
+    // Hot-path counters and latency histograms (lock-free, see nativeGetStats)
+    DriverStats& stats() { return stats_; }
+
+    // Delivered frame rate governor, driven by the camera's delivery thread. Lives in the
+    // driver so Unity can configure and query it whether or not a camera exists.
+    FrameGovernor& governor() { return governor_; }
+
+    // Motion-blur gate in front of Vuforia, also driven by the delivery thread
+    FrameQualityGate& qualityGate() { return qualityGate_; }
+
+    // Lowers the delivered rate while the headset is static (delivery thread as well)
+    MotionThrottle& motionThrottle() { return motionThrottle_; }
+
+    // Anchors shared with Unity's spatial anchors; updates go out with the next frame's pose
+    AnchorStore& anchors() { return anchors_; }
+
+    // Head motion over the MOTION_SPAN_NS before `timestamp`, from the pose history
+    bool motionAt(int64_t timestamp, PoseMotion* out) const {
+        return poseHistory_.motionAt(timestamp, MOTION_SPAN_NS, out);
+    }
+
+    // Head pose at `timestamp` (CLOCK_MONOTONIC) in Unity's convention, for render-time
+    // queries: lock-free, and unlike acquirePoseForTimestamp not counted in the match stats
+    bool samplePose(int64_t timestamp, PoseData* outPose) const {
+        return poseHistory_.sample(timestamp, outPose);
+    }
+
+    // Maps Unity's capture timestamps to CLOCK_MONOTONIC. The P/Invoke entry points convert
+    // on the way in, so everything inside the driver (and recordings) is monotonic.
+    ClockDomainMapper& clock() { return clock_; }
+
+    // Frame and pose memory sizing, fixed at construction
+    const MemoryLayout& memoryLayout() const { return layout_; }
+    void memoryReport(QuforiaMemoryReport* out) const;
+    // Camera modes are only advertised if their frames fit the pool's slabs
+    bool supportsCameraMode(const VuforiaDriver::CameraMode& mode) const { return layout_.fits(mode); }
+
+    // Sequence number of the newest published frame (0 if none)
+    uint64_t latestFrameSequence() const { return frameRing_.latestSequence(); }
+
+#ifdef __ANDROID__
+    // JVM handed over by Vuforia in PlatformData (null if it didn't provide one)
+    JavaVM* getJavaVM() const { return javaVM_; }
+#endif
 
 private:
     QuestExternalCamera* camera_;
     QuestExternalTracker* tracker_;
 
-    // Frame buffer (circular buffer, keep last 3 frames)
-    std::mutex frameMutex_;
-    std::queue<std::shared_ptr<CameraFrameData>> frameQueue_;
-    static const size_t MAX_FRAME_QUEUE_SIZE = 3;
+    // Convert/copy a caller's frame into a pool slot and publish it (optionally with a pose).
+    // Returns the frame's ingest ticket, 0 if it was rejected. Unless `async`, the frame has
+    // been published (or dropped) when this returns.
+    uint64_t ingestFrame(const uint8_t* imageData, int width, int height,
+                         VuforiaDriver::PixelFormat format, uint32_t stride, const PoseData* pose,
+                         const float* intrinsics, int64_t timestamp, bool flipVertically,
+                         bool async);
+
+    // Publish a job the ingest pool finished converting (called by one worker at a time)
+    friend class FrameIngestPool;
+    void finishIngest(IngestJob& job);
+
+    // Stamp a submitted pose with its frame timestamp and add it to the pose history
+    PoseData recordSubmittedPose(const PoseData& pose, int64_t timestamp);
+
+    // Claim a pool slot for a tightly packed width x height frame (evicts the oldest queued
+    // frame if needed)
+    FrameHandle acquireFrameSlot(int width, int height, VuforiaDriver::PixelFormat format);
+    // `downscaled`: frame was box-filtered to half the resolution the intrinsics describe;
+    // `crop`: frame is that window of the image the intrinsics describe
+    void publishFrame(FrameHandle frame, const float* intrinsics, int64_t timestamp,
+                      bool downscaled, const CropWindow& crop);
+    // Drop the oldest queued frame so its slab can be reused (see ringProducerMutex_)
+    bool evictOldestFrame();
+    // Rectified copy of `frame` in a new slot, or `frame` itself if that isn't possible
+    FrameHandle rectifyFrame(FrameHandle frame);
+
+    // What a width x height frame in `format` has to become for the active camera mode
+    struct FrameConversion {
+        VuforiaDriver::PixelFormat format = VuforiaDriver::PixelFormat::UNKNOWN;
+        int width = 0;
+        int height = 0;
+        ConvertOptions options;
+        CropWindow crop;      // Window of the input that becomes the frame (width 0 = whole)
+        bool needed = false;  // false when the frame can be published as-is
+    };
+    FrameConversion planConversion(int width, int height, VuforiaDriver::PixelFormat format) const;
+
+    // Frame pool, frame queue and pose history sizes, chosen once from the memory config
+    MemoryLayout layout_;
+
+    // Preallocated frame slabs: queued frames + one in delivery + one being written + spare,
+    // plus the frames the session recorder may hold while writing them out and the frames
+    // queued for the ingest workers. Declared before every FrameHandle member so it outlives them.
+    static const size_t FRAME_POOL_EXTRA_SLOTS = 3 + SessionRecorder::MAX_FRAMES_IN_FLIGHT +
+                                                 FrameIngestPool::MAX_PENDING_JOBS;
+    FramePool framePool_;
+
+    // Frame buffer (lock-free ring, keeps the last frameQueueDepth frames). Readers are lock-free; the producer
+    // side (publish/evict) runs on the Unity thread and, in async mode, on the worker
+    // publishing a frame, so it is serialized by ringProducerMutex_.
+    FrameRing frameRing_;
+    std::mutex ringProducerMutex_;
+
+    std::atomic<FrameDeliveryPolicy> deliveryPolicy_;
+
+    // Active camera mode packed as width | height << 16 | fps << 32 | format << 48 (0 = stopped)
+    std::atomic<uint64_t> activeMode_;
+    std::atomic<bool> lumaOnlyTracking_;
+    std::atomic<float> cropCenterX_;
+    std::atomic<float> cropCenterY_;
+    std::atomic<bool> cropHalfSizeModes_;
+
+    // Exposure for newly fed frames, packed as exposureNs | readoutNs << 32
+    std::atomic<uint64_t> exposure_;
+
+#ifdef __ANDROID__
+    JavaVM* javaVM_;
+#endif
+
+    // Slot currently lent to the producer via beginCameraFrame(), and the part of the full
+    // image the producer writes into it
+    FrameHandle borrowedFrame_;
+    CropWindow borrowedWindow_;
+
+    // Pose buffer (sorted lock-free ring, by default the last 3 seconds at up to 500 Hz, so
+    // display or IMU rate pose feeds don't shrink the window)
+    PoseHistory poseHistory_;
+    // feedInputPoses() staging, as many poses as the history holds
+    std::vector<PoseData> mappedPoses_;
+    // About one frame interval: long enough to average out pose jitter
+    static const int64_t MOTION_SPAN_NS = 20000000;
+
+    // Tracker receiving poses from the delivery thread (guarded by poseSinkMutex_)
+    std::mutex poseSinkMutex_;
+    QuestExternalTracker* poseSink_;
+
+    DriverStats stats_;
+    FrameGovernor governor_;
+    FrameQualityGate qualityGate_;
+    MotionThrottle motionThrottle_;
+    ClockDomainMapper clock_;
+
+    SessionRecorder recorder_;
+    SessionReplay replay_;
 
-    // Pose buffer (keep last 90 poses ~ 3 seconds @ 30fps)
-    std::mutex poseMutex_;
-    std::queue<std::shared_ptr<PoseData>> poseQueue_;
-    static const size_t MAX_POSE_QUEUE_SIZE = 90;
+    // Calibration set by Unity (takes precedence over per-frame intrinsics)
+    IntrinsicsStore intrinsics_;
+    AnchorStore anchors_;
+    FrameRectifier rectifier_;
 
-    // Cached intrinsics
-    std::mutex intrinsicsMutex_;
-    VuforiaDriver::CameraIntrinsics cachedIntrinsics_;
-    bool intrinsicsSet_;
+    FrameIngestPool ingest_;
 };
 
 // Global driver instance (managed by Vuforia)
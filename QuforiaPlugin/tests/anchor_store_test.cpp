@@ -0,0 +1,202 @@
+#include "anchor_store.h"
+#include "unit_test.h"
+#include <cstring>
+
+using VuforiaDriver::AnchorStatus;
+
+static const char* PERSISTED_UUID = "6f9619ff-8b86-d011-b42d-00c04fc964ff";
+
+static VuforiaDriver::AnchorPose identityPose() {
+    VuforiaDriver::AnchorPose pose = {
+        {0.1f, -0.2f, 0.5f},
+        {1, 0, 0, 0, 1, 0, 0, 0, 1}
+    };
+    return pose;
+}
+
+static QuforiaAnchorUpdate updateFor(const char* uuid, float y, bool localized) {
+    QuforiaAnchorUpdate update;
+    memset(&update, 0, sizeof(update));
+    snprintf(update.uuid, sizeof(update.uuid), "%s", uuid);
+    update.position[1] = y;
+    update.rotation[3] = 1.0f;
+    update.localized = localized ? 1 : 0;
+    return update;
+}
+
+// How many anchors with `status` the delivery thread would send next
+static int delivered(AnchorStore& store, AnchorStatus status) {
+    VuforiaDriver::Anchor anchors[AnchorStore::MAX_ANCHORS];
+    return store.takeUpdates(status, anchors, AnchorStore::MAX_ANCHORS);
+}
+
+static int pendingRequests(AnchorStore& store) {
+    QuforiaAnchorRequest requests[AnchorStore::MAX_REQUESTS];
+    return store.takeRequests(requests, AnchorStore::MAX_REQUESTS);
+}
+
+static void testCreateAndRemove() {
+    AnchorStore store;
+    VuforiaDriver::AnchorPose pose = identityPose();
+    const char* uuid = store.create(pose);
+    CHECK(uuid != nullptr);
+    CHECK(store.size() == 1);
+    CHECK(!store.hasUpdates());  // Vuforia made it, nothing to tell Vuforia
+
+    QuforiaAnchorRequest request;
+    CHECK(store.takeRequests(&request, 1) == 1);
+    CHECK(request.type == QUFORIA_ANCHOR_CREATE);
+    CHECK(strcmp(request.uuid, uuid) == 0);
+
+    // Unity places it where it was asked: no change for Vuforia
+    QuforiaAnchorUpdate update;
+    memcpy(update.uuid, request.uuid, sizeof(update.uuid));
+    memcpy(update.position, request.position, sizeof(update.position));
+    memcpy(update.rotation, request.rotation, sizeof(update.rotation));
+    update.localized = 1;
+    CHECK(store.update(&update, 1) == 1);
+    CHECK(!store.hasUpdates());
+
+    // Removing it asks Unity to erase the spatial anchor; late pose reports don't revive it
+    char removed[QUFORIA_ANCHOR_UUID_SIZE];
+    snprintf(removed, sizeof(removed), "%s", uuid);
+    CHECK(store.remove(removed));
+    CHECK(store.size() == 0);
+    CHECK(store.update(&update, 1) == 0);
+    CHECK(store.size() == 0);
+    CHECK(store.takeRequests(&request, 1) == 1);
+    CHECK(request.type == QUFORIA_ANCHOR_REMOVE);
+    CHECK(!store.remove(removed));
+}
+
+static void testRemoveBeforePlacement() {
+    AnchorStore store;
+    VuforiaDriver::AnchorPose pose = identityPose();
+    char uuid[QUFORIA_ANCHOR_UUID_SIZE];
+    snprintf(uuid, sizeof(uuid), "%s", store.create(pose));
+
+    // The CREATE Unity never took is cancelled instead of followed by a REMOVE
+    CHECK(store.remove(uuid));
+    CHECK(pendingRequests(store) == 0);
+}
+
+static void testDropBeforePlacement() {
+    AnchorStore store;
+    VuforiaDriver::AnchorPose pose = identityPose();
+    char uuid[QUFORIA_ANCHOR_UUID_SIZE];
+    snprintf(uuid, sizeof(uuid), "%s", store.create(pose));
+
+    // Unity gives up on it: nothing is left asking Unity to place it, Vuforia hears REMOVED
+    CHECK(store.drop(uuid));
+    CHECK(pendingRequests(store) == 0);
+    CHECK(delivered(store, AnchorStatus::REMOVED) == 1);
+    CHECK(!store.hasUpdates());
+}
+
+static void testPersistedLifecycle() {
+    AnchorStore store;
+
+    // A persisted anchor shows up: ADDED once, however many reports arrive before delivery
+    QuforiaAnchorUpdate update = updateFor(PERSISTED_UUID, 0.0f, true);
+    CHECK(store.update(&update, 1) == 1);
+    update.position[1] = 0.1f;
+    CHECK(store.update(&update, 1) == 1);
+    CHECK(store.hasUpdates());
+    CHECK(delivered(store, AnchorStatus::UPDATED) == 0);
+    CHECK(delivered(store, AnchorStatus::ADDED) == 1);
+    CHECK(!store.hasUpdates());
+
+    // Same pose again: nothing; moved: UPDATED
+    CHECK(store.update(&update, 1) == 1);
+    CHECK(!store.hasUpdates());
+    update.position[1] = 0.2f;
+    store.update(&update, 1);
+    CHECK(delivered(store, AnchorStatus::UPDATED) == 1);
+
+    // Losing and regaining tracking
+    update.localized = 0;
+    store.update(&update, 1);
+    CHECK(delivered(store, AnchorStatus::PAUSED) == 1);
+    update.localized = 1;
+    store.update(&update, 1);
+    CHECK(delivered(store, AnchorStatus::UPDATED) == 1);
+
+    // Erased in Unity
+    CHECK(store.drop(PERSISTED_UUID));
+    CHECK(delivered(store, AnchorStatus::REMOVED) == 1);
+    CHECK(store.size() == 0);
+    CHECK(!store.drop(PERSISTED_UUID));
+}
+
+static void testLostBeforeAnnounced() {
+    AnchorStore store;
+
+    // Added and lost again before a frame delivered the ADDED: Vuforia hears nothing
+    QuforiaAnchorUpdate update = updateFor(PERSISTED_UUID, 0.0f, true);
+    store.update(&update, 1);
+    update.localized = 0;
+    store.update(&update, 1);
+    CHECK(delivered(store, AnchorStatus::ADDED) == 0);
+    CHECK(delivered(store, AnchorStatus::PAUSED) == 0);
+
+    // Once it is back it is announced as new
+    update.localized = 1;
+    store.update(&update, 1);
+    CHECK(delivered(store, AnchorStatus::ADDED) == 1);
+}
+
+static int deliveredAny(AnchorStore& store) {
+    return delivered(store, AnchorStatus::REMOVED) + delivered(store, AnchorStatus::ADDED) +
+           delivered(store, AnchorStatus::UPDATED) + delivered(store, AnchorStatus::PAUSED);
+}
+
+static void testDroppedBeforeAnnounced() {
+    AnchorStore store;
+
+    // Added and erased in Unity before a frame delivered the ADDED: Vuforia hears nothing
+    QuforiaAnchorUpdate update = updateFor(PERSISTED_UUID, 0.0f, true);
+    store.update(&update, 1);
+    CHECK(store.drop(PERSISTED_UUID));
+    CHECK(store.size() == 0);
+    CHECK(deliveredAny(store) == 0);
+
+    // Same for a new space
+    store.update(&update, 1);
+    store.clear();
+    CHECK(deliveredAny(store) == 0);
+
+    // A new tracker's ADDED that hasn't gone out yet is just as unheard of
+    store.update(&update, 1);
+    CHECK(delivered(store, AnchorStatus::ADDED) == 1);
+    store.announceAll();
+    CHECK(store.drop(PERSISTED_UUID));
+    CHECK(deliveredAny(store) == 0);
+}
+
+static void testClearAndAnnounce() {
+    AnchorStore store;
+    QuforiaAnchorUpdate first = updateFor(PERSISTED_UUID, 0.0f, true);
+    QuforiaAnchorUpdate second = updateFor("0b7a2f1e-3c4d-4e5f-8a9b-0c1d2e3f4a5b", 0.5f, true);
+    store.update(&first, 1);
+    store.update(&second, 1);
+    CHECK(delivered(store, AnchorStatus::ADDED) == 2);
+
+    // A new tracker hears about every localized anchor again
+    store.announceAll();
+    CHECK(delivered(store, AnchorStatus::ADDED) == 2);
+
+    store.clear();
+    CHECK(store.size() == 0);
+    CHECK(delivered(store, AnchorStatus::REMOVED) == 2);
+}
+
+int main() {
+    testCreateAndRemove();
+    testRemoveBeforePlacement();
+    testDropBeforePlacement();
+    testPersistedLifecycle();
+    testLostBeforeAnnounced();
+    testDroppedBeforeAnnounced();
+    testClearAndAnnounce();
+    return unitTestResult("anchor_store_test");
+}
@@ -0,0 +1,104 @@
+#include "clock_domain.h"
+#include "driver_stats.h"
+#include "unit_test.h"
+#include <ctime>
+
+static const int64_t MS = 1000000LL;
+
+static int64_t nowNs(clockid_t clock) {
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+static void testMonotonicPassesThrough() {
+    ClockDomainMapper mapper;
+    const int64_t capture = monotonicNowNs() - 10 * MS;
+    CHECK(mapper.toMonotonic(capture) == capture);
+
+    // Nothing is captured after it reaches the driver
+    const int64_t future = monotonicNowNs() + 1000 * MS;
+    CHECK(mapper.toMonotonic(future) <= monotonicNowNs());
+
+    QuforiaClockState state;
+    mapper.state(&state);
+    CHECK(state.domain == QUFORIA_CLOCK_MONOTONIC);
+    CHECK(state.offsetNs < 0);
+}
+
+static void testKernelClocks() {
+    ClockDomainMapper mapper;
+
+    // Compared against the same clocks read here; a few ms covers any preemption in between
+    mapper.setDomain(QUFORIA_CLOCK_BOOTTIME);
+    int64_t expected = monotonicNowNs() - 10 * MS;
+    CHECK_NEAR(mapper.toMonotonic(nowNs(CLOCK_BOOTTIME) - 10 * MS), expected, 5 * MS);
+
+    mapper.setDomain(QUFORIA_CLOCK_REALTIME);
+    expected = monotonicNowNs() - 10 * MS;
+    CHECK_NEAR(mapper.toMonotonic(nowNs(CLOCK_REALTIME) - 10 * MS), expected, 5 * MS);
+    CHECK_NEAR(mapper.queryToMonotonic(nowNs(CLOCK_REALTIME)), monotonicNowNs(), 5 * MS);
+}
+
+static void testExternalSyncPoints() {
+    ClockDomainMapper mapper;
+    mapper.setDomain(QUFORIA_CLOCK_EXTERNAL);
+
+    // An external clock 1000 s behind CLOCK_MONOTONIC
+    const int64_t behind = 1000000 * MS;
+    const int64_t now = monotonicNowNs();
+    mapper.addSyncPoint(now - 100 * MS - behind, now - 100 * MS);
+    mapper.addSyncPoint(now - 50 * MS - behind, now - 50 * MS);
+    CHECK(mapper.toMonotonic(now - 20 * MS - behind) == now - 20 * MS);
+    CHECK(mapper.queryToMonotonic(now - behind) == now);
+
+    QuforiaClockState state;
+    mapper.state(&state);
+    CHECK(state.samples == 2);
+    CHECK(state.offsetNs == behind);
+    CHECK_NEAR(state.driftPpm, 0.0, 0.01);
+}
+
+static void testExternalJumpReestimates() {
+    ClockDomainMapper mapper;
+    mapper.setDomain(QUFORIA_CLOCK_EXTERNAL);
+
+    // Without sync points the first capture is taken to have just arrived
+    const int64_t external = 5000 * MS;
+    const int64_t mapped = mapper.toMonotonic(external);
+    CHECK_NEAR(mapped, monotonicNowNs(), 5 * MS);
+
+    // The clock restarts: mapping it with the old offset would land seconds in the past
+    const int64_t restarted = 10 * MS;
+    CHECK_NEAR(mapper.toMonotonic(restarted), monotonicNowNs(), 5 * MS);
+}
+
+static void testBatchSharesOneOffset() {
+    ClockDomainMapper mapper;
+    mapper.setDomain(QUFORIA_CLOCK_EXTERNAL);
+    const int64_t behind = 1000000 * MS;
+    const int64_t now = monotonicNowNs();
+    mapper.addSyncPoint(now - 100 * MS - behind, now - 100 * MS);
+
+    // Spacing is kept, and nothing lands past the newest pose's arrival
+    const ClockDomainMapper::BatchMapping mapping = mapper.mapBatch(now - 20 * MS - behind);
+    CHECK(mapping.limit == now - 20 * MS);
+    CHECK(mapping.map(now - 30 * MS - behind) == now - 30 * MS);
+    CHECK(mapping.map(now - behind) == mapping.limit);
+
+    // A batch from the future is clamped as a whole in every domain
+    mapper.setDomain(QUFORIA_CLOCK_MONOTONIC);
+    const int64_t future = monotonicNowNs() + 1000 * MS;
+    const ClockDomainMapper::BatchMapping clamped = mapper.mapBatch(future);
+    CHECK(clamped.limit <= monotonicNowNs());
+    CHECK(clamped.map(future - 10 * MS) == clamped.limit - 10 * MS);
+}
+
+int main() {
+    testMonotonicPassesThrough();
+    testKernelClocks();
+    testExternalSyncPoints();
+    testExternalJumpReestimates();
+    testBatchSharesOneOffset();
+    return unitTestResult("clock_domain_test");
+}
@@ -0,0 +1,113 @@
+#include "frame_governor.h"
+#include "unit_test.h"
+
+static const int64_t MS = 1000000LL;
+static const int64_t FRAME_INTERVAL_NS = 1000000000LL / 30;
+
+// A 30 fps camera whose frames Vuforia takes `callbackNs` to process
+class Feed {
+public:
+    explicit Feed(FrameGovernor& governor) : governor_(governor) { governor_.reset(30); }
+
+    // Feed frames until `deliveries` of them were delivered; returns how many were fed
+    int deliver(int deliveries, int64_t callbackNs) {
+        int fed = 0;
+        while (deliveries > 0) {
+            sequence_++;
+            timestamp_ += FRAME_INTERVAL_NS;
+            fed++;
+            if (governor_.shouldDeliver(sequence_, timestamp_)) {
+                governor_.frameDelivered(callbackNs, 0);
+                deliveries--;
+            }
+        }
+        return fed;
+    }
+
+private:
+    FrameGovernor& governor_;
+    uint64_t sequence_ = 0;
+    int64_t timestamp_ = 0;
+};
+
+static void testStepsUpUnderSustainedLoad() {
+    FrameGovernor governor;
+    Feed feed(governor);
+
+    // Callbacks longer than the frame interval: one level up after 15 overloaded deliveries
+    feed.deliver(14, 40 * MS);
+    CHECK(governor.level() == 0);
+    feed.deliver(1, 40 * MS);
+    CHECK(governor.level() == 1);
+
+    // Level 1 keeps every other frame
+    CHECK(feed.deliver(10, 40 * MS) == 20);
+
+    QuforiaGovernorState state;
+    governor.state(&state);
+    CHECK(state.frameDivisor == 2);
+    CHECK(state.framesShed == 10);
+    CHECK_NEAR(state.inputFps, 30.0, 0.1);
+}
+
+static void testHoldsLevelWithoutHeadroom() {
+    FrameGovernor governor;
+    Feed feed(governor);
+    feed.deliver(15, 40 * MS);
+    CHECK(governor.level() == 1);
+
+    // 40 ms fits the level 1 budget, but wouldn't fit level 0's: no oscillation
+    feed.deliver(300, 40 * MS);
+    CHECK(governor.level() == 1);
+}
+
+static void testStepsDownAfterSustainedHeadroom() {
+    FrameGovernor governor;
+    Feed feed(governor);
+    feed.deliver(15, 40 * MS);
+    CHECK(governor.level() == 1);
+
+    // The smoothed callback time needs a few deliveries to fall under the step-down
+    // threshold, then 90 consecutive ones with headroom
+    feed.deliver(90, 5 * MS);
+    CHECK(governor.level() == 1);
+    feed.deliver(20, 5 * MS);
+    CHECK(governor.level() == 0);
+
+    // A single slow callback doesn't step back up
+    feed.deliver(1, 40 * MS);
+    feed.deliver(30, 5 * MS);
+    CHECK(governor.level() == 0);
+}
+
+static void testTopLevelRecommendsHalfResolution() {
+    FrameGovernor governor;
+    Feed feed(governor);
+    feed.deliver(200, 500 * MS);
+    CHECK(governor.level() == FrameGovernor::MAX_LEVEL);
+
+    QuforiaGovernorState state;
+    governor.state(&state);
+    CHECK(state.recommendHalfResolution == 1);
+    CHECK(state.frameDivisor == 4);
+}
+
+static void testDisabledDeliversEverything() {
+    FrameGovernor governor;
+    Feed feed(governor);
+    feed.deliver(15, 40 * MS);
+    CHECK(governor.level() == 1);
+
+    governor.setEnabled(false);
+    CHECK(feed.deliver(10, 40 * MS) == 10);
+    CHECK(governor.level() == 0);
+}
+
+int main() {
+    testStepsUpUnderSustainedLoad();
+    testHoldsLevelWithoutHeadroom();
+    testStepsDownAfterSustainedHeadroom();
+    testTopLevelRecommendsHalfResolution();
+    testDisabledDeliversEverything();
+    return unitTestResult("frame_governor_test");
+}
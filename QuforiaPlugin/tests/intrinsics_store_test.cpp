@@ -0,0 +1,61 @@
+#include "intrinsics_store.h"
+#include "unit_test.h"
+
+// Unity array layout: [width, height, fx, fy, cx, cy, d0-d7]
+static void calibration(float fx, float* out) {
+    const float values[14] = { 1280, 960, fx, fx, 640, 480, 0.1f, -0.05f, 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 14; i++) {
+        out[i] = values[i];
+    }
+}
+
+static void testPublishesVersions() {
+    IntrinsicsStore store;
+    CHECK(store.current() == nullptr);
+
+    float intrinsics[14];
+    calibration(800, intrinsics);
+    const IntrinsicsSnapshot* first = store.publish(intrinsics);
+    CHECK(first->version == 1);
+    CHECK(first->width == 1280);
+    CHECK(first->intrinsics.focalLengthX == 800);
+    CHECK(first->intrinsics.distortionCoefficients[1] == -0.05f);
+    CHECK(store.current() == first);
+
+    // Identical updates keep the snapshot
+    CHECK(store.publish(intrinsics) == first);
+
+    calibration(810, intrinsics);
+    const IntrinsicsSnapshot* second = store.publish(intrinsics);
+    CHECK(second != first);
+    CHECK(second->version == 2);
+    CHECK(store.current() == second);
+}
+
+static void testReusesEarlierCalibrations() {
+    IntrinsicsStore store;
+    float a[14];
+    float b[14];
+    calibration(800, a);
+    calibration(810, b);
+    const IntrinsicsSnapshot* first = store.publish(a);
+    const IntrinsicsSnapshot* second = store.publish(b);
+
+    // A looped replay switching back and forth publishes nothing new
+    for (int loop = 0; loop < 100; loop++) {
+        CHECK(store.publish(a) == first);
+        CHECK(store.current() == first);
+        CHECK(store.publish(b) == second);
+    }
+    CHECK(store.current() == second);
+
+    float c[14];
+    calibration(820, c);
+    CHECK(store.publish(c)->version == 3);
+}
+
+int main() {
+    testPublishesVersions();
+    testReusesEarlierCalibrations();
+    return unitTestResult("intrinsics_store_test");
+}
@@ -0,0 +1,120 @@
+#include "motion_throttle.h"
+#include "unit_test.h"
+
+static const int64_t FRAME_INTERVAL_NS = 1000000000LL / 30;
+static const PoseMotion STILL = { 0.01f, 0.02f };
+static const PoseMotion MOVING = { 0.2f, 0.02f };
+
+// A 30 fps camera; frame timestamps come from the feed, not the wall clock
+class Feed {
+public:
+    explicit Feed(MotionThrottle& throttle) : throttle_(throttle) {}
+
+    // Feed `frames` frames with the head moving at `motion`; returns how many were delivered
+    int deliver(int frames, const PoseMotion* motion) {
+        int delivered = 0;
+        for (int i = 0; i < frames; i++) {
+            timestamp_ += FRAME_INTERVAL_NS;
+            delivered += throttle_.shouldDeliver(timestamp_, motion) ? 1 : 0;
+        }
+        return delivered;
+    }
+
+private:
+    MotionThrottle& throttle_;
+    int64_t timestamp_ = 0;
+};
+
+// Frames in `ns` at 30 fps
+static int framesIn(int64_t ns) {
+    return static_cast<int>(ns / FRAME_INTERVAL_NS);
+}
+
+static void testThrottlesAfterStaticDelay() {
+    MotionThrottle throttle;
+    throttle.setEnabled(true);
+    Feed feed(throttle);
+
+    // Full rate until the head has been still for STATIC_DELAY_NS
+    const int delayFrames = framesIn(MotionThrottle::STATIC_DELAY_NS);
+    CHECK(feed.deliver(delayFrames, &STILL) == delayFrames);
+    CHECK(!throttle.isThrottled());
+
+    // Then about staticFps: the interval slack lets one in 5 frames through, 6 a second
+    const int delivered = feed.deliver(30, &STILL);
+    CHECK(throttle.isThrottled());
+    CHECK(delivered >= 5 && delivered <= 7);
+
+    QuforiaMotionThrottleState state;
+    throttle.state(&state);
+    CHECK(state.throttled == 1);
+    CHECK(state.framesThrottled == static_cast<uint64_t>(30 - delivered));
+    CHECK_NEAR(state.staticSeconds, 2.0, 0.05);
+}
+
+static void testMotionResumesFullRate() {
+    MotionThrottle throttle;
+    throttle.setEnabled(true);
+    Feed feed(throttle);
+    feed.deliver(framesIn(2 * MotionThrottle::STATIC_DELAY_NS), &STILL);
+    CHECK(throttle.isThrottled());
+
+    // The first moving frame goes out, and the static delay starts over
+    CHECK(feed.deliver(1, &MOVING) == 1);
+    CHECK(!throttle.isThrottled());
+    CHECK(feed.deliver(10, &STILL) == 10);
+
+    // Not knowing the motion counts as moving
+    feed.deliver(framesIn(2 * MotionThrottle::STATIC_DELAY_NS), &STILL);
+    CHECK(throttle.isThrottled());
+    CHECK(feed.deliver(1, nullptr) == 1);
+    CHECK(!throttle.isThrottled());
+}
+
+static void testFullRateHold() {
+    MotionThrottle throttle;
+    throttle.setEnabled(true);
+    Feed feed(throttle);
+    feed.deliver(framesIn(2 * MotionThrottle::STATIC_DELAY_NS), &STILL);
+    CHECK(throttle.isThrottled());
+
+    throttle.setFullRateHold(true);
+    CHECK(feed.deliver(30, &STILL) == 30);
+    CHECK(!throttle.isThrottled());
+
+    // Released after a long still period: throttled again straight away
+    throttle.setFullRateHold(false);
+    CHECK(feed.deliver(30, &STILL) < 30);
+    CHECK(throttle.isThrottled());
+}
+
+static void testConfigureAndDisable() {
+    MotionThrottle throttle;
+    throttle.setEnabled(true);
+    throttle.configure(10.0f, 0.005f, 0.0f, true);
+    Feed feed(throttle);
+
+    // STILL is above the tighter linear threshold
+    CHECK(feed.deliver(framesIn(2 * MotionThrottle::STATIC_DELAY_NS), &STILL) ==
+          framesIn(2 * MotionThrottle::STATIC_DELAY_NS));
+
+    const PoseMotion stiller = { 0.001f, 0.02f };
+    feed.deliver(framesIn(MotionThrottle::STATIC_DELAY_NS), &stiller);
+    const int delivered = feed.deliver(30, &stiller);
+    CHECK(delivered >= 10 && delivered <= 15);
+    QuforiaMotionThrottleState state;
+    throttle.state(&state);
+    CHECK(state.recommendLowResolution == 1);
+
+    throttle.setEnabled(false);
+    CHECK(feed.deliver(30, &stiller) == 30);
+    CHECK(!throttle.isThrottled());
+}
+
+int main() {
+    testThrottlesAfterStaticDelay();
+    testMotionResumesFullRate();
+    testFullRateHold();
+    testConfigureAndDisable();
+    return unitTestResult("motion_throttle_test");
+}
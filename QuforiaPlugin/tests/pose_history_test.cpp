@@ -0,0 +1,122 @@
+#include "pose_history.h"
+#include "unit_test.h"
+
+static const int64_t MS = 1000000LL;
+
+// Head moving along x at 1 m per 10 ms, so positions tell where a sample came from
+static PoseData poseAt(int64_t timestamp) {
+    PoseData pose;
+    pose.timestamp = timestamp;
+    pose.position[0] = static_cast<float>(timestamp) / (10 * MS);
+    return pose;
+}
+
+static void testRejectsOutOfOrder() {
+    PoseHistory history;
+    history.allocate(1000 * MS, 100);
+
+    CHECK(history.push(poseAt(100 * MS)));
+    CHECK(!history.push(poseAt(90 * MS)));
+    CHECK(history.push(poseAt(100 * MS)));  // Same timestamp is still in order
+    CHECK(history.newestTimestamp() == 100 * MS);
+    CHECK(history.size() == 2);
+
+    // A batch keeps its in-order runs and drops what goes backwards
+    const PoseData batch[] = { poseAt(110 * MS), poseAt(120 * MS), poseAt(115 * MS), poseAt(130 * MS),
+                               poseAt(50 * MS) };
+    CHECK(history.pushBatch(batch, 5) == 3);
+    CHECK(history.newestTimestamp() == 130 * MS);
+    CHECK(history.size() == 5);
+}
+
+static void testInterpolates() {
+    PoseHistory history;
+    history.allocate(1000 * MS, 100);
+    history.push(poseAt(0));
+    history.push(poseAt(10 * MS));
+
+    PoseData pose;
+    int64_t matchError = -1;
+    CHECK(history.sample(4 * MS, &pose, &matchError));
+    CHECK_NEAR(pose.position[0], 0.4, 1e-5);
+    CHECK(pose.timestamp == 4 * MS);
+    CHECK(matchError == 4 * MS);
+
+    // A real sample comes back exactly
+    CHECK(history.sample(10 * MS, &pose, &matchError));
+    CHECK_NEAR(pose.position[0], 1.0, 1e-6);
+    CHECK(matchError == 0);
+}
+
+static void testInterpolationGap() {
+    PoseHistory history;
+    history.allocate(1000 * MS, 100);
+    history.push(poseAt(0));
+    history.push(poseAt(200 * MS));
+
+    // Too far apart to blend: the nearer sample within 50 ms, otherwise nothing
+    PoseData pose;
+    CHECK(history.sample(30 * MS, &pose));
+    CHECK_NEAR(pose.position[0], 0.0, 1e-6);
+    CHECK(history.sample(160 * MS, &pose));
+    CHECK_NEAR(pose.position[0], 20.0, 1e-6);
+    CHECK(!history.sample(100 * MS, &pose));
+
+    // With a wider gap allowed the same query interpolates
+    history.setMaxInterpolationGap(250 * MS);
+    CHECK(history.sample(100 * MS, &pose));
+    CHECK_NEAR(pose.position[0], 10.0, 1e-5);
+}
+
+static void testExtrapolationLimits() {
+    PoseHistory history;
+    history.allocate(1000 * MS, 100);
+    history.push(poseAt(0));
+    history.push(poseAt(10 * MS));
+
+    // Within the default 20 ms: extrapolated from the last two samples
+    PoseData pose;
+    int64_t matchError = -1;
+    CHECK(history.sample(15 * MS, &pose, &matchError));
+    CHECK_NEAR(pose.position[0], 1.5, 1e-5);
+    CHECK(matchError == 5 * MS);
+
+    // Further ahead: the newest pose is held, up to 50 ms
+    CHECK(history.sample(40 * MS, &pose));
+    CHECK_NEAR(pose.position[0], 1.0, 1e-6);
+    CHECK(!history.sample(70 * MS, &pose));
+
+    // Never more than one sample interval past the newest, whatever the tolerance
+    history.setMaxExtrapolation(100 * MS);
+    CHECK(history.sample(40 * MS, &pose));
+    CHECK_NEAR(pose.position[0], 2.0, 1e-5);
+
+    // Before the oldest sample: nearest only
+    CHECK(history.sample(-30 * MS, &pose));
+    CHECK_NEAR(pose.position[0], 0.0, 1e-6);
+    CHECK(!history.sample(-60 * MS, &pose));
+}
+
+static void testWindow() {
+    PoseHistory history;
+    history.allocate(100 * MS, 100);
+    for (int i = 0; i <= 100; i++) {
+        history.push(poseAt(i * 10 * MS));
+    }
+
+    // Poses from newest - 100 ms on; older ones have aged out
+    CHECK(history.size() == 11);
+    PoseData pose;
+    CHECK(history.sample(905 * MS, &pose));
+    CHECK_NEAR(pose.position[0], 90.5, 1e-4);
+    CHECK(!history.sample(500 * MS, &pose));
+}
+
+int main() {
+    testRejectsOutOfOrder();
+    testInterpolates();
+    testInterpolationGap();
+    testExtrapolationLimits();
+    testWindow();
+    return unitTestResult("pose_history_test");
+}
@@ -0,0 +1,80 @@
+#include "session_recorder.h"
+#include "session_replay.h"
+#include "unit_test.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+// A fresh temporary file for the recorder to overwrite
+static std::string temporaryPath() {
+    char path[] = "/tmp/quforia_recording_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+        return std::string();
+    }
+    ::close(fd);
+    return path;
+}
+
+static bool readHeader(const std::string& path, SessionFileHeader* header) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    const bool ok = fread(header, sizeof(*header), 1, file) == 1;
+    fclose(file);
+    return ok;
+}
+
+static PoseData poseAt(int64_t timestamp) {
+    PoseData pose = {};
+    pose.timestamp = timestamp;
+    pose.rotation[3] = 1.0f;
+    return pose;
+}
+
+static void testHeaderHasStartTimestamp() {
+    const std::string path = temporaryPath();
+    CHECK(!path.empty());
+
+    SessionRecorder recorder;
+    CHECK(recorder.start(path.c_str(), false));
+    // Intrinsics carry no timestamp and don't count as the start
+    const float intrinsics[SESSION_INTRINSICS_COUNT] = { 640, 480, 500, 500, 320, 240 };
+    recorder.recordIntrinsics(intrinsics);
+    recorder.recordPose(poseAt(5000));
+    recorder.recordPose(poseAt(6000));
+    recorder.stop();
+
+    SessionFileHeader header;
+    CHECK(readHeader(path, &header));
+    CHECK(header.magic == SESSION_FILE_MAGIC);
+    CHECK(header.startTimestamp == 5000);
+
+    // Still a valid session with every record after the header
+    SessionReplay replay;
+    CHECK(replay.open(path.c_str()));
+    CHECK(replay.poseCount() == 2);
+    unlink(path.c_str());
+}
+
+static void testEmptySessionHasNoStart() {
+    const std::string path = temporaryPath();
+    CHECK(!path.empty());
+
+    SessionRecorder recorder;
+    CHECK(recorder.start(path.c_str(), false));
+    recorder.stop();
+
+    SessionFileHeader header;
+    CHECK(readHeader(path, &header));
+    CHECK(header.startTimestamp == 0);
+    unlink(path.c_str());
+}
+
+int main() {
+    testHeaderHasStartTimestamp();
+    testEmptySessionHasNoStart();
+    return unitTestResult("session_recorder_test");
+}
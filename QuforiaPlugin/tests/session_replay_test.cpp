@@ -0,0 +1,197 @@
+#include "session_replay.h"
+#include "session_format.h"
+#include "pixel_convert.h"
+#include "unit_test.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using VuforiaDriver::PixelFormat;
+
+// Builds a session file in memory, record by record, the way SessionRecorder lays it out
+class SessionBuilder {
+public:
+    SessionBuilder() {
+        SessionFileHeader header = { SESSION_FILE_MAGIC, SESSION_FILE_VERSION, 0 };
+        append(&header, sizeof(header));
+    }
+
+    void pose(int64_t timestamp) {
+        SessionPose pose = {};
+        pose.rotation[3] = 1.0f;
+        record(SessionRecordType::POSE, timestamp, &pose, sizeof(pose));
+    }
+
+    // A frame record of `width` x `height` `format` carrying `pixelBytes` of pixel data
+    void frame(int64_t timestamp, uint32_t width, uint32_t height, uint32_t stride,
+               PixelFormat format, uint32_t pixelBytes) {
+        SessionFrameHeader frame = {};
+        frame.width = width;
+        frame.height = height;
+        frame.stride = stride;
+        frame.format = static_cast<uint32_t>(format);
+        frame.compression = static_cast<uint32_t>(SessionCompression::NONE);
+        frame.storedSize = pixelBytes;
+        frame.rawSize = pixelBytes;
+
+        std::vector<uint8_t> payload(sizeof(frame) + pixelBytes);
+        memcpy(payload.data(), &frame, sizeof(frame));
+        record(SessionRecordType::FRAME, timestamp, payload.data(), payload.size());
+    }
+
+    void record(SessionRecordType type, int64_t timestamp, const void* payload, size_t size) {
+        SessionRecordHeader header = { static_cast<uint32_t>(type), static_cast<uint32_t>(size), timestamp };
+        append(&header, sizeof(header));
+        append(payload, size);
+        const uint8_t padding[8] = {};
+        append(padding, sessionPadding(static_cast<uint32_t>(size)));
+    }
+
+    void truncate(size_t bytes) { data_.resize(data_.size() - bytes); }
+    uint8_t* data() { return data_.data(); }
+
+    // Write to a fresh temporary file; returns its path
+    std::string write() const {
+        char path[] = "/tmp/quforia_session_XXXXXX";
+        const int fd = mkstemp(path);
+        if (fd < 0) {
+            return std::string();
+        }
+        const bool written = ::write(fd, data_.data(), data_.size()) == static_cast<ssize_t>(data_.size());
+        ::close(fd);
+        return written ? path : std::string();
+    }
+
+private:
+    void append(const void* bytes, size_t size) {
+        const size_t offset = data_.size();
+        data_.resize(offset + size);
+        memcpy(data_.data() + offset, bytes, size);
+    }
+
+    std::vector<uint8_t> data_;
+};
+
+static bool opens(const SessionBuilder& builder, SessionReplay* replay) {
+    const std::string path = builder.write();
+    CHECK(!path.empty());
+    const bool ok = replay->open(path.c_str());
+    unlink(path.c_str());
+    return ok;
+}
+
+static const uint32_t WIDTH = 64;
+static const uint32_t HEIGHT = 48;
+
+static void testIndexesValidSession() {
+    SessionBuilder builder;
+    builder.pose(1000);
+    builder.frame(2000, WIDTH, HEIGHT, 0, PixelFormat::NV21, frameBufferSize(PixelFormat::NV21, WIDTH, HEIGHT));
+    builder.pose(3000);
+    builder.frame(4000, WIDTH, HEIGHT, 0, PixelFormat::RGBA8888,
+                  frameBufferSize(PixelFormat::RGBA8888, WIDTH, HEIGHT));
+
+    SessionReplay replay;
+    CHECK(opens(builder, &replay));
+    CHECK(replay.frameCount() == 2);
+    CHECK(replay.poseCount() == 2);
+    CHECK(replay.durationNs() == 3000);
+}
+
+static void testRejectsBadHeader() {
+    SessionBuilder builder;
+    builder.pose(1000);
+    SessionFileHeader* header = reinterpret_cast<SessionFileHeader*>(builder.data());
+
+    SessionReplay replay;
+    header->magic = 0;
+    CHECK(!opens(builder, &replay));
+    header->magic = SESSION_FILE_MAGIC;
+    header->version = SESSION_FILE_VERSION + 1;
+    CHECK(!opens(builder, &replay));
+}
+
+static void testRejectsUndersizedFrames() {
+    const uint32_t nv21Size = static_cast<uint32_t>(frameBufferSize(PixelFormat::NV21, WIDTH, HEIGHT));
+    SessionReplay replay;
+
+    // Pixel data short of the frame it describes
+    SessionBuilder shortPixels;
+    shortPixels.frame(1000, WIDTH, HEIGHT, 0, PixelFormat::NV21, nv21Size - 1);
+    CHECK(!opens(shortPixels, &replay));
+
+    // A stride narrower than a row
+    SessionBuilder narrowStride;
+    narrowStride.frame(1000, WIDTH, HEIGHT, WIDTH / 2, PixelFormat::NV21, nv21Size);
+    CHECK(!opens(narrowStride, &replay));
+
+    // No pixels at all, or a format with no known layout
+    SessionBuilder empty;
+    empty.frame(1000, 0, HEIGHT, 0, PixelFormat::NV21, 0);
+    CHECK(!opens(empty, &replay));
+    SessionBuilder unknown;
+    unknown.frame(1000, WIDTH, HEIGHT, 0, PixelFormat::UNKNOWN, nv21Size);
+    CHECK(!opens(unknown, &replay));
+
+    // A padded stride needs the padded size
+    const uint32_t stride = WIDTH + 16;
+    SessionBuilder padded;
+    padded.frame(1000, WIDTH, HEIGHT, stride, PixelFormat::NV21,
+                 static_cast<uint32_t>(frameBufferSize(PixelFormat::NV21, WIDTH, HEIGHT, stride)));
+    CHECK(opens(padded, &replay));
+    SessionBuilder paddedShort;
+    paddedShort.frame(1000, WIDTH, HEIGHT, stride, PixelFormat::NV21, nv21Size);
+    CHECK(!opens(paddedShort, &replay));
+}
+
+static void testRejectsUndersizedRecords() {
+    SessionReplay replay;
+    SessionPose pose = {};
+
+    SessionBuilder shortPose;
+    shortPose.record(SessionRecordType::POSE, 1000, &pose, sizeof(pose) - 8);
+    CHECK(!opens(shortPose, &replay));
+
+    float intrinsics[SESSION_INTRINSICS_COUNT] = {};
+    SessionBuilder shortIntrinsics;
+    shortIntrinsics.record(SessionRecordType::INTRINSICS, 0, intrinsics, sizeof(intrinsics) - 4);
+    CHECK(!opens(shortIntrinsics, &replay));
+}
+
+static void testDropsTruncatedTail() {
+    SessionBuilder builder;
+    builder.pose(1000);
+    builder.frame(2000, WIDTH, HEIGHT, 0, PixelFormat::NV21, frameBufferSize(PixelFormat::NV21, WIDTH, HEIGHT));
+    builder.truncate(100);
+
+    // A recording cut short keeps what was complete
+    SessionReplay replay;
+    CHECK(opens(builder, &replay));
+    CHECK(replay.poseCount() == 1);
+    CHECK(replay.frameCount() == 0);
+}
+
+static void testSkipsUnknownRecords() {
+    SessionBuilder builder;
+    builder.pose(1000);
+    const uint8_t future[12] = {};
+    builder.record(static_cast<SessionRecordType>(99), 1500, future, sizeof(future));
+    builder.pose(2000);
+
+    SessionReplay replay;
+    CHECK(opens(builder, &replay));
+    CHECK(replay.poseCount() == 2);
+    CHECK(replay.durationNs() == 1000);
+}
+
+int main() {
+    testIndexesValidSession();
+    testRejectsBadHeader();
+    testRejectsUndersizedFrames();
+    testRejectsUndersizedRecords();
+    testDropsTruncatedTail();
+    testSkipsUnknownRecords();
+    return unitTestResult("session_replay_test");
+}
@@ -0,0 +1,45 @@
+#ifndef QUFORIA_UNIT_TEST_H
+#define QUFORIA_UNIT_TEST_H
+
+#include <cmath>
+#include <cstdio>
+
+/**
+ * Minimal checks for the host unit tests. A failed CHECK prints where and what and is
+ * counted; the test keeps going so one run reports every broken expectation, and
+ * unitTestResult() turns the count into the exit code ctest looks at.
+ */
+#define CHECK(condition) unitTestCheck((condition), __FILE__, __LINE__, #condition)
+#define CHECK_NEAR(actual, expected, tolerance) \
+    unitTestCheckNear((actual), (expected), (tolerance), __FILE__, __LINE__, #actual)
+
+inline int& unitTestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void unitTestCheck(bool ok, const char* file, int line, const char* text) {
+    if (!ok) {
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, text);
+        unitTestFailures()++;
+    }
+}
+
+inline void unitTestCheckNear(double actual, double expected, double tolerance, const char* file,
+                              int line, const char* text) {
+    if (!(std::fabs(actual - expected) <= tolerance)) {
+        fprintf(stderr, "%s:%d: %s is %g, expected %g\n", file, line, text, actual, expected);
+        unitTestFailures()++;
+    }
+}
+
+inline int unitTestResult(const char* name) {
+    if (unitTestFailures() > 0) {
+        printf("%s: %d checks failed\n", name, unitTestFailures());
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+#endif // QUFORIA_UNIT_TEST_H